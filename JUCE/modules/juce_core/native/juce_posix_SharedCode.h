@@ -36,7 +36,31 @@ CriticalSection::CriticalSection() noexcept
 }
 
 CriticalSection::~CriticalSection() noexcept        { pthread_mutex_destroy (&lock); }
+
+#if HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION
+static std::atomic<CriticalSection::EnterCallback> criticalSectionEnterCallback { nullptr };
+
+void CriticalSection::setEnterCallback (EnterCallback newCallback) noexcept    { criticalSectionEnterCallback.store (newCallback); }
+
+void CriticalSection::enter() const noexcept
+{
+    if (auto callback = criticalSectionEnterCallback.load (std::memory_order_acquire))
+    {
+        const bool wasContended = pthread_mutex_trylock (&lock) != 0;
+
+        if (wasContended)
+            pthread_mutex_lock (&lock);
+
+        callback (*this, wasContended);
+        return;
+    }
+
+    pthread_mutex_lock (&lock);
+}
+#else
 void CriticalSection::enter() const noexcept        { pthread_mutex_lock (&lock); }
+#endif
+
 bool CriticalSection::tryEnter() const noexcept     { return pthread_mutex_trylock (&lock) == 0; }
 void CriticalSection::exit() const noexcept         { pthread_mutex_unlock (&lock); }
 
@@ -43,7 +43,31 @@ CriticalSection::CriticalSection() noexcept
 }
 
 CriticalSection::~CriticalSection() noexcept        { DeleteCriticalSection ((CRITICAL_SECTION*) lock); }
+
+#if HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION
+static std::atomic<CriticalSection::EnterCallback> criticalSectionEnterCallback { nullptr };
+
+void CriticalSection::setEnterCallback (EnterCallback newCallback) noexcept    { criticalSectionEnterCallback.store (newCallback); }
+
+void CriticalSection::enter() const noexcept
+{
+    if (auto callback = criticalSectionEnterCallback.load (std::memory_order_acquire))
+    {
+        const bool wasContended = TryEnterCriticalSection ((CRITICAL_SECTION*) lock) == FALSE;
+
+        if (wasContended)
+            EnterCriticalSection ((CRITICAL_SECTION*) lock);
+
+        callback (*this, wasContended);
+        return;
+    }
+
+    EnterCriticalSection ((CRITICAL_SECTION*) lock);
+}
+#else
 void CriticalSection::enter() const noexcept        { EnterCriticalSection ((CRITICAL_SECTION*) lock); }
+#endif
+
 bool CriticalSection::tryEnter() const noexcept     { return TryEnterCriticalSection ((CRITICAL_SECTION*) lock) != FALSE; }
 void CriticalSection::exit() const noexcept         { LeaveCriticalSection ((CRITICAL_SECTION*) lock); }
 
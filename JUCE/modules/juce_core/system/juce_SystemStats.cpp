@@ -184,6 +184,57 @@ String SystemStats::getStackBacktrace()
     return result;
 }
 
+int SystemStats::captureStackFrames (void** frames, int maxNumFrames) noexcept
+{
+   #if JUCE_ANDROID || JUCE_MINGW
+    ignoreUnused (frames, maxNumFrames);
+    return 0;
+   #elif JUCE_WINDOWS
+    return (int) CaptureStackBackTrace (0, (DWORD) maxNumFrames, frames, nullptr);
+   #else
+    return backtrace (frames, maxNumFrames);
+   #endif
+}
+
+String SystemStats::getStackBacktrace (const void* const* frames, int numFrames)
+{
+    String result;
+
+   #if JUCE_ANDROID || JUCE_MINGW
+    ignoreUnused (frames, numFrames);
+
+   #elif JUCE_WINDOWS
+    HANDLE process = GetCurrentProcess();
+    SymInitialize (process, nullptr, TRUE);
+
+    HeapBlock<SYMBOL_INFO> symbol;
+    symbol.calloc (sizeof (SYMBOL_INFO) + 256, 1);
+    symbol->MaxNameLen = 255;
+    symbol->SizeOfStruct = sizeof (SYMBOL_INFO);
+
+    for (int i = 0; i < numFrames; ++i)
+    {
+        DWORD64 displacement = 0;
+
+        if (SymFromAddr (process, (DWORD64) frames[i], &displacement, symbol))
+            result << i << ": " << symbol->Name << " + 0x" << String::toHexString ((int64) displacement) << newLine;
+    }
+
+   #else
+    char** frameStrings = backtrace_symbols (const_cast<void* const*> (frames), numFrames);
+
+    if (frameStrings != nullptr)
+    {
+        for (int i = 0; i < numFrames; ++i)
+            result << frameStrings[i] << newLine;
+
+        ::free (frameStrings);
+    }
+   #endif
+
+    return result;
+}
+
 //==============================================================================
 static SystemStats::CrashHandlerFunction globalCrashHandler = nullptr;
 
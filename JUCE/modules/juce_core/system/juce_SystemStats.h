@@ -209,6 +209,18 @@ public:
     */
     static String getStackBacktrace();
 
+    /** Writes the addresses of the current call-stack into the given array and returns
+        the number of frames.
+
+        Unlike getStackBacktrace() this doesn't resolve the symbols, so it can be used in
+        places where you can't allocate memory (eg. in a custom operator new). Use
+        getStackBacktrace (const void* const*, int) to convert the addresses later.
+    */
+    static int captureStackFrames (void** frames, int maxNumFrames) noexcept;
+
+    /** Returns a readable backtrace for the frames obtained by captureStackFrames(). */
+    static String getStackBacktrace (const void* const* frames, int numFrames);
+
     /** A function type for use in setApplicationCrashHandler().
         When called, its void* argument will contain platform-specific data about the crash.
     */
@@ -87,6 +87,24 @@ public:
     */
     void exit() const noexcept;
 
+   #if HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION
+    //==============================================================================
+    /** A function that is called by enter() after the lock was acquired.
+
+        The second argument is true if the lock was held by another thread and the
+        caller had to wait. This is used by HISE's audio thread instrumentation in
+        order to detect locks in the audio callback.
+    */
+    using EnterCallback = void (*) (const CriticalSection&, bool wasContended);
+
+    /** Installs a global callback that is notified about every call to enter().
+
+        If no callback is set, enter() just locks the mutex. Pass in nullptr to remove it.
+        Install it once at startup, before any thread uses a CriticalSection.
+    */
+    static void setEnterCallback (EnterCallback newCallback) noexcept;
+   #endif
+
 
     //==============================================================================
     /** Provides the type of scoped lock to use with a CriticalSection. */
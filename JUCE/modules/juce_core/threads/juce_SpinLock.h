@@ -68,6 +68,22 @@ public:
         lock = 0;
     }
 
+   #if HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION
+    //==============================================================================
+    /** A function that is called by enter() after the lock was acquired.
+
+        The second argument is true if the lock was held by another thread and the
+        caller had to spin. This is used by HISE's audio thread instrumentation.
+    */
+    using EnterCallback = void (*) (const SpinLock&, bool wasContended);
+
+    /** Installs a global callback that is notified about every call to enter().
+
+        Install it once at startup, before any thread uses a SpinLock. Pass in nullptr to remove it.
+    */
+    static void setEnterCallback (EnterCallback newCallback) noexcept;
+   #endif
+
     //==============================================================================
     /** Provides the type of scoped lock to use for locking a SpinLock. */
     using ScopedLockType = GenericScopedLock<SpinLock>;
@@ -331,18 +331,38 @@ void Thread::launch (std::function<void()> functionToRun)
 }
 
 //==============================================================================
+static void spinUntilEntered (const SpinLock& l) noexcept
+{
+    for (int i = 20; --i >= 0;)
+        if (l.tryEnter())
+            return;
+
+    while (! l.tryEnter())
+        Thread::yield();
+}
+
+#if HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION
+static std::atomic<SpinLock::EnterCallback> spinLockEnterCallback { nullptr };
+
+void SpinLock::setEnterCallback (EnterCallback newCallback) noexcept    { spinLockEnterCallback.store (newCallback); }
+
 void SpinLock::enter() const noexcept
 {
-    if (! tryEnter())
-    {
-        for (int i = 20; --i >= 0;)
-            if (tryEnter())
-                return;
+    const bool wasContended = ! tryEnter();
 
-        while (! tryEnter())
-            Thread::yield();
-    }
+    if (wasContended)
+        spinUntilEntered (*this);
+
+    if (auto callback = spinLockEnterCallback.load (std::memory_order_acquire))
+        callback (*this, wasContended);
 }
+#else
+void SpinLock::enter() const noexcept
+{
+    if (! tryEnter())
+        spinUntilEntered (*this);
+}
+#endif
 
 //==============================================================================
 bool JUCE_CALLTYPE Process::isRunningUnderDebugger() noexcept
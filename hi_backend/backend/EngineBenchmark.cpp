@@ -0,0 +1,722 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+namespace hise { using namespace juce;
+
+struct EngineBenchmark::Helpers
+{
+	static constexpr int NumNotesPerChannel = 96;
+	static constexpr int LowestNote = 24;
+
+	static MidiMessage getNoteOn(int voiceIndex)
+	{
+		const int channel = 1 + (voiceIndex / NumNotesPerChannel) % 16;
+		return MidiMessage::noteOn(channel, LowestNote + voiceIndex % NumNotesPerChannel, (uint8)100);
+	}
+
+	static MidiMessage getNoteOff(int voiceIndex)
+	{
+		const int channel = 1 + (voiceIndex / NumNotesPerChannel) % 16;
+		return MidiMessage::noteOff(channel, LowestNote + voiceIndex % NumNotesPerChannel);
+	}
+
+	template <class SynthType> static SynthType* addSynth(BackendProcessor* bp, const String& id)
+	{
+		auto s = new SynthType(bp, id, NUM_POLYPHONIC_VOICES);
+		s->addProcessorsWhenEmpty();
+
+		bp->getMainSynthChain()->getHandler()->add(s, nullptr);
+
+		return s;
+	}
+
+	static void addMasterEffect(BackendProcessor* bp, EffectProcessor* fx)
+	{
+		auto fxChain = dynamic_cast<EffectProcessorChain*>(bp->getMainSynthChain()->getChildProcessor(ModulatorSynth::EffectChain));
+		fxChain->getHandler()->add(fx, nullptr);
+	}
+
+	static Result compile(JavascriptProcessor* jp, const String& code)
+	{
+		if (!jp->parseSnippetsFromString(code, true))
+			return Result::fail("Can't parse the benchmark script");
+
+		// The processor is not initialised yet, so this compiles synchronously
+		jp->compileScript();
+
+		return Result::ok();
+	}
+
+	static Result writeWavFile(const File& f, const AudioSampleBuffer& b, double sampleRate)
+	{
+		f.deleteFile();
+
+		ScopedPointer<FileOutputStream> fos = new FileOutputStream(f);
+
+		if (fos->failedToOpen())
+			return Result::fail("Can't write to " + f.getFullPathName());
+
+		WavAudioFormat wav;
+		ScopedPointer<AudioFormatWriter> writer = wav.createWriterFor(fos, sampleRate, b.getNumChannels(), 24, {}, 0);
+
+		if (writer == nullptr)
+			return Result::fail("Can't create the WAV writer");
+
+		fos.release();
+
+		if (!writer->writeFromAudioSampleBuffer(b, 0, b.getNumSamples()))
+			return Result::fail("Can't write " + f.getFullPathName());
+
+		return Result::ok();
+	}
+
+	/** A two second stereo sawtooth at middle C. */
+	static AudioSampleBuffer createSample(double sampleRate)
+	{
+		AudioSampleBuffer b(2, roundToInt(2.0 * sampleRate));
+
+		const double delta = MidiMessage::getMidiNoteInHertz(60) / sampleRate;
+		double phase = 0.0;
+
+		for (int i = 0; i < b.getNumSamples(); i++)
+		{
+			const float v = 0.25f * (float)(2.0 * phase - 1.0);
+
+			b.setSample(0, i, v);
+			b.setSample(1, i, -v);
+
+			phase = std::fmod(phase + delta, 1.0);
+		}
+
+		return b;
+	}
+
+	/** A two second stereo impulse response with exponentially decaying noise (and a fixed seed). */
+	static AudioSampleBuffer createImpulseResponse(double sampleRate)
+	{
+		AudioSampleBuffer b(2, roundToInt(2.0 * sampleRate));
+
+		Random r(1234);
+
+		const float decay = (float)std::exp(std::log(0.001) / (double)b.getNumSamples());
+		float gain = 0.5f;
+
+		for (int i = 0; i < b.getNumSamples(); i++)
+		{
+			b.setSample(0, i, gain * (2.0f * r.nextFloat() - 1.0f));
+			b.setSample(1, i, gain * (2.0f * r.nextFloat() - 1.0f));
+			gain *= decay;
+		}
+
+		return b;
+	}
+
+	static ValueTree createSampleMap(const File& sampleFile, int numSamples)
+	{
+		ValueTree map("samplemap");
+		map.setProperty("ID", "Benchmark", nullptr);
+		map.setProperty("RRGroupAmount", 1, nullptr);
+
+		ValueTree s("sample");
+		s.setProperty(SampleIds::FileName, sampleFile.getFullPathName(), nullptr);
+		s.setProperty(SampleIds::Root, 60, nullptr);
+		s.setProperty(SampleIds::LoKey, 0, nullptr);
+		s.setProperty(SampleIds::HiKey, 127, nullptr);
+		s.setProperty(SampleIds::LoVel, 0, nullptr);
+		s.setProperty(SampleIds::HiVel, 127, nullptr);
+		s.setProperty(SampleIds::RRGroup, 1, nullptr);
+
+		// Loop the second half so that the voices keep streaming from the disk
+		s.setProperty(SampleIds::LoopEnabled, true, nullptr);
+		s.setProperty(SampleIds::LoopStart, numSamples / 2, nullptr);
+		s.setProperty(SampleIds::LoopEnd, numSamples, nullptr);
+
+		map.addChild(s, -1, nullptr);
+
+		return map;
+	}
+
+	/** Creates one wavetable set per note with 8 tables that add more harmonics. */
+	static ValueTree createWavetables(double sampleRate)
+	{
+		const int tableSize = 256;
+		const int numTables = 8;
+
+		MemoryBlock mb(sizeof(float) * tableSize * numTables, true);
+		auto data = static_cast<float*>(mb.getData());
+
+		for (int t = 0; t < numTables; t++)
+		{
+			for (int i = 0; i < tableSize; i++)
+			{
+				const double phase = double_Pi * 2.0 * (double)i / (double)tableSize;
+				double v = 0.0;
+
+				for (int h = 1; h <= 1 + t * 4; h++)
+					v += std::sin(phase * (double)h) / (double)h;
+
+				data[t * tableSize + i] = (float)v;
+			}
+		}
+
+		ValueTree v("wavetables");
+
+		for (int i = 0; i < 128; i++)
+		{
+			ValueTree t("wavetable");
+			t.setProperty("data", var(mb), nullptr);
+			t.setProperty("amount", numTables, nullptr);
+			t.setProperty("sampleRate", sampleRate, nullptr);
+			t.setProperty("noteNumber", i, nullptr);
+			v.addChild(t, -1, nullptr);
+		}
+
+		return v;
+	}
+
+	static String getScriptnodeScript()
+	{
+		String s;
+
+		s << "const var n = Engine.createDspNetwork(\"benchmark\");\n";
+		s << "for (i = 0; i < 4; i++)\n{\n";
+		s << "\tn.create(\"filters.svf\", \"svf\" + i).setParent(n, -1);\n";
+		s << "\tn.create(\"math.tanh\", \"tanh\" + i).setParent(n, -1);\n";
+		s << "}\n";
+		s << "function prepareToPlay(sampleRate, blockSize){}\n";
+		s << "function processBlock(channels){}\n";
+		s << "function onControl(number, value){}\n";
+
+		return s;
+	}
+
+	static String getHeavyNoteOnScript()
+	{
+		String s;
+
+		s << "const var data = [];\n";
+		s << "reg k = 0;\n";
+		s << "reg sum = 0.0;\n";
+		s << "for (i = 0; i < 128; i++) data.push(i / 128.0);\n";
+		s << "function onNoteOn()\n{\n";
+		s << "\tsum = 0.0;\n";
+		s << "\tfor (k = 0; k < 512; k++)\n";
+		s << "\t\tsum += Math.sin(data[k % 128] * Message.getNoteNumber());\n";
+		s << "\tMessage.setVelocity(Math.range(Math.abs(sum), 1, 127));\n";
+		s << "}\n";
+		s << "function onNoteOff(){}\n";
+		s << "function onController(){}\n";
+		s << "function onTimer(){}\n";
+		s << "function onControl(number, value){}\n";
+
+		return s;
+	}
+
+	static int getNumActiveVoices(BackendProcessor* bp)
+	{
+		int numVoices = 0;
+
+		Processor::Iterator<ModulatorSynth> iter(bp->getMainSynthChain(), false);
+
+		while (auto s = iter.getNextProcessor())
+		{
+			if (s != bp->getMainSynthChain())
+				numVoices += s->getNumActiveVoices();
+		}
+
+		return numVoices;
+	}
+
+	/** Keeps calling the audio callback with silence for the given time so that the background threads can finish their work. */
+	static void processSilence(BackendProcessor* bp, int blockSize, int milliseconds)
+	{
+		AudioSampleBuffer silence(2, blockSize);
+		MidiBuffer emptyMidi;
+
+		const auto start = Time::getMillisecondCounter();
+
+		while ((int)(Time::getMillisecondCounter() - start) < milliseconds)
+		{
+			silence.clear();
+			bp->processBlock(silence, emptyMidi);
+			Thread::sleep(5);
+		}
+	}
+};
+
+String EngineBenchmark::Measurement::toString() const
+{
+	String s;
+
+	s << getScenarioName(scenario) << ": ";
+	s << String(nsPerSamplePerVoice, 2) << " ns/sample/voice (" << String(numActiveVoices, 1) << " voices), ";
+	s << "block: " << String(meanBlockMicroseconds, 1) << " us (max " << String(maxBlockMicroseconds, 1) << " us, jitter " << String(jitterMicroseconds, 1) << " us), ";
+	s << "realtime factor: " << String(realtimeFactor, 1) << "x";
+
+	if (allocationsPerBlock >= 0.0)
+	{
+		s << ", allocations/block: " << String(allocationsPerBlock, 2);
+		s << ", frees/block: " << String(freesPerBlock, 2);
+		s << ", lock waits/block: " << String(lockWaitsPerBlock, 2);
+	}
+
+	return s;
+}
+
+var EngineBenchmark::Measurement::toJSON() const
+{
+	DynamicObject::Ptr obj = new DynamicObject();
+
+	obj->setProperty("scenario", getScenarioName(scenario));
+	obj->setProperty("numVoices", numVoices);
+	obj->setProperty("numActiveVoices", numActiveVoices);
+	obj->setProperty("numBlocks", numBlocks);
+	obj->setProperty("nsPerSample", nsPerSample);
+	obj->setProperty("nsPerSamplePerVoice", nsPerSamplePerVoice);
+	obj->setProperty("meanBlockMicroseconds", meanBlockMicroseconds);
+	obj->setProperty("maxBlockMicroseconds", maxBlockMicroseconds);
+	obj->setProperty("jitterMicroseconds", jitterMicroseconds);
+	obj->setProperty("realtimeFactor", realtimeFactor);
+	obj->setProperty("allocationsPerBlock", allocationsPerBlock);
+	obj->setProperty("freesPerBlock", freesPerBlock);
+	obj->setProperty("lockWaitsPerBlock", lockWaitsPerBlock);
+
+	if (audioThreadReport.isNotEmpty())
+		obj->setProperty("audioThreadReport", audioThreadReport);
+
+	if (profilerSummary.isNotEmpty())
+		obj->setProperty("profilerSummary", profilerSummary);
+
+	return var(obj.get());
+}
+
+EngineBenchmark::EngineBenchmark(const Settings& settings_) :
+	settings(settings_),
+	tempDirectory(File::getSpecialLocation(File::tempDirectory).getChildFile("HiseBenchmark"))
+{
+	// This makes the loading synchronous and prevents the audio driver from being opened
+	CompileExporter::setExportingFromCommandLine();
+
+	tempDirectory.createDirectory();
+}
+
+EngineBenchmark::~EngineBenchmark()
+{
+	tempDirectory.deleteRecursively();
+}
+
+String EngineBenchmark::getScenarioName(Scenario s)
+{
+	switch (s)
+	{
+	case Scenario::SineVoices:		return "sine";
+	case Scenario::SamplerVoices:	return "sampler";
+	case Scenario::WavetableVoices: return "wavetable";
+	case Scenario::ScriptnodeChain: return "scriptnode";
+	case Scenario::Convolution:		return "convolution";
+	case Scenario::ScriptOnNoteOn:	return "script";
+	case Scenario::Oversampling1x:	return "oversampling1x";
+	case Scenario::Oversampling2x:	return "oversampling2x";
+	case Scenario::Oversampling4x:	return "oversampling4x";
+	case Scenario::Oversampling8x:	return "oversampling8x";
+	case Scenario::Oversampling16x: return "oversampling16x";
+	case Scenario::SimpleReverb:	return "reverb";
+	case Scenario::FdnReverb:		return "fdnreverb";
+	default:						return {};
+	}
+}
+
+int EngineBenchmark::getOversamplingFactor(Scenario s)
+{
+	switch (s)
+	{
+	case Scenario::Oversampling2x:	return 2;
+	case Scenario::Oversampling4x:	return 4;
+	case Scenario::Oversampling8x:	return 8;
+	case Scenario::Oversampling16x: return 16;
+	default:						return 1;
+	}
+}
+
+EngineBenchmark::Scenario EngineBenchmark::getScenarioFromName(const String& name)
+{
+	for (int i = 0; i < (int)Scenario::numScenarios; i++)
+	{
+		if (getScenarioName((Scenario)i) == name)
+			return (Scenario)i;
+	}
+
+	return Scenario::numScenarios;
+}
+
+Result EngineBenchmark::runAll()
+{
+	for (int i = 0; i < (int)Scenario::numScenarios; i++)
+	{
+		auto r = run((Scenario)i);
+
+		if (r.failed())
+			return r;
+	}
+
+	return Result::ok();
+}
+
+Result EngineBenchmark::run(Scenario s)
+{
+	if (settings.sampleRate <= 0.0 || settings.blockSize <= 0 || settings.numVoices <= 0)
+		return Result::fail("Invalid settings");
+
+	if (settings.numVoices > NUM_POLYPHONIC_VOICES)
+		return Result::fail("The voice amount must not exceed " + String(NUM_POLYPHONIC_VOICES));
+
+	ScopedPointer<BackendProcessor> bp = new BackendProcessor(nullptr, nullptr);
+
+	// The processor isn't initialised before the first prepareToPlay call, so all module
+	// changes (and the script compilation) are executed synchronously here
+	auto r = createScenario(bp, s);
+
+	if (r.failed())
+		return r;
+
+	bp->prepareToPlay(settings.sampleRate, settings.blockSize);
+
+	r = OfflineMidiRenderer::waitUntilReady(bp, settings.blockSize, settings.loadingTimeoutMilliseconds);
+
+	if (r.failed())
+		return r;
+
+	// The convolution calculates the impulse response on a background thread
+	if (s == Scenario::Convolution)
+		Helpers::processSilence(bp, settings.blockSize, 1000);
+
+	Measurement m;
+
+	r = measure(bp, s, m);
+
+	bp = nullptr;
+
+	if (r.failed())
+		return Result::fail(getScenarioName(s) + ": " + r.getErrorMessage());
+
+	measurements.add(m);
+
+	return Result::ok();
+}
+
+Result EngineBenchmark::createScenario(BackendProcessor* bp, Scenario s)
+{
+	switch (s)
+	{
+	case Scenario::SineVoices:
+	{
+		Helpers::addSynth<SineSynth>(bp, "Sine");
+		return Result::ok();
+	}
+	case Scenario::SamplerVoices:
+	{
+		auto sampleFile = tempDirectory.getChildFile("Sample.wav");
+		auto sample = Helpers::createSample(settings.sampleRate);
+
+		auto r = Helpers::writeWavFile(sampleFile, sample, settings.sampleRate);
+
+		if (r.failed())
+			return r;
+
+		auto sampler = Helpers::addSynth<ModulatorSampler>(bp, "Sampler");
+		sampler->getSampleMap()->loadUnsavedValueTree(Helpers::createSampleMap(sampleFile, sample.getNumSamples()));
+
+		if (sampler->getNumSounds() == 0)
+			return Result::fail("Can't load the sample map");
+
+		return Result::ok();
+	}
+	case Scenario::WavetableVoices:
+	{
+		auto wt = Helpers::addSynth<WavetableSynth>(bp, "Wavetable");
+		wt->loadWaveTable(Helpers::createWavetables(settings.sampleRate));
+		return Result::ok();
+	}
+	case Scenario::ScriptnodeChain:
+	{
+		Helpers::addSynth<SineSynth>(bp, "Sine");
+
+		auto fx = new JavascriptMasterEffect(bp, "Network");
+		Helpers::addMasterEffect(bp, fx);
+
+		return Helpers::compile(fx, Helpers::getScriptnodeScript());
+	}
+	case Scenario::Convolution:
+	{
+		Helpers::addSynth<SineSynth>(bp, "Sine");
+
+		auto irFile = tempDirectory.getChildFile("Impulse.wav");
+		auto r = Helpers::writeWavFile(irFile, Helpers::createImpulseResponse(settings.sampleRate), settings.sampleRate);
+
+		if (r.failed())
+			return r;
+
+		auto fx = new ConvolutionEffect(bp, "Convolution");
+		Helpers::addMasterEffect(bp, fx);
+		fx->setLoadedFile(irFile.getFullPathName(), true);
+
+		return Result::ok();
+	}
+	case Scenario::ScriptOnNoteOn:
+	{
+		Helpers::addSynth<SineSynth>(bp, "Sine");
+
+		auto jp = new JavascriptMidiProcessor(bp, "Script");
+		jp->setOwnerSynth(bp->getMainSynthChain());
+
+		auto mpc = dynamic_cast<MidiProcessorChain*>(bp->getMainSynthChain()->getChildProcessor(ModulatorSynth::MidiProcessor));
+		mpc->getHandler()->add(jp, nullptr);
+
+		return Helpers::compile(jp, Helpers::getHeavyNoteOnScript());
+	}
+	case Scenario::Oversampling1x:
+	case Scenario::Oversampling2x:
+	case Scenario::Oversampling4x:
+	case Scenario::Oversampling8x:
+	case Scenario::Oversampling16x:
+	{
+		// The 1x scenario is the reference for the cost of the oversampling filters
+		Helpers::addSynth<SineSynth>(bp, "Sine");
+
+		auto saturator = new SaturatorEffect(bp, "Saturator");
+		Helpers::addMasterEffect(bp, saturator);
+		saturator->setAttribute(SaturatorEffect::Saturation, 0.9f, dontSendNotification);
+		saturator->setOversampling(getOversamplingFactor(s), settings.oversamplingFilter);
+
+		auto dynamics = new DynamicsEffect(bp, "Dynamics");
+		Helpers::addMasterEffect(bp, dynamics);
+		dynamics->setAttribute(DynamicsEffect::CompressorEnabled, 1.0f, dontSendNotification);
+		dynamics->setOversampling(getOversamplingFactor(s), settings.oversamplingFilter);
+
+		return Result::ok();
+	}
+	case Scenario::SimpleReverb:
+	{
+		// The reference for the FDN reverb
+		Helpers::addSynth<SineSynth>(bp, "Sine");
+		Helpers::addMasterEffect(bp, new SimpleReverbEffect(bp, "Reverb"));
+		return Result::ok();
+	}
+	case Scenario::FdnReverb:
+	{
+		Helpers::addSynth<SineSynth>(bp, "Sine");
+		Helpers::addMasterEffect(bp, new FdnReverbEffect(bp, "Reverb"));
+		return Result::ok();
+	}
+	default:
+		return Result::fail("Unknown scenario");
+	}
+}
+
+Result EngineBenchmark::measure(BackendProcessor* bp, Scenario s, Measurement& m)
+{
+	const int blockSize = settings.blockSize;
+	const int numVoices = settings.numVoices;
+
+	const int numWarmupBlocks = jmax(1, roundToInt(settings.warmupSeconds * settings.sampleRate / (double)blockSize));
+	const int numBlocks = jmax(1, roundToInt(settings.secondsToMeasure * settings.sampleRate / (double)blockSize));
+
+	// The script scenario retriggers some voices in every block so that the onNoteOn callback is executed constantly
+	const int numRetriggersPerBlock = s == Scenario::ScriptOnNoteOn ? jmin(8, numVoices) : 0;
+	int retriggerIndex = 0;
+
+	AudioSampleBuffer buffer(2, blockSize);
+	MidiBuffer midi;
+
+	Array<double> blockTimes;
+	blockTimes.ensureStorageAllocated(numBlocks);
+
+	int64 activeVoiceSum = 0;
+
+	const bool useProfiler = settings.traceDirectory.isDirectory();
+	auto& profiler = bp->getPerformanceProfiler();
+
+	for (int i = -numWarmupBlocks; i < numBlocks; i++)
+	{
+		buffer.clear();
+		midi.clear();
+
+		if (i == -numWarmupBlocks)
+		{
+			for (int v = 0; v < numVoices; v++)
+				midi.addEvent(Helpers::getNoteOn(v), 0);
+		}
+		else
+		{
+			for (int r = 0; r < numRetriggersPerBlock; r++)
+			{
+				midi.addEvent(Helpers::getNoteOff(retriggerIndex), 0);
+				midi.addEvent(Helpers::getNoteOn(retriggerIndex), blockSize / 2);
+				retriggerIndex = (retriggerIndex + 1) % numVoices;
+			}
+		}
+
+		// Only count the measured blocks (the note ons of the first warmup block are allowed to allocate)
+		if (i == 0)
+		{
+			AudioThreadInstrumentation::reset();
+
+			if (useProfiler)
+				profiler.startCapture();
+		}
+
+		const auto start = Time::getHighResolutionTicks();
+
+		bp->processBlock(buffer, midi);
+
+		const auto delta = Time::getHighResolutionTicks() - start;
+
+		if (i >= 0)
+		{
+			blockTimes.add(Time::highResolutionTicksToSeconds(delta));
+
+			// The voices are counted outside of the timed section
+			activeVoiceSum += Helpers::getNumActiveVoices(bp);
+		}
+	}
+
+	if (useProfiler)
+	{
+		profiler.stopCapture();
+
+		auto r = profiler.exportChromeTrace(settings.traceDirectory.getChildFile(getScenarioName(s) + ".json"));
+
+		if (r.failed())
+			return r;
+
+		m.profilerSummary = profiler.createSummary(10);
+	}
+
+	m.scenario = s;
+	m.numVoices = numVoices;
+	m.numActiveVoices = (double)activeVoiceSum / (double)numBlocks;
+	m.numBlocks = numBlocks;
+
+	if (m.numActiveVoices <= 0.0)
+		return Result::fail("No voices are playing");
+
+	double sum = 0.0;
+	double maxTime = 0.0;
+
+	for (auto t : blockTimes)
+	{
+		sum += t;
+		maxTime = jmax(maxTime, t);
+	}
+
+	const double mean = sum / (double)numBlocks;
+
+	double variance = 0.0;
+
+	for (auto t : blockTimes)
+		variance += (t - mean) * (t - mean);
+
+	variance /= (double)numBlocks;
+
+	m.nsPerSample = mean * 1.0e9 / (double)blockSize;
+	m.nsPerSamplePerVoice = m.nsPerSample / m.numActiveVoices;
+	m.meanBlockMicroseconds = mean * 1.0e6;
+	m.maxBlockMicroseconds = maxTime * 1.0e6;
+	m.jitterMicroseconds = std::sqrt(variance) * 1.0e6;
+	m.realtimeFactor = mean > 0.0 ? ((double)blockSize / settings.sampleRate) / mean : 0.0;
+
+	if (AudioThreadInstrumentation::isEnabled())
+	{
+		using Op = AudioThreadInstrumentation::OperationType;
+
+		auto c = AudioThreadInstrumentation::getCounters();
+
+		m.allocationsPerBlock = (double)c.get(Op::Allocation) / (double)numBlocks;
+		m.freesPerBlock = (double)c.get(Op::Deallocation) / (double)numBlocks;
+		m.lockWaitsPerBlock = (double)c.get(Op::ContendedLock) / (double)numBlocks;
+
+		if (c.hasViolations())
+		{
+			m.audioThreadReport = AudioThreadInstrumentation::createReport();
+
+			if (settings.failOnAudioThreadViolations)
+				return Result::fail("Illegal operations in the audio callback:\n" + m.audioThreadReport);
+		}
+	}
+	else if (settings.failOnAudioThreadViolations)
+		return Result::fail("The audio thread check needs HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION");
+
+	return Result::ok();
+}
+
+var EngineBenchmark::createReport() const
+{
+	DynamicObject::Ptr system = new DynamicObject();
+
+	system->setProperty("os", SystemStats::getOperatingSystemName());
+	system->setProperty("cpu", SystemStats::getCpuModel());
+	system->setProperty("numCpus", SystemStats::getNumCpus());
+	system->setProperty("hiseVersion", String(HISE_VERSION) + "." + String(BUILD_SUB_VERSION));
+	system->setProperty("audioThreadInstrumentation", AudioThreadInstrumentation::isEnabled());
+
+#if JUCE_DEBUG
+	system->setProperty("build", "Debug");
+#else
+	system->setProperty("build", "Release");
+#endif
+
+	DynamicObject::Ptr s = new DynamicObject();
+
+	s->setProperty("sampleRate", settings.sampleRate);
+	s->setProperty("blockSize", settings.blockSize);
+	s->setProperty("numVoices", settings.numVoices);
+	s->setProperty("secondsToMeasure", settings.secondsToMeasure);
+	s->setProperty("warmupSeconds", settings.warmupSeconds);
+	s->setProperty("oversamplingFilter", EffectOversampler::getFilterTypeNames()[(int)settings.oversamplingFilter]);
+
+	Array<var> list;
+
+	for (const auto& m : measurements)
+		list.add(m.toJSON());
+
+	DynamicObject::Ptr report = new DynamicObject();
+
+	report->setProperty("tag", settings.tag);
+	report->setProperty("date", Time::getCurrentTime().toISO8601(true));
+	report->setProperty("system", var(system.get()));
+	report->setProperty("settings", var(s.get()));
+	report->setProperty("measurements", var(list));
+
+	return var(report.get());
+}
+
+} // namespace hise
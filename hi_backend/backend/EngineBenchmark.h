@@ -0,0 +1,184 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef ENGINEBENCHMARK_H_INCLUDED
+#define ENGINEBENCHMARK_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** Measures the performance of the audio engine with a set of predefined scenarios.
+
+	Every scenario creates a fresh BackendProcessor without an audio device, builds a module tree
+	programmatically (with generated samples and impulse responses so that no external files are needed),
+	starts the given amount of voices and then calls the audio callback in a loop.
+
+	The result contains the CPU time per sample (and per voice), the distribution of the block times
+	(the standard deviation is reported as jitter) and the amount of heap allocations and lock waits per
+	block that were detected by the AudioThreadInstrumentation.
+
+	This is used by the `benchmark` command line action which writes the result as JSON file, so you can
+	compare the numbers between commits.
+*/
+class EngineBenchmark
+{
+public:
+
+	enum class Scenario
+	{
+		SineVoices = 0,
+		SamplerVoices,
+		WavetableVoices,
+		ScriptnodeChain,
+		Convolution,
+		ScriptOnNoteOn,
+		Oversampling1x,
+		Oversampling2x,
+		Oversampling4x,
+		Oversampling8x,
+		Oversampling16x,
+		SimpleReverb,
+		FdnReverb,
+		numScenarios
+	};
+
+	struct Settings
+	{
+		double sampleRate = 44100.0;
+		int blockSize = 512;
+		int numVoices = 64;
+
+		/** The audio time that is measured for each scenario. */
+		double secondsToMeasure = 10.0;
+
+		/** The audio time that is rendered after the voices are started before the measurement begins. */
+		double warmupSeconds = 1.0;
+
+		int loadingTimeoutMilliseconds = 60000;
+
+		/** An arbitrary string that is written to the report (eg. the commit hash). */
+		String tag;
+
+		/** If true, a scenario fails if the audio callback allocates or waits for a lock. 
+		
+			This needs HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION.
+		*/
+		bool failOnAudioThreadViolations = false;
+
+		/** If this is a directory, the PerformanceProfiler captures the measured blocks and writes 
+			a Chrome trace file for each scenario into this directory.
+		*/
+		File traceDirectory;
+
+		/** The filter type that is used by the oversampling scenarios. */
+		EffectOversampler::FilterType oversamplingFilter = EffectOversampler::MinimumPhaseIIR;
+	};
+
+	struct Measurement
+	{
+		var toJSON() const;
+
+		String toString() const;
+
+		Scenario scenario = Scenario::numScenarios;
+		int numVoices = 0;
+
+		/** The average amount of voices that were playing during the measured blocks. */
+		double numActiveVoices = 0.0;
+		int numBlocks = 0;
+
+		double nsPerSample = 0.0;
+
+		/** The time per sample divided by the active voices (not the requested voice amount). */
+		double nsPerSamplePerVoice = 0.0;
+
+		double meanBlockMicroseconds = 0.0;
+		double maxBlockMicroseconds = 0.0;
+
+		/** The standard deviation of the block times. */
+		double jitterMicroseconds = 0.0;
+
+		double realtimeFactor = 0.0;
+
+		/** These are -1 if HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION is disabled. */
+		double allocationsPerBlock = -1.0;
+		double freesPerBlock = -1.0;
+		double lockWaitsPerBlock = -1.0;
+
+		/** The call stacks of the allocations and lock waits (if there were any). */
+		String audioThreadReport;
+
+		/** The most expensive processors, nodes and callbacks (if the trace directory was set). */
+		String profilerSummary;
+	};
+
+	EngineBenchmark(const Settings& settings_);
+
+	~EngineBenchmark();
+
+	/** Builds the scenario, runs the measurement and adds the result to the list. */
+	Result run(Scenario s);
+
+	/** Runs all scenarios. It stops at the first one that fails. */
+	Result runAll();
+
+	const Array<Measurement>& getMeasurements() const noexcept { return measurements; }
+
+	/** Creates a JSON object with the system info, the settings and all measurements. */
+	var createReport() const;
+
+	static String getScenarioName(Scenario s);
+
+	/** Returns the oversampling factor of the oversampling scenarios (or 1 for every other scenario). */
+	static int getOversamplingFactor(Scenario s);
+
+	/** Returns Scenario::numScenarios if the name doesn't match. */
+	static Scenario getScenarioFromName(const String& name);
+
+private:
+
+	struct Helpers;
+
+	Result createScenario(BackendProcessor* bp, Scenario s);
+
+	Result measure(BackendProcessor* bp, Scenario s, Measurement& m);
+
+	Settings settings;
+	File tempDirectory;
+
+	Array<Measurement> measurements;
+
+	JUCE_DECLARE_NON_COPYABLE(EngineBenchmark);
+};
+
+} // namespace hise
+
+#endif  // ENGINEBENCHMARK_H_INCLUDED
@@ -0,0 +1,225 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+namespace hise { using namespace juce;
+
+String OfflineMidiRenderer::Statistics::toString() const
+{
+	String s;
+
+	s << "Rendered " << String(renderedSeconds, 2) << " seconds (" << String(numBlocks) << " blocks) in ";
+	s << String(elapsedSeconds, 2) << " seconds. Realtime factor: " << String(getRealtimeFactor(), 2) << "x";
+
+	return s;
+}
+
+OfflineMidiRenderer::OfflineMidiRenderer(const Settings& settings_) :
+	settings(settings_)
+{
+	// This makes the preset loading synchronous and prevents the audio driver from being opened
+	CompileExporter::setExportingFromCommandLine();
+}
+
+OfflineMidiRenderer::~OfflineMidiRenderer()
+{
+	processor = nullptr;
+}
+
+Result OfflineMidiRenderer::render()
+{
+	if (!settings.presetFile.existsAsFile())
+		return Result::fail("Can't find preset file " + settings.presetFile.getFullPathName());
+
+	if (settings.sampleRate <= 0.0 || settings.blockSize <= 0)
+		return Result::fail("Invalid sample rate or block size");
+
+	MidiMessageSequence sequence;
+
+	auto r = loadMidiFile(settings.midiFile, settings.sampleRate, sequence);
+
+	if (r.failed())
+		return r;
+
+	processor = new BackendProcessor(nullptr, nullptr);
+
+	auto projectDirectory = settings.presetFile.getParentDirectory().getParentDirectory();
+	auto& projectHandler = GET_PROJECT_HANDLER(processor->getMainSynthChain());
+
+	if (projectHandler.getWorkDirectory() != projectDirectory)
+		projectHandler.setWorkingProject(projectDirectory);
+
+	processor->prepareToPlay(settings.sampleRate, settings.blockSize);
+	processor->setNonRealtime(true);
+
+	if (settings.presetFile.getFileExtension() == ".hip")
+		processor->loadPresetFromFile(settings.presetFile, nullptr);
+	else
+		return Result::fail("The preset must be a .hip file");
+
+	r = waitUntilReady(processor, settings.blockSize, settings.loadingTimeoutMilliseconds);
+
+	if (r.failed())
+		return r;
+
+	settings.outputFile.deleteFile();
+
+	ScopedPointer<FileOutputStream> fos = new FileOutputStream(settings.outputFile);
+
+	if (fos->failedToOpen())
+		return Result::fail("Can't write to " + settings.outputFile.getFullPathName());
+
+	WavAudioFormat wav;
+	ScopedPointer<AudioFormatWriter> writer = wav.createWriterFor(fos, settings.sampleRate, 2, settings.bitDepth, {}, 0);
+
+	if (writer == nullptr)
+		return Result::fail("Can't create the WAV writer");
+
+	// the writer owns the stream now
+	fos.release();
+
+	return renderSequence(processor, sequence, *writer, settings, statistics);
+}
+
+Result OfflineMidiRenderer::loadMidiFile(const File& f, double sampleRate, MidiMessageSequence& sequence)
+{
+	FileInputStream fis(f);
+
+	if (fis.failedToOpen())
+		return Result::fail("Can't open MIDI file " + f.getFullPathName());
+
+	MidiFile midiFile;
+
+	if (!midiFile.readFrom(fis))
+		return Result::fail("Can't parse MIDI file " + f.getFullPathName());
+
+	midiFile.convertTimestampTicksToSeconds();
+
+	sequence.clear();
+
+	for (int i = 0; i < midiFile.getNumTracks(); i++)
+	{
+		auto track = midiFile.getTrack(i);
+
+		for (int j = 0; j < track->getNumEvents(); j++)
+		{
+			auto m = track->getEventPointer(j)->message;
+
+			if (m.isMetaEvent() || m.isSysEx())
+				continue;
+
+			m.setTimeStamp(std::round(m.getTimeStamp() * sampleRate));
+			sequence.addEvent(m);
+		}
+	}
+
+	sequence.sort();
+	sequence.updateMatchedPairs();
+
+	return Result::ok();
+}
+
+Result OfflineMidiRenderer::waitUntilReady(BackendProcessor* bp, int blockSize, int timeoutMilliseconds)
+{
+	AudioSampleBuffer silence(2, blockSize);
+	MidiBuffer emptyMidi;
+
+	auto& killState = bp->getKillStateHandler();
+	auto& sampleManager = bp->getSampleManager();
+
+	const auto start = Time::getMillisecondCounter();
+	int numReadyBlocks = 0;
+
+	// The audio callback drives the suspension of the kill state handler, so we need to keep calling it
+	// until the loading thread has finished and the processor has resumed for a few blocks
+	while (numReadyBlocks < 8)
+	{
+		if ((int)(Time::getMillisecondCounter() - start) > timeoutMilliseconds)
+			return Result::fail("Timeout while loading the preset");
+
+		silence.clear();
+		emptyMidi.clear();
+		bp->processBlock(silence, emptyMidi);
+
+		const bool ready = killState.isAudioRunning() &&
+						   !sampleManager.isPreloading() &&
+						   !sampleManager.hasPendingFunction(bp->getMainSynthChain());
+
+		numReadyBlocks = ready ? numReadyBlocks + 1 : 0;
+
+		if (!ready)
+			Thread::sleep(5);
+	}
+
+	return Result::ok();
+}
+
+Result OfflineMidiRenderer::renderSequence(BackendProcessor* bp, const MidiMessageSequence& sequence, AudioFormatWriter& writer, const Settings& settings, Statistics& statistics)
+{
+	MidiBuffer allEvents;
+
+	for (auto e : sequence)
+		allEvents.addEvent(e->message, (int)e->message.getTimeStamp());
+
+	const int numTailSamples = roundToInt(settings.tailSeconds * settings.sampleRate);
+	const int numTotal = roundToInt(sequence.getEndTime()) + numTailSamples;
+
+	AudioSampleBuffer buffer(2, settings.blockSize);
+
+	statistics = {};
+
+	const auto start = Time::getHighResolutionTicks();
+
+	for (int offset = 0; offset < numTotal; offset += settings.blockSize)
+	{
+		const int numThisTime = jmin(settings.blockSize, numTotal - offset);
+
+		AudioSampleBuffer subAudio(buffer.getArrayOfWritePointers(), 2, numThisTime);
+		subAudio.clear();
+
+		MidiBuffer subMidi;
+		subMidi.addEvents(allEvents, offset, numThisTime, -offset);
+
+		bp->processBlock(subAudio, subMidi);
+
+		if (!writer.writeFromAudioSampleBuffer(subAudio, 0, numThisTime))
+			return Result::fail("Error while writing the audio file");
+
+		statistics.numBlocks++;
+	}
+
+	statistics.elapsedSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+	statistics.renderedSeconds = (double)numTotal / settings.sampleRate;
+
+	return Result::ok();
+}
+
+} // namespace hise
@@ -0,0 +1,115 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef OFFLINERENDERER_H_INCLUDED
+#define OFFLINERENDERER_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** Renders a MIDI file through a preset without an audio device as fast as possible.
+
+	It loads the preset synchronously, switches the sample streaming into non-realtime mode
+	(so that the voices wait for the disk instead of dropping out) and feeds the MIDI file
+	block by block through the regular audio callback. The result is written to a WAV file.
+
+	This is used by the `render` command line action, but you can also use renderSequence()
+	with an already initialised processor (eg. for performance regression tests).
+*/
+class OfflineMidiRenderer
+{
+public:
+
+	struct Settings
+	{
+		File presetFile;
+		File midiFile;
+		File outputFile;
+
+		double sampleRate = 44100.0;
+		int blockSize = 512;
+		int bitDepth = 24;
+
+		/** The time that is rendered after the last MIDI event. */
+		double tailSeconds = 2.0;
+
+		/** The maximum time to wait for the preset and its samples to load. */
+		int loadingTimeoutMilliseconds = 120000;
+	};
+
+	struct Statistics
+	{
+		double renderedSeconds = 0.0;
+		double elapsedSeconds = 0.0;
+		int numBlocks = 0;
+
+		/** Returns how many times faster than realtime the rendering was. */
+		double getRealtimeFactor() const noexcept
+		{
+			return elapsedSeconds > 0.0 ? renderedSeconds / elapsedSeconds : 0.0;
+		}
+
+		String toString() const;
+	};
+
+	OfflineMidiRenderer(const Settings& settings_);
+
+	~OfflineMidiRenderer();
+
+	/** Loads the preset, renders the MIDI file and writes the WAV file. */
+	Result render();
+
+	const Statistics& getStatistics() const noexcept { return statistics; }
+
+	/** Reads all tracks of the MIDI file into one sequence with sample timestamps. */
+	static Result loadMidiFile(const File& f, double sampleRate, MidiMessageSequence& sequence);
+
+	/** Processes silent blocks until the processor is not suspended anymore and all samples are loaded. */
+	static Result waitUntilReady(BackendProcessor* bp, int blockSize, int timeoutMilliseconds);
+
+	/** Renders the sequence (with sample timestamps) using the given processor and writes the output to the writer. 
+	
+		The processor must be prepared with the sample rate and block size of the settings. */
+	static Result renderSequence(BackendProcessor* bp, const MidiMessageSequence& sequence, AudioFormatWriter& writer, const Settings& settings, Statistics& statistics);
+
+private:
+
+	Settings settings;
+	Statistics statistics;
+
+	ScopedPointer<BackendProcessor> processor;
+
+	JUCE_DECLARE_NON_COPYABLE(OfflineMidiRenderer);
+};
+
+} // namespace hise
+
+#endif  // OFFLINERENDERER_H_INCLUDED
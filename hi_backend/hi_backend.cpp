@@ -66,6 +66,8 @@
 
 #include "backend/CompileExporter.cpp"
 #include "backend/HisePlayerExporter.cpp"
+#include "backend/OfflineRenderer.cpp"
+#include "backend/EngineBenchmark.cpp"
 
 #include "backend/doc_generators/ApiMarkdownGenerator.cpp"
 #include "backend/doc_generators/ModuleDocGenerator.cpp"
@@ -68,6 +68,8 @@ END_JUCE_MODULE_DECLARATION
 #include "backend/BackendRootWindow.h"
 #include "backend/CompileExporter.h"
 #include "backend/HisePlayerExporter.h"
+#include "backend/OfflineRenderer.h"
+#include "backend/EngineBenchmark.h"
 
 #include "backend/debug_components/SamplePoolTable.h"
 #include "backend/debug_components/MacroEditTable.h"
@@ -37,8 +37,9 @@ FFTConvolver::FFTConvolver(audiofft::ImplementationType fftType) :
   _segCount(0),
   _fftComplexSize(0),
   _segments(),
-  _segmentsIR(),
+  _ir(),
   _fftBuffer(),
+  _fftType(fftType),
   _fft(fftType),
   _preMultiplied(),
   _conv(),
@@ -61,7 +62,6 @@ void FFTConvolver::reset()
   for (size_t i=0; i<_segCount; ++i)
   {
     delete _segments[i];
-    delete _segmentsIR[i];
   }
   
   _blockSize = 0;
@@ -69,7 +69,7 @@ void FFTConvolver::reset()
   _segCount = 0;
   _fftComplexSize = 0;
   _segments.clear();
-  _segmentsIR.clear();
+  _ir = nullptr;
   _fftBuffer.clear();
   _fft.init(0);
   _preMultiplied.clear();
@@ -96,15 +96,37 @@ void FFTConvolver::resetInput()
 
 }
 
-bool FFTConvolver::init(size_t blockSize, const Sample* ir, size_t irLen)
+FFTConvolver::PreparedIR::~PreparedIR()
 {
-  reset();
+  for (auto s : segments)
+  {
+    delete s;
+  }
+}
+
+
+size_t FFTConvolver::PreparedIR::getMemoryUsage() const
+{
+  return segments.size() * 2 * fftComplexSize * sizeof(Sample);
+}
+
+
+size_t FFTConvolver::getIRMemoryUsage() const
+{
+  return _ir != nullptr ? _ir->getMemoryUsage() : 0;
+}
 
+
+FFTConvolver::PreparedIRPtr FFTConvolver::prepare(audiofft::ImplementationType fftType, size_t blockSize, const Sample* ir, size_t irLen)
+{
   if (blockSize == 0)
   {
-    return false;
+    return nullptr;
   }
-  
+
+  auto p = std::make_shared<PreparedIR>();
+  p->blockSize = NextPowerOf2(blockSize);
+
   // Ignore zeros at the end of the impulse response because they only waste computation time
   while (irLen > 0 && ::fabs(ir[irLen-1]) < 0.000001f)
   {
@@ -113,13 +135,57 @@ bool FFTConvolver::init(size_t blockSize, const Sample* ir, size_t irLen)
 
   if (irLen == 0)
   {
-    return true;
+    return p;
+  }
+
+  const size_t segSize = 2 * p->blockSize;
+  const size_t segCount = static_cast<size_t>(::ceil(static_cast<float>(irLen) / static_cast<float>(p->blockSize)));
+  p->fftComplexSize = audiofft::AudioFFT::ComplexSize(segSize);
+
+  audiofft::AudioFFT fft(fftType);
+  fft.init(segSize);
+
+  SampleBuffer fftBuffer(segSize);
+
+  for (size_t i=0; i<segCount; ++i)
+  {
+    SplitComplex* segment = new SplitComplex(p->fftComplexSize);
+    const size_t remaining = irLen - (i * p->blockSize);
+    const size_t sizeCopy = (remaining >= p->blockSize) ? p->blockSize : remaining;
+    CopyAndPad(fftBuffer, &ir[i*p->blockSize], sizeCopy);
+    fft.fft(fftBuffer.data(), segment->re(), segment->im());
+    p->segments.push_back(segment);
+  }
+
+  return p;
+}
+
+
+bool FFTConvolver::init(size_t blockSize, const Sample* ir, size_t irLen)
+{
+  return init(prepare(_fftType, blockSize, ir, irLen));
+}
+
+
+bool FFTConvolver::init(PreparedIRPtr preparedIR)
+{
+  reset();
+
+  if (preparedIR == nullptr)
+  {
+    return false;
   }
   
-  _blockSize = NextPowerOf2(blockSize);
+  if (preparedIR->segments.empty())
+  {
+    return true;
+  }
+
+  _ir = preparedIR;
+  _blockSize = _ir->blockSize;
   _segSize = 2 * _blockSize;
-  _segCount = static_cast<size_t>(::ceil(static_cast<float>(irLen) / static_cast<float>(_blockSize)));
-  _fftComplexSize = audiofft::AudioFFT::ComplexSize(_segSize);
+  _segCount = _ir->segments.size();
+  _fftComplexSize = _ir->fftComplexSize;
   
   // FFT
   _fft.init(_segSize);
@@ -131,17 +197,6 @@ bool FFTConvolver::init(size_t blockSize, const Sample* ir, size_t irLen)
     _segments.push_back(new SplitComplex(_fftComplexSize));    
   }
   
-  // Prepare IR
-  for (size_t i=0; i<_segCount; ++i)
-  {
-    SplitComplex* segment = new SplitComplex(_fftComplexSize);
-    const size_t remaining = irLen - (i * _blockSize);
-    const size_t sizeCopy = (remaining >= _blockSize) ? _blockSize : remaining;
-    CopyAndPad(_fftBuffer, &ir[i*_blockSize], sizeCopy);
-    _fft.fft(_fftBuffer.data(), segment->re(), segment->im());
-    _segmentsIR.push_back(segment);
-  }
-  
   // Prepare convolution buffers  
   _preMultiplied.resize(_fftComplexSize);
   _conv.resize(_fftComplexSize);
@@ -166,6 +221,8 @@ void FFTConvolver::process(const Sample* input, Sample* output, size_t len)
     return;
   }
 
+  const std::vector<SplitComplex*>& segmentsIR = _ir->segments;
+
   size_t processed = 0;
   while (processed < len)
   {
@@ -186,11 +243,11 @@ void FFTConvolver::process(const Sample* input, Sample* output, size_t len)
       {
         const size_t indexIr = i;
         const size_t indexAudio = (_current + i) % _segCount;
-        ComplexMultiplyAccumulate(_preMultiplied, *_segmentsIR[indexIr], *_segments[indexAudio]);
+        ComplexMultiplyAccumulate(_preMultiplied, *segmentsIR[indexIr], *_segments[indexAudio]);
       }
     }
     _conv.copyFrom(_preMultiplied);
-    ComplexMultiplyAccumulate(_conv, *_segments[_current], *_segmentsIR[0]);
+    ComplexMultiplyAccumulate(_conv, *_segments[_current], *segmentsIR[0]);
 
     // Backward FFT
     _fft.ifft(_fftBuffer.data(), _conv.re(), _conv.im());
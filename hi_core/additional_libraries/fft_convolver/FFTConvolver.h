@@ -25,6 +25,7 @@
 #include "AudioFFT.h"
 #include "Utilities.h"
 
+#include <memory>
 #include <vector>
 
 
@@ -55,6 +56,40 @@ class FFTConvolver
 public:
   FFTConvolver(audiofft::ImplementationType fftType);  
   virtual ~FFTConvolver();
+
+  /**
+  * @brief The frequency domain segments of an impulse response for one block size
+  *
+  * It contains no rendering state, so it can be shared between multiple convolvers.
+  */
+  struct PreparedIR
+  {
+    PreparedIR() = default;
+    PreparedIR(const PreparedIR&) = delete;
+    PreparedIR& operator=(const PreparedIR&) = delete;
+    ~PreparedIR();
+
+    /**
+    * @brief Returns the amount of bytes used by the segments
+    */
+    size_t getMemoryUsage() const;
+
+    size_t blockSize = 0;
+    size_t fftComplexSize = 0;
+    std::vector<SplitComplex*> segments;
+  };
+
+  using PreparedIRPtr = std::shared_ptr<const PreparedIR>;
+
+  /**
+  * @brief Transforms the impulse response into the frequency domain segments that are used by init()
+  * @param fftType The FFT implementation (must match the one of the convolver)
+  * @param blockSize Block size internally used by the convolver (partition size)
+  * @param ir The impulse response
+  * @param irLen Length of the impulse response
+  * @return The prepared impulse response or nullptr if the block size is invalid
+  */
+  static PreparedIRPtr prepare(audiofft::ImplementationType fftType, size_t blockSize, const Sample* ir, size_t irLen);
   
   /**
   * @brief Initializes the convolver
@@ -65,6 +100,13 @@ public:
   */
   bool init(size_t blockSize, const Sample* ir, size_t irLen);
 
+  /**
+  * @brief Initializes the convolver with an impulse response that was created with prepare()
+  * @param preparedIR The prepared impulse response (it will be shared, not copied)
+  * @return true: Success - false: Failed
+  */
+  bool init(PreparedIRPtr preparedIR);
+
   /**
   * @brief Convolves the the given input samples and immediately outputs the result
   * @param input The input samples
@@ -80,14 +122,20 @@ public:
   
   void resetInput();
 
+  /**
+  * @brief Returns the amount of bytes used by the frequency domain segments of the impulse response
+  */
+  size_t getIRMemoryUsage() const;
+
 private:
   size_t _blockSize;
   size_t _segSize;
   size_t _segCount;
   size_t _fftComplexSize;
   std::vector<SplitComplex*> _segments;
-  std::vector<SplitComplex*> _segmentsIR;
+  PreparedIRPtr _ir;
   SampleBuffer _fftBuffer;
+  audiofft::ImplementationType _fftType;
   audiofft::AudioFFT _fft;
   SplitComplex _preMultiplied;
   SplitComplex _conv;
@@ -29,6 +29,7 @@ namespace fftconvolver
 {
 
 TwoStageFFTConvolver::TwoStageFFTConvolver(audiofft::ImplementationType fftType) :
+  _fftType(fftType),
   _headBlockSize(0),
   _tailBlockSize(0),
   _headConvolver(fftType),
@@ -41,7 +42,11 @@ TwoStageFFTConvolver::TwoStageFFTConvolver(audiofft::ImplementationType fftType)
   _tailInput(),
   _tailInputFill(0),
   _precalculatedPos(0),
-  _backgroundProcessingInput()
+  _backgroundProcessingInput(),
+  _skippedTailInput(),
+  _backgroundSkippedInput(),
+  _tailLate(false),
+  _renderSkippedTailInput(false)
 {
 }
 
@@ -68,6 +73,10 @@ void TwoStageFFTConvolver::reset()
   _tailInputFill = 0;
   _precalculatedPos = 0;
   _backgroundProcessingInput.clear();
+  _skippedTailInput.clear();
+  _backgroundSkippedInput.clear();
+  _tailLate = false;
+  _renderSkippedTailInput = false;
 }
 
   
@@ -79,6 +88,10 @@ void TwoStageFFTConvolver::cleanPipeline()
 	_tailPrecalculated.setZero();
 	_tailPrecalculated0.setZero();
 	_backgroundProcessingInput.setZero();
+	_skippedTailInput.setZero();
+	_backgroundSkippedInput.setZero();
+	_tailLate = false;
+	_renderSkippedTailInput = false;
 	_tailInputFill = 0;
 	_precalculatedPos = 0;
 	
@@ -87,16 +100,36 @@ void TwoStageFFTConvolver::cleanPipeline()
 	_headConvolver.resetInput();
 }
 
-bool TwoStageFFTConvolver::init(size_t headBlockSize,
-                                size_t tailBlockSize,
-                                const Sample* ir,
-                                size_t irLen)
+size_t TwoStageFFTConvolver::getIRMemoryUsage() const
 {
-  reset();
+  return _headConvolver.getIRMemoryUsage() + _tailConvolver0.getIRMemoryUsage() + _tailConvolver.getIRMemoryUsage();
+}
+
+size_t TwoStageFFTConvolver::PreparedIR::getMemoryUsage() const
+{
+  size_t numBytes = 0;
+
+  for (auto& p : { head, tail0, tail })
+  {
+    if (p != nullptr)
+    {
+      numBytes += p->getMemoryUsage();
+    }
+  }
+
+  return numBytes;
+}
 
+
+TwoStageFFTConvolver::PreparedIRPtr TwoStageFFTConvolver::prepare(audiofft::ImplementationType fftType,
+                                                                  size_t headBlockSize,
+                                                                  size_t tailBlockSize,
+                                                                  const Sample* ir,
+                                                                  size_t irLen)
+{
   if (headBlockSize == 0 || tailBlockSize == 0)
   {
-    return false;
+    return nullptr;
   }
   
   headBlockSize = std::max(size_t(1), headBlockSize);
@@ -105,6 +138,8 @@ bool TwoStageFFTConvolver::init(size_t headBlockSize,
     assert(false);
     std::swap(headBlockSize, tailBlockSize);
   }
+
+  auto p = std::make_shared<PreparedIR>();
   
   // Ignore zeros at the end of the impulse response because they only waste computation time
   while (irLen > 0 && ::fabs(ir[irLen-1]) < 0.000001f)
@@ -113,31 +148,75 @@ bool TwoStageFFTConvolver::init(size_t headBlockSize,
   }
 
   if (irLen == 0)
+  {
+    return p;
+  }
+  
+  p->headBlockSize = NextPowerOf2(headBlockSize);
+  p->tailBlockSize = NextPowerOf2(tailBlockSize);
+
+  const size_t headIrLen = std::min(irLen, p->tailBlockSize);
+  p->head = FFTConvolver::prepare(fftType, p->headBlockSize, ir, headIrLen);
+
+  if (irLen > p->tailBlockSize)
+  {
+    const size_t conv1IrLen = std::min(irLen-p->tailBlockSize, p->tailBlockSize);
+    p->tail0 = FFTConvolver::prepare(fftType, p->headBlockSize, ir+p->tailBlockSize, conv1IrLen);
+  }
+
+  if (irLen > 2 * p->tailBlockSize)
+  {
+    const size_t tailIrLen = irLen - (2*p->tailBlockSize);
+    p->tail = FFTConvolver::prepare(fftType, p->tailBlockSize, ir+(2*p->tailBlockSize), tailIrLen);
+  }
+
+  return p;
+}
+
+
+bool TwoStageFFTConvolver::init(size_t headBlockSize,
+                                size_t tailBlockSize,
+                                const Sample* ir,
+                                size_t irLen)
+{
+  return TwoStageFFTConvolver::init(prepare(_fftType, headBlockSize, tailBlockSize, ir, irLen));
+}
+
+
+bool TwoStageFFTConvolver::init(PreparedIRPtr preparedIR)
+{
+  reset();
+
+  if (preparedIR == nullptr)
+  {
+    return false;
+  }
+
+  if (preparedIR->head == nullptr)
   {
     return true;
   }
   
-  _headBlockSize = NextPowerOf2(headBlockSize);
-  _tailBlockSize = NextPowerOf2(tailBlockSize);
+  _headBlockSize = preparedIR->headBlockSize;
+  _tailBlockSize = preparedIR->tailBlockSize;
 
-  const size_t headIrLen = std::min(irLen, _tailBlockSize);
-  _headConvolver.init(_headBlockSize, ir, headIrLen);
+  _headConvolver.init(preparedIR->head);
 
-  if (irLen > _tailBlockSize)
+  if (preparedIR->tail0 != nullptr)
   {
-    const size_t conv1IrLen = std::min(irLen-_tailBlockSize, _tailBlockSize);
-    _tailConvolver0.init(_headBlockSize, ir+_tailBlockSize, conv1IrLen);
+    _tailConvolver0.init(preparedIR->tail0);
     _tailOutput0.resize(_tailBlockSize);
     _tailPrecalculated0.resize(_tailBlockSize);
   }
 
-  if (irLen > 2 * _tailBlockSize)
+  if (preparedIR->tail != nullptr)
   {
-    const size_t tailIrLen = irLen - (2*_tailBlockSize);
-    _tailConvolver.init(_tailBlockSize, ir+(2*_tailBlockSize), tailIrLen);
+    _tailConvolver.init(preparedIR->tail);
     _tailOutput.resize(_tailBlockSize);
     _tailPrecalculated.resize(_tailBlockSize);
     _backgroundProcessingInput.resize(_tailBlockSize);
+    _skippedTailInput.resize(_tailBlockSize);
+    _backgroundSkippedInput.resize(_tailBlockSize);
   }
 
   if (_tailPrecalculated0.size() > 0 || _tailPrecalculated.size() > 0)
@@ -218,10 +297,34 @@ void TwoStageFFTConvolver::process(const Sample* input, Sample* output, size_t l
           _backgroundProcessingInput.size() == _tailBlockSize &&
           _tailOutput.size() == _tailBlockSize)
       {
-        waitForBackgroundProcessing();
-        SampleBuffer::Swap(_tailPrecalculated, _tailOutput);
-        _backgroundProcessingInput.copyFrom(_tailInput);
-        startBackgroundProcessing();
+        if (!waitForBackgroundProcessing())
+        {
+          // The background processing is late, so this tail block is silent. The input is rendered
+          // with the next job so that it isn't missing in the tail history (if the job is late for 
+          // more than one block, only the last input block is kept).
+          _tailLate = true;
+          _tailPrecalculated.setZero();
+          _skippedTailInput.copyFrom(_tailInput);
+        }
+        else
+        {
+          if (_tailLate)
+          {
+            // The late result belongs to a block that was already played silent, so it's thrown away
+            _tailLate = false;
+            _tailPrecalculated.setZero();
+            _backgroundSkippedInput.copyFrom(_skippedTailInput);
+            _renderSkippedTailInput = true;
+          }
+          else
+          {
+            SampleBuffer::Swap(_tailPrecalculated, _tailOutput);
+            _renderSkippedTailInput = false;
+          }
+
+          _backgroundProcessingInput.copyFrom(_tailInput);
+          startBackgroundProcessing();
+        }
       }
         
       if (_tailInputFill == _tailBlockSize)
@@ -242,13 +345,18 @@ void TwoStageFFTConvolver::startBackgroundProcessing()
 }
 
 
-void TwoStageFFTConvolver::waitForBackgroundProcessing()
+bool TwoStageFFTConvolver::waitForBackgroundProcessing()
 {
+  return true;
 }
 
 
 void TwoStageFFTConvolver::doBackgroundProcessing()
 {
+  // The output of the skipped block is too late to be played, it only updates the history of the convolver
+  if (_renderSkippedTailInput)
+    _tailConvolver.process(_backgroundSkippedInput.data(), _tailOutput.data(), _tailBlockSize);
+
   _tailConvolver.process(_backgroundProcessingInput.data(), _tailOutput.data(), _tailBlockSize);
 }
     
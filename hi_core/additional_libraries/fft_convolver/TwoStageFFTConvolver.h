@@ -57,6 +57,38 @@ class TwoStageFFTConvolver
 public:
   TwoStageFFTConvolver(audiofft::ImplementationType fftType);  
   virtual ~TwoStageFFTConvolver();
+
+  /**
+  * @brief The frequency domain segments of the head and the tail convolvers
+  *
+  * It contains no rendering state, so it can be shared between multiple convolvers.
+  */
+  struct PreparedIR
+  {
+    /**
+    * @brief Returns the amount of bytes used by the segments
+    */
+    size_t getMemoryUsage() const;
+
+    size_t headBlockSize = 0;
+    size_t tailBlockSize = 0;
+    FFTConvolver::PreparedIRPtr head;
+    FFTConvolver::PreparedIRPtr tail0;
+    FFTConvolver::PreparedIRPtr tail;
+  };
+
+  using PreparedIRPtr = std::shared_ptr<const PreparedIR>;
+
+  /**
+  * @brief Transforms the impulse response into the frequency domain segments that are used by init()
+  * @param fftType The FFT implementation (must match the one of the convolver)
+  * @param headBlockSize The head block size
+  * @param tailBlockSize the tail block size
+  * @param ir The impulse response
+  * @param irLen Length of the impulse response in samples
+  * @return The prepared impulse response or nullptr if the block sizes are invalid
+  */
+  static PreparedIRPtr prepare(audiofft::ImplementationType fftType, size_t headBlockSize, size_t tailBlockSize, const Sample* ir, size_t irLen);
   
   /**
   * @brief Initialization the convolver
@@ -66,7 +98,14 @@ public:
   * @param irLen Length of the impulse response in samples
   * @return true: Success - false: Failed
   */
-  bool init(size_t headBlockSize, size_t tailBlockSize, const Sample* ir, size_t irLen);
+  virtual bool init(size_t headBlockSize, size_t tailBlockSize, const Sample* ir, size_t irLen);
+
+  /**
+  * @brief Initializes the convolver with an impulse response that was created with prepare()
+  * @param preparedIR The prepared impulse response (it will be shared, not copied)
+  * @return true: Success - false: Failed
+  */
+  virtual bool init(PreparedIRPtr preparedIR);
 
   /**
   * @brief Convolves the the given input samples and immediately outputs the result
@@ -74,15 +113,20 @@ public:
   * @param output The convolution result
   * @param len Number of input/output samples
   */
-  void process(const Sample* input, Sample* output, size_t len);
+  virtual void process(const Sample* input, Sample* output, size_t len);
 
   /**
   * @brief Resets the convolver and discards the set impulse response
   */
-  void reset();
+  virtual void reset();
   
   /** Clears the internal buffers so that it resets the convolution pipeline. */
-  void cleanPipeline();
+  virtual void cleanPipeline();
+
+  /**
+  * @brief Returns the amount of bytes used by the frequency domain segments of the impulse response
+  */
+  virtual size_t getIRMemoryUsage() const;
 
 protected:
   /**
@@ -98,16 +142,25 @@ protected:
   /**
   * @brief Called by the convolver if it expects the result of its previous call to startBackgroundProcessing()
   *
-  * After returning from this method, all background processing has to be completed.
+  * After returning true from this method, all background processing has to be completed.
+  * Return false if the work is not finished in time: the convolver will then play this tail 
+  * block silent and call this method again before it starts the next one. The result of the
+  * late job is thrown away and the skipped input is rendered along with the next job.
   */
-  virtual void waitForBackgroundProcessing();
+  virtual bool waitForBackgroundProcessing();
 
   /**
   * @brief Actually performs the background processing work
   */
   void doBackgroundProcessing();
 
+  /**
+  * @brief Returns the tail block size (the amount of samples between two background processing calls)
+  */
+  size_t getTailBlockSize() const { return _tailBlockSize; }
+
 private:
+  audiofft::ImplementationType _fftType;
   size_t _headBlockSize;
   size_t _tailBlockSize;
   FFTConvolver _headConvolver;
@@ -121,6 +174,10 @@ private:
   size_t _tailInputFill;
   size_t _precalculatedPos;
   SampleBuffer _backgroundProcessingInput;
+  SampleBuffer _skippedTailInput;
+  SampleBuffer _backgroundSkippedInput;
+  bool _tailLate;
+  bool _renderSkippedTailInput;
 
   // Prevent uncontrolled usage
   TwoStageFFTConvolver(const TwoStageFFTConvolver&);
@@ -200,6 +200,24 @@ Enable this to add a glitch detector to some performance crititcal functions
 #define USE_GLITCH_DETECTION 0
 #endif
 
+/** Config: HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION
+
+Enable this to count and record the call stacks of all heap allocations, frees and lock acquisitions in the audio callback.
+This replaces the global operator new / delete, so only use it for debugging and benchmark builds (see AudioThreadInstrumentation).
+*/
+#ifndef HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION
+#define HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION 0
+#endif
+
+/** Config: HISE_ENABLE_PROFILER
+
+Set this to 0 to remove the PerformanceProfiler scopes from the audio rendering code. 
+If enabled, the scopes only cost an atomic load until you start a capture.
+*/
+#ifndef HISE_ENABLE_PROFILER
+#define HISE_ENABLE_PROFILER 1
+#endif
+
 /** Config: ENABLE_PLOTTER
 
 Set this to 0 to deactivate the plotter data collection
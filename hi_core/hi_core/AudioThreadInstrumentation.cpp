@@ -0,0 +1,336 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#if HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION
+
+void* operator new(std::size_t size)
+{
+	hise::AudioThreadInstrumentation::record(hise::AudioThreadInstrumentation::OperationType::Allocation);
+
+	if (auto p = std::malloc(size == 0 ? 1 : size))
+		return p;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	if (p != nullptr)
+		hise::AudioThreadInstrumentation::record(hise::AudioThreadInstrumentation::OperationType::Deallocation);
+
+	std::free(p);
+}
+
+#endif
+
+namespace hise {
+using namespace juce;
+
+#if HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION
+
+namespace InstrumentationData
+{
+	// These are all zero-initialised PODs (or atomics with a constexpr constructor), so they are
+	// safe to use before the static initialisation (operator new might be called at any time)
+
+	struct CallStack
+	{
+		std::atomic<uint32> hash;
+		std::atomic<bool> ready;
+		std::atomic<int64> count;
+
+		AudioThreadInstrumentation::OperationType type;
+		int numFrames;
+		void* frames[AudioThreadInstrumentation::MaxNumFrames];
+	};
+
+	static std::atomic<int64> counters[(int)AudioThreadInstrumentation::OperationType::numOperationTypes];
+	static std::atomic<int64> numCallbacks;
+	static std::atomic<int64> numDroppedCallStacks;
+
+	static CallStack callStacks[AudioThreadInstrumentation::NumCallStacks];
+
+	static thread_local int audioThreadDepth = 0;
+	static thread_local int suspendDepth = 0;
+	static thread_local bool insideHook = false;
+
+	static uint32 getHash(AudioThreadInstrumentation::OperationType t, void* const* frames, int numFrames) noexcept
+	{
+		// FNV-1a over the return addresses
+		uint64 h = 14695981039346656037ULL ^ (uint64)t;
+
+		for (int i = 0; i < numFrames; i++)
+		{
+			h ^= (uint64)reinterpret_cast<pointer_sized_int>(frames[i]);
+			h *= 1099511628211ULL;
+		}
+
+		auto h32 = (uint32)(h ^ (h >> 32));
+		return h32 != 0 ? h32 : 1;
+	}
+
+	static void addCallStack(AudioThreadInstrumentation::OperationType t) noexcept
+	{
+		// Skips this function, record() and captureStackFrames()
+		constexpr int NumHookFrames = 3;
+
+		void* allFrames[AudioThreadInstrumentation::MaxNumFrames + NumHookFrames];
+
+		const int numCaptured = SystemStats::captureStackFrames(allFrames, AudioThreadInstrumentation::MaxNumFrames + NumHookFrames);
+		const int numFrames = jmax(0, numCaptured - NumHookFrames);
+		void* const* frames = allFrames + (numCaptured - numFrames);
+
+		const auto hash = getHash(t, frames, numFrames);
+
+		for (int i = 0; i < AudioThreadInstrumentation::NumCallStacks; i++)
+		{
+			auto& s = callStacks[(hash + (uint32)i) % AudioThreadInstrumentation::NumCallStacks];
+
+			uint32 expected = 0;
+
+			if (s.hash.compare_exchange_strong(expected, hash))
+			{
+				s.type = t;
+				s.numFrames = numFrames;
+				memcpy(s.frames, frames, sizeof(void*) * (size_t)numFrames);
+				s.count = 1;
+				s.ready = true;
+				return;
+			}
+
+			if (expected == hash)
+			{
+				s.count++;
+				return;
+			}
+		}
+
+		numDroppedCallStacks++;
+	}
+
+	static void lockEntered(bool wasContended)
+	{
+		AudioThreadInstrumentation::record(AudioThreadInstrumentation::OperationType::LockAcquisition);
+
+		if (wasContended)
+			AudioThreadInstrumentation::record(AudioThreadInstrumentation::OperationType::ContendedLock);
+	}
+
+	static void criticalSectionEntered(const CriticalSection&, bool wasContended) { lockEntered(wasContended); }
+	static void spinLockEntered(const SpinLock&, bool wasContended) { lockEntered(wasContended); }
+
+	/** Installs the lock callbacks once during the static initialisation, so they are never changed 
+		while another thread is entering a lock. They don't do anything outside of a ScopedAudioThread. */
+	struct HookInstaller
+	{
+		HookInstaller() noexcept
+		{
+			CriticalSection::setEnterCallback(criticalSectionEntered);
+			SpinLock::setEnterCallback(spinLockEntered);
+		}
+	};
+
+	static HookInstaller hookInstaller;
+}
+
+void AudioThreadInstrumentation::record(OperationType t) noexcept
+{
+	using namespace InstrumentationData;
+
+	if (audioThreadDepth == 0 || suspendDepth != 0 || insideHook)
+		return;
+
+	// Capturing the call stack might allocate on the first call, so this prevents the recursion
+	insideHook = true;
+
+	counters[(int)t]++;
+	addCallStack(t);
+
+	insideHook = false;
+}
+
+AudioThreadInstrumentation::ScopedAudioThread::ScopedAudioThread() noexcept
+{
+	using namespace InstrumentationData;
+
+	if (audioThreadDepth++ == 0)
+		numCallbacks++;
+}
+
+AudioThreadInstrumentation::ScopedAudioThread::~ScopedAudioThread() noexcept
+{
+	--InstrumentationData::audioThreadDepth;
+}
+
+AudioThreadInstrumentation::ScopedSuspender::ScopedSuspender() noexcept
+{
+	++InstrumentationData::suspendDepth;
+}
+
+AudioThreadInstrumentation::ScopedSuspender::~ScopedSuspender() noexcept
+{
+	--InstrumentationData::suspendDepth;
+}
+
+AudioThreadInstrumentation::Counters AudioThreadInstrumentation::getCounters() noexcept
+{
+	Counters c;
+
+	for (int i = 0; i < (int)OperationType::numOperationTypes; i++)
+		c.numOperations[i] = InstrumentationData::counters[i].load();
+
+	c.numCallbacks = InstrumentationData::numCallbacks.load();
+
+	return c;
+}
+
+void AudioThreadInstrumentation::reset() noexcept
+{
+	using namespace InstrumentationData;
+
+	for (auto& c : counters)
+		c = 0;
+
+	numCallbacks = 0;
+	numDroppedCallStacks = 0;
+
+	for (auto& s : callStacks)
+	{
+		s.ready = false;
+		s.count = 0;
+		s.hash = 0;
+	}
+}
+
+String AudioThreadInstrumentation::createReport(int maxNumCallStacks)
+{
+	using namespace InstrumentationData;
+
+	ScopedSuspender ss;
+
+	Array<CallStack*> list;
+
+	for (auto& s : callStacks)
+	{
+		if (s.ready)
+			list.add(&s);
+	}
+
+	struct Sorter
+	{
+		static int compareElements(CallStack* first, CallStack* second)
+		{
+			const auto c1 = first->count.load();
+			const auto c2 = second->count.load();
+
+			return c1 > c2 ? -1 : (c1 < c2 ? 1 : 0);
+		}
+	} sorter;
+
+	list.sort(sorter);
+
+	NewLine nl;
+	String report;
+
+	report << "Audio thread instrumentation: " << getCounters().toString() << nl;
+
+	if (numDroppedCallStacks > 0)
+		report << "(" << String(numDroppedCallStacks.load()) << " operations without recorded call stack)" << nl;
+
+	for (int i = 0; i < jmin(maxNumCallStacks, list.size()); i++)
+	{
+		auto s = list[i];
+
+		report << nl << getOperationName(s->type) << " (" << String(s->count.load()) << "x):" << nl;
+		report << SystemStats::getStackBacktrace(s->frames, s->numFrames);
+	}
+
+	return report;
+}
+
+#else
+
+void AudioThreadInstrumentation::record(OperationType) noexcept {}
+
+AudioThreadInstrumentation::Counters AudioThreadInstrumentation::getCounters() noexcept { return {}; }
+
+void AudioThreadInstrumentation::reset() noexcept {}
+
+String AudioThreadInstrumentation::createReport(int)
+{
+	return "Audio thread instrumentation is disabled (HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION)";
+}
+
+#endif
+
+AudioThreadInstrumentation::Counters AudioThreadInstrumentation::Counters::operator-(const Counters& other) const noexcept
+{
+	Counters c;
+
+	for (int i = 0; i < (int)OperationType::numOperationTypes; i++)
+		c.numOperations[i] = numOperations[i] - other.numOperations[i];
+
+	c.numCallbacks = numCallbacks - other.numCallbacks;
+
+	return c;
+}
+
+String AudioThreadInstrumentation::Counters::toString() const
+{
+	String s;
+
+	s << String(numCallbacks) << " callbacks, ";
+
+	for (int i = 0; i < (int)OperationType::numOperationTypes; i++)
+	{
+		s << getOperationName((OperationType)i) << ": " << String(numOperations[i]);
+
+		if (i != (int)OperationType::numOperationTypes - 1)
+			s << ", ";
+	}
+
+	return s;
+}
+
+String AudioThreadInstrumentation::getOperationName(OperationType t)
+{
+	switch (t)
+	{
+	case OperationType::Allocation:			return "Allocations";
+	case OperationType::Deallocation:		return "Frees";
+	case OperationType::LockAcquisition:	return "Locks";
+	case OperationType::ContendedLock:		return "Lock waits";
+	default:								return {};
+	}
+}
+
+}
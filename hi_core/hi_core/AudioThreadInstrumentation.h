@@ -0,0 +1,146 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef AUDIOTHREADINSTRUMENTATION_H_INCLUDED
+#define AUDIOTHREADINSTRUMENTATION_H_INCLUDED
+
+namespace hise {
+using namespace juce;
+
+/** Counts and records the heap allocations, frees and lock acquisitions on the audio thread.
+
+	If HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION is enabled, the global operator new / delete are replaced
+	and a callback is installed into CriticalSection::enter() and SpinLock::enter(). The hooks only record 
+	something on a thread that is inside a ScopedAudioThread - the MainController creates one next to the 
+	AudioThreadGuard in the audio callback.
+
+	The SimpleReadWriteLock, the SingleWriteLockfreeMutex and other custom spin loops are not covered. 
+	If you need to check them, call record() from their waiting code.
+
+	Every operation increases a counter and the call stack is stored (up to NumCallStacks unique stacks)
+	so you can find the source of the operation. Capturing the call stack doesn't allocate, the symbols are
+	resolved when you create the report.
+
+	The data is global (not per MainController) because the hooks can't know which instance is calling them.
+	If the instrumentation is disabled, everything compiles to nothing and the counters stay at zero.
+*/
+class AudioThreadInstrumentation
+{
+public:
+
+	enum class OperationType
+	{
+		Allocation = 0,
+		Deallocation,
+		LockAcquisition,
+		ContendedLock, ///< a lock acquisition that had to wait for another thread
+		numOperationTypes
+	};
+
+	enum
+	{
+		NumCallStacks = 64,
+		MaxNumFrames = 24
+	};
+
+	struct Counters
+	{
+		int64 get(OperationType t) const noexcept { return numOperations[(int)t]; }
+
+		/** Returns true if there was an allocation, a free or a lock that had to wait. 
+		
+			Uncontended locks are not considered as violation (the audio callback acquires a few on its own).
+		*/
+		bool hasViolations() const noexcept
+		{
+			return get(OperationType::Allocation) != 0 ||
+				   get(OperationType::Deallocation) != 0 ||
+				   get(OperationType::ContendedLock) != 0;
+		}
+
+		Counters operator-(const Counters& other) const noexcept;
+
+		String toString() const;
+
+		int64 numOperations[(int)OperationType::numOperationTypes] = { 0, 0, 0, 0 };
+		int64 numCallbacks = 0;
+	};
+
+	/** Activates the hooks for the current thread during the lifetime of this object. */
+	struct ScopedAudioThread
+	{
+#if HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION
+		ScopedAudioThread() noexcept;
+		~ScopedAudioThread() noexcept;
+#else
+		ScopedAudioThread() noexcept {};
+#endif
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread);
+	};
+
+	/** Deactivates the hooks for the current thread (eg. for debug output that is allowed to allocate). */
+	struct ScopedSuspender
+	{
+#if HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION
+		ScopedSuspender() noexcept;
+		~ScopedSuspender() noexcept;
+#else
+		ScopedSuspender() noexcept {};
+#endif
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedSuspender);
+	};
+
+	static constexpr bool isEnabled() noexcept { return HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION != 0; }
+
+	/** Returns the sum of all operations since the last reset. */
+	static Counters getCounters() noexcept;
+
+	/** Resets the counters and clears the recorded call stacks. 
+	
+		Don't call this while another thread is inside a ScopedAudioThread.
+	*/
+	static void reset() noexcept;
+
+	/** Creates a readable report with the counters and the most frequent call stacks. */
+	static String createReport(int maxNumCallStacks = 8);
+
+	static String getOperationName(OperationType t);
+
+	/** This is called by the hooks. You can also call it from a custom lock implementation. */
+	static void record(OperationType t) noexcept;
+};
+
+}
+
+#endif
@@ -270,7 +270,12 @@ struct DebugLogger::Failure : public DebugLogger::Message
         
     };
     
-	bool shouldPrintBacktrace() const override { return type == FailureType::PriorityInversion; }
+	bool shouldPrintBacktrace() const override 
+	{ 
+		return type == FailureType::PriorityInversion ||
+			   type == FailureType::AudioThreadAllocation ||
+			   type == FailureType::AudioThreadLockWait;
+	}
 
 	String getMessageText(int errorIndex = -1)
 	{
@@ -591,6 +596,37 @@ void DebugLogger::checkPriorityInversion(const SpinLock& spinLockToCheck, Locati
 	}
 }
 
+void DebugLogger::checkAudioThreadInstrumentation()
+{
+	if (!AudioThreadInstrumentation::isEnabled() || !isLogging())
+		return;
+
+	auto current = AudioThreadInstrumentation::getCounters();
+	auto delta = current - lastInstrumentationCounters;
+	lastInstrumentationCounters = current;
+
+	if (!delta.hasViolations())
+		return;
+
+	using Op = AudioThreadInstrumentation::OperationType;
+
+	const auto numAllocations = delta.get(Op::Allocation) + delta.get(Op::Deallocation);
+	const auto numLockWaits = delta.get(Op::ContendedLock);
+
+	actualBackTrace = getAudioThreadReport();
+
+	if (numAllocations > 0)
+		addFailure(Failure(messageIndex++, callbackIndex, Location::MainRenderCallback, FailureType::AudioThreadAllocation, nullptr, getCurrentTimeStamp(), (double)numAllocations));
+
+	if (numLockWaits > 0)
+		addFailure(Failure(messageIndex++, callbackIndex, Location::MainRenderCallback, FailureType::AudioThreadLockWait, nullptr, getCurrentTimeStamp(), (double)numLockWaits));
+}
+
+String DebugLogger::getAudioThreadReport() const
+{
+	return AudioThreadInstrumentation::createReport();
+}
+
 void DebugLogger::addAudioDeviceChange(FailureType changeType, double oldValue, double newValue)
 {
 	if (isLogging())
@@ -627,10 +663,13 @@ void DebugLogger::startLogging()
 
 	uptime = Time::getMillisecondCounterHiRes();
 
+	lastInstrumentationCounters = AudioThreadInstrumentation::getCounters();
+
 	FileOutputStream fos(currentLogFile);
 
 	fos << getHeader();
 	fos << getSystemSpecs();
+	fos << getModulatorChainStatistics();
 	
 
 	pendingFailures.ensureStorageAllocated(200);
@@ -663,6 +702,8 @@ struct MessageComparator
 
 void DebugLogger::timerCallback()
 {
+	checkAudioThreadInstrumentation();
+
 	Array<Failure> failureCopy;
 	Array<StringMessage> messageCopy;
 	Array<PerformanceWarning> warningCopy;
@@ -920,6 +961,8 @@ String DebugLogger::getNameForFailure(FailureType f)
 		RETURN_CASE_STRING_FAILURE(SampleLoadingError);
 		RETURN_CASE_STRING_FAILURE(StreamingFailure);
 		RETURN_CASE_STRING_FAILURE(SoftBypassFailure);
+		RETURN_CASE_STRING_FAILURE(AudioThreadAllocation);
+		RETURN_CASE_STRING_FAILURE(AudioThreadLockWait);
         RETURN_CASE_STRING_FAILURE(numFailureTypes);
 	}
 
@@ -1125,6 +1168,48 @@ void DebugLoggerComponent::paint(Graphics& g)
 }
 
 
+String DebugLogger::getModulatorChainStatistics() const
+{
+	NewLine nl;
+
+	String stats = "## Modulator chains\n\n";
+
+	auto chain = mc->getMainSynthChain();
+
+	if (chain == nullptr || !chain->isValidAndInitialised())
+		return stats;
+
+	int numFolded = 0;
+	int numUnfolded = 0;
+	int numFoldedVoiceStartMods = 0;
+	int numFusedTimeVariantMods = 0;
+
+	Processor::Iterator<ModulatorChain> iter(chain);
+
+	while (auto modChain = iter.getNextProcessor())
+	{
+		auto h = static_cast<const ModulatorChain::ModulatorChainHandler*>(modChain->getHandler());
+
+		if (!h->hasActiveMods())
+			continue;
+
+		if (h->isFolded())
+			numFolded++;
+		else
+			numUnfolded++;
+
+		numFoldedVoiceStartMods += h->getCompiledState().numFoldedVoiceStartMods;
+		numFusedTimeVariantMods += h->getCompiledState().numFusedTimeVariantMods;
+	}
+
+	stats << "Folded chains: **" << numFolded << "**  " << nl;
+	stats << "Unfolded chains: **" << numUnfolded << "**  " << nl;
+	stats << "Folded voice start modulators: **" << numFoldedVoiceStartMods << "**  " << nl;
+	stats << "Fused time variant modulators: **" << numFusedTimeVariantMods << "**  " << nl << nl;
+
+	return stats;
+}
+
 String DebugLogger::getSystemSpecs() const
 {
 	NewLine nl;
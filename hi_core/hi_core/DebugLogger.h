@@ -70,6 +70,8 @@ public:
 		SampleLoadingError,
 		StreamingFailure,
 		SoftBypassFailure,
+		AudioThreadAllocation, //< a heap allocation or free in the audio callback (needs HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION)
+		AudioThreadLockWait, //< the audio callback had to wait for a lock held by another thread
 		numFailureTypes
 	};
 
@@ -200,6 +202,12 @@ public:
 
 	void checkPriorityInversion(const SpinLock& spinLockToCheck, Location l, Processor* p, const Identifier& id);
 
+	/** Logs a failure if the AudioThreadInstrumentation detected allocations or lock waits since the last check. */
+	void checkAudioThreadInstrumentation();
+
+	/** Returns the report of the AudioThreadInstrumentation with the most frequent call stacks. */
+	String getAudioThreadReport() const;
+
 	void timerCallback() override;
 
 	MainController* getMainController()
@@ -222,6 +230,9 @@ public:
 
 	static void showLogFolder();
 
+	/** Returns a summary of how many modulator chains are folded into per-voice constants. */
+	String getModulatorChainStatistics() const;
+
 	static String getNameForLocation(Location l);
 	static String getNameForFailure(FailureType f);
 
@@ -323,6 +334,8 @@ private:
 
 	double uptime = 0.0;
 
+	AudioThreadInstrumentation::Counters lastInstrumentationCounters;
+
 	int warningLevel = 2;
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DebugLogger)
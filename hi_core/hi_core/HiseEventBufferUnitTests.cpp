@@ -58,10 +58,12 @@ public:
 		testEventBuffer();
 		testFadeEvent();
 		testEventBufferCopyMethods();
+		testEventBufferMerge();
 		testMidiBufferCopyMethods();
 		testMidiBufferIterators();
 		testEventBufferMoveOperations();
 		testEventHandler();
+		testEventHandlerOverlappingNotes();
 		testEventBufferStack();
 		testStartOffset();
 		testAlignment<16>(128);
@@ -512,6 +514,45 @@ private:
 
 	}
 
+	void testEventBufferMerge()
+	{
+		beginTest("Testing HiseEventBuffer merge and spill");
+
+		HiseEventBuffer b1;
+		HiseEventBuffer b2;
+		HiseEventBuffer ref;
+
+		b1.ensureSpillCapacity(HISE_EVENT_BUFFER_SIZE * 2);
+		ref.ensureSpillCapacity(HISE_EVENT_BUFFER_SIZE * 2);
+
+		const int numToFill1 = r.nextInt(HISE_EVENT_BUFFER_SIZE);
+		const int numToFill2 = r.nextInt(HISE_EVENT_BUFFER_SIZE);
+
+		for (int i = 0; i < numToFill1; i++)
+		{
+			auto e = generateRandomHiseEvent();
+			b1.addEvent(e);
+			ref.addEvent(e);
+		}
+
+		for (int i = 0; i < numToFill2; i++)
+			b2.addEvent(generateRandomHiseEvent());
+
+		b1.mergeSorted(b2);
+
+		for (const auto& e : b2)
+			ref.addEvent(e);
+
+		expectEquals(b1.getNumUsed(), numToFill1 + numToFill2, "No events dropped");
+		expect(b1.timeStampsAreSorted(), "Sorted after merge");
+		expect(b1 == ref, "Merge equals addEvent()");
+		expect(b1.isSpilling() == (numToFill1 + numToFill2 > HISE_EVENT_BUFFER_SIZE), "Spill block used");
+
+		b1.clear();
+
+		expect(!b1.isSpilling(), "Back to fixed storage after clear()");
+	}
+
 	void testMidiBufferCopyMethods()
 	{
 		beginTest("Testing MidiBuffer copy operations");
@@ -777,6 +818,95 @@ private:
 		
 	}
 
+	void testEventHandlerOverlappingNotes()
+	{
+		beginTest("Testing event ID handling with heavily overlapping notes");
+
+		HiseEventBuffer b;
+		EventIdHandler handler(b);
+
+		const int numRepetitions = 100;
+
+		for (int i = 0; i < numRepetitions; i++)
+		{
+			b.addEvent(HiseEvent(HiseEvent::Type::NoteOn, 60, 100, 1));
+			b.addEvent(HiseEvent(HiseEvent::Type::NoteOn, 60, 100, 2));
+		}
+
+		handler.handleEventIds();
+
+		Array<uint16> channel1Ids, channel2Ids;
+
+		HiseEventBuffer::Iterator onIter(b);
+
+		while (const HiseEvent* e = onIter.getNextConstEventPointer())
+		{
+			if (e->getChannel() == 1)
+				channel1Ids.add(e->getEventId());
+			else
+				channel2Ids.add(e->getEventId());
+		}
+
+		expectEquals<int>(channel1Ids.size(), numRepetitions, "Note on amount mismatch");
+		expectEquals<int>(channel2Ids.size(), numRepetitions, "Note on amount mismatch");
+
+		HiseEvent lookupOff(HiseEvent::Type::NoteOff, 60, 0, 1);
+		expectEquals<int>(handler.getEventIdForNoteOff(lookupOff), channel1Ids[0], "Lookup doesn't return the oldest note");
+
+		b.clear();
+
+		for (int i = 0; i < numRepetitions; i++)
+		{
+			b.addEvent(HiseEvent(HiseEvent::Type::NoteOff, 60, 0, 2));
+			b.addEvent(HiseEvent(HiseEvent::Type::NoteOff, 60, 0, 1));
+		}
+
+		// One note off too many must be ignored
+		b.addEvent(HiseEvent(HiseEvent::Type::NoteOff, 60, 0, 1));
+
+		handler.handleEventIds();
+
+		int channel1Index = 0;
+		int channel2Index = 0;
+		int numIgnored = 0;
+
+		HiseEventBuffer::Iterator offIter(b);
+
+		while (const HiseEvent* e = offIter.getNextConstEventPointer())
+		{
+			if (e->isIgnored())
+			{
+				numIgnored++;
+				continue;
+			}
+
+			if (e->getChannel() == 1)
+				expectEquals<int>(e->getEventId(), channel1Ids[channel1Index++], "Channel 1 note off mismatch");
+			else
+				expectEquals<int>(e->getEventId(), channel2Ids[channel2Index++], "Channel 2 note off mismatch");
+		}
+
+		expectEquals<int>(channel1Index, numRepetitions, "Not all channel 1 notes were released");
+		expectEquals<int>(channel2Index, numRepetitions, "Not all channel 2 notes were released");
+		expectEquals<int>(numIgnored, 1, "Orphaned note off wasn't ignored");
+
+		b.clear();
+
+		b.addEvent(HiseEvent(HiseEvent::Type::NoteOn, 61, 100, 1));
+		b.addEvent(HiseEvent(HiseEvent::Type::NoteOn, 61, 100, 1));
+		handler.handleEventIds();
+
+		b.clear();
+		b.addEvent(HiseEvent(HiseEvent::Type::AllNotesOff, 0, 0, 1));
+		b.addEvent(HiseEvent(HiseEvent::Type::NoteOff, 61, 0, 1));
+		handler.handleEventIds();
+
+		HiseEventBuffer::Iterator clearIter(b);
+		clearIter.getNextConstEventPointer();
+
+		expect(clearIter.getNextConstEventPointer()->isIgnored(), "All notes off didn't clear the overlapping notes");
+	}
+
 	Random r;
 
 	void testStartOffset()
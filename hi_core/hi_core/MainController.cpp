@@ -84,6 +84,8 @@ MainController::MainController() :
 {
 	PresetHandler::setCurrentMainController(this);
 
+	audioCallbackProfilerSource = performanceProfiler.registerSource("Audio Callback", PerformanceProfiler::Category::AudioCallback);
+
 	globalFont = GLOBAL_FONT();
 
 	BACKEND_ONLY(popupConsole = nullptr);
@@ -341,6 +343,8 @@ void MainController::loadPresetInternal(const ValueTree& v)
 
 			synthChain->loadMacrosFromValueTree(v);
 
+			triggerEffectLatencyUpdate();
+
 #if USE_BACKEND
 			Processor::Iterator<ModulatorSynth> iter(synthChain, false);
 
@@ -482,6 +486,51 @@ void MainController::killAndCallOnLoadingThread(const ProcessorFunction& f)
 	getKillStateHandler().killVoicesAndCall(getMainSynthChain(), f, KillStateHandler::SampleLoadingThread);
 }
 
+void MainController::updateEffectLatency()
+{
+	struct Helpers
+	{
+		static int getLatency(ModulatorSynth* s)
+		{
+			int latency = 0;
+
+			if (auto chain = dynamic_cast<ModulatorSynthChain*>(s))
+			{
+				for (int i = 0; i < chain->getHandler()->getNumProcessors(); i++)
+				{
+					if (auto child = dynamic_cast<ModulatorSynth*>(chain->getHandler()->getProcessor(i)))
+						latency = jmax(latency, getLatency(child));
+				}
+			}
+
+			if (auto fxChain = s->getChildProcessor(ModulatorSynth::EffectChain))
+			{
+				for (int i = 0; i < fxChain->getNumChildProcessors(); i++)
+				{
+					auto fx = dynamic_cast<MasterEffectProcessor*>(fxChain->getChildProcessor(i));
+
+					// A bypassed effect skips its oversampler so it doesn't delay the signal
+					if (fx != nullptr && !fx->isBypassed())
+						latency += fx->getLatencySamples();
+				}
+			}
+
+			return latency;
+		}
+	};
+
+	// The effects run at the (globally oversampled) internal samplerate
+	auto newLatency = roundToInt((double)Helpers::getLatency(getMainSynthChain()) / (double)getOversampleFactor());
+
+	if (newLatency == effectLatency)
+		return;
+
+	if (auto ap = dynamic_cast<AudioProcessor*>(this))
+		ap->setLatencySamples(jmax(0, ap->getLatencySamples() - effectLatency + newLatency));
+
+	effectLatency = newLatency;
+}
+
 bool MainController::refreshOversampling()
 {
 	auto requiredOversamplingFactor = (double)jlimit(1, 8, nextPowerOfTwo((int)(minimumSamplerate / getOriginalSamplerate())));
@@ -702,10 +751,12 @@ void MainController::processBlockCommon(AudioSampleBuffer &buffer, MidiBuffer &m
 		return;
 
 	AudioThreadGuard audioThreadGuard(&getKillStateHandler());
+	AudioThreadInstrumentation::ScopedAudioThread audioThreadInstrumentation;
 
 	getSampleManager().handleNonRealtimeState();
 
 	ADD_GLITCH_DETECTOR(getMainSynthChain(), DebugLogger::Location::MainRenderCallback);
+	PROFILE_SCOPE(audioCallbackProfilerSource);
     
 	getDebugLogger().checkAudioCallbackProperties(thisAsProcessor->getSampleRate(), numSamplesThisBlock);
 
@@ -797,6 +848,8 @@ void MainController::processBlockCommon(AudioSampleBuffer &buffer, MidiBuffer &m
 	masterEventBuffer.clear();
 #endif
 
+	getMacroManager().getMidiControlAutomationHandler()->getMPEData().getExpressionStore().startNextBlock();
+
 #if ENABLE_HOST_INFO
 	AudioPlayHead::CurrentPositionInfo newTime;
 
@@ -1180,6 +1233,8 @@ void MainController::prepareToPlay(double sampleRate_, int samplesPerBlock)
 
 	getMainSynthChain()->prepareToPlay(sampleRate, maxBufferSize.get());
 
+	updateEffectLatency();
+
 	AudioThreadGuard guard(&getKillStateHandler());
 
 	AudioThreadGuard::Suspender suspender;
@@ -1188,6 +1243,8 @@ void MainController::prepareToPlay(double sampleRate_, int samplesPerBlock)
 	LockHelpers::SafeLock itLock(this, LockHelpers::IteratorLock);
 	LockHelpers::SafeLock audioLock(this, LockHelpers::AudioLock);
 
+	masterEventBuffer.ensureSpillCapacity(HISE_EVENT_BUFFER_SPILL_SIZE);
+
 	getMainSynthChain()->setIsOnAir(true);
 
 	if (oversampler != nullptr)
@@ -1280,6 +1280,9 @@ public:
 
 	DebugLogger& getDebugLogger() { return debugLogger; }
 	const DebugLogger& getDebugLogger() const { return debugLogger; }
+
+	PerformanceProfiler& getPerformanceProfiler() { return performanceProfiler; }
+	const PerformanceProfiler& getPerformanceProfiler() const { return performanceProfiler; }
     
 	void addPreviewListener(BufferPreviewListener* l)
 	{
@@ -1351,6 +1354,22 @@ public:
 		return refreshOversampling();
 	}
 
+	/** Adds up the latency of all active (non-bypassed) oversampled master effects and reports it to the host.
+	*
+	*	Effects in the same chain are added, parallel child synths use the longest path. The latency that was set
+	*	by other sources (eg. Engine.setLatencySamples()) is preserved. This walks the processor tree and notifies
+	*	the host, so never call it from the audio thread - use triggerEffectLatencyUpdate() instead.
+	*/
+	void updateEffectLatency();
+
+	/** Refreshes the effect latency on the message thread. 
+	*
+	*	This only sets a flag, so you can call it from the audio thread (eg. when an effect is bypassed). 
+	*/
+	void triggerEffectLatencyUpdate() noexcept { effectLatencyUpdater.triggerAsyncUpdate(); }
+
+	int getEffectLatencySamples() const noexcept { return effectLatency; }
+
 	/** Returns the time that the plugin spends in its processBlock method. */
 	float getCpuUsage() const {return usagePercent.load();};
 
@@ -1556,6 +1575,7 @@ protected:
 	void killAndCallOnLoadingThread(const ProcessorFunction& f);
 
 
+
 	void setMaxEventTimestamp(int newMaxTimestamp)
 	{
 		maxEventTimestamp = newMaxTimestamp;
@@ -1646,6 +1666,28 @@ private:
 	ScopedPointer<juce::dsp::Oversampling<float>> oversampler;
 	double minimumSamplerate = 0.0;
 	int currentOversampleFactor = 1;
+	std::atomic<int> effectLatency { 0 };
+
+	struct EffectLatencyUpdater : private LockfreeAsyncUpdater
+	{
+		EffectLatencyUpdater(MainController& mc_) :
+			mc(mc_)
+		{};
+
+		using LockfreeAsyncUpdater::triggerAsyncUpdate;
+
+	private:
+
+		void handleAsyncUpdate() override
+		{
+			LockHelpers::SafeLock itLock(&mc, LockHelpers::IteratorLock);
+			mc.updateEffectLatency();
+		}
+
+		MainController& mc;
+	};
+
+	EffectLatencyUpdater effectLatencyUpdater { *this };
 	
 	Array<CustomTypeFace> customTypeFaces;
 	ValueTree customTypeFaceData;
@@ -1702,6 +1744,9 @@ private:
 
 	AutoSaver autoSaver;
 
+	PerformanceProfiler performanceProfiler;
+	PerformanceProfiler::Source audioCallbackProfilerSource;
+
 	DebugLogger debugLogger;
 
 #if USE_BACKEND
@@ -37,11 +37,14 @@ namespace hise { using namespace juce;
 MidiControllerAutomationHandler::MidiControllerAutomationHandler(MainController *mc_) :
 anyUsed(false),
 mpeData(mc_),
+deferredNotifier(*this),
 mc(mc_)
 {
 	tempBuffer.ensureSize(2048);
 
 	clear();
+
+	setCoalescingBlockSize(HISE_MIDI_AUTOMATION_SUBBLOCK_SIZE);
 }
 
 void MidiControllerAutomationHandler::addMidiControlledParameter(Processor *interfaceProcessor, int attributeIndex, NormalisableRange<double> parameterRange, int macroIndex)
@@ -616,6 +619,192 @@ bool MidiControllerAutomationHandler::MPEData::contains(MPEModulator* mod) const
 	return data->connections.contains(mod);
 }
 
+MidiControllerAutomationHandler::MPEData::ExpressionStore::ExpressionStore()
+{
+	for (int d = 0; d < numDimensions; d++)
+	{
+		for (int c = 0; c < NumChannels; c++)
+			targetValues[d][c] = getNeutralValue((Dimension)d);
+	}
+
+	memset(lastNoteOnIds, 0, sizeof(lastNoteOnIds));
+}
+
+void MidiControllerAutomationHandler::MPEData::ExpressionStore::prepareToPlay(double controlRate, int maxNumControlSamples)
+{
+	sampleRate = controlRate;
+
+	if (maxNumControlSamples > bufferSize)
+	{
+		bufferSize = maxNumControlSamples;
+		smoothedValues.calloc((size_t)(NumLanes * NumChannels * bufferSize));
+	}
+
+	for (auto& l : lanes)
+		l.updateCoefficients(sampleRate);
+
+	startNextBlock();
+}
+
+void MidiControllerAutomationHandler::MPEData::ExpressionStore::startNextBlock() noexcept
+{
+	for (auto& l : lanes)
+		l.numRendered = 0;
+}
+
+void MidiControllerAutomationHandler::MPEData::ExpressionStore::handleHiseEvent(const HiseEvent& e) noexcept
+{
+	const int c = jlimit<int>(0, NumChannels - 1, e.getChannel() - 1);
+
+	if (e.isNoteOn())
+	{
+		// Every modulator forwards the same note on, so only the first one resets the channel
+		if (lastNoteOnIds[c] == e.getEventId())
+			return;
+
+		lastNoteOnIds[c] = e.getEventId();
+
+		for (int d = 0; d < numDimensions; d++)
+			targetValues[d][c] = getNeutralValue((Dimension)d);
+
+		for (auto& l : lanes)
+		{
+			if (l.numUsers > 0)
+				l.currentValues[c] = getNeutralValue((Dimension)l.dimension);
+		}
+	}
+	else if (e.isChannelPressure())
+		targetValues[Press][c] = jlimit(0.0f, 1.0f, (float)e.getNoteNumber() / 127.0f);
+	else if (e.isControllerOfType(74))
+		targetValues[Slide][c] = jlimit(0.0f, 1.0f, (float)e.getControllerValue() / 127.0f);
+	else if (e.isPitchWheel())
+		targetValues[Glide][c] = jlimit(0.0f, 1.0f, 0.5f * ((float)e.getPitchWheelValue() - 8192.0f) / 2048.0f + 0.5f);
+	else if (e.isNoteOff())
+		targetValues[Lift][c] = jlimit(0.0f, 1.0f, (float)e.getVelocity() / 127.0f);
+}
+
+int MidiControllerAutomationHandler::MPEData::ExpressionStore::acquireLane(Dimension d, float smoothingTimeMs)
+{
+	int freeIndex = -1;
+
+	for (int i = 0; i < NumLanes; i++)
+	{
+		auto& l = lanes[i];
+
+		if (l.numUsers > 0 && l.dimension == (int)d && l.smoothingTime == smoothingTimeMs)
+		{
+			l.numUsers++;
+			return i;
+		}
+
+		if (l.numUsers == 0 && freeIndex == -1)
+			freeIndex = i;
+	}
+
+	if (freeIndex == -1)
+	{
+		// You've run out of lanes, the modulator will fall back to its own smoothing
+		jassertfalse;
+		return -1;
+	}
+
+	auto& l = lanes[freeIndex];
+
+	l.dimension = (int)d;
+	l.smoothingTime = smoothingTimeMs;
+	l.numUsers = 1;
+	l.numRendered = 0;
+
+	for (int c = 0; c < NumChannels; c++)
+		l.currentValues[c] = targetValues[d][c];
+
+	l.updateCoefficients(sampleRate);
+
+	return freeIndex;
+}
+
+void MidiControllerAutomationHandler::MPEData::ExpressionStore::releaseLane(int laneIndex)
+{
+	if (isPositiveAndBelow(laneIndex, NumLanes))
+	{
+		auto& l = lanes[laneIndex];
+
+		jassert(l.numUsers > 0);
+		l.numUsers = jmax(0, l.numUsers - 1);
+	}
+}
+
+const float* MidiControllerAutomationHandler::MPEData::ExpressionStore::getSmoothedValues(int laneIndex, int channelIndex, int startSample, int numSamples) noexcept
+{
+	jassert(isPositiveAndBelow(laneIndex, NumLanes));
+	jassert(isPositiveAndBelow(channelIndex, NumChannels));
+	jassert(startSample + numSamples <= bufferSize);
+
+	auto& l = lanes[laneIndex];
+
+	const int endSample = jmin(bufferSize, startSample + numSamples);
+
+	if (endSample > l.numRendered)
+		renderLane(l, endSample - l.numRendered);
+
+	return smoothedValues + (laneIndex * NumChannels + channelIndex) * bufferSize + startSample;
+}
+
+float MidiControllerAutomationHandler::MPEData::ExpressionStore::getNeutralValue(Dimension d) noexcept
+{
+	return (d == Slide || d == Glide) ? 0.5f : 0.0f;
+}
+
+float MidiControllerAutomationHandler::MPEData::ExpressionStore::applyStartOffset(float* data, int numSamples, float offset, float decay) noexcept
+{
+	for (int i = 0; i < numSamples; i++)
+	{
+		offset *= decay;
+		data[i] += offset;
+	}
+
+	return offset;
+}
+
+void MidiControllerAutomationHandler::MPEData::ExpressionStore::renderLane(Lane& l, int numSamplesToRender) noexcept
+{
+	const float* targets = targetValues[l.dimension];
+	float* current = l.currentValues;
+	float* data = smoothedValues + (&l - lanes) * NumChannels * bufferSize;
+
+	const float a0 = l.a0;
+	const float decay = l.decay;
+
+	for (int i = l.numRendered; i < l.numRendered + numSamplesToRender; i++)
+	{
+		// All channels are updated at once with a constant trip count so the filter math gets vectorised
+		for (int c = 0; c < NumChannels; c++)
+		{
+			current[c] = a0 * targets[c] + decay * current[c];
+			data[c * bufferSize + i] = current[c];
+		}
+	}
+
+	l.numRendered += numSamplesToRender;
+}
+
+void MidiControllerAutomationHandler::MPEData::ExpressionStore::Lane::updateCoefficients(double sampleRate)
+{
+	if (sampleRate <= 0.0 || smoothingTime <= 0.0f)
+	{
+		a0 = 1.0f;
+		decay = 0.0f;
+		return;
+	}
+
+	// Same coefficients as the Smoother class
+	const float freq = 1000.0f / smoothingTime;
+	const float x = expf(-2.0f * float_Pi * freq / (float)sampleRate);
+
+	a0 = 1.0f - x;
+	decay = x;
+}
+
 
 
 ValueTree MidiControllerAutomationHandler::exportAsValueTree() const
@@ -671,6 +860,12 @@ void MidiControllerAutomationHandler::handleParameterData(MidiBuffer &b)
 
 	if (bufferEmpty || noCCsUsed) return;
 
+	if (coalescingBlockSize > 0)
+	{
+		handleCoalescedParameterData(b);
+		return;
+	}
+
 	tempBuffer.clear();
 
 	MidiBuffer::Iterator mb(b);
@@ -697,13 +892,7 @@ void MidiControllerAutomationHandler::handleParameterData(MidiBuffer &b)
 				{
 					jassert(a.processor.get() != nullptr);
 
-					auto normalizedValue = (double)m.getControllerValue() / 127.0;
-
-					if (a.inverted) normalizedValue = 1.0 - normalizedValue;
-
-					const double value = a.parameterRange.convertFrom0to1(normalizedValue);
-
-					const float snappedValue = (float)a.parameterRange.snapToLegalValue(value);
+					const float snappedValue = getValueForController(a, m.getControllerValue());
 
 					if (a.macroIndex != -1)
 					{
@@ -730,6 +919,212 @@ void MidiControllerAutomationHandler::handleParameterData(MidiBuffer &b)
 	b.addEvents(tempBuffer, 0, -1, 0);
 }
 
+float MidiControllerAutomationHandler::getValueForController(const AutomationData& a, int controllerValue) const
+{
+	auto normalizedValue = (double)controllerValue / 127.0;
+
+	if (a.inverted) normalizedValue = 1.0 - normalizedValue;
+
+	const double value = a.parameterRange.convertFrom0to1(normalizedValue);
+
+	return (float)a.parameterRange.snapToLegalValue(value);
+}
+
+void MidiControllerAutomationHandler::handleCoalescedParameterData(MidiBuffer& b)
+{
+	tempBuffer.clear();
+	numPendingChanges = 0;
+
+	MidiBuffer::Iterator mb(b);
+	MidiMessage m;
+
+	int samplePos;
+
+	while (mb.getNextEvent(m, samplePos))
+	{
+		bool consumed = false;
+
+		if (m.isController())
+		{
+			const int number = m.getControllerNumber();
+
+			if (isLearningActive())
+				setUnlearndedMidiControlNumber(number, sendNotification);
+
+			for (auto& a : automationData[number])
+			{
+				if (a.used && a.processor.get() != nullptr)
+				{
+					// Only the last value of each connection in this block will be applied
+					int pendingIndex = -1;
+
+					for (int i = 0; i < numPendingChanges; i++)
+					{
+						if (pendingChanges[i] == &a)
+						{
+							pendingIndex = i;
+							break;
+						}
+					}
+
+					if (pendingIndex == -1 && numPendingChanges < numElementsInArray(pendingChanges))
+					{
+						pendingIndex = numPendingChanges++;
+						pendingChanges[pendingIndex] = &a;
+					}
+
+					if (pendingIndex != -1)
+						pendingValues[pendingIndex] = m.getControllerValue();
+					else
+						jassertfalse; // too many connections automated in a single block
+
+					consumed = true;
+				}
+			}
+		}
+
+		if (!consumed) tempBuffer.addEvent(m, samplePos);
+	}
+
+	for (int i = 0; i < numPendingChanges; i++)
+	{
+		auto& a = *pendingChanges[i];
+		const int controllerValue = pendingValues[i];
+
+		if (a.macroIndex != -1)
+		{
+			mc->getMacroManager().getMacroChain()->setMacroControl(a.macroIndex, (float)controllerValue, sendNotification);
+		}
+		else
+		{
+			const float snappedValue = getValueForController(a, controllerValue);
+
+			if (a.lastValue != snappedValue)
+			{
+				a.processor->setAttribute(a.attribute, snappedValue, dontSendNotification);
+				a.lastValue = snappedValue;
+				deferredNotifier.push(a.processor);
+			}
+		}
+	}
+
+	numPendingChanges = 0;
+
+	b.clear();
+	b.addEvents(tempBuffer, 0, -1, 0);
+}
+
+void MidiControllerAutomationHandler::setCoalescingBlockSize(int newBlockSize)
+{
+	if (newBlockSize > 0)
+	{
+		// The largest raster aligned size that still fits into a processing block
+		constexpr int maxBlockSize = HISE_MAX_PROCESSING_BLOCKSIZE - HISE_MAX_PROCESSING_BLOCKSIZE % HISE_EVENT_RASTER;
+
+		newBlockSize = jmax(HISE_EVENT_RASTER, newBlockSize);
+		newBlockSize += (HISE_EVENT_RASTER - newBlockSize % HISE_EVENT_RASTER) % HISE_EVENT_RASTER;
+		newBlockSize = jmin(maxBlockSize, newBlockSize);
+	}
+	else
+		newBlockSize = 0;
+
+	coalescingBlockSize = newBlockSize;
+	deferredNotifier.setActive(coalescingBlockSize > 0);
+}
+
+int MidiControllerAutomationHandler::flushDeferredNotifications()
+{
+	return deferredNotifier.flush();
+}
+
+int MidiControllerAutomationHandler::getSplitPositions(const MidiBuffer& b, int numSamples, int* positions, int maxPositions) const
+{
+	const int blockSize = coalescingBlockSize.load();
+
+	if (blockSize == 0 || b.isEmpty() || (!anyUsed && !unlearnedData.used))
+		return 0;
+
+	int numPositions = 0;
+	int lastPosition = 0;
+
+	MidiBuffer::Iterator mb(b);
+	MidiMessage m;
+	int samplePos;
+
+	while (mb.getNextEvent(m, samplePos) && numPositions < maxPositions)
+	{
+		if (!m.isController() || automationData[m.getControllerNumber()].isEmpty())
+			continue;
+
+		const int splitPosition = samplePos - samplePos % blockSize;
+
+		if (splitPosition > lastPosition && splitPosition < numSamples)
+		{
+			positions[numPositions++] = splitPosition;
+			lastPosition = splitPosition;
+		}
+	}
+
+	return numPositions;
+}
+
+MidiControllerAutomationHandler::DeferredNotifier::DeferredNotifier(MidiControllerAutomationHandler& parent_) :
+	parent(parent_),
+	pendingProcessors(1024)
+{
+}
+
+void MidiControllerAutomationHandler::DeferredNotifier::push(const WeakReference<Processor>& p)
+{
+	if (overflow.load())
+		return;
+
+	if (!pendingProcessors.push(p))
+		overflow.store(true);
+}
+
+void MidiControllerAutomationHandler::DeferredNotifier::setActive(bool shouldBeActive)
+{
+	if (shouldBeActive)
+		startTimer(30);
+	else
+		stopTimer();
+}
+
+int MidiControllerAutomationHandler::DeferredNotifier::flush()
+{
+	if (pendingProcessors.isEmpty() && !overflow.load())
+		return 0;
+
+	Array<Processor*> notifiedProcessors;
+
+	WeakReference<Processor> p;
+
+	while (pendingProcessors.pop(p))
+	{
+		if (p.get() != nullptr)
+			notifiedProcessors.addIfNotAlreadyThere(p.get());
+	}
+
+	// Some processors were dropped, so we need to update all of them
+	if (overflow.exchange(false))
+	{
+		for (const auto& list : parent.automationData)
+		{
+			for (const auto& a : list)
+			{
+				if (a.used && a.processor.get() != nullptr)
+					notifiedProcessors.addIfNotAlreadyThere(a.processor.get());
+			}
+		}
+	}
+
+	for (auto np : notifiedProcessors)
+		np->sendChangeMessage();
+
+	return notifiedProcessors.size();
+}
+
 
 hise::MidiControllerAutomationHandler::AutomationData MidiControllerAutomationHandler::getDataFromIndex(int index) const
 {
@@ -1206,9 +1601,58 @@ void DelayedRenderer::processWrapped(AudioSampleBuffer& buffer, MidiBuffer& midi
 #endif
 	}
 	else
+	{
+		processSplitAtAutomationEvents(buffer, midiMessages);
+	}
+}
+
+void DelayedRenderer::processSplitAtAutomationEvents(AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
+{
+#if HISE_MIDIFX_PLUGIN
+	// The MIDI output would get lost when splitting the buffer
+	mc->processBlockCommon(buffer, midiMessages);
+#else
+	auto handler = mc->getMacroManager().getMidiControlAutomationHandler();
+
+	int splitPositions[HISE_MAX_PROCESSING_BLOCKSIZE / HISE_EVENT_RASTER];
+
+	const int numSamples = buffer.getNumSamples();
+	const int numSplits = handler->getSplitPositions(midiMessages, numSamples, splitPositions, numElementsInArray(splitPositions));
+
+	if (numSplits == 0)
 	{
 		mc->processBlockCommon(buffer, midiMessages);
+		return;
 	}
+
+	const int numChannels = buffer.getNumChannels();
+
+	auto ptrs = (float**)alloca(sizeof(float*) * numChannels);
+
+	memcpy(ptrs, buffer.getArrayOfWritePointers(), sizeof(float*) * numChannels);
+
+	int start = 0;
+
+	for (int i = 0; i <= numSplits; i++)
+	{
+		const int end = i < numSplits ? splitPositions[i] : numSamples;
+		const int numThisTime = end - start;
+
+		jassert(numThisTime > 0 && numThisTime % HISE_EVENT_RASTER == 0);
+
+		AudioSampleBuffer chunk(ptrs, numChannels, numThisTime);
+
+		delayedMidiBuffer.clear();
+		delayedMidiBuffer.addEvents(midiMessages, start, numThisTime, -start);
+
+		mc->processBlockCommon(chunk, delayedMidiBuffer);
+
+		for (int c = 0; c < numChannels; c++)
+			ptrs[c] += numThisTime;
+
+		start = end;
+	}
+#endif
 }
 
 void DelayedRenderer::prepareToPlayWrapped(double sampleRate, int samplesPerBlock)
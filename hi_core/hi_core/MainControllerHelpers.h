@@ -90,6 +90,14 @@ public:
 
 #define HI_NUM_MIDI_AUTOMATION_SLOTS 8
 
+/** The default sub block size for coalesced MIDI automation (0 disables it). 
+*
+*	See MidiControllerAutomationHandler::setCoalescingBlockSize(). 
+*/
+#ifndef HISE_MIDI_AUTOMATION_SUBBLOCK_SIZE
+#define HISE_MIDI_AUTOMATION_SUBBLOCK_SIZE 0
+#endif
+
 /** This handles the MIDI automation for the frontend plugin.
 *
 *	For faster performance, one CC value can only control one parameter.
@@ -122,6 +130,41 @@ public:
 	/** The main routine. Call this for every MidiBuffer you want to process and it handles both setting parameters as well as MIDI learning. */
 	void handleParameterData(MidiBuffer &b);
 
+	/** Enables the coalesced automation mode.
+	*
+	*	If the block size is bigger than zero, CC bursts are collapsed to the last value per 
+	*	parameter, the parameters are changed without notification and the UI update is deferred
+	*	to the message thread. The DelayedRenderer splits the audio callback at the sub blocks 
+	*	that contain automated CC messages, so the values are applied at their timestamps
+	*	(quantised to the block size). It will be rounded up to a multiple of HISE_EVENT_RASTER and
+	*	limited to HISE_MAX_PROCESSING_BLOCKSIZE.
+	*
+	*	The default is HISE_MIDI_AUTOMATION_SUBBLOCK_SIZE, but you can change it at runtime 
+	*	(eg. with Engine.setMidiAutomationSubBlockSize()).
+	*/
+	void setCoalescingBlockSize(int newBlockSize);
+
+	/** Returns the sub block size for the coalesced mode or 0 if it's disabled. */
+	int getCoalescingBlockSize() const noexcept { return coalescingBlockSize.load(); }
+
+	/** Sends the deferred change messages of the coalesced mode and returns the number of notified processors.
+	*
+	*	This is called periodically on the message thread, so you only need to call it directly for testing.
+	*/
+	int flushDeferredNotifications();
+
+	/** Returns true if the deferred notification queue was full since the last flush. 
+	*
+	*	In this case, the next flush notifies every connected processor so no update gets lost.
+	*/
+	bool hasDeferredNotificationOverflow() const noexcept { return deferredNotifier.hasOverflowed(); }
+
+	/** Calculates the sample positions where the rendering should be split so that the automated CC messages are applied at their timestamps.
+	*
+	*	Returns the number of split positions written to the array (the start of the buffer is not included).
+	*/
+	int getSplitPositions(const MidiBuffer& b, int numSamples, int* positions, int maxPositions) const;
+
 		
 	class MPEData : public ControlledObject,
 					public RestorableObject,
@@ -214,8 +257,107 @@ public:
 			}
 		}
 
+		/** A central storage of the per-channel MPE expression values.
+
+			It keeps the current and target values of every MIDI channel in structure-of-arrays form
+			and smoothes all channels of a dimension in a single pass. MPE modulators that track the same
+			dimension with the same smoothing time share a lane, so the smoothing is calculated only once
+			per block no matter how many modulators read from it.
+
+			The values are stored in the normalised range (0...1) before any table is applied.
+		*/
+		class ExpressionStore
+		{
+		public:
+
+			enum Dimension
+			{
+				Press = 0,
+				Slide,
+				Glide,
+				Lift,
+				numDimensions
+			};
+
+			static constexpr int NumChannels = 16;
+			static constexpr int NumLanes = 32;
+
+			ExpressionStore();
+
+			/** Sets the control rate and resizes the smoothing buffers. Call this from prepareToPlay(). */
+			void prepareToPlay(double controlRate, int maxNumControlSamples);
+
+			/** Rewinds the render position of every lane. The MainController calls this at the start of each block. */
+			void startNextBlock() noexcept;
+
+			/** Updates the target values with the given event.
+			
+				This can be called multiple times with the same event (eg. from every MPE modulator that receives it). */
+			void handleHiseEvent(const HiseEvent& e) noexcept;
+
+			/** Returns a lane that smoothes the given dimension with the given time. Call this with the audio lock held. */
+			int acquireLane(Dimension d, float smoothingTimeMs);
+
+			/** Releases a lane that was acquired with acquireLane(). Call this with the audio lock held. */
+			void releaseLane(int laneIndex);
+
+			/** Returns the smoothed values of the given channel for the given control rate range. 
+			
+				The lane is rendered lazily, so only the first reader of a range does the actual work. */
+			const float* getSmoothedValues(int laneIndex, int channelIndex, int startSample, int numSamples) noexcept;
+
+			/** Returns the value that the given channel is heading to. */
+			float getTargetValue(Dimension d, int channelIndex) const noexcept { return targetValues[d][channelIndex]; }
+
+			/** Returns the factor that is applied to the distance to the target value for each sample of the lane. */
+			float getDecayFactor(int laneIndex) const noexcept { return lanes[laneIndex].decay; }
+
+			/** Returns the value that a channel is reset to when a new note starts on it. */
+			static float getNeutralValue(Dimension d) noexcept;
+
+			/** Adds the start value offset of a voice to the given values and lets it decay with the lane factor.
+			
+				The offset is decayed before it is added, so the sum follows a per voice smoother that starts at the
+				start value. Returns the remaining offset for the next block. */
+			static float applyStartOffset(float* data, int numSamples, float offset, float decay) noexcept;
+
+		private:
+
+			struct Lane
+			{
+				void updateCoefficients(double sampleRate);
+
+				int dimension = -1;
+				int numUsers = 0;
+				float smoothingTime = 0.0f;
+				float a0 = 1.0f;
+				float decay = 0.0f;
+				int numRendered = 0;
+				float currentValues[NumChannels];
+			};
+
+			void renderLane(Lane& l, int numSamplesToRender) noexcept;
+
+			double sampleRate = 0.0;
+			int bufferSize = 0;
+
+			float targetValues[numDimensions][NumChannels];
+			uint16 lastNoteOnIds[NumChannels];
+
+			Lane lanes[NumLanes];
+
+			/** The smoothed values, laid out as [lane][channel][sample]. */
+			HeapBlock<float> smoothedValues;
+
+			JUCE_DECLARE_NON_COPYABLE(ExpressionStore);
+		};
+
+		ExpressionStore& getExpressionStore() noexcept { return expressionStore; }
+
 	private:
 
+		ExpressionStore expressionStore;
+
 		struct AsyncRestorer : private Timer
 		{
 		public:
@@ -309,6 +451,43 @@ private:
 
 	MPEData mpeData;
 
+	void handleCoalescedParameterData(MidiBuffer& b);
+
+	float getValueForController(const AutomationData& a, int controllerValue) const;
+
+	/** Sends the change messages for parameters that were automated on the audio thread. */
+	struct DeferredNotifier : private Timer
+	{
+		DeferredNotifier(MidiControllerAutomationHandler& parent_);
+
+		void setActive(bool shouldBeActive);
+
+		/** Adds the processor to the queue. If the queue is full, it sets the overflow flag instead. */
+		void push(const WeakReference<Processor>& p);
+
+		int flush();
+
+		bool hasOverflowed() const noexcept { return overflow.load(); }
+
+	private:
+
+		void timerCallback() override { flush(); }
+
+		MidiControllerAutomationHandler& parent;
+
+		LockfreeQueue<WeakReference<Processor>> pendingProcessors;
+
+		std::atomic<bool> overflow { false };
+	};
+
+	DeferredNotifier deferredNotifier;
+
+	std::atomic<int> coalescingBlockSize { 0 };
+
+	AutomationData* pendingChanges[128];
+	int pendingValues[128];
+	int numPendingChanges = 0;
+
 	bool anyUsed;
 	MidiBuffer tempBuffer;
 
@@ -508,6 +687,9 @@ public:
 
 private:
 
+	/** Splits the rendering at the sub blocks that contain automated CC messages (if the coalesced automation mode is enabled). */
+	void processSplitAtAutomationEvents(AudioSampleBuffer& buffer, MidiBuffer& midiMessages);
+
 	class Pimpl;
 
 	ScopedPointer<Pimpl> pimpl;
@@ -0,0 +1,436 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+namespace hise {
+using namespace juce;
+
+namespace ProfilerHelpers
+{
+	static std::atomic<int> nextInstanceIndex(0);
+
+	struct CachedThreadSlot
+	{
+		int instanceIndex;
+		int captureIndex;
+		void* buffer;
+	};
+
+	// The thread slots are claimed again for each capture, so the cache must be invalidated when the capture index changes
+	static thread_local CachedThreadSlot cachedSlot = { -1, -1, nullptr };
+
+	static double toMicroSeconds(int64 ticks)
+	{
+		return Time::highResolutionTicksToSeconds(ticks) * 1000000.0;
+	}
+
+	struct SelfTimeComparator
+	{
+		static int compareElements(const PerformanceProfiler::Statistics& first, const PerformanceProfiler::Statistics& second)
+		{
+			if (first.selfSeconds > second.selfSeconds)
+				return -1;
+
+			if (first.selfSeconds < second.selfSeconds)
+				return 1;
+
+			return 0;
+		}
+	};
+}
+
+String PerformanceProfiler::Statistics::toString() const
+{
+	String s;
+
+	s << name << " (" << getCategoryName(category) << "): ";
+	s << String(numCalls) << " calls, ";
+	s << "total: " << String(totalSeconds * 1000.0, 2) << " ms, ";
+	s << "self: " << String(selfSeconds * 1000.0, 2) << " ms, ";
+	s << "avg: " << String(numCalls > 0 ? totalSeconds / (double)numCalls * 1000000.0 : 0.0, 1) << " us, ";
+	s << "max: " << String(maxSeconds * 1000000.0, 1) << " us";
+
+	return s;
+}
+
+PerformanceProfiler::PerformanceProfiler() :
+	instanceIndex(ProfilerHelpers::nextInstanceIndex++),
+	captureIndex(0),
+	capturing(false),
+	numDroppedEvents(0),
+	collector(*this)
+{
+	for (auto& b : threadBuffers)
+	{
+		b.owner.store(nullptr);
+		b.writePosition.store(0);
+		b.readPosition.store(0);
+	}
+}
+
+PerformanceProfiler::~PerformanceProfiler()
+{
+	capturing.store(false);
+	collector.stopThread(1000);
+}
+
+PerformanceProfiler::Source PerformanceProfiler::registerSource(const String& name, Category c)
+{
+	const String key = String((int)c) + ":" + name;
+
+	ScopedLock sl(sourceLock);
+
+	Source s;
+	s.profiler = this;
+
+	if (sourceIds.contains(key))
+	{
+		s.id = sourceIds[key];
+		return s;
+	}
+
+	SourceInfo info;
+	info.name = name;
+	info.escapedName = JSON::toString(var(name));
+	info.category = c;
+
+	s.id = sources.size();
+	sources.add(info);
+	sourceIds.set(key, s.id);
+
+	return s;
+}
+
+void PerformanceProfiler::startCapture(double maxLengthSeconds)
+{
+	stopCapture();
+
+	ScopedLock sl(dataLock);
+
+	capturedEvents.clearQuick();
+	statistics.clearQuick();
+
+	for (auto& b : threadBuffers)
+	{
+		if (b.events == nullptr)
+			b.events.calloc(BufferSize);
+
+		b.owner.store(nullptr);
+		b.readPosition.store(b.writePosition.load());
+		b.stackDepth = 0;
+	}
+
+	numDroppedEvents.store(0);
+	captureStartTicks = Time::getHighResolutionTicks();
+	maxCaptureTicks = maxLengthSeconds > 0.0 ? Time::secondsToHighResolutionTicks(maxLengthSeconds) : 0;
+
+	// Invalidates the cached thread slots (the owners have been cleared above)
+	captureIndex++;
+
+	capturing.store(true, std::memory_order_release);
+	collector.startThread(4);
+}
+
+void PerformanceProfiler::stopCapture()
+{
+	capturing.store(false);
+	collector.stopThread(1000);
+	collectEvents();
+}
+
+bool PerformanceProfiler::addEvent(int sourceId, bool isBegin) noexcept
+{
+	auto b = getBufferForCurrentThread();
+
+	if (b == nullptr)
+	{
+		numDroppedEvents++;
+		return false;
+	}
+
+	const auto w = b->writePosition.load(std::memory_order_relaxed);
+
+	if (w - b->readPosition.load(std::memory_order_acquire) >= (uint32)BufferSize)
+	{
+		numDroppedEvents++;
+		return false;
+	}
+
+	auto& e = b->events[w & (BufferSize - 1)];
+
+	e.sourceId = sourceId;
+	e.isBegin = isBegin ? 1 : 0;
+	e.ticks = Time::getHighResolutionTicks();
+
+	b->writePosition.store(w + 1, std::memory_order_release);
+
+	return true;
+}
+
+PerformanceProfiler::ThreadBuffer* PerformanceProfiler::getBufferForCurrentThread() noexcept
+{
+	auto& cache = ProfilerHelpers::cachedSlot;
+	const int thisCaptureIndex = captureIndex.load(std::memory_order_relaxed);
+
+	if (cache.instanceIndex == instanceIndex && cache.captureIndex == thisCaptureIndex)
+		return static_cast<ThreadBuffer*>(cache.buffer);
+
+	auto threadId = Thread::getCurrentThreadId();
+	ThreadBuffer* buffer = nullptr;
+
+	for (auto& b : threadBuffers)
+	{
+		if (b.owner.load() == threadId)
+		{
+			buffer = &b;
+			break;
+		}
+	}
+
+	if (buffer == nullptr)
+	{
+		for (auto& b : threadBuffers)
+		{
+			void* expected = nullptr;
+
+			if (b.owner.compare_exchange_strong(expected, threadId))
+			{
+				buffer = &b;
+				break;
+			}
+		}
+	}
+
+	cache.instanceIndex = instanceIndex;
+	cache.captureIndex = thisCaptureIndex;
+	cache.buffer = buffer;
+
+	return buffer;
+}
+
+void PerformanceProfiler::collectEvents()
+{
+	int numSources = 0;
+
+	{
+		ScopedLock sl(sourceLock);
+		numSources = sources.size();
+	}
+
+	ScopedLock sl(dataLock);
+
+	while (statistics.size() < numSources)
+		statistics.add({});
+
+	for (int i = 0; i < NumThreadSlots; i++)
+	{
+		auto& b = threadBuffers[i];
+
+		if (b.events == nullptr)
+			continue;
+
+		auto r = b.readPosition.load(std::memory_order_relaxed);
+		const auto w = b.writePosition.load(std::memory_order_acquire);
+
+		for (; r != w; r++)
+			processEvent(i, b, b.events[r & (BufferSize - 1)], numSources);
+
+		b.readPosition.store(r, std::memory_order_release);
+	}
+
+	if (maxCaptureTicks > 0 && Time::getHighResolutionTicks() - captureStartTicks > maxCaptureTicks)
+		capturing.store(false);
+}
+
+void PerformanceProfiler::processEvent(int threadIndex, ThreadBuffer& b, const Event& e, int numSources)
+{
+	if (!isPositiveAndBelow(e.sourceId, numSources))
+		return;
+
+	if (e.isBegin != 0)
+	{
+		// If the nesting is too deep, the inner scopes are skipped
+		if (b.stackDepth < MaxStackDepth)
+			b.stack[b.stackDepth++] = { e.sourceId, e.ticks, 0 };
+
+		return;
+	}
+
+	// Begin events without an end (because the buffer was full) are discarded here
+	for (int d = b.stackDepth - 1; d >= 0; d--)
+	{
+		const auto scope = b.stack[d];
+
+		if (scope.sourceId != e.sourceId)
+			continue;
+
+		const auto duration = e.ticks - scope.startTicks;
+		const auto seconds = Time::highResolutionTicksToSeconds(duration);
+
+		auto& s = statistics.getReference(e.sourceId);
+
+		s.numCalls++;
+		s.totalSeconds += seconds;
+		s.selfSeconds += Time::highResolutionTicksToSeconds(duration - scope.childTicks);
+		s.maxSeconds = jmax(s.maxSeconds, seconds);
+
+		b.stackDepth = d;
+
+		if (d > 0)
+			b.stack[d - 1].childTicks += duration;
+
+		if (capturedEvents.size() < MaxNumCapturedEvents)
+			capturedEvents.add({ e.sourceId, threadIndex, scope.startTicks, duration });
+
+		return;
+	}
+}
+
+void PerformanceProfiler::CollectorThread::run()
+{
+	while (!threadShouldExit() && parent.isCapturing())
+	{
+		wait(20);
+		parent.collectEvents();
+	}
+}
+
+Array<PerformanceProfiler::Statistics> PerformanceProfiler::getStatistics() const
+{
+	Array<Statistics> list;
+
+	ScopedLock sl(dataLock);
+	ScopedLock sl2(sourceLock);
+
+	for (int i = 0; i < statistics.size(); i++)
+	{
+		if (statistics[i].numCalls == 0)
+			continue;
+
+		auto s = statistics[i];
+		s.name = sources[i].name;
+		s.category = sources[i].category;
+		list.add(s);
+	}
+
+	ProfilerHelpers::SelfTimeComparator comparator;
+	list.sort(comparator);
+
+	return list;
+}
+
+String PerformanceProfiler::createSummary(int maxNumSources) const
+{
+	auto list = getStatistics();
+
+	String s;
+
+	{
+		ScopedLock sl(dataLock);
+		s << "Captured events: " << String(capturedEvents.size());
+	}
+
+	s << ", dropped events: " << String(getNumDroppedEvents()) << "\n";
+
+	for (int i = 0; i < jmin(maxNumSources, list.size()); i++)
+		s << list[i].toString() << "\n";
+
+	return s;
+}
+
+String PerformanceProfiler::createChromeTrace() const
+{
+	MemoryOutputStream mos;
+
+	ScopedLock sl(dataLock);
+	ScopedLock sl2(sourceLock);
+
+	bool usedThreads[NumThreadSlots] = { false };
+	bool audioThreads[NumThreadSlots] = { false };
+
+	mos << "{\"traceEvents\":[\n";
+	mos << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"HISE\"}}";
+
+	for (const auto& e : capturedEvents)
+	{
+		const auto& info = sources.getReference(e.sourceId);
+
+		usedThreads[e.threadIndex] = true;
+
+		if (info.category == Category::AudioCallback)
+			audioThreads[e.threadIndex] = true;
+
+		mos << ",\n{\"name\":" << info.escapedName;
+		mos << ",\"cat\":\"" << getCategoryName(info.category) << "\"";
+		mos << ",\"ph\":\"X\"";
+		mos << ",\"ts\":" << String(ProfilerHelpers::toMicroSeconds(e.startTicks - captureStartTicks), 3);
+		mos << ",\"dur\":" << String(ProfilerHelpers::toMicroSeconds(e.durationTicks), 3);
+		mos << ",\"pid\":1,\"tid\":" << e.threadIndex << "}";
+	}
+
+	for (int i = 0; i < NumThreadSlots; i++)
+	{
+		if (!usedThreads[i])
+			continue;
+
+		auto name = audioThreads[i] ? "Audio Thread" : "Thread " + String(i);
+
+		mos << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i;
+		mos << ",\"args\":{\"name\":\"" << name << "\"}}";
+	}
+
+	mos << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	return mos.toString();
+}
+
+Result PerformanceProfiler::exportChromeTrace(const File& targetFile) const
+{
+	if (!targetFile.replaceWithText(createChromeTrace()))
+		return Result::fail("Can't write the trace file " + targetFile.getFullPathName());
+
+	return Result::ok();
+}
+
+String PerformanceProfiler::getCategoryName(Category c)
+{
+	switch (c)
+	{
+	case Category::AudioCallback:	return "AudioCallback";
+	case Category::Processor:		return "Processor";
+	case Category::Node:			return "Node";
+	case Category::ScriptCallback:	return "ScriptCallback";
+	default:						return "Unknown";
+	}
+}
+
+}
@@ -0,0 +1,260 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef PERFORMANCEPROFILER_H_INCLUDED
+#define PERFORMANCEPROFILER_H_INCLUDED
+
+namespace hise {
+using namespace juce;
+
+/** A hierarchical profiler that records the CPU time of Processors, scriptnode nodes and script callbacks.
+
+	Every object that wants to be profiled registers a Source (a name and a Category) on a non-realtime thread
+	and wraps its processing into a PROFILE_SCOPE(source) macro. While the profiler is capturing, the begin
+	and end timestamps are written into a lock-free ring buffer for each thread. A background thread collects
+	the events, matches the begin / end pairs and calculates the statistics for each source.
+
+	If the profiler is not capturing, a scope costs one atomic load, so it's safe to leave the macros in the
+	audio rendering code (you can remove them completely with HISE_ENABLE_PROFILER=0).
+
+	After you've captured a time window, you can export it as Chrome trace event JSON, which can be loaded
+	into chrome://tracing or https://ui.perfetto.dev.
+*/
+class PerformanceProfiler
+{
+public:
+
+	enum class Category
+	{
+		AudioCallback = 0,
+		Processor,
+		Node,
+		ScriptCallback,
+		numCategories
+	};
+
+	enum
+	{
+		NumThreadSlots = 16,
+		BufferSize = 8192, ///< the number of events per thread (must be a power of two)
+		MaxStackDepth = 64,
+		MaxNumCapturedEvents = 1 << 20
+	};
+
+	/** A handle to a registered name that can be used for PROFILE_SCOPE. 
+	
+		It's a POD that can be copied around on the audio thread. A default constructed source is never recorded.
+	*/
+	struct Source
+	{
+		PerformanceProfiler* profiler = nullptr;
+		int id = -1;
+	};
+
+	/** Records a begin event when created and the matching end event when destroyed. */
+	struct ScopedEvent
+	{
+		ScopedEvent(const Source& s) noexcept :
+			source(s)
+		{
+			if (source.profiler != nullptr && source.profiler->isCapturing())
+				active = source.profiler->addEvent(source.id, true);
+		}
+
+		~ScopedEvent() noexcept
+		{
+			if (active)
+				source.profiler->addEvent(source.id, false);
+		}
+
+	private:
+
+		const Source source;
+		bool active = false;
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedEvent);
+	};
+
+	/** The accumulated timings of a source for the last captured time window. */
+	struct Statistics
+	{
+		String toString() const;
+
+		String name;
+		Category category = Category::numCategories;
+		int64 numCalls = 0;
+
+		/** The time including all nested scopes. */
+		double totalSeconds = 0.0;
+
+		/** The time without the nested scopes. */
+		double selfSeconds = 0.0;
+
+		double maxSeconds = 0.0;
+	};
+
+	PerformanceProfiler();
+
+	~PerformanceProfiler();
+
+	/** Registers a name and returns the handle for it. 
+	
+		This allocates, so don't call it on the audio thread. Registering the same name twice returns the same id.
+	*/
+	Source registerSource(const String& name, Category c);
+
+	/** Starts capturing the events. 
+
+		This clears the data from the last capture. If maxLengthSeconds is bigger than zero, the capture stops
+		automatically after this time. Call this from the message thread.
+	*/
+	void startCapture(double maxLengthSeconds=0.0);
+
+	/** Stops the capture and collects the remaining events. */
+	void stopCapture();
+
+	bool isCapturing() const noexcept { return capturing.load(std::memory_order_acquire); }
+
+	/** Returns the statistics for all sources that were called during the last capture (sorted by their self time). */
+	Array<Statistics> getStatistics() const;
+
+	/** Creates a readable table of the most expensive sources. */
+	String createSummary(int maxNumSources=20) const;
+
+	/** Creates the captured events as Chrome trace event JSON. */
+	String createChromeTrace() const;
+
+	/** Writes the Chrome trace event JSON to the given file. */
+	Result exportChromeTrace(const File& targetFile) const;
+
+	/** Returns the number of events that were lost because a buffer was full (or there were too many threads). */
+	int64 getNumDroppedEvents() const noexcept { return numDroppedEvents.load(); }
+
+	static String getCategoryName(Category c);
+
+	/** This is called by the ScopedEvent. Returns false if the event couldn't be written. */
+	bool addEvent(int sourceId, bool isBegin) noexcept;
+
+private:
+
+	struct Event
+	{
+		int32 sourceId;
+		int32 isBegin;
+		int64 ticks;
+	};
+
+	struct CapturedEvent
+	{
+		int32 sourceId;
+		int32 threadIndex;
+		int64 startTicks;
+		int64 durationTicks;
+	};
+
+	struct OpenScope
+	{
+		int32 sourceId;
+		int64 startTicks;
+		int64 childTicks;
+	};
+
+	struct ThreadBuffer
+	{
+		std::atomic<void*> owner;
+		std::atomic<uint32> writePosition;
+		std::atomic<uint32> readPosition;
+		HeapBlock<Event> events;
+
+		// These are only used by the collecting thread
+		OpenScope stack[MaxStackDepth];
+		int stackDepth = 0;
+	};
+
+	struct SourceInfo
+	{
+		String name;
+		String escapedName;
+		Category category;
+	};
+
+	struct CollectorThread : public Thread
+	{
+		CollectorThread(PerformanceProfiler& p) :
+			Thread("Profiler Event Collector"),
+			parent(p)
+		{};
+
+		void run() override;
+
+		PerformanceProfiler& parent;
+	};
+
+	ThreadBuffer* getBufferForCurrentThread() noexcept;
+
+	void collectEvents();
+
+	void processEvent(int threadIndex, ThreadBuffer& b, const Event& e, int numSources);
+
+	const int instanceIndex;
+	std::atomic<int> captureIndex;
+
+	std::atomic<bool> capturing;
+	std::atomic<int64> numDroppedEvents;
+
+	ThreadBuffer threadBuffers[NumThreadSlots];
+
+	CriticalSection sourceLock;
+	Array<SourceInfo> sources;
+	HashMap<String, int> sourceIds;
+
+	CriticalSection dataLock;
+	Array<CapturedEvent> capturedEvents;
+	Array<Statistics> statistics;
+	int64 captureStartTicks = 0;
+	int64 maxCaptureTicks = 0;
+
+	CollectorThread collector;
+
+	JUCE_DECLARE_NON_COPYABLE(PerformanceProfiler);
+};
+
+#if HISE_ENABLE_PROFILER
+#define PROFILE_SCOPE(source) PerformanceProfiler::ScopedEvent scopedProfilerEvent(source)
+#else
+#define PROFILE_SCOPE(source)
+#endif
+
+}
+
+#endif
@@ -56,6 +56,8 @@
 #include "DepentUtilityFunctions.cpp"
 
 #include "UtilityClasses.cpp"
+#include "AudioThreadInstrumentation.cpp"
+#include "PerformanceProfiler.cpp"
 #include "DebugLogger.cpp"
 #include "ThreadWithQuasiModalProgressWindow.cpp"
 #include "ExternalFilePool.cpp"
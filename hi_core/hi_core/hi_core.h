@@ -77,6 +77,8 @@
 */
 #include "UtilityClasses.h"
 
+#include "AudioThreadInstrumentation.h"
+#include "PerformanceProfiler.h"
 #include "DebugLogger.h"
 #include "ThreadWithQuasiModalProgressWindow.h"
 #include "Popup.h"
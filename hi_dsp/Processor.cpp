@@ -72,6 +72,8 @@ Processor::Processor(MainController *m, const String &id_, int numVoices_) :
 		idAsIdentifier = Identifier(id);
 	}
 
+	profilerSource = getMainController()->getPerformanceProfiler().registerSource(id, PerformanceProfiler::Category::Processor);
+
 	enablePooledUpdate(getMainController()->getGlobalUIUpdater());
 
 	//enableAllocationFreeMessages(50);
@@ -423,6 +423,8 @@ public:
 			idAsIdentifier = Identifier();
 		}
 
+		profilerSource = getMainController()->getPerformanceProfiler().registerSource(id, PerformanceProfiler::Category::Processor);
+
 		sendChangeMessage();
 
 		if (notifyChangeHandler)
@@ -435,6 +437,9 @@ public:
 		return idAsIdentifier;
 	}
 
+	/** Returns the handle that is used to profile the rendering of this Processor (see PerformanceProfiler). */
+	const PerformanceProfiler::Source& getProfilerSource() const noexcept { return profilerSource; }
+
 	/** This bypasses the processor. You don't have to check in the processors logic itself, normally the chain should do that for you. */
 	virtual void setBypassed(bool shouldBeBypassed, NotificationType notifyChangeHandler=dontSendNotification) noexcept 
 	{ 
@@ -968,6 +973,8 @@ private:
 	String id;
 
 	Identifier idAsIdentifier;
+
+	PerformanceProfiler::Source profilerSource;
 };
 
 
@@ -58,6 +58,7 @@
 #include "modules/MidiPlayer.cpp"
 #include "modules/EffectProcessor.cpp"
 #include "modules/EffectProcessorChain.cpp"
+#include "modules/VoiceStealing.cpp"
 #include "modules/ModulatorSynth.cpp"
 #include "modules/ModulatorSynthChain.cpp"
 #include "modules/ModulatorSynthGroup.cpp"
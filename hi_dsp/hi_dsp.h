@@ -104,6 +104,7 @@ class ProcessorEditor;
 #include "modules/EffectProcessor.h"
 #include "modules/EffectProcessorChain.h"
 
+#include "modules/VoiceStealing.h"
 #include "modules/ModulatorSynth.h"
 #include "modules/ModulatorSynthChain.h"
 #include "modules/ModulatorSynthGroup.h"
@@ -0,0 +1,451 @@
+/*
+  ==============================================================================
+
+    DspCoreModules.cpp
+    Created: 10 Jul 2016 1:00:04pm
+    Author:  Christoph
+
+  ==============================================================================
+*/
+
+namespace hise { using namespace juce;
+
+void ModulatedDelayLine::setMaxDelaySamples(int newMaxDelayInSamples, int newMaxBlockSize)
+{
+	jassert(newMaxDelayInSamples >= 0);
+	jassert(newMaxBlockSize > 0);
+
+	maxDelay = newMaxDelayInSamples;
+	maxBlockSize = newMaxBlockSize;
+
+	// The read after a push looks back by the block size, the delay time and
+	// the samples before the read position that the interpolation needs.
+	const int newSize = nextPowerOfTwo(maxDelay + maxBlockSize + 4);
+
+	if (newSize != size)
+	{
+		size = newSize;
+		mask = size - 1;
+		buffer.allocate(size, true);
+		writeIndex = 0;
+	}
+}
+
+void ModulatedDelayLine::clear() noexcept
+{
+	if (buffer != nullptr)
+		FloatVectorOperations::clear(buffer, size);
+
+	writeIndex = 0;
+}
+
+void ModulatedDelayLine::pushBlock(const float* input, int numSamples) noexcept
+{
+	jassert(buffer != nullptr);
+	jassert(numSamples <= size);
+
+	const int numBeforeWrap = jmin(numSamples, size - writeIndex);
+
+	FloatVectorOperations::copy(buffer + writeIndex, input, numBeforeWrap);
+
+	if (numBeforeWrap < numSamples)
+		FloatVectorOperations::copy(buffer, input + numBeforeWrap, numSamples - numBeforeWrap);
+
+	writeIndex = (writeIndex + numSamples) & mask;
+}
+
+void ModulatedDelayLine::readBlock(float* output, const float* delayInSamples, int numSamples, Tap& tap, ReadPosition position) const noexcept
+{
+	jassert(buffer != nullptr);
+	jassert(position == ReadPosition::BeforePush || numSamples <= maxBlockSize);
+
+	int origin = getBlockOrigin(numSamples, position);
+
+	while (numSamples > 0)
+	{
+		const int numThisTime = jmin(numSamples, (int)ChunkSize);
+
+		readModulated(output, delayInSamples, numThisTime, origin, tap);
+
+		output += numThisTime;
+		delayInSamples += numThisTime;
+		origin += numThisTime;
+		numSamples -= numThisTime;
+	}
+}
+
+void ModulatedDelayLine::readBlock(float* output, float delayInSamples, int numSamples, Tap& tap, ReadPosition position) const noexcept
+{
+	jassert(buffer != nullptr);
+	jassert(position == ReadPosition::BeforePush || numSamples <= maxBlockSize);
+
+	if (numSamples > 0)
+		readConstant(output, delayInSamples, numSamples, getBlockOrigin(numSamples, position), tap);
+}
+
+void ModulatedDelayLine::readStereoBlock(const ModulatedDelayLine& left, const ModulatedDelayLine& right, float** output, const float* delayInSamples, int numSamples, Tap& leftTap, Tap& rightTap, ReadPosition position) noexcept
+{
+	jassert(left.buffer != nullptr && right.buffer != nullptr);
+	jassert(left.size == right.size && left.writeIndex == right.writeIndex);
+	jassert(left.interpolation == right.interpolation && left.maxDelay == right.maxDelay);
+	jassert(position == ReadPosition::BeforePush || numSamples <= left.maxBlockSize);
+
+	if (numSamples <= 0)
+		return;
+
+	const int origin = left.getBlockOrigin(numSamples, position);
+
+	if (left.interpolation != Interpolation::Linear && left.interpolation != Interpolation::None)
+	{
+		left.readBlock(output[0], delayInSamples, numSamples, leftTap, position);
+		right.readBlock(output[1], delayInSamples, numSamples, rightTap, position);
+		return;
+	}
+
+	const float* l = left.buffer.get();
+	const float* r = right.buffer.get();
+	float* outL = output[0];
+	float* outR = output[1];
+	const int m = left.mask;
+	const float maxD = (float)left.maxDelay;
+
+	if (left.interpolation == Interpolation::None)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			const int index = (origin + i - (int)jmax(0.0f, jmin(maxD, delayInSamples[i]))) & m;
+
+			outL[i] = l[index];
+			outR[i] = r[index];
+		}
+	}
+	else
+	{
+		// Same as the mono linear read in readModulated()
+		for (int i = 0; i < numSamples; i++)
+		{
+			const float delay = jmax(0.0f, jmin(maxD, delayInSamples[i]));
+			const int integerDelay = (int)delay;
+			const int index = origin + i - integerDelay - 1;
+			const float alpha = 1.0f - (delay - (float)integerDelay);
+
+			const int i0 = index & m;
+			const int i1 = (index + 1) & m;
+
+			const float l0 = l[i0];
+			const float r0 = r[i0];
+
+			outL[i] = l0 + alpha * (l[i1] - l0);
+			outR[i] = r0 + alpha * (r[i1] - r0);
+		}
+	}
+
+	leftTap.lastOutput = outL[numSamples - 1];
+	rightTap.lastOutput = outR[numSamples - 1];
+}
+
+void ModulatedDelayLine::readModulated(float* output, const float* delayInSamples, int numSamples, int origin, Tap& tap) const noexcept
+{
+	jassert(numSamples <= ChunkSize);
+
+	switch (interpolation)
+	{
+	case Interpolation::None:
+	{
+		for (int i = 0; i < numSamples; i++)
+			output[i] = buffer[(origin + i - (int)limitDelay(delayInSamples[i])) & mask];
+
+		break;
+	}
+	case Interpolation::Linear:
+	{
+		const float* data = buffer.get();
+		const int m = mask;
+		const float maxD = (float)maxDelay;
+
+		// The delay is positive, so we can truncate it instead of using floor() on the read
+		// position. This results in alpha = 1 for integer delay times.
+		for (int i = 0; i < numSamples; i++)
+		{
+			const float delay = jmax(0.0f, jmin(maxD, delayInSamples[i]));
+			const int integerDelay = (int)delay;
+			const int index = origin + i - integerDelay - 1;
+			const float alpha = 1.0f - (delay - (float)integerDelay);
+
+			const float x0 = data[index & m];
+			const float x1 = data[(index + 1) & m];
+
+			output[i] = x0 + alpha * (x1 - x0);
+		}
+
+		break;
+	}
+	case Interpolation::Lagrange:	readLagrange(output, delayInSamples, numSamples, origin); break;
+	case Interpolation::Allpass:	readAllpass(output, delayInSamples, numSamples, origin, tap); return;
+	default:						jassertfalse; break;
+	}
+
+	tap.lastOutput = output[numSamples - 1];
+}
+
+void ModulatedDelayLine::readLagrange(float* output, const float* delayInSamples, int numSamples, int origin) const noexcept
+{
+	using SSEFloat = dsp::SIMDRegister<float>;
+
+	constexpr int sseSize = SSEFloat::SIMDRegisterSize / sizeof(float);
+
+	static_assert(ChunkSize % sseSize == 0, "chunk size must be a multiple of the SIMD register size");
+
+	const int numRounded = (numSamples + sseSize - 1) / sseSize * sseSize;
+
+	alignas(32) float alpha[ChunkSize];
+	alignas(32) float xm1[ChunkSize];
+	alignas(32) float x0[ChunkSize];
+	alignas(32) float x1[ChunkSize];
+	alignas(32) float x2[ChunkSize];
+	alignas(32) float result[ChunkSize];
+
+	// Gather the four samples around every read position first, so that the
+	// polynomial can be evaluated with SIMD instructions on contiguous memory.
+	for (int i = 0; i < numSamples; i++)
+	{
+		const float delay = limitDelay(delayInSamples[i]);
+		const int integerDelay = (int)delay;
+		const int index = origin + i - integerDelay - 1;
+
+		alpha[i] = 1.0f - (delay - (float)integerDelay);
+		xm1[i] = buffer[(index - 1) & mask];
+		x0[i] = buffer[index & mask];
+		x1[i] = buffer[(index + 1) & mask];
+		x2[i] = buffer[(index + 2) & mask];
+	}
+
+	for (int i = numSamples; i < numRounded; i++)
+	{
+		alpha[i] = 0.0f;
+		xm1[i] = 0.0f;
+		x0[i] = 0.0f;
+		x1[i] = 0.0f;
+		x2[i] = 0.0f;
+	}
+
+	const auto zero = SSEFloat::expand(0.0f);
+	const auto one = SSEFloat::expand(1.0f);
+	const auto two = SSEFloat::expand(2.0f);
+	const auto half = SSEFloat::expand(0.5f);
+	const auto sixth = SSEFloat::expand(1.0f / 6.0f);
+
+	for (int i = 0; i < numRounded; i += sseSize)
+	{
+		const auto a = SSEFloat::fromRawArray(alpha + i);
+		const auto am1 = a - one;
+		const auto am2 = a - two;
+		const auto ap1 = a + one;
+
+		const auto cm1 = zero - a * am1 * am2 * sixth;
+		const auto c0 = ap1 * am1 * am2 * half;
+		const auto c1 = zero - ap1 * a * am2 * half;
+		const auto c2 = ap1 * a * am1 * sixth;
+
+		const auto y = SSEFloat::fromRawArray(xm1 + i) * cm1 +
+					   SSEFloat::fromRawArray(x0 + i) * c0 +
+					   SSEFloat::fromRawArray(x1 + i) * c1 +
+					   SSEFloat::fromRawArray(x2 + i) * c2;
+
+		y.copyToRawArray(result + i);
+	}
+
+	FloatVectorOperations::copy(output, result, numSamples);
+}
+
+void ModulatedDelayLine::readAllpass(float* output, const float* delayInSamples, int numSamples, int origin, Tap& tap) const noexcept
+{
+	float y = tap.lastOutput;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		const float delay = limitDelay(delayInSamples[i]);
+		const int integerDelay = (int)delay;
+		const int index = origin + i - integerDelay;
+		const float fraction = delay - (float)integerDelay;
+
+		if (fraction == 0.0f)
+		{
+			y = buffer[index & mask];
+		}
+		else
+		{
+			// the newer sample is delayed by 1 - eta / 1 + eta
+			const float alpha = 1.0f - fraction;
+			const float eta = alpha / (2.0f - alpha);
+
+			y = eta * (buffer[index & mask] - y) + buffer[(index - 1) & mask];
+		}
+
+		output[i] = y;
+	}
+
+	tap.lastOutput = y;
+}
+
+void ModulatedDelayLine::readConstant(float* output, float delayInSamples, int numSamples, int origin, Tap& tap) const noexcept
+{
+	delayInSamples = limitDelay(delayInSamples);
+
+	if (interpolation == Interpolation::None)
+	{
+		addSegment(output, origin - (int)delayInSamples, numSamples, 1.0f, true);
+		tap.lastOutput = output[numSamples - 1];
+		return;
+	}
+
+	const float integerPosition = std::floor(-delayInSamples);
+	const float a = -delayInSamples - integerPosition;
+	const int index = origin + (int)integerPosition;
+
+	switch (interpolation)
+	{
+	case Interpolation::Linear:
+	{
+		addSegment(output, index, numSamples, 1.0f - a, true);
+
+		if (a != 0.0f)
+			addSegment(output, index + 1, numSamples, a, false);
+
+		tap.lastOutput = output[numSamples - 1];
+		break;
+	}
+	case Interpolation::Lagrange:
+	{
+		addSegment(output, index - 1, numSamples, -a * (a - 1.0f) * (a - 2.0f) / 6.0f, true);
+		addSegment(output, index, numSamples, (a + 1.0f) * (a - 1.0f) * (a - 2.0f) * 0.5f, false);
+		addSegment(output, index + 1, numSamples, -(a + 1.0f) * a * (a - 2.0f) * 0.5f, false);
+		addSegment(output, index + 2, numSamples, (a + 1.0f) * a * (a - 1.0f) / 6.0f, false);
+
+		tap.lastOutput = output[numSamples - 1];
+		break;
+	}
+	case Interpolation::Allpass:
+	{
+		const float eta = a / (2.0f - a);
+		float y = tap.lastOutput;
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			const int thisIndex = index + i;
+			y = eta * (buffer[(thisIndex + 1) & mask] - y) + buffer[thisIndex & mask];
+			output[i] = y;
+		}
+
+		tap.lastOutput = y;
+		break;
+	}
+	default:
+		jassertfalse;
+		break;
+	}
+}
+
+void ModulatedDelayLine::addSegment(float* output, int index, int numSamples, float gain, bool overwrite) const noexcept
+{
+	index &= mask;
+
+	const int numBeforeWrap = jmin(numSamples, size - index);
+
+	if (overwrite)
+	{
+		FloatVectorOperations::copyWithMultiply(output, buffer + index, gain, numBeforeWrap);
+
+		if (numBeforeWrap < numSamples)
+			FloatVectorOperations::copyWithMultiply(output + numBeforeWrap, buffer, gain, numSamples - numBeforeWrap);
+	}
+	else
+	{
+		FloatVectorOperations::addWithMultiply(output, buffer + index, gain, numBeforeWrap);
+
+		if (numBeforeWrap < numSamples)
+			FloatVectorOperations::addWithMultiply(output + numBeforeWrap, buffer, gain, numSamples - numBeforeWrap);
+	}
+}
+
+void ModulatedDelayLine::CrossfadeTap::reset() noexcept
+{
+	currentDelay = targetDelay;
+	oldDelay = targetDelay;
+	fadeCounter = -1;
+
+	currentTap.reset();
+	oldTap.reset();
+}
+
+float ModulatedDelayLine::CrossfadeTap::getMinimumDelay() const noexcept
+{
+	const float d = jmin(currentDelay, targetDelay);
+
+	return fadeCounter >= 0 ? jmin(d, oldDelay) : d;
+}
+
+void ModulatedDelayLine::CrossfadeTap::read(const ModulatedDelayLine& delayLine, float* output, int numSamples, ReadPosition position) noexcept
+{
+	jassert(delayLine.buffer != nullptr);
+
+	int origin = delayLine.getBlockOrigin(numSamples, position);
+
+	while (numSamples > 0)
+	{
+		startFadeIfRequired();
+
+		if (fadeCounter < 0)
+		{
+			delayLine.readConstant(output, currentDelay, numSamples, origin, currentTap);
+			return;
+		}
+
+		const int numThisTime = jmin(numSamples, fadeTimeSamples - fadeCounter, (int)ChunkSize);
+
+		float oldValues[ChunkSize];
+		float ramp[ChunkSize];
+
+		delayLine.readConstant(oldValues, oldDelay, numThisTime, origin, oldTap);
+		delayLine.readConstant(output, currentDelay, numThisTime, origin, currentTap);
+
+		const float delta = 1.0f / (float)fadeTimeSamples;
+		const float start = (float)fadeCounter * delta;
+
+		for (int i = 0; i < numThisTime; i++)
+			ramp[i] = start + (float)i * delta;
+
+		// output = old + (new - old) * ramp
+		FloatVectorOperations::subtract(output, oldValues, numThisTime);
+		FloatVectorOperations::multiply(output, ramp, numThisTime);
+		FloatVectorOperations::add(output, oldValues, numThisTime);
+
+		fadeCounter += numThisTime;
+
+		if (fadeCounter >= fadeTimeSamples)
+			fadeCounter = -1;
+
+		output += numThisTime;
+		origin += numThisTime;
+		numSamples -= numThisTime;
+	}
+}
+
+void ModulatedDelayLine::CrossfadeTap::startFadeIfRequired() noexcept
+{
+	if (fadeCounter >= 0 || targetDelay == currentDelay)
+		return;
+
+	if (fadeTimeSamples == 0)
+	{
+		currentDelay = targetDelay;
+		return;
+	}
+
+	oldDelay = currentDelay;
+	oldTap = currentTap;
+	currentDelay = targetDelay;
+	fadeCounter = 0;
+}
+
+} // namespace hise
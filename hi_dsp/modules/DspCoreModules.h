@@ -212,6 +212,181 @@ private:
 };
 
 
+/** A delay line with power-of-two wrapped storage that supports modulated and interpolated reads.
+
+	Unlike the DelayLine class above, the storage is not tied to a read position: you push
+	blocks of samples into the buffer and read them back with any number of taps, each
+	with a constant delay time or a delay time for every sample (eg. the voices of a chorus).
+
+	The delay time is measured from the position where the sample at the same block index
+	was written, so a delay of zero returns the input signal if you read after pushing
+	the block. In a feedback loop you have to read before you push the block, which only
+	works if the block is shorter than the delay time, so use getMaxFeedbackBlockSize()
+	to split the buffer into blocks that are short enough.
+
+	The modulated lagrange read gathers the samples in chunks and evaluates the polynomial with
+	SIMD instructions. The linear interpolation is cheap enough to be calculated in the gather loop,
+	so the cost of an additional tap is mostly the memory access.
+*/
+class ModulatedDelayLine
+{
+public:
+
+	enum class Interpolation
+	{
+		None = 0, ///< truncates the delay time to the sample before
+		Linear, ///< linear interpolation between two samples (the default)
+		Lagrange, ///< third order lagrange interpolation using four samples
+		Allpass, ///< first order allpass interpolation (flat frequency response, but it has a state per tap)
+		numInterpolationTypes
+	};
+
+	/** Tells the read functions where the current block is located in the buffer. */
+	enum class ReadPosition
+	{
+		AfterPush = 0, ///< the block was already pushed into the delay line
+		BeforePush ///< the block will be pushed after the read (used in feedback loops)
+	};
+
+	/** The state of a single read position.
+
+		Every tap that reads from a delay line needs its own object because the allpass interpolation is recursive.
+	*/
+	struct Tap
+	{
+		void reset() noexcept { lastOutput = 0.0f; }
+
+		float lastOutput = 0.0f;
+	};
+
+	/** A tap with a constant delay time that fades to a new delay time instead of modulating the read position.
+
+		This is used for echo delays, where modulating the read position would create a pitch glide.
+		If the delay time changes while a fade is pending, the fade to the latest value starts after
+		the current one is finished.
+	*/
+	struct CrossfadeTap
+	{
+		/** Sets the delay time. The audio thread starts the fade at the next read. */
+		void setDelayTimeSamples(float newDelayInSamples) noexcept { targetDelay = jmax(0.0f, newDelayInSamples); }
+
+		/** Sets the length of the crossfade. Zero switches immediately to the new delay time. */
+		void setFadeTimeSamples(int newFadeTimeInSamples) noexcept { fadeTimeSamples = jmax(0, newFadeTimeInSamples); }
+
+		/** Cancels any pending fade and jumps to the target delay time. */
+		void reset() noexcept;
+
+		/** Returns the shortest delay time that the next read might use. */
+		float getMinimumDelay() const noexcept;
+
+		/** Reads a block from the delay line and applies the crossfade if required. */
+		void read(const ModulatedDelayLine& delayLine, float* output, int numSamples, ReadPosition position) noexcept;
+
+	private:
+
+		void startFadeIfRequired() noexcept;
+
+		Tap currentTap, oldTap;
+
+		float targetDelay = 0.0f;
+		float currentDelay = 0.0f;
+		float oldDelay = 0.0f;
+
+		int fadeCounter = -1;
+		int fadeTimeSamples = 1024;
+	};
+
+	/** The maximum number of samples that are processed in one go by the modulated read. */
+	static constexpr int ChunkSize = 64;
+
+	ModulatedDelayLine() {};
+
+	/** Allocates the storage for the given delay time and the longest block that you want to read after pushing it.
+
+		This does not allocate if the size doesn't change, but you must not call it during processing.
+	*/
+	void setMaxDelaySamples(int newMaxDelayInSamples, int newMaxBlockSize);
+
+	int getMaxDelaySamples() const noexcept { return maxDelay; }
+
+	void setInterpolation(Interpolation newInterpolation) noexcept { interpolation = newInterpolation; }
+
+	Interpolation getInterpolation() const noexcept { return interpolation; }
+
+	/** Returns the shortest delay time that the current interpolation can read without looking ahead of the written samples. */
+	int getMinimumDelay() const noexcept { return interpolation == Interpolation::Lagrange ? 1 : 0; }
+
+	/** Returns the number of samples you can process in a feedback loop if the shortest delay time in the block is minDelayInSamples.
+
+		If this returns zero, you need to push a single sample and read it back with ReadPosition::AfterPush.
+	*/
+	int getMaxFeedbackBlockSize(float minDelayInSamples) const noexcept
+	{
+		return jmax(0, (int)minDelayInSamples - getMinimumDelay());
+	}
+
+	/** Clears the storage. */
+	void clear() noexcept;
+
+	/** Writes a block of samples into the delay line. */
+	void pushBlock(const float* input, int numSamples) noexcept;
+
+	/** Writes a single sample into the delay line. */
+	void pushSample(float input) noexcept
+	{
+		jassert(buffer != nullptr);
+
+		buffer[writeIndex] = input;
+		writeIndex = (writeIndex + 1) & mask;
+	}
+
+	/** Reads a block with a separate delay time for each sample. */
+	void readBlock(float* output, const float* delayInSamples, int numSamples, Tap& tap, ReadPosition position = ReadPosition::AfterPush) const noexcept;
+
+	/** Reads a block with a constant delay time. */
+	void readBlock(float* output, float delayInSamples, int numSamples, Tap& tap, ReadPosition position = ReadPosition::AfterPush) const noexcept;
+
+	/** Reads a block from two delay lines with the same delay time for each sample.
+
+		Both delay lines must have the same size and interpolation and must be written in sync (eg. the channels
+		of a stereo effect). The read positions and the interpolation weights are then calculated once for both
+		channels and the linear interpolation reads both buffers in the same loop.
+	*/
+	static void readStereoBlock(const ModulatedDelayLine& left, const ModulatedDelayLine& right, float** output, const float* delayInSamples, int numSamples, Tap& leftTap, Tap& rightTap, ReadPosition position = ReadPosition::AfterPush) noexcept;
+
+private:
+
+	int getBlockOrigin(int numSamples, ReadPosition position) const noexcept
+	{
+		return position == ReadPosition::AfterPush ? writeIndex - numSamples : writeIndex;
+	}
+
+	void readModulated(float* output, const float* delayInSamples, int numSamples, int origin, Tap& tap) const noexcept;
+	void readLagrange(float* output, const float* delayInSamples, int numSamples, int origin) const noexcept;
+	void readAllpass(float* output, const float* delayInSamples, int numSamples, int origin, Tap& tap) const noexcept;
+	void readConstant(float* output, float delayInSamples, int numSamples, int origin, Tap& tap) const noexcept;
+
+	/** Adds numSamples values starting at the (unwrapped) buffer index to the output. */
+	void addSegment(float* output, int index, int numSamples, float gain, bool overwrite) const noexcept;
+
+	float limitDelay(float delayInSamples) const noexcept
+	{
+		return jlimit((float)getMinimumDelay(), (float)maxDelay, delayInSamples);
+	}
+
+	HeapBlock<float> buffer;
+
+	Interpolation interpolation = Interpolation::Linear;
+
+	int maxDelay = 0;
+	int maxBlockSize = 0;
+	int size = 0;
+	int mask = 0;
+	int writeIndex = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(ModulatedDelayLine);
+};
+
 } // namespace hise
 
 #endif  // DSPCOREMODULES_H_INCLUDED
@@ -32,6 +32,69 @@
 
 namespace hise { using namespace juce;
 
+void EffectOversampler::prepare(int newFactor, FilterType newFilterType, int maxBlockSize, int numChannels/*=2*/)
+{
+	factor = sanitizeFactor(newFactor);
+	filterType = newFilterType;
+
+	ScopedPointer<juce::dsp::Oversampling<float>> newOversampler;
+
+	if (factor > 1)
+	{
+		using OversamplingType = juce::dsp::Oversampling<float>;
+
+		auto type = filterType == LinearPhaseFIR ? OversamplingType::filterHalfBandFIREquiripple :
+												   OversamplingType::filterHalfBandPolyphaseIIR;
+
+		auto order = (size_t)roundToInt(std::log2((double)factor));
+
+		newOversampler = new OversamplingType((size_t)numChannels, order, type, true);
+		newOversampler->initProcessing((size_t)maxBlockSize);
+	}
+
+	latency = newOversampler != nullptr ? roundToInt(newOversampler->getLatencyInSamples()) : 0;
+
+	oversampler.swapWith(newOversampler);
+}
+
+void EffectOversampler::reset()
+{
+	if (oversampler != nullptr)
+		oversampler->reset();
+}
+
+AudioSampleBuffer EffectOversampler::processUp(AudioSampleBuffer& b, int numSamples) noexcept
+{
+	jassert(isActive());
+
+	dsp::AudioBlock<float> block(b.getArrayOfWritePointers(), (size_t)b.getNumChannels(), (size_t)numSamples);
+	auto upsampled = oversampler->processSamplesUp(block);
+
+	jassert(upsampled.getNumChannels() == 2);
+
+	float* channels[2] = { upsampled.getChannelPointer(0), upsampled.getChannelPointer(1) };
+
+	return AudioSampleBuffer(channels, 2, (int)upsampled.getNumSamples());
+}
+
+void EffectOversampler::processDown(AudioSampleBuffer& b, int numSamples) noexcept
+{
+	jassert(isActive());
+
+	dsp::AudioBlock<float> block(b.getArrayOfWritePointers(), (size_t)b.getNumChannels(), (size_t)numSamples);
+	oversampler->processSamplesDown(block);
+}
+
+int EffectOversampler::sanitizeFactor(int factor) noexcept
+{
+	return jlimit(1, MaxFactor, nextPowerOfTwo(jmax(1, factor)));
+}
+
+juce::StringArray EffectOversampler::getFilterTypeNames()
+{
+	return { "Minimum Phase IIR", "Linear Phase FIR" };
+}
+
 
 bool EffectProcessor::isSilent(AudioSampleBuffer& b, int startSample, int numSamples)
 {
@@ -127,4 +190,53 @@ void MasterEffectProcessor::setSoftBypass(bool shouldBeSoftBypassed, bool useRam
 	}
 }
 
+void MasterEffectProcessor::setOversampling(int newFactor, EffectOversampler::FilterType newFilterType)
+{
+	newFactor = supportsOversampling() ? EffectOversampler::sanitizeFactor(newFactor) : 1;
+
+	if (newFactor == oversamplingFactor && newFilterType == oversamplingFilter)
+		return;
+
+	if (getSampleRate() <= 0.0)
+	{
+		// The oversampler will be created in the next prepareToPlay call
+		oversamplingFactor = newFactor;
+		oversamplingFilter = newFilterType;
+		return;
+	}
+
+	auto f = [newFactor, newFilterType](Processor* p)
+	{
+		auto fx = static_cast<MasterEffectProcessor*>(p);
+
+		{
+			ScopedLock sl(p->getMainController()->getLock());
+
+			fx->oversamplingFactor = newFactor;
+			fx->oversamplingFilter = newFilterType;
+			fx->prepareToPlay(fx->getSampleRate(), fx->getLargestBlockSize());
+		}
+
+		p->getMainController()->triggerEffectLatencyUpdate();
+
+		return SafeFunctionCall::OK;
+	};
+
+	getMainController()->getKillStateHandler().killVoicesAndCall(this, f, MainController::KillStateHandler::TargetThread::SampleLoadingThread);
+}
+
+void MasterEffectProcessor::applyEffectWithOversampling(AudioSampleBuffer& stereoBuffer, int numSamples)
+{
+	if (oversampler.isActive())
+	{
+		auto oversampledBuffer = oversampler.processUp(stereoBuffer, numSamples);
+		applyEffect(oversampledBuffer, 0, oversampledBuffer.getNumSamples());
+		oversampler.processDown(stereoBuffer, numSamples);
+	}
+	else
+	{
+		applyEffect(stereoBuffer, 0, numSamples);
+	}
+}
+
 } // namespace hise
@@ -39,6 +39,61 @@ namespace hise { using namespace juce;
 
 #define EFFECT_PROCESSOR_COLOUR 0xff3a6666
 
+/** A wrapper around juce::dsp::Oversampling that renders a MasterEffectProcessor at a higher samplerate.
+*
+*	It upsamples the stereo buffer, lets the effect process the oversampled data and filters it back down
+*	to the original samplerate. You can choose between the polyphase IIR filters (minimum phase with a
+*	latency of a few samples) and the equiripple FIR filters (linear phase, but with a higher latency).
+*/
+class EffectOversampler
+{
+public:
+
+	enum FilterType
+	{
+		MinimumPhaseIIR = 0,
+		LinearPhaseFIR,
+		numFilterTypes
+	};
+
+	static constexpr int MaxFactor = 16;
+
+	/** Creates the filters for the given factor (1 deactivates the oversampling). This allocates, so don't call it in the audio thread. */
+	void prepare(int newFactor, FilterType newFilterType, int maxBlockSize, int numChannels=2);
+
+	/** Clears the filter states. */
+	void reset();
+
+	bool isActive() const noexcept { return oversampler != nullptr; }
+
+	/** The factor of the filters that were created with prepare(). */
+	int getFactor() const noexcept { return isActive() ? factor : 1; }
+
+	FilterType getFilterType() const noexcept { return filterType; }
+
+	/** The latency of the up- and downsampling filters at the original samplerate. */
+	int getLatencySamples() const noexcept { return latency; }
+
+	/** Upsamples the given range and returns a buffer that refers to the internal (oversampled) data. */
+	AudioSampleBuffer processUp(AudioSampleBuffer& b, int numSamples) noexcept;
+
+	/** Downsamples the internal data into the given buffer. */
+	void processDown(AudioSampleBuffer& b, int numSamples) noexcept;
+
+	/** Returns a valid factor between 1 and MaxFactor (rounded to the next power of two). */
+	static int sanitizeFactor(int factor) noexcept;
+
+	static StringArray getFilterTypeNames();
+
+private:
+
+	ScopedPointer<juce::dsp::Oversampling<float>> oversampler;
+
+	int factor = 1;
+	FilterType filterType = MinimumPhaseIIR;
+	int latency = 0;
+};
+
 /** Base class for all Processors that applies a audio effect on the audio data. 
 *	
 *
@@ -208,6 +263,12 @@ public:
 		ValueTree v = Processor::exportAsValueTree();
 		v.addChild(getMatrix().exportAsValueTree(), -1, nullptr);
 
+		if (oversamplingFactor != 1)
+		{
+			v.setProperty("Oversampling", oversamplingFactor, nullptr);
+			v.setProperty("OversamplingFilter", (int)oversamplingFilter, nullptr);
+		}
+
 		return v;
 	}
 
@@ -221,12 +282,20 @@ public:
 		{
 			getMatrix().restoreFromValueTree(r);
 		}
+
+		auto filter = jlimit<int>(0, EffectOversampler::numFilterTypes - 1, v.getProperty("OversamplingFilter", 0));
+		setOversampling(v.getProperty("Oversampling", 1), (EffectOversampler::FilterType)filter);
 	}
 
 	void setBypassed(bool shouldBeBypassed, NotificationType notifyChangeHandler/* =dontSendNotification */) noexcept override
 	{
+		const bool changed = shouldBeBypassed != isBypassed();
+
 		Processor::setBypassed(shouldBeBypassed, notifyChangeHandler);
 		setSoftBypass(shouldBeBypassed, getMainController()->shouldUseSoftBypassRamps());
+
+		if (changed && getLatencySamples() > 0)
+			getMainController()->triggerEffectLatencyUpdate();
 	}
 
 	virtual bool isFadeOutPending() const noexcept;
@@ -279,9 +348,36 @@ public:
 		EffectProcessor::prepareToPlay(sampleRate, samplesPerBlock);
 
 		if (sampleRate > 0.0 && samplesPerBlock > 0)
+		{
 			softBypassRamper.reset(sampleRate / (double)samplesPerBlock, 0.1);
+			oversampler.prepare(oversamplingFactor, oversamplingFilter, samplesPerBlock);
+		}
 	}
 
+	/** Override this and return true if your effect can be rendered at a higher samplerate.
+	*
+	*	If the oversampling is enabled, applyEffect() will be called with the oversampled buffer, so you need to
+	*	use getProcessingSampleRate() for the DSP setup in prepareToPlay() and divide the sample index by
+	*	getOversamplingFactor() when you read the modulation values (they are still rendered at the original samplerate).
+	*/
+	virtual bool supportsOversampling() const { return false; }
+
+	/** Changes the oversampling factor (1, 2, 4, 8 or 16) and the filter type. 
+	*
+	*	This suspends the audio processing of this effect, prepares it again and reports the new latency to the host.
+	*/
+	void setOversampling(int newFactor, EffectOversampler::FilterType newFilterType);
+
+	int getOversamplingFactor() const noexcept { return oversamplingFactor; }
+
+	EffectOversampler::FilterType getOversamplingFilterType() const noexcept { return oversamplingFilter; }
+
+	/** The samplerate that applyEffect() runs at. */
+	double getProcessingSampleRate() const noexcept { return getSampleRate() * (double)oversamplingFactor; }
+
+	/** The amount of samples that this effect delays the signal. */
+	virtual int getLatencySamples() const { return oversampler.getLatencySamples(); }
+
 	void setEventBuffer(HiseEventBuffer* eventBufferFromSynth)
 	{
 		eventBuffer = eventBufferFromSynth;
@@ -347,7 +443,7 @@ public:
 					killBuffer->copyFromWithRamp(i, 0, stereoBuffer.getReadPointer(i), numSamples, start_inv, end_inv);
 				}
 
-				applyEffect(stereoBuffer, 0, samplesToUse);
+				applyEffectWithOversampling(stereoBuffer, samplesToUse);
 				isTailing = !isSilent(stereoBuffer, 0, samplesToUse);
 
 				stereoBuffer.applyGainRamp(0, numSamples, start, end);
@@ -362,6 +458,7 @@ public:
 					if (end < 0.5f)
 					{
 						voicesKilled();
+						oversampler.reset();
 						softBypassState = Bypassed;
 					}
 					else
@@ -375,7 +472,7 @@ public:
 			}
 			else
 			{
-				applyEffect(stereoBuffer, 0, samplesToUse);
+				applyEffectWithOversampling(stereoBuffer, samplesToUse);
 				isTailing = !isSilent(stereoBuffer, 0, samplesToUse);
 
 #if ENABLE_ALL_PEAK_METERS
@@ -416,11 +513,15 @@ protected:
 
 private:
 
-	
+	void applyEffectWithOversampling(AudioSampleBuffer& stereoBuffer, int numSamples);
 
 	SoftBypassState softBypassState = Inactive;
 	LinearSmoothedValue<float> softBypassRamper;
 
+	EffectOversampler oversampler;
+	int oversamplingFactor = 1;
+	EffectOversampler::FilterType oversamplingFilter = EffectOversampler::MinimumPhaseIIR;
+
 	
 };
 
@@ -601,6 +702,21 @@ public:
 		return;
 	}
 
+	/** Override this and return true if the effect can process all voices of a render callback in one go.
+
+		This is only queried for the last voice effect of a synth chain. If it returns true, the synth will
+		call startVoiceBatch(), then renderVoice() for every active voice and renderVoiceBatch() before the
+		voices are added to the output, so renderVoice() may just store the voice data and defer the
+		processing until renderVoiceBatch() is called.
+	*/
+	virtual bool canRenderVoiceBatch() const { return false; }
+
+	/** Called by the synth before the voices of a render callback are calculated. */
+	virtual void startVoiceBatch(int /*startSample*/, int /*numSamples*/) {}
+
+	/** Called by the synth after all voices of a render callback have been calculated. */
+	virtual void renderVoiceBatch() {}
+
 	virtual void startVoice(int voiceIndex, const HiseEvent& e)
 	{
 		ignoreUnused(e);
@@ -55,7 +55,14 @@ void EffectProcessorChain::renderMasterEffects(AudioSampleBuffer &b)
 
 	ADD_GLITCH_DETECTOR(parentProcessor, DebugLogger::Location::MasterEffectRendering);
 
-	FOR_EACH_MASTER_EFFECT(renderWholeBuffer(b));
+	for (auto fx : masterEffects)
+	{
+		if (fx->isSoftBypassed())
+			continue;
+
+		PROFILE_SCOPE(fx->getProfilerSource());
+		fx->renderWholeBuffer(b);
+	}
 
 	const auto prev = resetCounter;
 
@@ -123,6 +130,7 @@ void EffectProcessorChainFactoryType::fillTypeNameList()
 	ADD_NAME_TO_TYPELIST(ShapeFX);
 	ADD_NAME_TO_TYPELIST(PolyshapeFX);
 	ADD_NAME_TO_TYPELIST(MidiMetronome);
+	ADD_NAME_TO_TYPELIST(FdnReverbEffect);
 };
 
 Processor* EffectProcessorChainFactoryType::createProcessor	(int typeIndex, const String &id)
@@ -157,6 +165,7 @@ Processor* EffectProcessorChainFactoryType::createProcessor	(int typeIndex, cons
 	case shapeFX:						return new ShapeFX(m, id);
 	case polyshapeFx:					return new PolyshapeFX(m, id, numVoices);
 	case midiMetronome:					return new MidiMetronome(m, id);
+	case fdnReverb:					return new FdnReverbEffect(m, id);
 	default:					jassertfalse; return nullptr;
 	}
 };
@@ -227,6 +236,12 @@ void EffectProcessorChain::EffectChainHandler::add(Processor *newProcessor, Proc
 		sp->compileScript();
 	}
 
+	if (auto mep = dynamic_cast<MasterEffectProcessor*>(newProcessor))
+	{
+		if (mep->getLatencySamples() > 0)
+			chain->getMainController()->triggerEffectLatencyUpdate();
+	}
+
 	notifyListeners(Listener::ProcessorAdded, newProcessor);
 }
 
@@ -237,6 +252,9 @@ void EffectProcessorChain::EffectChainHandler::remove(Processor *processorToBeRe
 
 	ScopedPointer<Processor> ownedProcessorToRemove = processorToBeRemoved;
 
+	auto mep = dynamic_cast<MasterEffectProcessor*>(processorToBeRemoved);
+	const bool hadLatency = mep != nullptr && mep->getLatencySamples() > 0;
+
 	{
 		auto mc = chain->getMainController();
 
@@ -251,13 +269,16 @@ void EffectProcessorChain::EffectChainHandler::remove(Processor *processorToBeRe
 		chain->allEffects.removeAllInstancesOf(dynamic_cast<EffectProcessor*>(processorToBeRemoved));
 
 		if (auto vep = dynamic_cast<VoiceEffectProcessor*>(processorToBeRemoved))		 chain->voiceEffects.removeObject(vep, false);
-		else if (auto mep = dynamic_cast<MasterEffectProcessor*>(processorToBeRemoved))		 chain->masterEffects.removeObject(mep, false);
+		else if (mep != nullptr)								 chain->masterEffects.removeObject(mep, false);
 		else if (auto moep = dynamic_cast<MonophonicEffectProcessor*>(processorToBeRemoved)) chain->monoEffects.removeObject(moep, false);
 		else jassertfalse;
 
 		jassert(chain->allEffects.size() == (chain->masterEffects.size() + chain->voiceEffects.size() + chain->monoEffects.size()));
 	}
 
+	if (hadLatency)
+		chain->getMainController()->triggerEffectLatencyUpdate();
+
 	if (removeEffect)
 		ownedProcessorToRemove = nullptr;
 	else
@@ -144,6 +144,26 @@ public:
 		return resetCounter > 0;
 	}
 
+	/** Returns the last active voice effect if it can render all voices at once or nullptr.
+
+		@see VoiceEffectProcessor::canRenderVoiceBatch()
+	*/
+	VoiceEffectProcessor* getVoiceBatchEffect() const
+	{
+		if (isBypassed() || renderPolyFxAsMono)
+			return nullptr;
+
+		for (int i = voiceEffects.size() - 1; i >= 0; i--)
+		{
+			if (voiceEffects[i]->isBypassed())
+				continue;
+
+			return voiceEffects[i]->canRenderVoiceBatch() ? voiceEffects[i] : nullptr;
+		}
+
+		return nullptr;
+	}
+
 	bool hasTailingPolyEffects() const
 	{
 		for (int i = 0; i < voiceEffects.size(); i++)
@@ -344,7 +364,8 @@ public:
 		analyser,
 		shapeFX,
 		polyshapeFx,
-		midiMetronome
+		midiMetronome,
+		fdnReverb
 	};
 
 	EffectProcessorChainFactoryType(int numVoices_, Processor *ownerProcessor):
@@ -68,11 +68,46 @@ struct MidiPlayerHelpers
 
 
 
+struct HiseMidiSequence::CompileJob : public ThreadPoolJob
+{
+	CompileJob(HiseMidiSequence& parent_) :
+		ThreadPoolJob("Compile MIDI tracks"),
+		parent(parent_)
+	{}
+
+	JobStatus runJob() override
+	{
+		parent.buildCompiledTracks();
+		return jobHasFinished;
+	}
+
+	struct Selector : public ThreadPool::JobSelector
+	{
+		Selector(HiseMidiSequence* s) : sequence(s) {};
+
+		bool isJobSuitable(ThreadPoolJob* job) override
+		{
+			auto cj = dynamic_cast<CompileJob*>(job);
+			return cj != nullptr && &cj->parent == sequence;
+		}
+
+		HiseMidiSequence* sequence;
+	};
+
+	HiseMidiSequence& parent;
+};
+
 HiseMidiSequence::HiseMidiSequence()
 {
 
 }
 
+HiseMidiSequence::~HiseMidiSequence()
+{
+	CompileJob::Selector s(this);
+	compilePool->removeAllJobs(false, -1, &s);
+}
+
 
 
 juce::ValueTree HiseMidiSequence::exportAsValueTree() const
@@ -129,101 +164,61 @@ void HiseMidiSequence::restoreFromValueTree(const ValueTree &v)
 }
 
 
-juce::MidiMessage* HiseMidiSequence::getNextEvent(Range<double> rangeToLookForTicks)
+HiseMidiSequence::CompiledTrack::CompiledTrack(const MidiMessageSequence& seq, int trackIndex)
 {
-	SimpleReadWriteLock::ScopedReadLock sl(swapLock);
-
-	auto nextIndex = lastPlayedIndex + 1;
+	notes.ensureStorageAllocated(seq.getNumEvents() / 2);
 
-	if (auto seq = getReadPointer(currentTrackIndex))
+	for (auto e : seq)
 	{
-		if (nextIndex >= seq->getNumEvents())
-		{
-			lastPlayedIndex = -1;
-			nextIndex = 0;
-		}
-
-		auto loopEndTicks = getLength() * signature.normalisedLoopRange.getEnd();
-		
+		if (!e->message.isNoteOn())
+			continue;
 
-		auto wrapAroundLoop = rangeToLookForTicks.contains(loopEndTicks);
+		CompiledNote n;
+		n.onTicks = e->message.getTimeStamp();
+		n.noteOn = HiseEvent(e->message);
+		n.noteOn.setArtificial();
+		n.noteOn.setChannel(trackIndex + 1);
 
-		if (wrapAroundLoop)
+		if (auto noteOff = e->noteOffObject)
 		{
-			auto loopStartTicks = getLength() * signature.normalisedLoopRange.getStart();
-			auto rangeEndAfterWrap = rangeToLookForTicks.getEnd() - loopEndTicks + loopStartTicks;
-
-			Range<double> beforeWrap = { rangeToLookForTicks.getStart(), loopEndTicks };
-			Range<double> afterWrap = { loopStartTicks, rangeEndAfterWrap };
-
-			if (auto nextEvent = seq->getEventPointer(nextIndex))
-			{
-				auto ts = nextEvent->message.getTimeStamp();
-
-				if (beforeWrap.contains(ts))
-				{
-					lastPlayedIndex = nextIndex;
-					return &nextEvent->message;
-				}
-				if (afterWrap.contains(ts))
-				{
-					lastPlayedIndex = nextIndex;
-					return &nextEvent->message;
-				}
-
-				// We don't want to wrap around notes that lie within the loop range.
-				if (ts < loopEndTicks)
-					return nullptr;
-			}
+			n.lengthInTicks = jmax(0.0, noteOff->message.getTimeStamp() - n.onTicks);
+			n.noteOff = HiseEvent(noteOff->message);
+			n.noteOff.setArtificial();
+			n.noteOff.setChannel(trackIndex + 1);
+		}
 
-			auto indexAfterWrap = seq->getNextIndexAtTime(loopStartTicks);
+		notes.add(n);
+	}
+}
 
-			if (auto afterEvent = seq->getEventPointer(indexAfterWrap))
-			{
-				while (afterEvent != nullptr && afterEvent->message.isNoteOff())
-				{
-					indexAfterWrap++;
+void HiseMidiSequence::rebuildCompiledTracks()
+{
+	// A job that hasn't started yet will pick up this change, too
+	if (!compileJobPending.exchange(true))
+		compilePool->addJob(new CompileJob(*this), true);
+}
 
-					afterEvent = seq->getEventPointer(indexAfterWrap);
-				}
+void HiseMidiSequence::buildCompiledTracks()
+{
+	// Clear the flag before reading the sequences so that every later change starts another job
+	compileJobPending.store(false);
 
-				if (afterEvent != nullptr)
-				{
-					jassert(afterEvent->message.isNoteOn());
+	OwnedArray<CompiledTrack> newTracks;
+	uint32 builtVersion;
 
-					auto ts = afterEvent->message.getTimeStamp();
+	{
+		SimpleReadWriteLock::ScopedReadLock sl(swapLock);
 
-					if (afterWrap.contains(ts))
-					{
-						lastPlayedIndex = indexAfterWrap;
+		builtVersion = sequenceVersion;
 
-						return &afterEvent->message;
-					}
-				}
-			}
-		}
-		else
-		{
-			if (auto nextEvent = seq->getEventPointer(nextIndex))
-			{
-				if (rangeToLookForTicks.contains(nextEvent->message.getTimeStamp()))
-				{
-					lastPlayedIndex = nextIndex;
-					return &nextEvent->message;
-				}
-			}
-		}
+		for (int i = 0; i < sequences.size(); i++)
+			newTracks.add(new CompiledTrack(*sequences[i], i));
 	}
 
-	return nullptr;
-}
-
-juce::MidiMessage* HiseMidiSequence::getMatchingNoteOffForCurrentEvent()
-{
-	if (auto noteOff = getReadPointer(currentTrackIndex)->getEventPointer(lastPlayedIndex)->noteOffObject)
-		return &noteOff->message;
-
-	return nullptr;
+	// The old tracks are deleted after the lock is released
+	SimpleReadWriteLock::ScopedWriteLock sl(swapLock);
+	newTracks.swapWith(compiledTracks);
+	compiledVersion = builtVersion;
 }
 
 double HiseMidiSequence::getLength() const
@@ -338,7 +333,10 @@ void HiseMidiSequence::loadFrom(const MidiFile& file)
 	{
 		SimpleReadWriteLock::ScopedWriteLock sl(swapLock);
 		newSequences.swapWith(sequences);
+		sequenceVersion++;
 	}
+
+	rebuildCompiledTracks();
 }
 
 void HiseMidiSequence::createEmptyTrack()
@@ -349,8 +347,10 @@ void HiseMidiSequence::createEmptyTrack()
 		SimpleReadWriteLock::ScopedWriteLock sl(swapLock);
 		sequences.add(newTrack.release());
 		currentTrackIndex = sequences.size() - 1;
-		lastPlayedIndex = -1;
+		sequenceVersion++;
 	}
+
+	rebuildCompiledTracks();
 }
 
 juce::File HiseMidiSequence::writeToTempFile()
@@ -408,49 +408,25 @@ int HiseMidiSequence::getNumEvents() const
 
 void HiseMidiSequence::setCurrentTrackIndex(int index)
 {
-	if (isPositiveAndBelow(index, sequences.size()) && index != currentTrackIndex)
-	{
-		double lastTimestamp = 0.0;
-
-		SimpleReadWriteLock::ScopedReadLock sl(swapLock);
-
-		if (lastPlayedIndex != -1)
-			lastTimestamp = getReadPointer(currentTrackIndex)->getEventPointer(lastPlayedIndex)->message.getTimeStamp();
-
-		currentTrackIndex = jlimit<int>(0, sequences.size()-1, index);
-
-		if (lastPlayedIndex != -1)
-			lastPlayedIndex = getReadPointer(currentTrackIndex)->getNextIndexAtTime(lastTimestamp);
-	}
+	// The playback is not stateful, so switching the track doesn't need to look up the position
+	if (isPositiveAndBelow(index, sequences.size()))
+		currentTrackIndex = index;
 }
 
 void HiseMidiSequence::trimInactiveTracks()
 {
-	SimpleReadWriteLock::ScopedWriteLock sl(swapLock);
-
-	auto seqToKeep = sequences.removeAndReturn(currentTrackIndex);
-
-	sequences.clear(true);
-	sequences.add(seqToKeep);
-	currentTrackIndex = 0;
-	resetPlayback();
-}
-
-void HiseMidiSequence::resetPlayback()
-{
-	lastPlayedIndex = -1;
-}
-
-void HiseMidiSequence::setPlaybackPosition(double normalisedPosition)
-{
-	SimpleReadWriteLock::ScopedReadLock sl(swapLock);
-
-	if (auto s = getReadPointer(currentTrackIndex))
 	{
-		auto currentTimestamp = getLength() * normalisedPosition;
+		SimpleReadWriteLock::ScopedWriteLock sl(swapLock);
+
+		auto seqToKeep = sequences.removeAndReturn(currentTrackIndex);
 
-		lastPlayedIndex = s->getNextIndexAtTime(currentTimestamp) - 1;
+		sequences.clear(true);
+		sequences.add(seqToKeep);
+		currentTrackIndex = 0;
+		sequenceVersion++;
 	}
+
+	rebuildCompiledTracks();
 }
 
 juce::RectangleList<float> HiseMidiSequence::getRectangleList(Rectangle<float> targetBounds) const
@@ -563,8 +539,13 @@ Array<HiseEvent> HiseMidiSequence::getEventList(double sampleRate, double bpm)
 
 void HiseMidiSequence::swapCurrentSequence(MidiMessageSequence* sequenceToSwap)
 {
-	SimpleReadWriteLock::ScopedWriteLock sl(swapLock);
-	sequences.set(currentTrackIndex, sequenceToSwap, true);
+	{
+		SimpleReadWriteLock::ScopedWriteLock sl(swapLock);
+		sequences.set(currentTrackIndex, sequenceToSwap, true);
+		sequenceVersion++;
+	}
+
+	rebuildCompiledTracks();
 }
 
 
@@ -679,6 +660,8 @@ void MidiPlayer::EditAction::writeArrayToSequence(HiseMidiSequence::Ptr destinat
 
 MidiPlayer::MidiPlayer(MainController *mc, const String &id, ModulatorSynth* ) :
 	MidiProcessor(mc, id),
+	recordingQueue(HISE_MIDI_RECORDING_QUEUE_SIZE),
+	recordingDrainer(*this),
 	ownedUndoManager(new UndoManager())
 {
 	addAttributeID(Stop);
@@ -691,14 +674,58 @@ MidiPlayer::MidiPlayer(MainController *mc, const String &id, ModulatorSynth* ) :
 	addAttributeID(PlaybackSpeed);
 
 	mc->addTempoListener(this);
-
 }
 
 MidiPlayer::~MidiPlayer()
 {
+	recordingDrainer.stopTimer();
 	getMainController()->removeTempoListener(this);
 }
 
+void MidiPlayer::RecordingQueueDrainer::timerCallback()
+{
+	if (parent.recordingQueue.isEmpty())
+	{
+		// The recording has stopped and everything was fetched
+		if (parent.playState != PlayState::Record)
+			stopTimer();
+
+		return;
+	}
+
+	// Don't block the message thread while the recording is flushed on the background thread
+	ScopedTryLock sl(parent.recordingLock);
+
+	if (sl.isLocked())
+		parent.drainRecordingQueueInternal();
+}
+
+void MidiPlayer::startRecordingDrainer()
+{
+	// This might be called from the audio thread, so we start the timer on the loading thread
+	auto f = [](Processor* p)
+	{
+		static_cast<MidiPlayer*>(p)->recordingDrainer.startTimer(50);
+		return SafeFunctionCall::OK;
+	};
+
+	getMainController()->getSampleManager().addDeferredFunction(this, f);
+}
+
+void MidiPlayer::drainRecordingQueue()
+{
+	ScopedLock sl(recordingLock);
+	drainRecordingQueueInternal();
+}
+
+void MidiPlayer::drainRecordingQueueInternal()
+{
+	HiseEvent e;
+
+	while (recordingQueue.pop(e))
+		currentlyRecordedEvents.add(e);
+}
+
 void MidiPlayer::tempoChanged(double newTempo)
 {
 	ticksPerSample = MidiPlayerHelpers::samplesToTicks(1, newTempo, getSampleRate());
@@ -984,7 +1011,6 @@ void MidiPlayer::preprocessBuffer(HiseEventBuffer& buffer, int numSamples)
 
 		if (playState == PlayState::Stop)
 		{
-			seq->resetPlayback();
 			playState = PlayState::Stop;
 			timeStampForNextCommand = 0;
 			currentPosition = -1.0;
@@ -1019,88 +1045,43 @@ void MidiPlayer::preprocessBuffer(HiseEventBuffer& buffer, int numSamples)
 		else
 			currentRange = { positionInTicks, jmin<double>(lengthInTicks, positionInTicks + tickThisTime) };
 
-		MidiMessage* eventsInThisCallback[16];
-		memset(eventsInThisCallback, 0, sizeof(MidiMessage*) * 16);
-
-		
-
-		while (auto e = seq->getNextEvent(currentRange))
+		if (!isBypassed())
 		{
-			bool found = false;
+			// ticksPerSample is updated in tempoChanged(), so there's no need to recalculate this for every event.
+			const double samplesPerTick = 1.0 / getTicksPerSample();
+			auto& eventHandler = getMainController()->getEventHandler();
 
-			for (int i = 0; i < 16; i++)
+			seq->forEachNoteInRange(currentRange, [&](const HiseMidiSequence::CompiledNote& n, double tickOffset)
 			{
-				if (eventsInThisCallback[i] == e)
-				{
-					found = true;
-					break;
-				}
-
-				if (eventsInThisCallback[i] == nullptr)
-				{
-					eventsInThisCallback[i] = e;
-					break;
-				}
-			}
-
-			if (found)
-				break;
-
-			auto timeStampInThisBuffer = e->getTimeStamp() - positionInTicks;
-
-			timeStampInThisBuffer;
-
-			if (timeStampInThisBuffer < 0.0)
-				timeStampInThisBuffer += getCurrentSequence()->getTimeSignature().normalisedLoopRange.getLength() * lengthInTicks;
-
-			auto timeStamp = (int)MidiPlayerHelpers::ticksToSamples(timeStampInThisBuffer / playbackSpeed, getMainController()->getBpm(), getSampleRate());
-			timeStamp += timeStampForNextCommand;
+				auto timeStamp = (int)(tickOffset * samplesPerTick) + timeStampForNextCommand;
 
-			jassert(isPositiveAndBelow(timeStamp, numSamples));
+				jassert(isPositiveAndBelow(timeStamp, numSamples));
 
-			HiseEvent newEvent(*e);
-
-			newEvent.setTimeStamp(timeStamp);
-			newEvent.setArtificial();
-			newEvent.setChannel(currentTrackIndex + 1);
-
-			if (newEvent.isNoteOn() && !isBypassed())
-			{
-				getMainController()->getEventHandler().pushArtificialNoteOn(newEvent);
+				HiseEvent newEvent(n.noteOn);
+				newEvent.setTimeStamp(timeStamp);
 
+				eventHandler.pushArtificialNoteOn(newEvent);
 				buffer.addEvent(newEvent);
 
-				if (auto noteOff = seq->getMatchingNoteOffForCurrentEvent())
+				if (n.lengthInTicks >= 0.0)
 				{
-					HiseEvent newNoteOff(*noteOff);
-					newNoteOff.setArtificial();
-
-					auto noteOffTimeStampInBuffer = noteOff->getTimeStamp() - positionInTicks;
-					
-					if (noteOffTimeStampInBuffer < 0.0)
-						noteOffTimeStampInBuffer += lengthInTicks;
+					HiseEvent newNoteOff(n.noteOff);
 
-					timeStamp += timeStampForNextCommand;
+					auto noteOffTimeStamp = (int)((tickOffset + n.lengthInTicks) * samplesPerTick) + timeStampForNextCommand;
 
-					auto noteOffTimeStamp = (int)MidiPlayerHelpers::ticksToSamples(noteOffTimeStampInBuffer, getMainController()->getBpm(), getSampleRate());
-
-					newNoteOff.setChannel(currentTrackIndex + 1);
-
-					auto on_id = getMainController()->getEventHandler().getEventIdForNoteOff(newNoteOff);
+					auto on_id = eventHandler.getEventIdForNoteOff(newNoteOff);
 
 					jassert(newEvent.getEventId() == on_id);
 
 					newNoteOff.setEventId(on_id);
 					newNoteOff.setTimeStamp(noteOffTimeStamp);
-					newNoteOff.setTimeStamp(noteOffTimeStamp);
-					
 
 					if (noteOffTimeStamp < numSamples)
 						buffer.addEvent(newNoteOff);
 					else
 						addHiseEventToBuffer(newNoteOff);
 				}
-			}
+			});
 		}
 
 		timeStampForNextCommand = 0;
@@ -1146,7 +1127,10 @@ void MidiPlayer::processHiseEvent(HiseEvent &m) noexcept
 			copy.setChannel(currentTrackIndex + 1);
 			copy.setTimeStamp(timestampSamples);
 
-			currentlyRecordedEvents.add(copy);
+			if (recordingQueue.push(copy))
+				numRecordedEvents.fetch_add(1);
+			else
+				numDroppedEvents.fetch_add(1);
 		}
 	}
 }
@@ -1431,7 +1415,7 @@ bool MidiPlayer::play(int timestamp)
 {
 	sendAllocationFreeChangeMessage();
 
-	if (auto seq = getCurrentSequence())
+	if (getCurrentSequence() != nullptr)
 	{
 		if (isRecording())
 			finishRecording();
@@ -1439,7 +1423,6 @@ bool MidiPlayer::play(int timestamp)
 		{
 			// This allows switching from record to play while maintaining the position
 			currentPosition = 0.0;
-			seq->resetPlayback();
 		}
 			
 		playState = PlayState::Play;
@@ -1459,7 +1442,7 @@ bool MidiPlayer::stop(int timestamp)
 {
 	sendAllocationFreeChangeMessage();
 
-	if (auto seq = getCurrentSequence())
+	if (getCurrentSequence() != nullptr)
 	{
 		if (isRecording())
 			finishRecording();
@@ -1469,10 +1452,6 @@ bool MidiPlayer::stop(int timestamp)
 			addNoteOffsToPendingNoteOns();
 		}
 
-		
-		
-
-		seq->resetPlayback();
 		playState = PlayState::Stop;
 
 		
@@ -1497,9 +1476,6 @@ bool MidiPlayer::record(int timestamp)
 	{
 		currentPosition = 0.0;
 		ticksSincePlaybackStart = 0.0;
-
-		if(auto seq = getCurrentSequence())
-			seq->resetPlayback();
 	}
 
 	playState = PlayState::Record;
@@ -1513,6 +1489,8 @@ bool MidiPlayer::record(int timestamp)
 
 	if (recordState == RecordState::Idle)
 		prepareForRecording(true);
+	else
+		startRecordingDrainer();
 
 	return false;
 }
@@ -1537,8 +1515,21 @@ void MidiPlayer::prepareForRecording(bool copyExistingEvents/*=true*/)
 
 		newEvents.ensureStorageAllocated(2048);
 
-		mp->currentlyRecordedEvents.swapWith(newEvents);
+		{
+			ScopedLock sl(mp->recordingLock);
+
+			// Discard everything that was left over from the last take
+			HiseEvent unused;
+			while (mp->recordingQueue.pop(unused))
+				;
+
+			mp->numRecordedEvents.store(0);
+			mp->numDroppedEvents.store(0);
+			mp->currentlyRecordedEvents.swapWith(newEvents);
+		}
+
 		mp->recordState.store(RecordState::Prepared);
+		mp->recordingDrainer.startTimer(50);
 
 		return SafeFunctionCall::OK;
 	};
@@ -1549,7 +1540,8 @@ void MidiPlayer::prepareForRecording(bool copyExistingEvents/*=true*/)
 
 void MidiPlayer::finishRecording()
 {
-	if (currentlyRecordedEvents.isEmpty())
+	// Nothing was recorded since the last flush, so the sequence doesn't need to be rewritten
+	if (numRecordedEvents.load() == 0)
 		return;
 
 	auto finishPos = currentPosition;
@@ -1558,6 +1550,14 @@ void MidiPlayer::finishRecording()
 	{
 		auto mp = static_cast<MidiPlayer*>(p);
 
+		ScopedLock sl(mp->recordingLock);
+
+		mp->drainRecordingQueueInternal();
+		mp->numRecordedEvents.store(0);
+
+		if (auto numDropped = mp->numDroppedEvents.exchange(0))
+			debugError(mp, String(numDropped) + " recorded events were dropped because the recording queue was full. Increase HISE_MIDI_RECORDING_QUEUE_SIZE");
+
 		auto l = &mp->currentlyRecordedEvents;
 
 		int lastTimestamp = (int)MidiPlayerHelpers::ticksToSamples(mp->getCurrentSequence()->getLength() * finishPos, mp->getMainController()->getBpm(), mp->getSampleRate()) - 1;
@@ -1643,6 +1643,10 @@ hise::HiseMidiSequence::Ptr MidiPlayer::getListOfCurrentlyRecordedEvents()
 {
 	HiseMidiSequence::Ptr recordedList = new HiseMidiSequence();
 	recordedList->createEmptyTrack();
+
+	ScopedLock sl(recordingLock);
+	drainRecordingQueueInternal();
+
 	EditAction::writeArrayToSequence(recordedList, currentlyRecordedEvents, getMainController()->getBpm(), getSampleRate());
 	return recordedList;
 }
@@ -1779,11 +1783,10 @@ bool MidiPlayer::saveAsMidiFile(const String& fileName, int trackIndex)
 
 void MidiPlayer::updatePositionInCurrentSequence(bool ignorePlaybackspeed)
 {
-	if (auto seq = getCurrentSequence())
+	if (getCurrentSequence() != nullptr)
 	{
 		auto newPos = getPlaybackPositionFromTicksSinceStart();
 		currentPosition = newPos;
-		seq->setPlaybackPosition(currentPosition);
 	}
 }
 
@@ -33,6 +33,11 @@
 
 #pragma once
 
+/** The amount of events the audio thread can record before the background thread has to fetch them. */
+#ifndef HISE_MIDI_RECORDING_QUEUE_SIZE
+#define HISE_MIDI_RECORDING_QUEUE_SIZE 8192
+#endif
+
 namespace hise {
 using namespace juce;
 
@@ -130,6 +135,54 @@ public:
 	/** The internal resolution (set to a sensible high default). */
 	static constexpr int TicksPerQuarter = 960;
 
+	/** A note of a compiled track. The events are already converted and only need a timestamp (and the event ID of the note off). */
+	struct CompiledNote
+	{
+		double onTicks = 0.0;
+		double lengthInTicks = -1.0; ///< -1 if the note on has no matching note off
+		HiseEvent noteOn;
+		HiseEvent noteOff;
+	};
+
+	/** A flat playback representation of a track.
+
+		It contains all note on events of the track (with their matching note off) sorted by their 
+		tick position, so the playback can find the notes for a range with a binary search and 
+		iterate over a contiguous slice. It's created on a background thread whenever the tracks change
+		so the audio thread doesn't have to walk the MidiMessageSequence.
+	*/
+	struct CompiledTrack
+	{
+		CompiledTrack(const MidiMessageSequence& seq, int trackIndex);
+
+		/** Returns the index of the first note that starts at or after the given tick position. */
+		int getFirstIndexAtOrAfter(double ticks) const
+		{
+			auto pos = std::lower_bound(notes.begin(), notes.end(), ticks, [](const CompiledNote& n, double t)
+			{
+				return n.onTicks < t;
+			});
+
+			return (int)(pos - notes.begin());
+		}
+
+		/** Calls f for every note within the range with the offset to the range start (plus the given offset). */
+		template <typename F> void forEachNote(Range<double> tickRange, double offsetTicks, const F& f) const
+		{
+			for (int i = getFirstIndexAtOrAfter(tickRange.getStart()); i < notes.size(); i++)
+			{
+				const auto& n = notes.getReference(i);
+
+				if (n.onTicks >= tickRange.getEnd())
+					break;
+
+				f(n, n.onTicks - tickRange.getStart() + offsetTicks);
+			}
+		}
+
+		Array<CompiledNote> notes;
+	};
+
 	/** This object is ref-counted so this can be used as reference pointer. */
 	using Ptr = ReferenceCountedObjectPtr<HiseMidiSequence>;
 
@@ -138,6 +191,9 @@ public:
 	/** Creates an empty new sequence object. */
 	HiseMidiSequence();
 
+	/** Waits until a pending build of the compiled tracks is finished. */
+	~HiseMidiSequence();
+
 	/** Saves the sequence into a ValueTree. It stores the ID and the
 	    data as compressed MIDI file.
 	*/
@@ -146,13 +202,41 @@ public:
 	/** Loads the sequence from the value tree. */
 	void restoreFromValueTree(const ValueTree &v) override;
 
-	/** Gets the next event of the current track in the given range. This also advances the playback pointer
-		so you should only use it in the audio thread for playback. 
+	/** Calls the function for every note of the current track that starts within the given range (wrapping around the loop end).
+
+		The function will be called with the CompiledNote and the tick offset from the start of the range.
+		This only acquires the read lock once and does a binary search into the compiled track, so it's 
+		the method that should be used for playback in the audio thread.
 	*/
-	MidiMessage* getNextEvent(Range<double> rangeToLookForTicks);
+	template <typename F> void forEachNoteInRange(Range<double> rangeToLookForTicks, const F& f) const
+	{
+		SimpleReadWriteLock::ScopedReadLock sl(swapLock);
+
+		// The compiled tracks of an older build don't match the track indexes of the current sequences
+		// so nothing is played until the compile job has caught up.
+		if (compiledVersion != sequenceVersion)
+			return;
+
+		auto track = compiledTracks[currentTrackIndex];
+
+		if (track == nullptr)
+			return;
+
+		auto lengthInTicks = getLength();
+		auto loopEndTicks = lengthInTicks * signature.normalisedLoopRange.getEnd();
+
+		if (rangeToLookForTicks.contains(loopEndTicks))
+		{
+			auto loopStartTicks = lengthInTicks * signature.normalisedLoopRange.getStart();
+			auto rangeEndAfterWrap = rangeToLookForTicks.getEnd() - loopEndTicks + loopStartTicks;
+			auto numTicksBeforeWrap = loopEndTicks - rangeToLookForTicks.getStart();
 
-	/** Returns the MIDI note off message for the current note on message. */
-	MidiMessage* getMatchingNoteOffForCurrentEvent();
+			track->forEachNote({ rangeToLookForTicks.getStart(), loopEndTicks }, 0.0, f);
+			track->forEachNote({ loopStartTicks, rangeEndAfterWrap }, numTicksBeforeWrap, f);
+		}
+		else
+			track->forEachNote(rangeToLookForTicks, 0.0, f);
+	}
 
 	/** Returns the length in ticks (as defined with TicksPerQuarter). */
 	double getLength() const;
@@ -216,12 +300,6 @@ public:
 	/** Removes all inactive tracks and keeps only the currently active one. */
 	void trimInactiveTracks();
 
-	/** Resets the playback position. */
-	void resetPlayback();
-
-	/** Sets the playback position. This will search through all events in the current track and set the index to point to the next event so this operation is not trivial. */
-	void setPlaybackPosition(double normalisedPosition);
-
 	/** Returns a rectangle list of all note events in the current track that can be used by UI elements to draw notes. It automatically scales them to the supplied targetBounds.
 	*/
 	RectangleList<float> getRectangleList(Rectangle<float> targetBounds) const;
@@ -249,10 +327,37 @@ private:
 
 	mutable SimpleReadWriteLock swapLock;
 
+	struct CompileJob;
+
+	/** A single background thread that builds the compiled tracks of all sequences. */
+	struct CompileThreadPool : public ThreadPool
+	{
+		CompileThreadPool() : ThreadPool(1) {};
+	};
+
+	/** Recreates the compiled tracks after the sequences were changed.
+	
+		This only starts a job on the compile thread (unless there's already one waiting), so it
+		can be called from the edit operations without blocking. The edit operations bump the 
+		sequenceVersion when they swap in the new sequences, so until the job is finished, the 
+		outdated compiled tracks are not played.
+	*/
+	void rebuildCompiledTracks();
+
+	/** Builds the compiled tracks from the sequences and swaps them in. This is called by the CompileJob. */
+	void buildCompiledTracks();
+
+	SharedResourcePointer<CompileThreadPool> compilePool;
+	std::atomic<bool> compileJobPending { false };
+
 	Identifier id;
 	OwnedArray<MidiMessageSequence> sequences;
+	OwnedArray<CompiledTrack> compiledTracks;
 	int currentTrackIndex = 0;
-	int lastPlayedIndex = -1;
+
+	/** Incremented whenever the sequences change. The compiled tracks are only used if they were built from the same version. */
+	uint32 sequenceVersion = 0;
+	uint32 compiledVersion = 0;
 
 	double artificialLengthInQuarters = -1.0;
 
@@ -591,9 +696,17 @@ public:
 	/** Creates a temporary sequence containing all the events from the currently recorded event list. */
 	HiseMidiSequence::Ptr getListOfCurrentlyRecordedEvents();
 
-	/** Returns the array of HiseEvents without conversion to a HiseMidiSequence. */
+	/** Returns the array of HiseEvents without conversion to a HiseMidiSequence. 
+	
+		This only contains the events that were already fetched from the recording queue, so call
+		drainRecordingQueue() before if you need the most recent events. */
 	const Array<HiseEvent>& getListOfCurrentlyRecordedEventsRaw() const { return currentlyRecordedEvents; }
 
+	/** Moves all events that the audio thread has recorded into the list of currently recorded events. 
+	
+		Call this from any thread except the audio thread. */
+	void drainRecordingQueue();
+
 	bool saveAsMidiFile(const String& fileName, int trackIndex);
 
 	void addPlaybackListener(PlaybackListener* l)
@@ -639,6 +752,33 @@ private:
 
 	Array<WeakReference<PlaybackListener>> playbackListeners;
 
+	struct RecordingQueueDrainer : public Timer
+	{
+		RecordingQueueDrainer(MidiPlayer& parent_) :
+			parent(parent_)
+		{};
+
+		void timerCallback() override;
+
+		MidiPlayer& parent;
+	};
+
+	void drainRecordingQueueInternal();
+
+	/** Starts the timer that fetches the recorded events. It stops itself when the recording is stopped. */
+	void startRecordingDrainer();
+
+	/** The audio thread pushes the recorded events into this queue and never touches currentlyRecordedEvents. */
+	LockfreeQueue<HiseEvent> recordingQueue;
+
+	/** Guards currentlyRecordedEvents between the consumer threads (the audio thread never acquires this lock). */
+	CriticalSection recordingLock;
+
+	std::atomic<int> numRecordedEvents{ 0 };
+	std::atomic<int> numDroppedEvents{ 0 };
+
+	RecordingQueueDrainer recordingDrainer;
+
 	Array<HiseEvent> currentlyRecordedEvents;
 
 	std::atomic<RecordState> recordState{ RecordState::Idle};
@@ -230,6 +230,7 @@ public:
             if(m.isIgnored())
                 continue;
             
+			PROFILE_SCOPE(processors[i]->getProfilerSource());
 			processors[i]->processHiseEvent(m);
 		}
 	};
@@ -238,6 +239,9 @@ public:
 	{
 		Processor::prepareToPlay(sampleRate, samplesPerBlock);
 
+		futureEventBuffer.ensureSpillCapacity(HISE_EVENT_BUFFER_SPILL_SIZE);
+		artificialEvents.ensureSpillCapacity(HISE_EVENT_BUFFER_SPILL_SIZE);
+
 		for (auto p : processors)
 			p->prepareToPlay(sampleRate, samplesPerBlock);
 	}
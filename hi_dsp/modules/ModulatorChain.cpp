@@ -193,8 +193,13 @@ ModulatorChain::ModChainWithBuffer::ModChainWithBuffer(ConstructionData data) :
 	type(data.t),
 	currentMonophonicRampValue(c->getInitialValue())
 {
-	FloatVectorOperations::fill(currentConstantVoiceValues, c->getInitialValue(), NUM_POLYPHONIC_VOICES);
-	FloatVectorOperations::fill(currentRampValues, c->getInitialValue(), NUM_POLYPHONIC_VOICES);
+	numVoiceValues = jmax(1, data.parent->getVoiceAmount());
+
+	voiceValueArena.malloc(2 * numVoiceValues);
+	currentConstantVoiceValues = voiceValueArena.get();
+	currentRampValues = voiceValueArena.get() + numVoiceValues;
+
+	FloatVectorOperations::fill(voiceValueArena.get(), c->getInitialValue(), 2 * numVoiceValues);
 
 	if (data.t == Type::VoiceStartOnly)
 		c->setIsVoiceStartChain(true);
@@ -258,9 +263,7 @@ void ModulatorChain::ModChainWithBuffer::startVoice(int voiceIndex)
 	
 	Modulation::applyModulationValue(c->getMode(), firstDynamicValue, c->getCurrentMonophonicStartValue());
 
-	setConstantVoiceValueInternal(voiceIndex, c->getConstantVoiceValue(voiceIndex));
-
-	
+	setConstantVoiceValueInternal(voiceIndex, c->getFoldedVoiceValue(voiceIndex));
 
 	currentRampValues[voiceIndex] = firstDynamicValue;
 
@@ -307,7 +310,7 @@ void ModulatorChain::ModChainWithBuffer::expandMonophonicValuesToAudioRate(int s
 
 void ModulatorChain::ModChainWithBuffer::setCurrentRampValueForVoice(int voiceIndex, float value) noexcept
 {
-	if (voiceIndex >= 0 && voiceIndex < NUM_POLYPHONIC_VOICES)
+	if (isPositiveAndBelow(voiceIndex, numVoiceValues))
 		currentRampValues[voiceIndex] = value;
 }
 
@@ -337,12 +340,28 @@ void ModulatorChain::ModChainWithBuffer::calculateMonophonicModulationValues(int
 		jassert(c->getSampleRate() > 0);
 
 		ModIterator<TimeVariantModulator> iter(c);
-		
-		FloatVectorOperations::fill(modBuffer.monoValues + startSample_cr, c->getInitialValue(), numSamples_cr);
 
-		while (auto mod = iter.next())
+		if (c->handler.getCompiledState().fuseTimeVariantStages)
 		{
-			mod->render(modBuffer.monoValues, modBuffer.scratchBuffer, startSample_cr, numSamples_cr);
+			bool isFirstStage = true;
+
+			while (auto mod = iter.next())
+			{
+				mod->renderFusedGainStage(modBuffer.monoValues, modBuffer.scratchBuffer, startSample_cr, numSamples_cr, isFirstStage);
+				isFirstStage = false;
+			}
+
+			if (isFirstStage)
+				FloatVectorOperations::fill(modBuffer.monoValues + startSample_cr, c->getInitialValue(), numSamples_cr);
+		}
+		else
+		{
+			FloatVectorOperations::fill(modBuffer.monoValues + startSample_cr, c->getInitialValue(), numSamples_cr);
+
+			while (auto mod = iter.next())
+			{
+				mod->render(modBuffer.monoValues, modBuffer.scratchBuffer, startSample_cr, numSamples_cr);
+			}
 		}
 
 		ModIterator<MonophonicEnvelope> iter2(c);
@@ -382,16 +401,33 @@ void ModulatorChain::ModChainWithBuffer::calculateModulationValuesForCurrentVoic
 	int startSample_cr = startSample / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR;
 	int numSamples_cr = numSamples / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR;
 
+	if (c->handler.getCompiledState().constantForBlock)
+	{
+		// A folded chain has no time variant modulators or envelopes, so the result is the folded voice
+		// start value for the whole block and there's nothing to render.
+		currentVoiceData = nullptr;
+		setConstantVoiceValueInternal(voiceIndex, c->hasActivePolyMods() ? c->getFoldedVoiceValue(voiceIndex) : 1.0f);
+		setDisplayValueInternal(voiceIndex, startSample_cr, numSamples_cr);
+		c->polyManager.clearCurrentVoice();
+		return;
+	}
+
 	bool constantValuesAreSmoothed = false;
 
+	const bool renderEnvelopes = options.renderPolyphonicEnvelopes && c->hasActivePolyEnvelopes();
+
 	if (c->hasActivePolyMods())
 	{
-		const float thisConstantValue = c->getConstantVoiceValue(voiceIndex);
+		const float thisConstantValue = c->getFoldedVoiceValue(voiceIndex);
 		const float previousConstantValue = currentConstantVoiceValues[voiceIndex];
 
 		const bool smoothConstantValue = (std::abs(previousConstantValue - thisConstantValue) > 0.01f);
 
-		if (smoothConstantValue)
+		// If there are no envelopes and no monophonic values, the result is constant for this block
+		// and the buffer will not be used, so we can skip filling it.
+		const bool needsVoiceBuffer = renderEnvelopes || useMonophonicData;
+
+		if (needsVoiceBuffer && smoothConstantValue)
 		{
 			constantValuesAreSmoothed = true;
 
@@ -407,14 +443,14 @@ void ModulatorChain::ModChainWithBuffer::calculateModulationValuesForCurrentVoic
 				value += delta;
 			}
 		}
-		else
+		else if (needsVoiceBuffer)
 		{
 			FloatVectorOperations::fill(voiceData + startSample_cr, thisConstantValue, numSamples_cr);
 		}
 
 		setConstantVoiceValueInternal(voiceIndex, thisConstantValue);
 
-		if (c->hasActivePolyEnvelopes())
+		if (renderEnvelopes)
 		{
 			ModIterator<EnvelopeModulator> iter(c);
 
@@ -610,6 +646,11 @@ void ModulatorChain::ModChainWithBuffer::setIncludeMonophonicValuesInVoiceRender
 	options.includeMonophonicValues = shouldInclude;
 }
 
+void ModulatorChain::ModChainWithBuffer::setRenderPolyphonicEnvelopes(bool shouldRender)
+{
+	options.renderPolyphonicEnvelopes = shouldRender;
+}
+
 
 void ModulatorChain::ModChainWithBuffer::clear()
 {
@@ -627,7 +668,10 @@ ModulatorChain::ModulatorChain(MainController *mc, const String &uid, int numVoi
 	activeVoices.setRange(0, numVoices, false);
 	setFactoryType(new ModulatorChainFactoryType(numVoices, m, p));
 
-	FloatVectorOperations::fill(lastVoiceValues, 1.0, NUM_POLYPHONIC_VOICES);
+	foldedVoiceValues.malloc(jmax(1, numVoices));
+
+	for (int i = 0; i < jmax(1, numVoices); i++)
+		foldedVoiceValues[i] = FoldedVoiceValue();
 
 	if (Identifier::isValidIdentifier(uid))
 	{
@@ -778,6 +822,53 @@ float ModulatorChain::getConstantVoiceValue(int voiceIndex) const
 	}
 };
 
+float ModulatorChain::getFoldedVoiceValue(int voiceIndex)
+{
+	if (!hasActiveVoiceStartMods())
+		return getInitialValue();
+
+	const auto hash = getVoiceStartIntensityHash();
+
+	auto& v = foldedVoiceValues[voiceIndex];
+
+	if (v.intensityHash != hash)
+	{
+		// The intensity has changed since the voice was started, so we need to fold the values again
+		v.value = getConstantVoiceValue(voiceIndex);
+		v.intensityHash = hash;
+	}
+
+	return v.value;
+}
+
+uint32 ModulatorChain::getVoiceStartIntensityHash() const noexcept
+{
+	if (intensityHashDirty.exchange(false))
+		cachedIntensityHash = calculateVoiceStartIntensityHash();
+
+	return cachedIntensityHash;
+}
+
+uint32 ModulatorChain::calculateVoiceStartIntensityHash() const noexcept
+{
+	// Start with a non-zero value so that an empty hash array is never valid
+	uint32 hash = 0x9e3779b9;
+
+	ModIterator<VoiceStartModulator> iter(this);
+
+	while (auto mod = iter.next())
+	{
+		const float intensity = mod->getIntensity();
+		uint32 intensityBits;
+		memcpy(&intensityBits, &intensity, sizeof(float));
+
+		hash = hash * 31 + intensityBits;
+		hash = hash * 31 + (mod->isBipolar() ? 1u : 0u);
+	}
+
+	return hash;
+}
+
 float ModulatorChain::startVoice(int voiceIndex)
 {
 	jassert(hasVoiceModulators());
@@ -792,7 +883,8 @@ float ModulatorChain::startVoice(int voiceIndex)
 		mod->startVoice(voiceIndex);
 
 	const float startValue = getConstantVoiceValue(voiceIndex);
-	lastVoiceValues[voiceIndex] = startValue;
+	foldedVoiceValues[voiceIndex].value = startValue;
+	foldedVoiceValues[voiceIndex].intensityHash = getVoiceStartIntensityHash();
 
 	setOutputValue(startValue);
 
@@ -1041,6 +1133,9 @@ void ModulatorChain::ModulatorChainHandler::addModulator(Modulator *newModulator
 
 		newModulator->setIsOnAir(chain->isOnAir());
 
+		if (auto m = dynamic_cast<Modulation*>(newModulator))
+			m->ownerChain = chain;
+
 		if (dynamic_cast<VoiceStartModulator*>(newModulator) != nullptr)
 		{
 			VoiceStartModulator *m = static_cast<VoiceStartModulator*>(newModulator);
@@ -1151,6 +1246,9 @@ void ModulatorChain::ModulatorChainHandler::deleteModulator(Modulator *modulator
 		modulatorToBeDeleted->setIsOnAir(false);
 		modulatorToBeDeleted->removeBypassListener(this);
 
+		if (auto m = dynamic_cast<Modulation*>(modulatorToBeDeleted))
+			m->ownerChain = nullptr;
+
 		activeAllList.remove(modulatorToBeDeleted);
 
 		if (auto env = dynamic_cast<EnvelopeModulator*>(modulatorToBeDeleted))
@@ -1214,6 +1312,44 @@ void ModulatorChain::ModulatorChainHandler::checkActiveState()
 	activeVoiceStarts = !activeVoiceStartList.isEmpty();
 	activeMonophonicEnvelopes = !activeMonophonicEnvelopesList.isEmpty();
 	anyActive = !activeAllList.isEmpty();
+
+	chain->invalidateFoldedVoiceValues();
+
+	compile();
+}
+
+void ModulatorChain::ModulatorChainHandler::compile()
+{
+	CompiledState newState;
+
+	newState.numFoldedVoiceStartMods = activeVoiceStartList.size();
+	newState.constantForBlock = !(activeTimeVariants || activeEnvelopes || activeMonophonicEnvelopes);
+
+	// The intensity of gain modulators can be applied in the same loop as the multiplication, 
+	// but the other modes need their own conversion, so they keep the separate passes.
+	newState.fuseTimeVariantStages = activeTimeVariants && chain->getMode() == Modulation::GainMode;
+	newState.numFusedTimeVariantMods = newState.fuseTimeVariantStages ? activeTimeVariantsList.size() : 0;
+
+	compiledState = newState;
+
+	auto& logger = chain->getMainController()->getDebugLogger();
+
+	if (logger.isLogging())
+	{
+		String m;
+
+		m << chain->getId();
+
+		if (auto parent = chain->getParentProcessor())
+			m << " (" << parent->getId() << ")";
+
+		m << " compiled: ";
+		m << (isFolded() ? "folded" : "unfolded") << ", ";
+		m << String(compiledState.numFoldedVoiceStartMods) << " voice start modulators folded, ";
+		m << String(compiledState.numFusedTimeVariantMods) << " time variant stages fused";
+
+		logger.logMessage(m);
+	}
 }
 
 
@@ -1267,6 +1403,7 @@ void EnvelopeModulatorFactoryType::fillTypeNameList()
 	ADD_NAME_TO_TYPELIST(CCEnvelope);
 	ADD_NAME_TO_TYPELIST(JavascriptEnvelopeModulator);
 	ADD_NAME_TO_TYPELIST(MPEModulator);
+	ADD_NAME_TO_TYPELIST(GlobalEnvelopeModulator);
 }
 
 
@@ -241,6 +241,12 @@ public:
 		*/
 		void setIncludeMonophonicValuesInVoiceRendering(bool shouldInclude);
 
+		/** This makes the voice modulation render the polyphonic envelopes. Default is enabled.
+		*
+		*	Disable this if you want to render the envelopes yourself (eg. one buffer per envelope).
+		*/
+		void setRenderPolyphonicEnvelopes(bool shouldRender);
+
 		/** Call this when there's nothing to do to reset the modulation chain. 
 		*
 		*	It clears the internal buffers and sets the constant value to the default.
@@ -268,6 +274,7 @@ public:
 			bool expandToAudioRate = false;
 			bool includeMonophonicValues = true;
 			bool voiceValuesReadOnly = true;
+			bool renderPolyphonicEnvelopes = true;
 		};
 
 		void setDisplayValue(float v);
@@ -304,8 +311,12 @@ public:
 
 		float currentMonoValue = 1.0f;
 		float lastConstantVoiceValue = 1.0f;
-		float currentConstantVoiceValues[NUM_POLYPHONIC_VOICES];
-		float currentRampValues[NUM_POLYPHONIC_VOICES];
+
+		// Both per-voice arrays point into one allocation that is sized with the voice amount of the parent
+		HeapBlock<float> voiceValueArena;
+		float* currentConstantVoiceValues = nullptr;
+		float* currentRampValues = nullptr;
+		int numVoiceValues = 0;
 		
 		float currentMonophonicRampValue;
 		float const* currentVoiceData = nullptr;
@@ -438,6 +449,21 @@ public:
 	/** Iterates all voice start modulators and returns the value either between 0.0 and 1.0 (GainMode) or -1.0 ... 1.0 (Pitch Mode). */
 	float getConstantVoiceValue(int voiceIndex) const;
 
+	/** Returns the voice start value that was folded when the voice was started.
+	*
+	*	The voice start values can't change during the lifetime of a voice, so the result of getConstantVoiceValue()
+	*	is cached in startVoice(). It will only be recalculated if the intensity of one of the voice start modulators
+	*	was changed in the meantime.
+	*/
+	float getFoldedVoiceValue(int voiceIndex);
+
+	/** Marks the cached intensity hash as dirty so that the folded voice values are recalculated.
+	*
+	*	This is called when the intensity or polarity of a voice start modulator changes and whenever the list of
+	*	active modulators is changed (which includes bypassing a modulator).
+	*/
+	void invalidateFoldedVoiceValues() noexcept { intensityHashDirty.store(true); }
+
 	Table::ValueTextConverter getTableValueConverter() const
 	{
 		return handler.tableValueConverter;
@@ -524,6 +550,7 @@ public:
 			activeEnvelopes = false;
 			activeTimeVariants = false;
 			activeVoiceStarts = false;
+			compiledState = CompiledState();
 
 			chain->envelopeModulators.clear();
 			chain->variantModulators.clear();
@@ -540,6 +567,31 @@ public:
 		bool hasActiveMonophoicEnvelopes() const noexcept { return activeMonophonicEnvelopes; };
 		bool hasActiveMods() const noexcept { return anyActive; }
 
+		/** The result of the compile step that is performed whenever the list of active modulators changes. 
+		*
+		*	It is used by the rendering methods to skip work that can't change the result of the chain.
+		*/
+		struct CompiledState
+		{
+			/** the number of voice start modulators that are folded into one constant per voice. */
+			int numFoldedVoiceStartMods = 0;
+
+			/** the number of time variant modulators that are rendered as fused gain stages. */
+			int numFusedTimeVariantMods = 0;
+
+			/** if true, the time variant modulators apply their intensity while multiplying with the chain buffer. */
+			bool fuseTimeVariantStages = false;
+
+			/** if true, the chain result can't change within a block (it has no time variant modulators or envelopes). */
+			bool constantForBlock = true;
+		};
+
+		/** Returns the state of the last compile step. */
+		const CompiledState& getCompiledState() const noexcept { return compiledState; }
+
+		/** Returns true if the chain result is a constant for each voice and doesn't need a per-sample buffer. */
+		bool isFolded() const noexcept { return anyActive && compiledState.constantForBlock; }
+
 		UnorderedStack<VoiceStartModulator*, 16> activeVoiceStartList;
 		UnorderedStack<TimeVariantModulator*, 16> activeTimeVariantsList;
 		UnorderedStack<EnvelopeModulator*, 16> activeEnvelopesList;
@@ -550,6 +602,11 @@ public:
 
 		void checkActiveState();
 
+		/** Creates the CompiledState for the current list of active modulators. */
+		void compile();
+
+		CompiledState compiledState;
+
 		bool activeVoiceStarts = false;
 		bool activeEnvelopes = false;
 		bool activeTimeVariants = false;
@@ -584,7 +641,22 @@ private:
 	
 	Identifier chainIdentifier;
 
-	float lastVoiceValues[NUM_POLYPHONIC_VOICES];
+	/** Returns the cached hash of the voice start intensities and only walks the modulators if it is dirty. */
+	uint32 getVoiceStartIntensityHash() const noexcept;
+
+	uint32 calculateVoiceStartIntensityHash() const noexcept;
+
+	mutable std::atomic<bool> intensityHashDirty { true };
+	mutable uint32 cachedIntensityHash = 0;
+
+	struct FoldedVoiceValue
+	{
+		float value = 1.0f;
+		uint32 intensityHash = 0;
+	};
+
+	// One element per voice, allocated with the voice amount of the chain
+	HeapBlock<FoldedVoiceValue> foldedVoiceValues;
 	float monophonicStartValue = 1.0f;
 
 	bool isVoiceStartChain;
@@ -77,6 +77,7 @@ bypassState(false)
 	midiProcessorChain->setParentProcessor(this);
 
 	setVoiceLimit(numVoices);
+	voiceStealer.setNumVoices(numVoices);
 
 	for (int i = 0; i < 4; i++)
 	{
@@ -129,6 +130,9 @@ ValueTree ModulatorSynth::exportAsValueTree() const
 
 	v.setProperty("IconColour", iconColour.toString(), nullptr);
 
+	if (getVoiceStealingPolicy() != VoiceStealer::Policy::Oldest)
+		v.setProperty("VoiceStealing", VoiceStealer::getPolicyName(getVoiceStealingPolicy()), nullptr);
+
 	return v;
 }
 
@@ -143,6 +147,8 @@ void ModulatorSynth::restoreFromValueTree(const ValueTree &v)
 
 	iconColour = Colour::fromString(v.getProperty("IconColour", Colours::transparentBlack.toString()).toString());
 
+	setVoiceStealingPolicy(VoiceStealer::getPolicyFromName(v.getProperty("VoiceStealing", "Oldest").toString()));
+
 	Processor::restoreFromValueTree(v);
 }
 
@@ -301,6 +307,15 @@ int ModulatorSynth::getNumActiveVoices() const
 	return activeVoices.size() - pendingRemoveVoices.size();
 }
 
+void ModulatorSynth::setVoiceStealingPolicy(VoiceStealer::Policy newPolicy)
+{
+	if (newPolicy == voiceStealer.getPolicy())
+		return;
+
+	LockHelpers::SafeLock sl(getMainController(), LockHelpers::AudioLock, isOnAir());
+	voiceStealer.setPolicy(newPolicy);
+}
+
 ProcessorEditorBody *ModulatorSynth::createEditor(ProcessorEditor *parentEditor)
 {
 #if USE_BACKEND
@@ -362,6 +377,7 @@ void ModulatorSynth::renderNextBlockWithModulators(AudioSampleBuffer& outputBuff
 	jassert(isOnAir());
 
     ADD_GLITCH_DETECTOR(this, DebugLogger::Location::SynthRendering);
+	PROFILE_SCOPE(getProfilerSource());
     
 	int numSamples = outputBuffer.getNumSamples();
 
@@ -482,13 +498,47 @@ void ModulatorSynth::renderVoice(int startSample, int numThisTime)
     
 	clearPendingRemoveVoices();
 
+	auto batchEffect = (isChainDisabled(EffectChain) || !canBatchVoiceEffects()) ? nullptr : effectChain->getVoiceBatchEffect();
+
+	if (batchEffect != nullptr)
+		batchEffect->startVoiceBatch(startSample, numThisTime);
+
 	for (auto v : activeVoices)
 	{
 		jassert(!v->isInactive());
 
 		calculateModulationValuesForVoice(v, startSample, numThisTime);
 
-		v->renderNextBlock(internalBuffer, startSample, numThisTime);
+		if (voiceStealer.getPolicy() == VoiceStealer::Policy::Quietest)
+		{
+			const auto& gainMod = modChains[BasicChains::GainChain];
+			auto gainValues = gainMod.getReadPointerForVoiceValues(startSample);
+			const float level = gainValues != nullptr ? gainValues[numThisTime - 1] : gainMod.getConstantModulationValue();
+
+			voiceStealer.setVoiceLevel(v->getVoiceIndex(), level);
+		}
+
+		if (batchEffect != nullptr)
+		{
+			// The voice effect defers its processing, so we need to add the voice to the output later...
+			if (!v->isInactive())
+			{
+				v->calculateBlock(startSample, numThisTime);
+				batchedVoices.insertWithoutSearch(v);
+			}
+		}
+		else
+			v->renderNextBlock(internalBuffer, startSample, numThisTime);
+	}
+
+	if (batchEffect != nullptr)
+	{
+		batchEffect->renderVoiceBatch();
+
+		for (auto v : batchedVoices)
+			v->addToOutputBuffer(internalBuffer, startSample, numThisTime);
+
+		batchedVoices.clear();
 	}
 
 	clearPendingRemoveVoices();
@@ -740,6 +790,9 @@ void ModulatorSynth::preHiseEventCallback(const HiseEvent &e)
 		stopSynthTimer(3);
 	}
 
+	if (e.isNoteOff())
+		voiceStealer.clearPriorityForEvent(e.getEventId());
+
 	for (auto& mb : modChains)
 		mb.handleHiseEvent(e);
 
@@ -774,6 +827,8 @@ void ModulatorSynth::startVoiceWithHiseEvent(ModulatorSynthVoice* voice, Synthes
 
 	Synthesiser::startVoice(static_cast<SynthesiserVoice*>(voice), sound, e.getChannel(), e.getNoteNumber(), e.getFloatVelocity());
 
+	voiceStealer.voiceStarted(voice->getVoiceIndex(), e.getEventId(), e.getNoteNumber(), getMainController()->getUptime(), getVoiceStealingPriority(voice, e));
+
 	voice->saveStartUptimeDelta();
 }
 
@@ -793,6 +848,8 @@ void ModulatorSynth::preStartVoice(int voiceIndex, const HiseEvent& e)
 
 void ModulatorSynth::preStopVoice(int voiceIndex)
 {
+	voiceStealer.voiceReleased(voiceIndex);
+
 	for (auto& mb : modChains)
 		mb.stopVoice(voiceIndex);
 
@@ -821,6 +878,10 @@ void ModulatorSynth::prepareToPlay(double newSampleRate, int samplesPerBlock)
 		ProcessorHelpers::increaseBufferIfNeeded(pitchBuffer, samplesPerBlock);
 		ProcessorHelpers::increaseBufferIfNeeded(gainBuffer, samplesPerBlock);
 		ProcessorHelpers::increaseBufferIfNeeded(internalBuffer, samplesPerBlock);
+
+		eventBuffer.ensureSpillCapacity(HISE_EVENT_BUFFER_SPILL_SIZE);
+
+		voiceStealer.setNumVoices(getNumVoices());
 		
 		for(int i = 0; i < getNumVoices(); i++)
 		{
@@ -928,6 +989,8 @@ void ModulatorSynth::flagVoiceAsRemoved(ModulatorSynthVoice* v)
 {
 	jassert(v->isInactive());
 
+	voiceStealer.voiceRemoved(v->getVoiceIndex());
+
 	pendingRemoveVoices.insert(v);
 }
 
@@ -1071,7 +1134,9 @@ void ModulatorSynth::noteOn(const HiseEvent &m)
 		return;
 
 	// Make room for the sounds
+	noteNumberToBeStarted = m.getNoteNumber();
 	handleVoiceLimit(numSoundsToStart);
+	noteNumberToBeStarted = -1;
 
 	const int midiChannel = m.getChannel();
 	const int midiNoteNumber = m.getNoteNumber();
@@ -1223,15 +1288,9 @@ void ModulatorSynthVoice::resetVoice()
 
 	ModulatorSynth *os = getOwnerSynth();
 
-	ModulatorChain *g = static_cast<ModulatorChain*>(os->getChildProcessor(ModulatorSynth::GainModulation));
-	ModulatorChain *p = static_cast<ModulatorChain*>(os->getChildProcessor(ModulatorSynth::PitchModulation));
 	EffectProcessorChain *e = static_cast<EffectProcessorChain*>(os->getChildProcessor(ModulatorSynth::EffectChain));
 
-	if(g->hasActiveEnvelopesAtAll())
-		g->reset(voiceIndex);
-
-	if(p->hasActiveEnvelopesAtAll())
-		p->reset(voiceIndex);
+	resetEnvelopes();
 
 	e->reset(voiceIndex);
 
@@ -1255,6 +1314,20 @@ void ModulatorSynthVoice::resetVoice()
 	currentHiseEvent = HiseEvent();
 }
 
+void ModulatorSynthVoice::resetEnvelopes()
+{
+	ModulatorSynth *os = getOwnerSynth();
+
+	ModulatorChain *g = static_cast<ModulatorChain*>(os->getChildProcessor(ModulatorSynth::GainModulation));
+	ModulatorChain *p = static_cast<ModulatorChain*>(os->getChildProcessor(ModulatorSynth::PitchModulation));
+
+	if(g->hasActiveEnvelopesAtAll())
+		g->reset(voiceIndex);
+
+	if(p->hasActiveEnvelopesAtAll())
+		p->reset(voiceIndex);
+}
+
 void ModulatorSynthVoice::checkRelease()
 {
 	ModulatorSynth *os = getOwnerSynth();
@@ -1354,14 +1427,11 @@ ModulatorSynthVoice* ModulatorSynth::getFreeVoice(SynthesiserSound* s, int midiC
 
 juce::SynthesiserVoice* ModulatorSynth::findVoiceToSteal(SynthesiserSound* soundToPlay, int midiChannel, int midiNoteNumber) const
 {
-	for (auto v: activeVoices)
+	// return voices that are being killed
+	if (auto v = getVoice(voiceStealer.getVoiceBeingKilled()))
 	{
-		// return voices that are being killed
-		if (v->isBeingKilled())
-		{
-			DBG("Already killing: Found voice " + String(v->getVoiceIndex()) + " to steal");
-			return v;
-		}
+		DBG("Already killing: Found voice " + String(static_cast<ModulatorSynthVoice*>(v)->getVoiceIndex()) + " to steal");
+		return v;
 	}
 
 	return Synthesiser::findVoiceToSteal(soundToPlay, midiChannel, midiNoteNumber);
@@ -1397,215 +1467,68 @@ void ModulatorSynth::killAllVoicesWithNoteNumber(int noteNumber)
 	
 int ModulatorSynth::killLastVoice(bool allowTailOff/*=true*/)
 {
-	ModulatorSynthVoice *oldestUnkilledMessage = nullptr;
-	double oldestUptime = DBL_MAX;
+	// The voice stealer keeps the candidates sorted, so we don't need to 
+	// iterate over the active voices here...
 
-	// This variable will count additional voice kills
-	// that happen when a sibling voice is killed along with 
-	// its to-be killed sibling...
-	
-	int numVoicesKilled = 0;
-
-	for (auto v: activeVoices)
+	// If there's a voice already being killed and we need to 
+	// make room for another voice kill, force-kill it and its siblings
+	if (!allowTailOff)
 	{
-		if (v->isInactive())
-			continue;
-
-		if (!v->isTailingOff())
-			continue;
-
-		// If there's a voice already being killed and we need to 
-		// make room for another voice kill, force-kill it and its siblings
-		if (!allowTailOff && v->isBeingKilled())
+		if (auto v = static_cast<ModulatorSynthVoice*>(getVoice(voiceStealer.getVoiceBeingKilled())))
 		{
 			LOG_SYNTH_EVENT("Force-kill voice " + String(v->getVoiceIndex()));
-			numVoicesKilled += killVoiceAndSiblings(v, false);
-
-			if (numVoicesKilled > 0)
-			{
-				// job is done, return
-				return numVoicesKilled;
-			}
-			else
-			{
-				allowTailOff = true;
-			}
-		}
-		else
-		{
-			const double voiceUptime = v->getVoiceUptime();
-
-			if (!v->isBeingKilled() && voiceUptime < oldestUptime)
-			{
-				oldestUptime = voiceUptime;
-				oldestUnkilledMessage = v;
-			}
-		}
-	}
-
-	if (oldestUnkilledMessage != nullptr)
-	{
-		return killVoiceAndSiblings(oldestUnkilledMessage, allowTailOff);
-	}
-
-	oldestUnkilledMessage = nullptr;
-	oldestUptime = DBL_MAX;
-
-	// Now the same again for all notes
-	for (auto v: activeVoices)
-	{
-		if (v->isInactive())
-			continue;
-
-		// If there's a voice already being killed and we need to 
-		// make room for another voice kill, force-kill it and its siblings
-		if (!allowTailOff && v->isBeingKilled())
-		{
-			numVoicesKilled += killVoiceAndSiblings(v, false);
-
-			if (numVoicesKilled > 0)
-			{
-				// job is done, return
-				return numVoicesKilled;
-			}
-			else
-			{
-				allowTailOff = true;
-			}
-		}
-		else
-		{
-			const double voiceUptime = v->getVoiceUptime();
-
-			if (!v->isBeingKilled() && voiceUptime < oldestUptime)
-			{
-				oldestUptime = voiceUptime;
-				oldestUnkilledMessage = v;
-			}
+			return killVoiceAndSiblings(v, false);
 		}
 	}
 
-	if (oldestUnkilledMessage != nullptr)
+	if (auto v = static_cast<ModulatorSynthVoice*>(getVoice(voiceStealer.getVoiceToSteal(noteNumberToBeStarted))))
 	{
-		return killVoiceAndSiblings(oldestUnkilledMessage, allowTailOff);
+		jassert(!v->isInactive() && !v->isBeingKilled());
+		return killVoiceAndSiblings(v, allowTailOff);
 	}
 
-	// Just forcekill the first voice that is active...
-	for (auto v : activeVoices)
-	{
-		if (v->isBeingKilled())
-		{
-			return killVoiceAndSiblings(v, false);
-		}
-	}
+	// Just forcekill a voice that is already fading out...
+	if (auto v = static_cast<ModulatorSynthVoice*>(getVoice(voiceStealer.getVoiceBeingKilled())))
+		return killVoiceAndSiblings(v, false);
 	
 	return 0;
-
-#if 0
-	int sizeAtCalculationStart = voices.size();
-
-	// search all tailing notes
-	for(int i = 0; i < voices.size(); i++)
-	{
-		// must not delete elements from the voice stack during this loop...
-		jassert(sizeAtCalculationStart == voices.size());
-
-		ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(voices[i]);
-
-
-
-		// If there is already a note fading out, kill it and
-		// let the newest tail off
-		if (!allowTailOff && v->isBeingKilled())
-		{
-			killVoiceAndSiblings(v, false);
-			allowTailOff = true;
-		}
-
-		if(v->isBeingKilled() || !v->isTailingOff()) continue;
-
-		
-
-		const double voiceUptime = v->getVoiceUptime();
-
-		if(voiceUptime < oldestUptime)
-		{
-			oldestUptime = voiceUptime;
-			oldest = v;
-		}
-	}
-	
-	
-	if(oldest != nullptr)
-	{
-		killVoiceAndSiblings(oldest, allowTailOff);
-		return;
-	}
-
-	// search all notes
-	for(int i = 0; i < voices.size(); i++)
-	{
-		ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(voices[i]);
-
-		// If there is already a note fading out, kill it and
-		// let the newest tail off
-		if (!allowTailOff && v->isBeingKilled())
-		{
-			killVoiceAndSiblings(v, false);
-			allowTailOff = true;
-		}
-
-		if(v->isBeingKilled()) continue;
-
-		const double voiceUptime = v->getVoiceUptime();
-
-		if(voiceUptime < oldestUptime)
-		{
-			oldestUptime = voiceUptime;
-			oldest = v;
-		}
-	}
-
-	if(oldest != nullptr)
-	{
-		killVoiceAndSiblings(oldest, allowTailOff);
-		return;
-	}
-#endif
 };
 
 
 int ModulatorSynth::killVoiceAndSiblings(ModulatorSynthVoice* v, bool allowTailOff)
 {
-	auto e = v->getCurrentHiseEvent();
-
 	int numVoicesKilled = 0;
 
-	for (auto av: activeVoices)
+	// Resetting a voice removes it from the sibling list, so we need to collect them first
+	int siblings[NUM_POLYPHONIC_VOICES];
+	int numSiblings = 0;
+
+	voiceStealer.forEachSibling(v->getVoiceIndex(), [&](int siblingIndex)
 	{
-		// Skip the note
-		if (av == v)
-			continue;
+		if (numSiblings < NUM_POLYPHONIC_VOICES)
+			siblings[numSiblings++] = siblingIndex;
+	});
+
+	for (int i = 0; i < numSiblings; i++)
+	{
+		auto av = static_cast<ModulatorSynthVoice*>(getVoice(siblings[i]));
 
 		// Let inactive notes be removed later
-		if (av->isInactive())
+		if (av == nullptr || av->isInactive())
 			continue;
 
-		if (av->getCurrentHiseEvent() == e)
+		if (allowTailOff)
 		{
-			if (allowTailOff)
-			{
-				LOG_SYNTH_EVENT("Kill sibling voice " + String(av->getVoiceIndex()));
-				av->killVoice();
-			}
-			else
-			{
-				LOG_SYNTH_EVENT("Reset sibling voice " + String(av->getVoiceIndex()));
-				av->resetVoice();
-			}
-
-			numVoicesKilled++;
+			LOG_SYNTH_EVENT("Kill sibling voice " + String(av->getVoiceIndex()));
+			av->killVoice();
 		}
+		else
+		{
+			LOG_SYNTH_EVENT("Reset sibling voice " + String(av->getVoiceIndex()));
+			av->resetVoice();
+		}
+
+		numVoicesKilled++;
 	}
 
 	if (allowTailOff)
@@ -1631,6 +1554,7 @@ void ModulatorSynth::deleteAllVoices()
     
 	activeVoices.clear();
 	pendingRemoveVoices.clear();
+	voiceStealer.clear();
 	lastStartedVoice = nullptr;
 	clearVoices();
 }
@@ -1648,6 +1572,7 @@ void ModulatorSynth::resetAllVoices()
         lastStartedVoice = nullptr;
         activeVoices.clearQuick();
         pendingRemoveVoices.clearQuick();
+        voiceStealer.clear();
         
     }
     
@@ -1741,32 +1666,35 @@ void ModulatorSynthVoice::renderNextBlock (AudioSampleBuffer& outputBuffer, int
 	if (isActive)
     { 
 		calculateBlock(startSample, numSamples);
+		addToOutputBuffer(outputBuffer, startSample, numSamples);
+    }
+}
 
-		if (gainFader.isSmoothing())
-		{
-			applyEventVolumeFade(startSample, numSamples);
-		}
-		else if (eventGainFactor != 1.0f)
-		{
-			applyEventVolumeFactor(startSample, numSamples);
-		}
-
-		if(killThisVoice)
-		{
-			applyKillFadeout(startSample, numSamples);
-		}
+void ModulatorSynthVoice::addToOutputBuffer(AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
+{
+	if (gainFader.isSmoothing())
+	{
+		applyEventVolumeFade(startSample, numSamples);
+	}
+	else if (eventGainFactor != 1.0f)
+	{
+		applyEventVolumeFactor(startSample, numSamples);
+	}
 
-		const int maxChannelAmount = jmin<int>(voiceBuffer.getNumChannels(), outputBuffer.getNumChannels());
+	if(killThisVoice)
+	{
+		applyKillFadeout(startSample, numSamples);
+	}
 
-		for (int i = 0; i < maxChannelAmount; i++)
-		{
-			FloatVectorOperations::add(outputBuffer.getWritePointer(i, startSample), voiceBuffer.getReadPointer(i, startSample), numSamples);
-		}
+	const int maxChannelAmount = jmin<int>(voiceBuffer.getNumChannels(), outputBuffer.getNumChannels());
 
+	for (int i = 0; i < maxChannelAmount; i++)
+	{
+		FloatVectorOperations::add(outputBuffer.getWritePointer(i, startSample), voiceBuffer.getReadPointer(i, startSample), numSamples);
+	}
 
-		// checks if any envelopes are active and in their release state and calls stopNote until they are finished.
-		checkRelease();
-    }
+	// checks if any envelopes are active and in their release state and calls stopNote until they are finished.
+	checkRelease();
 }
 
 void ModulatorSynthVoice::setCurrentHiseEvent(const HiseEvent &m)
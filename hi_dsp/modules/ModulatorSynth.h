@@ -154,6 +154,27 @@ public:
 
 	// ===================================================================================================================
 
+	/** Sets the policy that is used to choose the voice that will be stolen when the voice limit is reached. */
+	void setVoiceStealingPolicy(VoiceStealer::Policy newPolicy);
+
+	VoiceStealer::Policy getVoiceStealingPolicy() const noexcept { return voiceStealer.getPolicy(); }
+
+	/** Sets the priority for the voices that will be started by the given event. 
+	*
+	*	Voices with a lower priority will be stolen first. This only works with the LowestPriority policy and returns false otherwise.
+	*/
+	bool setVoiceStealingPriorityForEvent(uint16 eventId, int priority) { return voiceStealer.setPriorityForEvent(eventId, priority); }
+
+	/** Returns the priority for the voice that is used by the LowestPriority voice stealing policy.
+	*
+	*	The default implementation returns the priority that was set with setVoiceStealingPriorityForEvent() or 0.
+	*/
+	virtual int getVoiceStealingPriority(const ModulatorSynthVoice* /*v*/, const HiseEvent& e) const { return voiceStealer.getPriorityForEvent(e.getEventId()); }
+
+	VoiceStealer& getVoiceStealer() noexcept { return voiceStealer; }
+
+	// ===================================================================================================================
+
 	virtual ProcessorEditorBody *createEditor(ProcessorEditor *parentEditor)  override;
 
 	/** Call this instead of Synthesiser::renderNextBlock to let the ModulatorChains to their work. 
@@ -169,6 +190,13 @@ public:
 	/** This method is called to actually render all voices. It operates on the internal buffer of the ModulatorSynth. */
 	void renderVoice(int startSample, int numThisTime);
 
+	/** Override this and return true if the voices call the voice effect chain as last step of their calculateBlock() (after the gain modulation).
+
+		In this case the last voice effect may defer its processing and render all voices at once (see VoiceEffectProcessor::canRenderVoiceBatch()).
+		Synths that apply the gain modulation after the voice effects must return false, otherwise the order would change.
+	*/
+	virtual bool canBatchVoiceEffects() const { return false; }
+
 	void calculateModulationValuesForVoice(ModulatorSynthVoice * v, int startSample, int numThisTime);;
 
 	void clearPendingRemoveVoices();
@@ -488,6 +516,9 @@ private:
 
 	VoiceStack pendingRemoveVoices;
 
+	/** The voices that were calculated in the current render pass if a voice effect renders them in one batch. */
+	VoiceStack batchedVoices;
+
 protected:
 
 	
@@ -537,6 +568,11 @@ private:
 	// kills or resets all voices that have the same start event. */
 	int killVoiceAndSiblings(ModulatorSynthVoice* v, bool allowTailOff);
 
+	VoiceStealer voiceStealer;
+
+	// the note number of the note that is about to be started (used by the SameNote stealing policy)
+	int noteNumberToBeStarted = -1;
+
 
 	// ===================================================================================================================
 
@@ -626,6 +662,13 @@ public:
 
 
 	virtual void calculateBlock(int startSample, int numSamples) = 0;
+
+	/** Applies the event gain & kill fades and adds the calculated voice buffer to the output.
+
+		This is called by renderNextBlock() after calculateBlock(), but the synth will call it separately
+		if the voice effects are rendered as batch after all voices have been calculated.
+	*/
+	void addToOutputBuffer(AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
 	
 	bool isPitchFadeActive() const noexcept
 	{
@@ -707,6 +750,9 @@ public:
 
 	virtual void resetVoice();
 
+	/** Resets the envelopes of the gain and pitch chain for this voice. This is called by resetVoice(), so override it if the envelope state must outlive the voice. */
+	virtual void resetEnvelopes();
+
 	bool isInactive() const noexcept
 	{
         return !isActive; //uptimeDelta == 0.0;
@@ -719,7 +765,9 @@ public:
 	void killVoice()
 	{
 		//stopNote(true);
-		killThisVoice = true;	
+		killThisVoice = true;
+
+		ownerSynth->getVoiceStealer().voiceKilled(voiceIndex);
 	}
 
 	bool const shouldBeKilled() const
@@ -199,6 +199,7 @@ void ModulatorSynthChain::renderNextBlockWithModulators(AudioSampleBuffer &buffe
 	if (isSoftBypassed()) return;
 
 	ADD_GLITCH_DETECTOR(this, DebugLogger::Location::SynthChainRendering);
+	PROFILE_SCOPE(getProfilerSource());
 
 	if (getMainController()->getMainSynthChain() == this && !activeChannels.areAllChannelsEnabled())
 	{
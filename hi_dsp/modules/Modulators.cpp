@@ -74,6 +74,8 @@ void Modulation::setIntensity(float newIntensity) noexcept
 	intensity = newIntensity;
 
 	smoothedIntensity.setValue(newIntensity);
+
+	invalidateFoldedVoiceValues();
 }
 
 void Modulation::setIntensityFromSlider(float sliderValue) noexcept
@@ -96,6 +98,14 @@ void Modulation::setIsBipolar(bool shouldBeBiPolar) noexcept
 	jassert(modulationMode == PitchMode || modulationMode == PanMode);
 
 	bipolar = shouldBeBiPolar;
+
+	invalidateFoldedVoiceValues();
+}
+
+void Modulation::invalidateFoldedVoiceValues() noexcept
+{
+	if (ownerChain != nullptr)
+		ownerChain->invalidateFoldedVoiceValues();
 }
 
 float Modulation::getInitialValue() const noexcept
@@ -508,7 +518,7 @@ void TimeModulation::applyPanModulation(float * calculatedModValues, float * des
 
 }
 
-void TimeModulation::applyPanModulation(float * calculatedModValues, float * destinationValues, float fixedIntensity, int numValues) const noexcept
+void TimeModulation::applyPanModulation(const float * calculatedModValues, float * destinationValues, float fixedIntensity, int numValues) const noexcept
 {
 	// input: modValues (0 ... 1), intensity (-1 ... 1)
 	// output: 0 -> 0.5
@@ -545,6 +555,97 @@ VoiceStartModulator::VoiceStartModulator(MainController *mc, const String &id, i
 	voiceValues.insertMultiple(0, 1.0f, numVoices);
 };
 
+void TimeVariantModulator::renderFusedGainStage(float* monoModulationValues, float* scratchBuffer, int startSample, int numSamples, bool isFirstStage)
+{
+	jassert(getMode() == GainMode);
+	jassert(monoModulationValues != scratchBuffer);
+
+	if (smoothedIntensity.isSmoothing())
+	{
+		// Use the default code path while the intensity is ramping...
+		if (isFirstStage)
+			FloatVectorOperations::fill(monoModulationValues + startSample, getInitialValue(), numSamples);
+
+		render(monoModulationValues, scratchBuffer, startSample, numSamples);
+		return;
+	}
+
+	const float* mod = getSharedModulationValues(startSample, numSamples);
+
+	if (mod == nullptr)
+	{
+		setScratchBuffer(scratchBuffer, startSample + numSamples);
+		calculateBlock(startSample, numSamples);
+		mod = internalBuffer.getReadPointer(0, startSample);
+	}
+
+	const float intensity = getIntensity();
+	const float a = 1.0f - intensity;
+
+	float* dest = monoModulationValues + startSample;
+
+	if (isFirstStage)
+	{
+		FloatVectorOperations::copyWithMultiply(dest, mod, intensity, numSamples);
+		FloatVectorOperations::add(dest, a, numSamples);
+	}
+	else
+	{
+		// The shared values must not be changed, so the intensity is applied in the scratch buffer
+		// (if the values were calculated by this modulator, mod already points to it).
+		float* gain = scratchBuffer + startSample;
+
+		FloatVectorOperations::copyWithMultiply(gain, mod, intensity, numSamples);
+		FloatVectorOperations::add(gain, a, numSamples);
+		FloatVectorOperations::multiply(dest, gain, numSamples);
+	}
+
+	lastConstantValue = monoModulationValues[startSample];
+
+#if ENABLE_ALL_PEAK_METERS
+	pushPlotterValues(monoModulationValues, startSample, numSamples);
+	setOutputValue(lastConstantValue);
+#endif
+}
+
+bool TimeVariantModulator::renderSharedModulationValues(float* monoModulationValues, float* scratchBuffer, int startSample, int numSamples)
+{
+	// The gain mode uses renderFusedGainStage() and the smoothed intensity needs the default code path
+	if (getMode() == GainMode || smoothedIntensity.isSmoothing())
+		return false;
+
+	const float* mod = getSharedModulationValues(startSample, numSamples);
+
+	if (mod == nullptr)
+		return false;
+
+	const float intensity = getIntensity();
+	float* dest = monoModulationValues + startSample;
+
+	if (getMode() == PitchMode)
+	{
+		float* pitch = scratchBuffer + startSample;
+
+		if (isBipolar())
+		{
+			// (2 * x - 1) * intensity
+			FloatVectorOperations::copyWithMultiply(pitch, mod, 2.0f * intensity, numSamples);
+			FloatVectorOperations::add(pitch, -intensity, numSamples);
+		}
+		else
+			FloatVectorOperations::copyWithMultiply(pitch, mod, intensity, numSamples);
+
+		Modulation::PitchConverters::normalisedRangeToPitchFactor(pitch, numSamples);
+		FloatVectorOperations::multiply(dest, pitch, numSamples);
+	}
+	else
+	{
+		applyPanModulation(mod, dest, intensity, numSamples);
+	}
+
+	return true;
+}
+
 EnvelopeModulator::EnvelopeModulator(MainController *mc, const String &id, int voiceAmount_, Modulation::Mode m):
 	Modulator(mc, id, voiceAmount_),
 	TimeModulation(m),
@@ -606,6 +707,7 @@ Processor *EnvelopeModulatorFactoryType::createProcessor(int typeIndex, const St
 	case ccEnvelope:		return new CCEnvelope(m, id, numVoices, mode);
 	case scriptEnvelope:	return new JavascriptEnvelopeModulator(m, id, numVoices, mode);
 	case mpeModulator:		return new MPEModulator(m, id, numVoices, mode);
+	case globalEnvelopeModulator:	return new GlobalEnvelopeModulator(m, id, numVoices, mode);
 	default: jassertfalse;	return nullptr;
 
 	}
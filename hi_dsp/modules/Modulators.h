@@ -253,8 +253,18 @@ protected:
 
 	LinearSmoothedValue<float> smoothedIntensity;
 
+	/** Tells the parent chain that its folded voice start values are outdated. */
+	void invalidateFoldedVoiceValues() noexcept;
+
 private:
 
+	friend class ModulatorChain;
+
+	/** The chain this modulation is attached to. This is set by the chain handler when the modulator is added
+	*	so that the intensity setters can invalidate the folded values without looking up the parent processor. 
+	*/
+	ModulatorChain* ownerChain = nullptr;
+
 	Component::SafePointer<Plotter> attachedPlotter;
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Modulation)
@@ -405,7 +415,7 @@ protected:
 	void applyPitchModulation(float* calculatedModulationValues, float *destinationValues, float fixedIntensity, int numValues) const noexcept;;
 
 	void applyPanModulation(float * calculatedModValues, float * destinationValues, float fixedIntensity, float* intensityValues, int numValues) const noexcept;
-	void applyPanModulation(float * calculatedModValues, float * destinationValues, float fixedIntensity, int numValues) const noexcept;
+	void applyPanModulation(const float * calculatedModValues, float * destinationValues, float fixedIntensity, int numValues) const noexcept;
 
 	void applyIntensityForGainValues(float* calculatedModulationValues, float fixedIntensity, int numValues) const;
 
@@ -668,10 +678,14 @@ public:
 		// applyTimeModulation will not work correctly if it's going to be calculated in place...
 		jassert(monoModulationValues != scratchBuffer);
 
-		setScratchBuffer(scratchBuffer, startSample + numSamples);
-		calculateBlock(startSample, numSamples);
+		if (!renderSharedModulationValues(monoModulationValues, scratchBuffer, startSample, numSamples))
+		{
+			setScratchBuffer(scratchBuffer, startSample + numSamples);
+			calculateBlock(startSample, numSamples);
+
+			applyTimeModulation(monoModulationValues, startSample, numSamples);
+		}
 
-		applyTimeModulation(monoModulationValues, startSample, numSamples);
 		lastConstantValue = monoModulationValues[startSample];
 
 #if ENABLE_ALL_PEAK_METERS
@@ -685,6 +699,28 @@ public:
 
 	}
 
+	/** Renders the modulator as fused gain stage of a ModulatorChain.
+	*
+	*	Instead of applying the intensity to the calculated values in a separate pass, it will be applied in the same loop 
+	*	that multiplies the values with the chain buffer. If it's the first stage of the chain, the values are written
+	*	directly, so the chain buffer doesn't need to be initialised. This only works in GainMode.
+	*/
+	void renderFusedGainStage(float* monoModulationValues, float* scratchBuffer, int startSample, int numSamples, bool isFirstStage);
+
+	/** Overwrite this and return a pointer to already calculated values if the modulator doesn't need to calculate them itself.
+	*
+	*	This is used by renderFusedGainStage() and render() to read the values without copying them into the internal buffer first.
+	*	The values must not be modified and must stay valid until the end of the current block.
+	*/
+	virtual const float* getSharedModulationValues(int /*startSample*/, int /*numSamples*/) { return nullptr; }
+
+	/** Applies the shared modulation values to the chain buffer if there are any and returns false otherwise. 
+	*
+	*	This is the zero-copy path of render() for the pitch and pan modes: the intensity is applied while reading the
+	*	shared values (into the scratch buffer for the pitch conversion), so they are never copied into the internal buffer.
+	*/
+	bool renderSharedModulationValues(float* monoModulationValues, float* scratchBuffer, int startSample, int numSamples);
+
 	float getLastConstantValue() const noexcept { return lastConstantValue; }
 
 protected:
@@ -1094,7 +1130,8 @@ class EnvelopeModulatorFactoryType: public FactoryType
 		tableEnvelope,
 		ccEnvelope,
 		scriptEnvelope,
-		mpeModulator
+		mpeModulator,
+		globalEnvelopeModulator
 	};
 
 public:
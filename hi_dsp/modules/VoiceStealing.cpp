@@ -0,0 +1,468 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+namespace hise { using namespace juce;
+
+String VoiceStealer::getPolicyName(Policy p)
+{
+	switch (p)
+	{
+	case Policy::Oldest:			return "Oldest";
+	case Policy::Quietest:			return "Quietest";
+	case Policy::LowestPriority:	return "LowestPriority";
+	case Policy::SameNote:			return "SameNote";
+	case Policy::numPolicies:		break;
+	}
+
+	jassertfalse;
+	return {};
+}
+
+VoiceStealer::Policy VoiceStealer::getPolicyFromName(const String& name)
+{
+	for (int i = 0; i < (int)Policy::numPolicies; i++)
+	{
+		if (getPolicyName((Policy)i) == name)
+			return (Policy)i;
+	}
+
+	return Policy::Oldest;
+}
+
+VoiceStealer::VoiceStealer(int numVoicesToTrack)
+{
+	// Allocate the priority table here so that changing the policy never allocates on the audio thread
+	eventPriorities.malloc(HISE_EVENT_ID_ARRAY_SIZE);
+	clearEventPriorities();
+
+	setNumVoices(numVoicesToTrack);
+}
+
+void VoiceStealer::setNumVoices(int newNumVoices)
+{
+	newNumVoices = jmax(1, newNumVoices);
+
+	if (newNumVoices == numVoices)
+		return;
+
+	numVoices = newNumVoices;
+
+	// The voice infos and the heap share one allocation
+	const size_t infoSize = sizeof(VoiceInfo) * (size_t)numVoices;
+	arena.allocate(infoSize + sizeof(int) * (size_t)numVoices, true);
+
+	info = reinterpret_cast<VoiceInfo*>(arena.get());
+	heap = reinterpret_cast<int*>(arena.get() + infoSize);
+
+	for (int i = 0; i < numVoices; i++)
+		new (info + i) VoiceInfo();
+
+	clear();
+}
+
+void VoiceStealer::clearEventPriorities() noexcept
+{
+	for (int i = 0; i < HISE_EVENT_ID_ARRAY_SIZE; i++)
+		eventPriorities[i] = EventPriority();
+}
+
+void VoiceStealer::setPolicy(Policy newPolicy)
+{
+	if (policy == newPolicy)
+		return;
+
+	policy = newPolicy;
+
+	if (policy == Policy::LowestPriority)
+		clearEventPriorities();
+
+	// The sort order has changed, so we need to rebuild the heap
+	heapSize = 0;
+
+	for (int i = 0; i < numVoices; i++)
+	{
+		info[i].heapPosition = -1;
+
+		if (info[i].active && !info[i].killed)
+			heapInsert(i);
+	}
+}
+
+void VoiceStealer::voiceStarted(int voiceIndex, uint16 eventId, int noteNumber, double startUptime, int priority)
+{
+	if (!isPositiveAndBelow(voiceIndex, numVoices))
+	{
+		jassertfalse;
+		return;
+	}
+
+	if (info[voiceIndex].active)
+		voiceRemoved(voiceIndex);
+
+	auto& v = info[voiceIndex];
+
+	v.active = true;
+	v.released = false;
+	v.killed = false;
+	v.eventId = eventId;
+	v.noteNumber = noteNumber;
+	v.startUptime = startUptime;
+	v.startIndex = startCounter++;
+	v.priority = priority;
+	v.level = 1.0f;
+
+	if (isPositiveAndBelow(noteNumber, 128))
+	{
+		v.prevSameNote = sameNoteTail[noteNumber];
+		v.nextSameNote = -1;
+
+		if (sameNoteTail[noteNumber] != -1)
+			info[sameNoteTail[noteNumber]].nextSameNote = voiceIndex;
+		else
+			sameNoteHead[noteNumber] = voiceIndex;
+
+		sameNoteTail[noteNumber] = voiceIndex;
+	}
+
+	// All voices of one note on message are started one after another,
+	// so we only need to check the last started voice.
+	if (isTracked(lastStartedVoice) && info[lastStartedVoice].eventId == eventId)
+	{
+		auto& sibling = info[lastStartedVoice];
+
+		v.prevSibling = lastStartedVoice;
+		v.nextSibling = sibling.nextSibling;
+		info[sibling.nextSibling].prevSibling = voiceIndex;
+		sibling.nextSibling = voiceIndex;
+	}
+	else
+	{
+		v.prevSibling = voiceIndex;
+		v.nextSibling = voiceIndex;
+	}
+
+	heapInsert(voiceIndex);
+
+	lastStartedVoice = voiceIndex;
+}
+
+void VoiceStealer::voiceReleased(int voiceIndex)
+{
+	if (!isTracked(voiceIndex) || info[voiceIndex].released)
+		return;
+
+	info[voiceIndex].released = true;
+
+	if (info[voiceIndex].heapPosition != -1)
+		heapUpdate(voiceIndex);
+}
+
+void VoiceStealer::voiceKilled(int voiceIndex)
+{
+	if (!isTracked(voiceIndex) || info[voiceIndex].killed)
+		return;
+
+	auto& v = info[voiceIndex];
+
+	heapRemove(voiceIndex);
+	unlinkSameNote(voiceIndex);
+
+	v.killed = true;
+	v.prevKilled = -1;
+	v.nextKilled = killedHead;
+
+	if (killedHead != -1)
+		info[killedHead].prevKilled = voiceIndex;
+
+	killedHead = voiceIndex;
+}
+
+void VoiceStealer::voiceRemoved(int voiceIndex)
+{
+	if (!isTracked(voiceIndex))
+		return;
+
+	heapRemove(voiceIndex);
+	unlinkSameNote(voiceIndex);
+	unlinkKilled(voiceIndex);
+	unlinkSibling(voiceIndex);
+
+	info[voiceIndex] = VoiceInfo();
+
+	if (lastStartedVoice == voiceIndex)
+		lastStartedVoice = -1;
+}
+
+void VoiceStealer::setVoiceLevel(int voiceIndex, float newLevel)
+{
+	if (!isTracked(voiceIndex))
+		return;
+
+	auto& v = info[voiceIndex];
+
+	if (v.level != newLevel)
+	{
+		v.level = newLevel;
+
+		if (policy == Policy::Quietest && v.heapPosition != -1)
+			heapUpdate(voiceIndex);
+	}
+}
+
+bool VoiceStealer::setPriorityForEvent(uint16 eventId, int priority)
+{
+	if (policy != Policy::LowestPriority)
+		return false;
+
+	auto& p = eventPriorities[eventId % HISE_EVENT_ID_ARRAY_SIZE];
+	p.eventId = (int)eventId;
+	p.priority = priority;
+
+	return true;
+}
+
+int VoiceStealer::getPriorityForEvent(uint16 eventId) const noexcept
+{
+	if (policy != Policy::LowestPriority)
+		return 0;
+
+	const auto& p = eventPriorities[eventId % HISE_EVENT_ID_ARRAY_SIZE];
+	return p.eventId == (int)eventId ? p.priority : 0;
+}
+
+void VoiceStealer::clearPriorityForEvent(uint16 eventId) noexcept
+{
+	auto& p = eventPriorities[eventId % HISE_EVENT_ID_ARRAY_SIZE];
+
+	if (p.eventId == (int)eventId)
+		p = EventPriority();
+}
+
+void VoiceStealer::clear()
+{
+	for (int i = 0; i < numVoices; i++)
+		info[i] = VoiceInfo();
+
+	for (int i = 0; i < 128; i++)
+	{
+		sameNoteHead[i] = -1;
+		sameNoteTail[i] = -1;
+	}
+
+	heapSize = 0;
+	killedHead = -1;
+	lastStartedVoice = -1;
+}
+
+int VoiceStealer::getVoiceToSteal(int noteNumber) const noexcept
+{
+	if (policy == Policy::SameNote && isPositiveAndBelow(noteNumber, 128) && sameNoteHead[noteNumber] != -1)
+		return sameNoteHead[noteNumber];
+
+	return heapSize > 0 ? heap[0] : -1;
+}
+
+int VoiceStealer::getVoiceBeingKilled() const noexcept
+{
+	return killedHead;
+}
+
+bool VoiceStealer::shouldBeStolenBefore(int a, int b) const noexcept
+{
+	const auto& va = info[a];
+	const auto& vb = info[b];
+
+	if (policy == Policy::LowestPriority && va.priority != vb.priority)
+		return va.priority < vb.priority;
+
+	if (va.released != vb.released)
+		return va.released;
+
+	if (policy == Policy::Quietest && va.level != vb.level)
+		return va.level < vb.level;
+
+	if (va.startUptime != vb.startUptime)
+		return va.startUptime < vb.startUptime;
+
+	// the counter might wrap around, but it's only used for voices started at the same time
+	return (int32)(va.startIndex - vb.startIndex) < 0;
+}
+
+void VoiceStealer::heapInsert(int voiceIndex) noexcept
+{
+	jassert(info[voiceIndex].heapPosition == -1);
+	jassert(heapSize < numVoices);
+
+	heap[heapSize] = voiceIndex;
+	info[voiceIndex].heapPosition = heapSize;
+	heapSize++;
+
+	siftUp(heapSize - 1);
+}
+
+void VoiceStealer::heapRemove(int voiceIndex) noexcept
+{
+	const int pos = info[voiceIndex].heapPosition;
+
+	if (pos == -1)
+		return;
+
+	const int lastPos = heapSize - 1;
+
+	if (pos != lastPos)
+		heapSwap(pos, lastPos);
+
+	heapSize--;
+	info[voiceIndex].heapPosition = -1;
+
+	if (pos != lastPos)
+	{
+		const int movedVoice = heap[pos];
+		siftUp(pos);
+		siftDown(info[movedVoice].heapPosition);
+	}
+}
+
+void VoiceStealer::heapUpdate(int voiceIndex) noexcept
+{
+	const int pos = info[voiceIndex].heapPosition;
+
+	jassert(pos != -1);
+
+	siftUp(pos);
+	siftDown(info[voiceIndex].heapPosition);
+}
+
+void VoiceStealer::heapSwap(int posA, int posB) noexcept
+{
+	std::swap(heap[posA], heap[posB]);
+	info[heap[posA]].heapPosition = posA;
+	info[heap[posB]].heapPosition = posB;
+}
+
+void VoiceStealer::siftUp(int pos) noexcept
+{
+	while (pos > 0)
+	{
+		const int parent = (pos - 1) / 2;
+
+		if (!shouldBeStolenBefore(heap[pos], heap[parent]))
+			break;
+
+		heapSwap(pos, parent);
+		pos = parent;
+	}
+}
+
+void VoiceStealer::siftDown(int pos) noexcept
+{
+	for (;;)
+	{
+		const int left = 2 * pos + 1;
+		const int right = left + 1;
+		int best = pos;
+
+		if (left < heapSize && shouldBeStolenBefore(heap[left], heap[best]))
+			best = left;
+
+		if (right < heapSize && shouldBeStolenBefore(heap[right], heap[best]))
+			best = right;
+
+		if (best == pos)
+			break;
+
+		heapSwap(pos, best);
+		pos = best;
+	}
+}
+
+void VoiceStealer::unlinkSameNote(int voiceIndex) noexcept
+{
+	auto& v = info[voiceIndex];
+
+	if (!isPositiveAndBelow(v.noteNumber, 128))
+		return;
+
+	const bool isLinked = v.prevSameNote != -1 || sameNoteHead[v.noteNumber] == voiceIndex;
+
+	if (!isLinked)
+		return;
+
+	if (v.prevSameNote != -1)
+		info[v.prevSameNote].nextSameNote = v.nextSameNote;
+	else
+		sameNoteHead[v.noteNumber] = v.nextSameNote;
+
+	if (v.nextSameNote != -1)
+		info[v.nextSameNote].prevSameNote = v.prevSameNote;
+	else
+		sameNoteTail[v.noteNumber] = v.prevSameNote;
+
+	v.prevSameNote = -1;
+	v.nextSameNote = -1;
+}
+
+void VoiceStealer::unlinkKilled(int voiceIndex) noexcept
+{
+	auto& v = info[voiceIndex];
+
+	if (!v.killed)
+		return;
+
+	if (v.prevKilled != -1)
+		info[v.prevKilled].nextKilled = v.nextKilled;
+	else
+		killedHead = v.nextKilled;
+
+	if (v.nextKilled != -1)
+		info[v.nextKilled].prevKilled = v.prevKilled;
+
+	v.prevKilled = -1;
+	v.nextKilled = -1;
+	v.killed = false;
+}
+
+void VoiceStealer::unlinkSibling(int voiceIndex) noexcept
+{
+	auto& v = info[voiceIndex];
+
+	if (v.nextSibling == -1)
+		return;
+
+	info[v.prevSibling].nextSibling = v.nextSibling;
+	info[v.nextSibling].prevSibling = v.prevSibling;
+
+	v.prevSibling = -1;
+	v.nextSibling = -1;
+}
+
+} // namespace hise
@@ -0,0 +1,234 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef VOICESTEALING_H_INCLUDED
+#define VOICESTEALING_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** Keeps track of the active voices of a ModulatorSynth and chooses the voice that should be stolen.
+*
+*	The candidates are kept in a binary heap that is updated when a voice is started, released, killed or removed,
+*	so finding the voice to steal doesn't need to iterate over all active voices. Picking a voice is O(1),
+*	every update is O(log n).
+*
+*	Additionally it maintains a few intrusive lists (voices with the same note number, voices that are being killed
+*	and voices that were started by the same event) so that the other lookups in the voice stealing logic are O(1), too.
+*
+*	It only works with voice indexes, so it can be used by every synth type without knowing the voice class.
+*	The per-voice state is sized with setNumVoices() and lives in a single allocation.
+*/
+class VoiceStealer
+{
+public:
+
+	/** The policies that define which voice will be stolen. */
+	enum class Policy
+	{
+		Oldest = 0,		///< steals the voice that was started first. Released voices are stolen before held voices.
+		Quietest,		///< steals the voice with the lowest gain modulation value. Released voices are stolen before held voices.
+		LowestPriority,	///< steals the voice with the lowest priority (see setPriorityForEvent()), then the oldest.
+		SameNote,		///< steals the oldest voice with the same note number, then falls back to Oldest.
+		numPolicies
+	};
+
+	static String getPolicyName(Policy p);
+
+	/** Returns the policy with the given name or Policy::Oldest if the name is not valid. */
+	static Policy getPolicyFromName(const String& name);
+
+	explicit VoiceStealer(int numVoicesToTrack = NUM_POLYPHONIC_VOICES);
+
+	/** Changes the amount of voices that can be tracked. This allocates and removes all voices, so call it when preparing the synth. */
+	void setNumVoices(int newNumVoices);
+
+	int getNumVoices() const noexcept { return numVoices; }
+
+	/** Changes the policy. This rebuilds the heap, so don't call it on every note. */
+	void setPolicy(Policy newPolicy);
+
+	Policy getPolicy() const noexcept { return policy; }
+
+	/** Call this when a voice was started. 
+	*
+	*	If the voice that was started before was started with the same event id, it will be added to its siblings.
+	*/
+	void voiceStarted(int voiceIndex, uint16 eventId, int noteNumber, double startUptime, int priority);
+
+	/** Call this when the note of a voice was released (the voice might still be playing). */
+	void voiceReleased(int voiceIndex);
+
+	/** Call this when the voice is faded out. It will be removed from the candidates but can still be force-killed. */
+	void voiceKilled(int voiceIndex);
+
+	/** Call this when the voice was reset and is inactive. */
+	void voiceRemoved(int voiceIndex);
+
+	/** Updates the level that is used by the Quietest policy. */
+	void setVoiceLevel(int voiceIndex, float newLevel);
+
+	/** Sets the priority for all voices that will be started by the event with the given id.
+	*
+	*	This is used by the LowestPriority policy and returns false if another policy is active.
+	*/
+	bool setPriorityForEvent(uint16 eventId, int priority);
+
+	/** Returns the priority that was set for the event or 0. */
+	int getPriorityForEvent(uint16 eventId) const noexcept;
+
+	/** Removes the priority of the event. Call this when the note is released so that the event id can be reused. */
+	void clearPriorityForEvent(uint16 eventId) noexcept;
+
+	/** Calls the function with the index of every voice that plays the given note number and is not being killed, oldest first.
+	*
+	*	The function must not start, kill or remove voices, so collect the indexes first if you need to do this.
+	*/
+	template <typename F> void forEachVoiceWithSameNote(int noteNumber, const F& f) const
+	{
+		if (!isPositiveAndBelow(noteNumber, 128))
+			return;
+
+		for (int i = sameNoteHead[noteNumber]; i != -1; i = info[i].nextSameNote)
+			f(i);
+	}
+
+	/** Removes all voices. */
+	void clear();
+
+	/** Returns the index of the voice that should be stolen to start a note with the given number, or -1. */
+	int getVoiceToSteal(int noteNumber) const noexcept;
+
+	/** Returns the index of a voice that is already fading out or -1. */
+	int getVoiceBeingKilled() const noexcept;
+
+	/** Returns the number of voices that can be stolen. */
+	int getNumCandidates() const noexcept { return heapSize; }
+
+	bool isTracked(int voiceIndex) const noexcept
+	{
+		return isPositiveAndBelow(voiceIndex, numVoices) && info[voiceIndex].active;
+	}
+
+	/** Calls the function with the index of every voice that was started with the same event (excluding the voice itself). 
+	*
+	*	The function must not modify the siblings of the voice (so don't call voiceRemoved() from within the function).
+	*	Only voices that were started directly after each other are linked (which is the case for all voices that are 
+	*	started by one note on), so a voice that is started later with the same event id (eg. with Synth.playNote()
+	*	after another note was started) gets its own sibling list.
+	*/
+	template <typename F> void forEachSibling(int voiceIndex, const F& f) const
+	{
+		if (!isTracked(voiceIndex))
+			return;
+
+		for (int i = info[voiceIndex].nextSibling; i != voiceIndex; i = info[i].nextSibling)
+			f(i);
+	}
+
+private:
+
+	struct VoiceInfo
+	{
+		double startUptime = 0.0;
+		uint32 startIndex = 0;
+		float level = 1.0f;
+		int priority = 0;
+		int noteNumber = -1;
+		uint16 eventId = 0;
+
+		int heapPosition = -1;
+
+		int prevSameNote = -1;
+		int nextSameNote = -1;
+
+		int prevKilled = -1;
+		int nextKilled = -1;
+
+		int prevSibling = -1;
+		int nextSibling = -1;
+
+		bool active = false;
+		bool released = false;
+		bool killed = false;
+	};
+
+	/** Returns true if the voice a should be stolen before the voice b. */
+	bool shouldBeStolenBefore(int a, int b) const noexcept;
+
+	void heapInsert(int voiceIndex) noexcept;
+	void heapRemove(int voiceIndex) noexcept;
+	void heapUpdate(int voiceIndex) noexcept;
+	void heapSwap(int posA, int posB) noexcept;
+	void siftUp(int pos) noexcept;
+	void siftDown(int pos) noexcept;
+
+	void unlinkSameNote(int voiceIndex) noexcept;
+	void unlinkKilled(int voiceIndex) noexcept;
+	void unlinkSibling(int voiceIndex) noexcept;
+
+	struct EventPriority
+	{
+		int eventId = -1;
+		int priority = 0;
+	};
+
+	// info and heap point into the arena, which holds numVoices elements of each
+	HeapBlock<char> arena;
+	VoiceInfo* info = nullptr;
+	int* heap = nullptr;
+	int numVoices = 0;
+
+	void clearEventPriorities() noexcept;
+
+	// indexed by the event id, allocated in the constructor and cleared when the LowestPriority policy is selected
+	HeapBlock<EventPriority> eventPriorities;
+
+	int heapSize = 0;
+
+	int sameNoteHead[128];
+	int sameNoteTail[128];
+
+	int killedHead = -1;
+
+	int lastStartedVoice = -1;
+
+	// used to sort voices that were started at the same time
+	uint32 startCounter = 0;
+
+	Policy policy = Policy::Oldest;
+
+	JUCE_DECLARE_NON_COPYABLE(VoiceStealer);
+};
+
+} // namespace hise
+
+#endif  // VOICESTEALING_H_INCLUDED
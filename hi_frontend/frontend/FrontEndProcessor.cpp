@@ -396,6 +396,8 @@ void FrontendProcessor::createPreset(const ValueTree& synthData)
 
 	synthChain->loadMacrosFromValueTree(synthData);
 
+	updateEffectLatency();
+
 	LOG_START("Adding plugin parameters");
 
     try
@@ -60,6 +60,7 @@ loadingThread(*this)
 	parameterNames.add("HiCut");
 	parameterNames.add("Damping");
 	parameterNames.add("FFTType");
+	parameterNames.add("UseMultiStage");
 
 	smoothedGainerWet.setParameter((int)ScriptingDsp::SmoothedGainer::Parameters::FastMode, 1.0f);
 	smoothedGainerDry.setParameter((int)ScriptingDsp::SmoothedGainer::Parameters::FastMode, 1.0f);
@@ -76,6 +77,7 @@ ConvolutionEffect::~ConvolutionEffect()
     
 	convolverL = nullptr;
 	convolverR = nullptr;
+	trueStereoConvolver = nullptr;
 }
 
 void ConvolutionEffect::createEngine(audiofft::ImplementationType fftType)
@@ -91,15 +93,26 @@ void ConvolutionEffect::createEngine(audiofft::ImplementationType fftType)
 
 		convolverL = nullptr;
 		convolverR = nullptr;
+		trueStereoConvolver = nullptr;
 
 		convolverL = new MultithreadedConvolver(fftType);
 		convolverR = new MultithreadedConvolver(fftType);
+		trueStereoConvolver = new MatrixConvolver(fftType);
 
 		convolverL->reset();
 		convolverR->reset();
 
-		convolverL->setUseBackgroundThread(useBackground);
-		convolverR->setUseBackgroundThread(useBackground);
+		setUseBackgroundThreadForEngines(useBackground);
+
+		convolverL->setUseMultiStage(useMultiStage);
+		convolverR->setUseMultiStage(useMultiStage);
+
+		if (getSampleRate() > 0.0)
+		{
+			convolverL->setSampleRate(getSampleRate());
+			convolverR->setSampleRate(getSampleRate());
+			trueStereoConvolver->setSampleRate(getSampleRate());
+		}
 
 		if (reload)
 			setImpulse();
@@ -108,6 +121,80 @@ void ConvolutionEffect::createEngine(audiofft::ImplementationType fftType)
 
 
 
+void ConvolutionEffect::setUseBackgroundThreadForEngines(bool shouldBeUsingBackgroundThread)
+{
+	convolverL->setUseBackgroundThread(shouldBeUsingBackgroundThread);
+	convolverR->setUseBackgroundThread(shouldBeUsingBackgroundThread);
+	trueStereoConvolver->setUseBackgroundThread(shouldBeUsingBackgroundThread);
+
+	// A job that is still running when switching to offline rendering must not be dropped
+	convolverL->setNonRealtime(nonRealtime);
+	convolverR->setNonRealtime(nonRealtime);
+	trueStereoConvolver->setNonRealtime(nonRealtime);
+}
+
+void ConvolutionEffect::processConvolution(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+{
+	if (isTrueStereo())
+	{
+		const float* inputs[2] = { inL, inR };
+		float* outputs[2] = { outL, outR };
+
+		trueStereoConvolver->process(inputs, outputs, numSamples);
+		return;
+	}
+
+	if (convolverL != nullptr)
+		convolverL->process(inL, outL, numSamples);
+
+	if (convolverR != nullptr)
+		convolverR->process(inR, outR, numSamples);
+}
+
+void ConvolutionEffect::cleanConvolutionPipeline()
+{
+	convolverL->cleanPipeline();
+	convolverR->cleanPipeline();
+	trueStereoConvolver->cleanPipeline();
+}
+
+bool ConvolutionEffect::isTrueStereo() const
+{
+	return trueStereoConvolver != nullptr && trueStereoConvolver->getNumInputs() > 0;
+}
+
+size_t ConvolutionEffect::getIRMemoryUsage() const
+{
+	ScopedLock sl(getImpulseLock());
+
+	if (isTrueStereo())
+		return trueStereoConvolver->getIRMemoryUsage();
+
+	size_t numBytes = 0;
+
+	if (convolverL != nullptr)
+		numBytes += convolverL->getIRMemoryUsage();
+
+	if (convolverR != nullptr)
+		numBytes += convolverR->getIRMemoryUsage();
+
+	return numBytes;
+}
+
+void ConvolutionEffect::voicesKilled()
+{
+	cleanConvolutionPipeline();
+	leftPredelay.clear();
+	rightPredelay.clear();
+}
+
+void ConvolutionEffect::nonRealtimeModeChanged(bool isNonRealtime)
+{
+	nonRealtime = isNonRealtime;
+
+	setUseBackgroundThreadForEngines(!nonRealtime && useBackgroundThread);
+}
+
 void ConvolutionEffect::setImpulse()
 {
 	enableProcessing(false);
@@ -128,6 +215,7 @@ float ConvolutionEffect::getAttribute(int parameterIndex) const
 	case HiCut:			return (float)cutoffFrequency;
 	case Damping:		return Decibels::gainToDecibels(damping);
 	case FFTType:		return (float)(int)currentType;
+	case UseMultiStage:	return useMultiStage ? 1.0f : 0.0f;
 	default:			jassertfalse; return 1.0f;
 	}
 }
@@ -152,8 +240,7 @@ void ConvolutionEffect::setInternalAttribute(int parameterIndex, float newValue)
 						enableProcessing(processingEnabled); 
 						break;
 	case UseBackgroundThread:	useBackgroundThread = newValue > 0.5f;
-								convolverL->setUseBackgroundThread(useBackgroundThread && !nonRealtime);
-								convolverR->setUseBackgroundThread(useBackgroundThread && !nonRealtime);
+								setUseBackgroundThreadForEngines(useBackgroundThread && !nonRealtime);
 								break;
 	case Predelay:		predelayMs = newValue;
 						calcPredelay();
@@ -166,6 +253,25 @@ void ConvolutionEffect::setInternalAttribute(int parameterIndex, float newValue)
 						setImpulse();
 						break;
 	case FFTType:		createEngine((audiofft::ImplementationType)(int)newValue); break;
+	case UseMultiStage:
+	{
+		const bool shouldUseMultiStage = newValue > 0.5f;
+
+		if (shouldUseMultiStage != useMultiStage)
+		{
+			useMultiStage = shouldUseMultiStage;
+
+			{
+				ScopedLock sl(getImpulseLock());
+				convolverL->setUseMultiStage(useMultiStage);
+				convolverR->setUseMultiStage(useMultiStage);
+			}
+
+			setImpulse();
+		}
+
+		break;
+	}
 	default:			jassertfalse; return;
 	}
 }
@@ -184,6 +290,7 @@ float ConvolutionEffect::getDefaultValue(int parameterIndex) const
 	case HiCut:			return 20000.0f;
 	case Damping:		return 0.0f;
 	case FFTType:		return (float)(int)audiofft::ImplementationType::BestAvailable;
+	case UseMultiStage:	return 0.0f;
 	default:			jassertfalse; return 1.0f;
 	}
 }
@@ -202,6 +309,7 @@ void ConvolutionEffect::restoreFromValueTree(const ValueTree &v)
 	loadAttributeWithDefault(HiCut);
 	loadAttribute(Damping, "Damping");
 	loadAttributeWithDefault(FFTType);
+	loadAttributeWithDefault(UseMultiStage);
 
 	AudioSampleProcessor::restoreFromValueTree(v);
 }
@@ -220,6 +328,7 @@ ValueTree ConvolutionEffect::exportAsValueTree() const
 	saveAttribute(HiCut, "HiCut");
 	saveAttribute(Damping, "Damping");
 	saveAttribute(FFTType, "FFTType");
+	saveAttribute(UseMultiStage, "UseMultiStage");
 
 	AudioSampleProcessor::saveToValueTree(v);
 
@@ -244,6 +353,10 @@ void ConvolutionEffect::prepareToPlay(double sampleRate, int samplesPerBlock)
 		leftPredelay.prepareToPlay(sampleRate);
 		rightPredelay.prepareToPlay(sampleRate);
 
+		convolverL->setSampleRate(sampleRate);
+		convolverR->setSampleRate(sampleRate);
+		trueStereoConvolver->setSampleRate(sampleRate);
+
 		setImpulse();
 	}
 
@@ -309,21 +422,13 @@ void ConvolutionEffect::applyEffect(AudioSampleBuffer &buffer, int startSample,
 				s_gain += s_step;
 			}
 			
-			if (convolverL != nullptr)
-				convolverL->process(smoothed_input_l, convolutedL, numSamples);
-
-			if (convolverR != nullptr)
-				convolverR->process(smoothed_input_r, convolutedR, numSamples);
+			processConvolution(smoothed_input_l, smoothed_input_r, convolutedL, convolutedR, numSamples);
 
 			smoothInputBuffer = false;
 		}
 		else
 		{
-			if (convolverL != nullptr)
-				convolverL->process(l, convolutedL, numSamples);
-
-			if (convolverR != nullptr)
-				convolverR->process(r, convolutedR, numSamples);
+			processConvolution(l, r, convolutedL, convolutedR, numSamples);
 		}
 		
 		smoothedGainerDry.processBlock(channels, 2, numSamples);
@@ -353,10 +458,7 @@ void ConvolutionEffect::applyEffect(AudioSampleBuffer &buffer, int startSample,
 			if (rampIndex >= rampingTime)
 			{
 				if (!processFlag)
-				{
-					convolverL->cleanPipeline();
-					convolverR->cleanPipeline();
-				}
+					cleanConvolutionPipeline();
 
 				rampFlag = false;
 			}
@@ -444,8 +546,7 @@ void ConvolutionEffect::calcPredelay()
 
 void ConvolutionEffect::applyExponentialFadeout(AudioSampleBuffer& buffer, int numSamples, float targetValue)
 {
-	float* l = buffer.getWritePointer(0);
-	float* r = buffer.getWritePointer(1);
+	auto data = buffer.getArrayOfWritePointers();
 
 	const float base = targetValue;
 	const float invBase = 1.0f - targetValue;
@@ -455,8 +556,8 @@ void ConvolutionEffect::applyExponentialFadeout(AudioSampleBuffer& buffer, int n
 	{
 		const float multiplier = base + invBase * expf((float)i / factor);
 
-		*l++ *= multiplier;
-		*r++ *= multiplier;
+		for (int c = 0; c < buffer.getNumChannels(); c++)
+			data[c][i] *= multiplier;
 	}
 }
 
@@ -470,13 +571,13 @@ void ConvolutionEffect::applyHighFrequencyDamping(AudioSampleBuffer& buffer, int
 	lp1.setType(SimpleOnePole::FilterType::LP);
 	lp1.setFrequency(20000.0);
 	lp1.setSampleRate(sampleRate >= 0.0 ? sampleRate : 44100.0);
-	lp1.setNumChannels(2);
+	lp1.setNumChannels(buffer.getNumChannels());
 
 	SimpleOnePole lp2;
 	lp2.setType(SimpleOnePole::FilterType::LP);
 	lp2.setFrequency(20000.0);
 	lp2.setSampleRate(sampleRate >= 0.0 ? sampleRate : 44100.0);
-	lp2.setNumChannels(2);
+	lp2.setNumChannels(buffer.getNumChannels());
 	
 
 	for (int i = 0; i < numSamples; i += 64)
@@ -576,10 +677,7 @@ void ConvolutionEffect::LoadingThread::run()
 
 		if (doSomething)
 		{
-			ScopedLock sl(parent.getImpulseLock());
-
-			ScopedValueSetter<bool> svs(parent.isReloading, true);
-
+			// reloadInternal() only locks the impulse while it copies the settings and swaps the engines
 			shouldRestart = false;
 			
 			if (reloadInternal())
@@ -597,62 +695,929 @@ void ConvolutionEffect::LoadingThread::run()
 
 bool ConvolutionEffect::LoadingThread::reloadInternal()
 {
-    if(parent.convolverL == nullptr)
-        return true;
-    
-	if (parent.getSampleBuffer() == nullptr || parent.getSampleBuffer()->getNumChannels() == 0)
+	AudioSampleBuffer pBuffer;
+	double resampleRatio;
+	Range<int> range;
+
 	{
 		ScopedLock sl(parent.getImpulseLock());
 
-		parent.convolverL->reset();
-		parent.convolverR->reset();
+		if (parent.convolverL == nullptr)
+			return true;
+
+		if (parent.getSampleBuffer() == nullptr || parent.getSampleBuffer()->getNumChannels() == 0)
+		{
+			ScopedValueSetter<bool> svs(parent.isReloading, true);
+
+			parent.convolverL->reset();
+			parent.convolverR->reset();
+			parent.trueStereoConvolver->reset();
+			return true;
+		}
+
+		pBuffer = *parent.getSampleBuffer();
+		resampleRatio = parent.getResampleFactor();
+		range = parent.getRange();
+	}
+
+	if (range.isEmpty())
+		range = { 0, pBuffer.getNumSamples() };
+
+	const auto resampledLength = roundToInt((double)range.getLength() * resampleRatio);
+	const auto headSize = nextPowerOfTwo(parent.getLargestBlockSize());
+	const auto fullTailLength = nextPowerOfTwo(resampledLength - headSize);
+
+	ConvolutionImpulseCache::Key key;
+
+	key.reference = parent.getFileName();
+	key.sampleRate = parent.getSampleRate();
+	key.range = range;
+
+	// A 4 channel impulse response contains the paths LL, LR, RL, RR
+	key.numChannels = pBuffer.getNumChannels() == 4 ? 4 : 2;
+	key.headBlockSize = (size_t)headSize;
+	key.tailBlockSize = (size_t)jmin<int>(8192, fullTailLength);
+	key.multiStage = parent.useMultiStage && key.numChannels == 2;
+	key.fftType = parent.currentType;
+	key.damping = parent.damping;
+	key.cutoffFrequency = parent.cutoffFrequency;
+
+	// Impulse responses without a pool reference can't be identified, so they are not cached
+	const bool useCache = key.reference.isNotEmpty();
+
+	ConvolutionImpulseCache::Entry::Ptr entry = useCache ? parent.impulseCache->getEntry(key) : nullptr;
+
+	if (entry == nullptr)
+	{
+		entry = createCacheEntry(pBuffer, key, resampleRatio);
+
+		if (entry == nullptr)
+			return false;
+
+		if (useCache)
+			parent.impulseCache->addEntry(entry);
+	}
+
+	auto& impulse = entry->impulse;
+
+	// Everything above runs without the lock, so the audio thread keeps playing the old impulse until here
+	ScopedLock sl(parent.getImpulseLock());
+	ScopedValueSetter<bool> svs(parent.isReloading, true);
+
+	if (parent.convolverL == nullptr)
 		return true;
+
+	parent.convolverL->reset();
+	parent.convolverR->reset();
+	parent.trueStereoConvolver->reset();
+
+	if (key.numChannels == 4)
+	{
+		if (entry->preparedMatrix != nullptr)
+			parent.trueStereoConvolver->init(entry->preparedMatrix);
+		else
+			parent.trueStereoConvolver->init(key.headBlockSize, key.tailBlockSize, 2, 2, impulse.getArrayOfReadPointers(), impulse.getNumSamples());
+	}
+	else if (entry->preparedChannels.size() == 2 && parent.convolverL->isUsingMultiStage())
+	{
+		parent.convolverL->init(entry->preparedChannels[0]);
+		parent.convolverR->init(entry->preparedChannels[1]);
 	}
+	else if (entry->preparedTwoStageChannels.size() == 2 && !parent.convolverL->isUsingMultiStage())
+	{
+		parent.convolverL->init(entry->preparedTwoStageChannels[0]);
+		parent.convolverR->init(entry->preparedTwoStageChannels[1]);
+	}
+	else
+	{
+		parent.convolverL->init(key.headBlockSize, key.tailBlockSize, impulse.getReadPointer(0), impulse.getNumSamples());
+		parent.convolverR->init(key.headBlockSize, key.tailBlockSize, impulse.getReadPointer(1), impulse.getNumSamples());
+	}
+
+	parent.enableProcessing(parent.processingEnabled);
+
+	return true;
+}
 
-	auto pBuffer = *parent.getSampleBuffer();
+ConvolutionImpulseCache::Entry::Ptr ConvolutionEffect::LoadingThread::createCacheEntry(const AudioSampleBuffer& originalBuffer, const ConvolutionImpulseCache::Key& key, double resampleRatio)
+{
+	ConvolutionImpulseCache::Entry::Ptr e = new ConvolutionImpulseCache::Entry();
 
-	auto resampleRatio = parent.getResampleFactor();
+	e->key = key;
 
-	AudioSampleBuffer scratchBuffer;
+	auto& scratchBuffer = e->impulse;
 
-	if (!MultithreadedConvolver::prepareImpulseResponse(pBuffer, scratchBuffer, &shouldRestart, parent.getRange(), resampleRatio))
-		return false;
+	if (!MultithreadedConvolver::prepareImpulseResponse(originalBuffer, scratchBuffer, &shouldRestart, key.range, resampleRatio, key.numChannels))
+		return nullptr;
 
 	auto resampledLength = scratchBuffer.getNumSamples();
 
 	if (shouldRestart)
-		return false;
+		return nullptr;
 
-	if (parent.damping != 1.0f)
-		applyExponentialFadeout(scratchBuffer, resampledLength, parent.damping);
+	if (key.damping != 1.0f)
+		applyExponentialFadeout(scratchBuffer, resampledLength, key.damping);
 
 	if (shouldRestart)
-		return false;
+		return nullptr;
 
-	if (parent.cutoffFrequency != 20000.0)
-		applyHighFrequencyDamping(scratchBuffer, resampledLength, parent.cutoffFrequency, parent.getSampleRate());
+	if (key.cutoffFrequency != 20000.0)
+		applyHighFrequencyDamping(scratchBuffer, resampledLength, key.cutoffFrequency, key.sampleRate);
 
 	if (shouldRestart)
+		return nullptr;
+
+	if (key.numChannels == 4)
+	{
+		e->preparedMatrix = MatrixConvolver::prepare(key.fftType, key.headBlockSize, key.tailBlockSize, 2, 2, scratchBuffer.getArrayOfReadPointers(), resampledLength);
+
+		if (shouldRestart)
+			return nullptr;
+	}
+	else
+	{
+		for (int i = 0; i < scratchBuffer.getNumChannels(); i++)
+		{
+			auto data = scratchBuffer.getReadPointer(i);
+
+			if (key.multiStage)
+				e->preparedChannels.add(MultiStageConvolver::prepare(key.fftType, key.headBlockSize, key.tailBlockSize, data, resampledLength));
+			else
+				e->preparedTwoStageChannels.add(fftconvolver::TwoStageFFTConvolver::prepare(key.fftType, key.headBlockSize, key.tailBlockSize, data, resampledLength));
+
+			if (shouldRestart)
+				return nullptr;
+		}
+	}
+
+	return e;
+}
+
+void ConvolutionEffect::poolEntryReloaded(PoolReference referenceThatWasChanged)
+{
+	impulseCache->removeEntries(referenceThatWasChanged.getReferenceString());
+	AudioSampleProcessor::poolEntryReloaded(referenceThatWasChanged);
+}
+
+bool ConvolutionImpulseCache::Key::operator==(const Key& other) const
+{
+	return reference == other.reference &&
+		   sampleRate == other.sampleRate &&
+		   range == other.range &&
+		   numChannels == other.numChannels &&
+		   headBlockSize == other.headBlockSize &&
+		   tailBlockSize == other.tailBlockSize &&
+		   multiStage == other.multiStage &&
+		   fftType == other.fftType &&
+		   damping == other.damping &&
+		   cutoffFrequency == other.cutoffFrequency;
+}
+
+size_t ConvolutionImpulseCache::Entry::getMemoryUsage() const
+{
+	size_t numBytes = (size_t)impulse.getNumChannels() * (size_t)impulse.getNumSamples() * sizeof(float);
+
+	for (auto p : preparedChannels)
+		numBytes += p->getMemoryUsage();
+
+	for (auto p : preparedTwoStageChannels)
+	{
+		if (p != nullptr)
+			numBytes += p->getMemoryUsage();
+	}
+
+	if (preparedMatrix != nullptr)
+		numBytes += preparedMatrix->getMemoryUsage();
+
+	return numBytes;
+}
+
+std::atomic<size_t> ConvolutionImpulseCache::maxMemoryUsage((size_t)HISE_CONVOLUTION_CACHE_SIZE_MB * 1024 * 1024);
+
+void ConvolutionImpulseCache::setMaxMemoryUsage(size_t numBytes)
+{
+	maxMemoryUsage = numBytes;
+}
+
+size_t ConvolutionImpulseCache::getMaxMemoryUsage()
+{
+	return maxMemoryUsage.load();
+}
+
+ConvolutionImpulseCache::Entry::Ptr ConvolutionImpulseCache::getEntry(const Key& key)
+{
+	ScopedLock sl(lock);
+
+	for (int i = 0; i < entries.size(); i++)
+	{
+		if (entries[i]->key == key)
+		{
+			Entry::Ptr e = entries[i];
+
+			// move it to the end so that it will be removed last
+			entries.remove(i);
+			entries.add(e);
+
+			return e;
+		}
+	}
+
+	return nullptr;
+}
+
+void ConvolutionImpulseCache::addEntry(Entry::Ptr newEntry)
+{
+	ScopedLock sl(lock);
+
+	for (int i = 0; i < entries.size(); i++)
+	{
+		if (entries[i]->key == newEntry->key)
+		{
+			entries.remove(i);
+			break;
+		}
+	}
+
+	entries.add(newEntry);
+	removeLeastRecentlyUsedEntries();
+}
+
+void ConvolutionImpulseCache::removeEntries(const String& reference)
+{
+	ScopedLock sl(lock);
+
+	for (int i = entries.size() - 1; i >= 0; i--)
+	{
+		if (entries[i]->key.reference == reference)
+			entries.remove(i);
+	}
+}
+
+size_t ConvolutionImpulseCache::getMemoryUsage() const
+{
+	ScopedLock sl(lock);
+
+	size_t numBytes = 0;
+
+	for (auto e : entries)
+		numBytes += e->getMemoryUsage();
+
+	return numBytes;
+}
+
+void ConvolutionImpulseCache::removeLeastRecentlyUsedEntries()
+{
+	// Always keep the most recent entry, even if it's bigger than the limit
+	while (entries.size() > 1 && (entries.size() > (int)MaxNumEntries || getMemoryUsage() > getMaxMemoryUsage()))
+		entries.remove(0);
+}
+
+ConvolutionWorkerPool::WorkerThread::WorkerThread(ConvolutionWorkerPool& parent_, int index) :
+	Thread("Convolution Worker " + String(index + 1)),
+	parent(parent_)
+{
+
+}
+
+void ConvolutionWorkerPool::WorkerThread::run()
+{
+	while (!threadShouldExit())
+	{
+		if (!parent.runNextJob())
+			parent.jobAvailable.wait(500);
+	}
+}
+
+ConvolutionWorkerPool::ConvolutionWorkerPool()
+{
+	for (auto& s : slots)
+	{
+		s.state.store(Free);
+		s.job.store(nullptr);
+		s.deadline.store(0.0);
+	}
+
+	numUsedSlots.store(0);
+
+	// leave one core for the audio thread
+	const int numThreads = jlimit<int>(1, (int)MaxNumThreads, SystemStats::getNumCpus() - 1);
+
+	for (int i = 0; i < numThreads; i++)
+	{
+		workers.add(new WorkerThread(*this, i));
+		workers.getLast()->startThread(9);
+	}
+}
+
+ConvolutionWorkerPool::~ConvolutionWorkerPool()
+{
+	for (auto w : workers)
+		w->signalThreadShouldExit();
+
+	for (int i = 0; i < workers.size(); i++)
+		jobAvailable.signal();
+
+	for (auto w : workers)
+		w->stopThread(1000);
+}
+
+int ConvolutionWorkerPool::registerJob(Job* job)
+{
+	for (int i = 0; i < MaxNumJobs; i++)
+	{
+		auto& s = slots[i];
+		int expected = Free;
+
+		if (s.state.compare_exchange_strong(expected, Registering))
+		{
+			s.job.store(job);
+			s.state.store(Idle);
+
+			int used = numUsedSlots.load();
+
+			while (used < i + 1 && !numUsedSlots.compare_exchange_weak(used, i + 1))
+				;
+
+			return i;
+		}
+	}
+
+	// More than 256 convolution instances? Really?
+	jassertfalse;
+	return -1;
+}
+
+void ConvolutionWorkerPool::unregisterJob(int slotIndex)
+{
+	if (!isPositiveAndBelow(slotIndex, (int)MaxNumJobs))
+		return;
+
+	auto& s = slots[slotIndex];
+
+	for (;;)
+	{
+		int expected = s.state.load();
+
+		if (expected == Running)
+		{
+			Thread::yield();
+			continue;
+		}
+
+		if (s.state.compare_exchange_strong(expected, Registering))
+			break;
+	}
+
+	s.job.store(nullptr);
+	s.state.store(Free);
+}
+
+void ConvolutionWorkerPool::addJob(int slotIndex, double deadlineMilliseconds)
+{
+	auto& s = slots[slotIndex];
+
+	s.deadline.store(Time::getMillisecondCounterHiRes() + deadlineMilliseconds);
+
+	int expected = Idle;
+
+	if (s.state.compare_exchange_strong(expected, Queued))
+		jobAvailable.signal();
+	else
+		jassertfalse; // the last job should have been finished with waitForJob()
+}
+
+bool ConvolutionWorkerPool::waitForJob(int slotIndex, int maxNumSpins)
+{
+	auto& s = slots[slotIndex];
+
+	for (int numSpins = 0;; numSpins++)
+	{
+		int expected = Queued;
+
+		// Not picked up by a worker yet, so we render it here instead of waiting for the pool
+		if (s.state.compare_exchange_strong(expected, Running))
+		{
+			runSlot(s);
+			return true;
+		}
+
+		if (expected != Running)
+			return true;
+
+		if (maxNumSpins != -1 && numSpins >= maxNumSpins)
+			return false;
+
+		Thread::yield();
+	}
+}
+
+bool ConvolutionWorkerPool::runNextJob()
+{
+	const int numToCheck = numUsedSlots.load();
+
+	for (;;)
+	{
+		Slot* earliest = nullptr;
+		double earliestDeadline = std::numeric_limits<double>::max();
+
+		for (int i = 0; i < numToCheck; i++)
+		{
+			auto& s = slots[i];
+
+			if (s.state.load() == Queued)
+			{
+				auto d = s.deadline.load();
+
+				if (d < earliestDeadline)
+				{
+					earliestDeadline = d;
+					earliest = &s;
+				}
+			}
+		}
+
+		if (earliest == nullptr)
+			return false;
+
+		int expected = Queued;
+
+		// Another thread might have grabbed it in the meantime, so we need to search again
+		if (earliest->state.compare_exchange_strong(expected, Running))
+		{
+			runSlot(*earliest);
+			return true;
+		}
+	}
+}
+
+void ConvolutionWorkerPool::runSlot(Slot& s)
+{
+	jassert(s.state.load() == Running);
+
+	if (auto j = s.job.load())
+		j->runJob();
+
+	s.state.store(Idle);
+}
+
+MultiStageConvolver::MultiStageConvolver(audiofft::ImplementationType fftType_) :
+	fftType(fftType_),
+	head(fftType_)
+{
+
+}
+
+MultiStageConvolver::~MultiStageConvolver()
+{
+	reset();
+}
+
+MultiStageConvolver::PreparedImpulse::Ptr MultiStageConvolver::prepare(audiofft::ImplementationType fftType, size_t headBlockSize, size_t tailBlockSize, const Sample* ir, size_t irLen)
+{
+	if (headBlockSize == 0 || tailBlockSize == 0)
+		return nullptr;
+
+	PreparedImpulse::Ptr p = new PreparedImpulse();
+
+	// Ignore zeros at the end of the impulse response because they only waste computation time
+	while (irLen > 0 && std::abs(ir[irLen - 1]) < 0.000001f)
+		--irLen;
+
+	if (irLen == 0)
+		return p;
+
+	headBlockSize = (size_t)nextPowerOfTwo((int)headBlockSize);
+	tailBlockSize = jmax(headBlockSize, (size_t)nextPowerOfTwo((int)tailBlockSize));
+
+	Array<size_t> blockSizes;
+
+	for (auto b = headBlockSize * StageFactor; b <= tailBlockSize && 2 * b < irLen; b *= StageFactor)
+		blockSizes.add(b);
+
+	const auto headLength = blockSizes.isEmpty() ? irLen : 2 * blockSizes.getFirst();
+
+	p->headBlockSize = headBlockSize;
+	p->headImpulse.resize(headLength);
+	memcpy(p->headImpulse.data(), ir, headLength * sizeof(Sample));
+
+	audiofft::AudioFFT fft(fftType);
+
+	for (int i = 0; i < blockSizes.size(); i++)
+	{
+		const auto offset = 2 * blockSizes[i];
+		const auto end = i == blockSizes.size() - 1 ? irLen : 2 * blockSizes[i + 1];
+		const auto length = end - offset;
+
+		auto s = new PreparedImpulse::Segments();
+
+		s->blockSize = blockSizes[i];
+		s->complexSize = audiofft::AudioFFT::ComplexSize(2 * s->blockSize);
+
+		// keep every segment aligned for the SSE loads in ComplexMultiplyAccumulate()
+		s->segmentStride = (s->complexSize + 3) & ~(size_t)3;
+		s->numSegments = (length + s->blockSize - 1) / s->blockSize;
+
+		// The segments are stored next to each other so that the multiply-accumulate loop walks through linear memory
+		s->real.resize(s->numSegments * s->segmentStride);
+		s->imag.resize(s->numSegments * s->segmentStride);
+
+		fftconvolver::SampleBuffer fftBuffer(2 * s->blockSize);
+		fft.init(2 * s->blockSize);
+
+		for (size_t j = 0; j < s->numSegments; j++)
+		{
+			const auto segmentOffset = j * s->blockSize;
+			const auto numToCopy = jmin(s->blockSize, length - segmentOffset);
+
+			fftconvolver::CopyAndPad(fftBuffer, ir + offset + segmentOffset, numToCopy);
+			fft.fft(fftBuffer.data(), s->real.data() + j * s->segmentStride, s->imag.data() + j * s->segmentStride);
+		}
+
+		p->stages.add(s);
+	}
+
+	return p;
+}
+
+size_t MultiStageConvolver::PreparedImpulse::getMemoryUsage() const
+{
+	size_t numBytes = headImpulse.size() * sizeof(Sample);
+
+	for (auto s : stages)
+		numBytes += (s->real.size() + s->imag.size()) * sizeof(Sample);
+
+	return numBytes;
+}
+
+bool MultiStageConvolver::init(size_t headBlockSize, size_t tailBlockSize, const Sample* ir, size_t irLen)
+{
+	return init(prepare(fftType, headBlockSize, tailBlockSize, ir, irLen));
+}
+
+bool MultiStageConvolver::init(PreparedImpulse::Ptr preparedImpulse)
+{
+	reset();
+
+	if (preparedImpulse == nullptr)
 		return false;
 
-	const auto headSize = nextPowerOfTwo(parent.getLargestBlockSize());
-	const auto fullTailLength = nextPowerOfTwo(resampledLength - headSize);
+	impulse = preparedImpulse;
 
-	ScopedLock sl(parent.getImpulseLock());
+	if (impulse->headImpulse.size() == 0)
+		return true;
 
-    
-	parent.convolverL->reset();
-	parent.convolverR->reset();
-	parent.convolverL->init(headSize, jmin<int>(8192, fullTailLength), scratchBuffer.getReadPointer(0), resampledLength);
-	parent.convolverR->init(headSize, jmin<int>(8192, fullTailLength), scratchBuffer.getReadPointer(1), resampledLength);
-	parent.enableProcessing(parent.processingEnabled);
+	head.init(impulse->headBlockSize, impulse->headImpulse.data(), impulse->headImpulse.size());
+
+	for (auto segments : impulse->stages)
+	{
+		auto s = new Stage(*pool, fftType);
+		s->init(*segments);
+		stages.add(s);
+	}
+
+	return true;
+}
+
+void MultiStageConvolver::process(const Sample* input, Sample* output, size_t len)
+{
+	head.process(input, output, len);
+
+	if (stages.isEmpty())
+		return;
+
+	// The first stage has the smallest block size, so we split the buffer at its boundaries
+	auto& first = *stages.getFirst();
+
+	size_t processed = 0;
+
+	while (processed < len)
+	{
+		const auto numThisTime = jmin(len - processed, first.blockSize - first.inputFill);
+
+		for (auto s : stages)
+		{
+			FloatVectorOperations::add(output + processed, s->precalculated.data() + s->inputFill, (int)numThisTime);
+			memcpy(s->input.data() + s->inputFill, input + processed, numThisTime * sizeof(Sample));
+
+			s->inputFill += numThisTime;
+
+			if (s->inputFill == s->blockSize)
+			{
+				finishStageBlock(*s);
+				s->inputFill = 0;
+			}
+		}
+
+		processed += numThisTime;
+	}
+}
+
+void MultiStageConvolver::reset()
+{
+	// The destructor of each stage unregisters its job and waits until it's finished
+	stages.clear();
+	head.reset();
+	impulse = nullptr;
+}
+
+size_t MultiStageConvolver::getIRMemoryUsage() const
+{
+	size_t numBytes = head.getIRMemoryUsage();
+
+	for (auto s : stages)
+	{
+		if (s->segments != nullptr)
+			numBytes += (s->segments->real.size() + s->segments->imag.size()) * sizeof(Sample);
+	}
+
+	return numBytes;
+}
+
+void MultiStageConvolver::cleanPipeline()
+{
+	for (auto s : stages)
+	{
+		waitForStage(*s, -1);
+		s->cleanPipeline();
+	}
+
+	head.resetInput();
+}
+
+void MultiStageConvolver::finishStageBlock(Stage& s)
+{
+	if (!waitForStage(s, nonRealtime ? -1 : ConvolutionWorkerPool::MaxNumWaitSpins))
+	{
+		// The worker is late, so this block of the stage is silent instead of stalling the audio thread. 
+		// The input is rendered with the next job so that it isn't missing in the history of the stage
+		// (if the worker is late for more than one block, only the last input block is kept).
+		s.late = true;
+		s.precalculated.setZero();
+		s.skippedInput.copyFrom(s.input);
+		return;
+	}
+
+	if (s.late)
+	{
+		// The late result belongs to a block that was already played silent, so it's thrown away
+		s.late = false;
+		s.precalculated.setZero();
+		s.backgroundSkippedInput.copyFrom(s.skippedInput);
+		s.renderSkippedInput = true;
+	}
+	else
+	{
+		SampleBuffer::Swap(s.precalculated, s.output);
+		s.renderSkippedInput = false;
+	}
+
+	s.backgroundInput.copyFrom(s.input);
+	startStage(s);
+}
+
+void MultiStageConvolver::startStage(Stage& s)
+{
+	if (useBackgroundThread && s.jobIndex != -1)
+	{
+		// The result is needed when the next block of this stage is filled
+		const auto deadline = 1000.0 * (double)s.blockSize / sampleRate;
+		pool->addJob(s.jobIndex, deadline);
+	}
+	else
+	{
+		s.runJob();
+	}
+}
+
+bool MultiStageConvolver::waitForStage(Stage& s, int maxNumSpins)
+{
+	// Always wait for the job, the flag might have been changed since the last call
+	if (s.jobIndex != -1)
+		return pool->waitForJob(s.jobIndex, maxNumSpins);
+
+	return true;
+}
+
+MultiStageConvolver::Stage::Stage(ConvolutionWorkerPool& pool_, audiofft::ImplementationType fftType) :
+	pool(pool_),
+	fft(fftType)
+{
+	jobIndex = pool.registerJob(this);
+}
+
+MultiStageConvolver::Stage::~Stage()
+{
+	pool.unregisterJob(jobIndex);
+}
+
+void MultiStageConvolver::Stage::init(const PreparedImpulse::Segments& newSegments)
+{
+	segments = &newSegments;
+	blockSize = segments->blockSize;
+	currentSegment = 0;
+	inputFill = 0;
+
+	fft.init(2 * blockSize);
+	fftBuffer.resize(2 * blockSize);
+
+	inputReal.resize(segments->numSegments * segments->segmentStride);
+	inputImag.resize(segments->numSegments * segments->segmentStride);
+
+	convReal.resize(segments->complexSize);
+	convImag.resize(segments->complexSize);
+	overlap.resize(blockSize);
+
+	input.resize(blockSize);
+	backgroundInput.resize(blockSize);
+	skippedInput.resize(blockSize);
+	backgroundSkippedInput.resize(blockSize);
+	output.resize(blockSize);
+	precalculated.resize(blockSize);
+}
+
+void MultiStageConvolver::Stage::runJob()
+{
+	// The output of the skipped block is too late to be played, it only updates the history of the stage
+	if (renderSkippedInput)
+		processBlock(backgroundSkippedInput.data());
+
+	processBlock(backgroundInput.data());
+}
+
+void MultiStageConvolver::Stage::processBlock(const Sample* blockInput)
+{
+	const auto numSegments = segments->numSegments;
+	const auto stride = segments->segmentStride;
+
+	fftconvolver::CopyAndPad(fftBuffer, blockInput, blockSize);
+	fft.fft(fftBuffer.data(), inputReal.data() + currentSegment * stride, inputImag.data() + currentSegment * stride);
+
+	convReal.setZero();
+	convImag.setZero();
+
+	for (size_t i = 0; i < numSegments; i++)
+	{
+		const auto inputIndex = (currentSegment + i) % numSegments;
+
+		fftconvolver::ComplexMultiplyAccumulate(convReal.data(), convImag.data(),
+			segments->real.data() + i * stride, segments->imag.data() + i * stride,
+			inputReal.data() + inputIndex * stride, inputImag.data() + inputIndex * stride,
+			segments->complexSize);
+	}
+
+	fft.ifft(fftBuffer.data(), convReal.data(), convImag.data());
+
+	fftconvolver::Sum(output.data(), fftBuffer.data(), overlap.data(), blockSize);
+	memcpy(overlap.data(), fftBuffer.data() + blockSize, blockSize * sizeof(Sample));
+
+	currentSegment = currentSegment > 0 ? currentSegment - 1 : numSegments - 1;
+}
+
+void MultiStageConvolver::Stage::cleanPipeline()
+{
+	inputReal.setZero();
+	inputImag.setZero();
+	overlap.setZero();
+	input.setZero();
+	backgroundInput.setZero();
+	skippedInput.setZero();
+	backgroundSkippedInput.setZero();
+	output.setZero();
+	precalculated.setZero();
+	inputFill = 0;
+	currentSegment = 0;
+	late = false;
+	renderSkippedInput = false;
+}
+
+MultithreadedConvolver::MultithreadedConvolver(audiofft::ImplementationType fftType_) :
+	TwoStageFFTConvolver(fftType_),
+	tailJob(*this),
+	fftType(fftType_)
+{
+	jobIndex = pool->registerJob(&tailJob);
+
+	if (jobIndex == -1)
+		useBackgroundThread = false;
+}
+
+MultithreadedConvolver::~MultithreadedConvolver()
+{
+	pool->unregisterJob(jobIndex);
+}
+
+bool MultithreadedConvolver::init(size_t headBlockSize, size_t tailBlockSize, const fftconvolver::Sample* ir, size_t irLen)
+{
+	if (multiStage != nullptr)
+	{
+		TwoStageFFTConvolver::reset();
+		return multiStage->init(headBlockSize, tailBlockSize, ir, irLen);
+	}
+
+	return TwoStageFFTConvolver::init(headBlockSize, tailBlockSize, ir, irLen);
+}
+
+void MultithreadedConvolver::process(const fftconvolver::Sample* input, fftconvolver::Sample* output, size_t len)
+{
+	if (multiStage != nullptr)
+		multiStage->process(input, output, len);
+	else
+		TwoStageFFTConvolver::process(input, output, len);
+}
+
+void MultithreadedConvolver::reset()
+{
+	TwoStageFFTConvolver::reset();
+
+	if (multiStage != nullptr)
+		multiStage->reset();
+}
+
+void MultithreadedConvolver::cleanPipeline()
+{
+	if (multiStage != nullptr)
+		multiStage->cleanPipeline();
+	else
+		TwoStageFFTConvolver::cleanPipeline();
+}
+
+size_t MultithreadedConvolver::getIRMemoryUsage() const
+{
+	if (multiStage != nullptr)
+		return multiStage->getIRMemoryUsage();
+
+	return TwoStageFFTConvolver::getIRMemoryUsage();
+}
+
+bool MultithreadedConvolver::init(MultiStageConvolver::PreparedImpulse::Ptr preparedImpulse)
+{
+	if (multiStage == nullptr)
+	{
+		jassertfalse;
+		return false;
+	}
+
+	TwoStageFFTConvolver::reset();
+	return multiStage->init(preparedImpulse);
+}
+
+bool MultithreadedConvolver::init(fftconvolver::TwoStageFFTConvolver::PreparedIRPtr preparedIR)
+{
+	if (multiStage != nullptr)
+	{
+		jassertfalse;
+		return false;
+	}
+
+	return TwoStageFFTConvolver::init(preparedIR);
+}
+
+void MultithreadedConvolver::setUseMultiStage(bool shouldUseMultiStage)
+{
+	if (shouldUseMultiStage == isUsingMultiStage())
+		return;
+
+	reset();
+
+	if (shouldUseMultiStage)
+	{
+		multiStage = new MultiStageConvolver(fftType);
+		multiStage->setSampleRate(sampleRate);
+		multiStage->setUseBackgroundThread(useBackgroundThread);
+		multiStage->setNonRealtime(nonRealtime);
+	}
+	else
+	{
+		multiStage = nullptr;
+	}
+}
+
+void MultithreadedConvolver::startBackgroundProcessing()
+{
+	if (useBackgroundThread)
+	{
+		// The result is needed when the next tail block is filled
+		const auto deadline = 1000.0 * (double)getTailBlockSize() / sampleRate;
+		pool->addJob(jobIndex, deadline);
+	}
+	else
+	{
+		doBackgroundProcessing();
+	}
+}
+
+bool MultithreadedConvolver::waitForBackgroundProcessing()
+{
+	// Always wait for the job, the flag might have been changed since the last call
+	if (jobIndex != -1)
+		return pool->waitForJob(jobIndex, nonRealtime ? -1 : ConvolutionWorkerPool::MaxNumWaitSpins);
 
 	return true;
 }
 
-bool MultithreadedConvolver::prepareImpulseResponse(const AudioSampleBuffer& originalBuffer, AudioSampleBuffer& buffer, bool* abortFlag, Range<int> range, double resampleRatio)
+bool MultithreadedConvolver::prepareImpulseResponse(const AudioSampleBuffer& originalBuffer, AudioSampleBuffer& buffer, bool* abortFlag, Range<int> range, double resampleRatio, int numChannels)
 {
-	AudioSampleBuffer copyBuffer(2, originalBuffer.getNumSamples());
+	AudioSampleBuffer copyBuffer(numChannels, originalBuffer.getNumSamples());
 
 	if (range.isEmpty())
 		range = { 0, originalBuffer.getNumSamples() };
@@ -660,8 +1625,8 @@ bool MultithreadedConvolver::prepareImpulseResponse(const AudioSampleBuffer& ori
 	if (originalBuffer.getNumSamples() == 0)
 		return true;
 
-	copyBuffer.copyFrom(0, 0, originalBuffer.getReadPointer(0), originalBuffer.getNumSamples(), 1.0f);
-	copyBuffer.copyFrom(1, 0, originalBuffer.getReadPointer(originalBuffer.getNumChannels() >= 2 ? 1 : 0), originalBuffer.getNumSamples(), 1.0f);
+	for (int c = 0; c < numChannels; c++)
+		copyBuffer.copyFrom(c, 0, originalBuffer.getReadPointer(c % originalBuffer.getNumChannels()), originalBuffer.getNumSamples(), 1.0f);
 
 	if (abortFlag != nullptr && *abortFlag)
 		return false;
@@ -672,27 +1637,26 @@ bool MultithreadedConvolver::prepareImpulseResponse(const AudioSampleBuffer& ori
 	if (irLength > 44100 * 20)
 		jassertfalse;
 
-	auto l = copyBuffer.getReadPointer(0, offset);
-	auto r = copyBuffer.getReadPointer(1, offset);
-
 	int resampledLength = roundToInt((double)irLength * resampleRatio);
 
-	buffer.setSize(2, resampledLength);
+	buffer.setSize(numChannels, resampledLength);
 
 	if (abortFlag != nullptr && *abortFlag)
 		return false;
 
-	if (resampleRatio != 1.0)
+	for (int c = 0; c < numChannels; c++)
 	{
-		LagrangeInterpolator resampler;
-		resampler.process(1.0 / resampleRatio, l, buffer.getWritePointer(0), resampledLength);
-		resampler.reset();
-		resampler.process(1.0 / resampleRatio, r, buffer.getWritePointer(1), resampledLength);
-	}
-	else
-	{
-		FloatVectorOperations::copy(buffer.getWritePointer(0), l, irLength);
-		FloatVectorOperations::copy(buffer.getWritePointer(1), r, irLength);
+		auto src = copyBuffer.getReadPointer(c, offset);
+
+		if (resampleRatio != 1.0)
+		{
+			LagrangeInterpolator resampler;
+			resampler.process(1.0 / resampleRatio, src, buffer.getWritePointer(c), resampledLength);
+		}
+		else
+		{
+			FloatVectorOperations::copy(buffer.getWritePointer(c), src, irLength);
+		}
 	}
 
 	return true;
@@ -103,105 +103,237 @@ private:
 	
 };
 
-class MultithreadedConvolver : public fftconvolver::TwoStageFFTConvolver
+/** A zero-latency convolver that splits the impulse response into partitions with growing sizes.
+
+	The first part of the impulse response is rendered by a uniform convolver with the head block size on the
+	audio thread. The rest is divided into stages whose block size grows by the factor 4 until it reaches the
+	maximum block size (eg. 64, 256, 1024, 4096). A stage with the block size B covers the impulse response from
+	2 * B to the start of the next stage, so it has a full block of time to render its result in the
+	ConvolutionWorkerPool before it's needed.
+
+	The CPU load of this convolver is spread much more evenly across the audio callbacks than the two stage
+	convolver (which renders one big FFT for the entire tail), so it's the better choice for long impulse responses.
+
+	Every stage has its own FFT plan and keeps the spectra of its impulse response segments in one contiguous buffer.
+*/
+class MultiStageConvolver
 {
-	class BackgroundThread : public Thread
+public:
+
+	enum
 	{
-	public:
+		StageFactor = 4
+	};
 
-		BackgroundThread(MultithreadedConvolver& parent_) :
-			Thread("Convolution Background Thread"),
-			parent(parent_)
-		{
-			
-		}
+	MultiStageConvolver(audiofft::ImplementationType fftType);
 
-		void run() override
-		{
-			while (!threadShouldExit())
-			{
+	~MultiStageConvolver();
 
-				if (active)
-				{
-					ScopedValueSetter<bool> svs(currentlyRendering, true);
-					parent.doBackgroundProcessing();
-					active = false;
+	/** The frequency domain representation of an impulse response for a given partition scheme.
 
-					if (threadShouldExit())
-						return;
-				}
+		It contains only the impulse response (and no rendering state), so it can be shared between multiple convolvers.
+	*/
+	struct PreparedImpulse : public ReferenceCountedObject
+	{
+		using Ptr = ReferenceCountedObjectPtr<PreparedImpulse>;
 
-				wait(500);
-			}
+		/** The spectra of all impulse response segments of one stage. */
+		struct Segments
+		{
+			size_t blockSize = 0;
+			size_t complexSize = 0;
+			size_t segmentStride = 0;
+			size_t numSegments = 0;
+
+			fftconvolver::SampleBuffer real;
+			fftconvolver::SampleBuffer imag;
 		};
 
-		void setSomethingTodo(bool shouldBeActive)
-		{
-			active = shouldBeActive;
-		}
+		/** Returns the amount of bytes used by the impulse response data. */
+		size_t getMemoryUsage() const;
 
-		bool isBusy() const { return currentlyRendering; }
+		size_t headBlockSize = 0;
 
-		bool currentlyRendering = false;
-		bool active = false;
+		/** The beginning of the impulse response in the time domain (the head convolver transforms it itself). */
+		fftconvolver::SampleBuffer headImpulse;
 
-		MultithreadedConvolver& parent;
+		OwnedArray<Segments> stages;
 	};
 
+	/** Transforms the impulse response into the frequency domain using the partition scheme of init(). 
+	
+		This is the expensive part of the initialisation, so you can call this on a background thread and
+		share the result between multiple convolvers. It returns nullptr if the block sizes are invalid.
+	*/
+	static PreparedImpulse::Ptr prepare(audiofft::ImplementationType fftType, size_t headBlockSize, size_t tailBlockSize, const fftconvolver::Sample* ir, size_t irLen);
+
+	/** Initialises the convolver (it uses the same arguments as the TwoStageFFTConvolver).
 
-public:
+		The block size of the first stage is the head block size and the last stage won't exceed the tail block size.
+	*/
+	bool init(size_t headBlockSize, size_t tailBlockSize, const fftconvolver::Sample* ir, size_t irLen);
 
-	MultithreadedConvolver(audiofft::ImplementationType fftType) :
-		TwoStageFFTConvolver(fftType),
-		backgroundThread(*this)
-	{};
+	/** Initialises the convolver with an impulse response that was created with prepare(). 
+	
+		The prepared impulse must have been created with the same FFT type.
+	*/
+	bool init(PreparedImpulse::Ptr preparedImpulse);
+
+	/** Convolves the input samples and writes the result to the output. */
+	void process(const fftconvolver::Sample* input, fftconvolver::Sample* output, size_t len);
+
+	/** Resets the convolver and discards the impulse response. */
+	void reset();
+
+	/** Clears the internal buffers without changing the impulse response. */
+	void cleanPipeline();
+
+	/** Sets the sample rate that is used to calculate the deadline for the stage rendering. */
+	void setSampleRate(double newSampleRate) { sampleRate = newSampleRate; }
+
+	void setUseBackgroundThread(bool shouldBeUsingBackgroundThread) { useBackgroundThread = shouldBeUsingBackgroundThread; }
+
+	/** If enabled, the convolver waits until the worker has finished a late job instead of playing the block silent.
+
+		Use this if the convolver doesn't run in realtime (eg. when rendering offline or in a unit test), so that
+		a descheduled worker thread can't change the output.
+	*/
+	void setNonRealtime(bool isNonRealtime) { nonRealtime = isNonRealtime; }
+
+	/** Returns the number of stages (excluding the head). */
+	int getNumStages() const { return stages.size(); }
 
-	virtual ~MultithreadedConvolver()
+	/** Returns the amount of bytes used by the frequency domain representation of the impulse response. */
+	size_t getIRMemoryUsage() const;
+
+private:
+
+	using Sample = fftconvolver::Sample;
+	using SampleBuffer = fftconvolver::SampleBuffer;
+
+	struct Stage : public ConvolutionWorkerPool::Job
 	{
-		backgroundThread.stopThread(1000);
+		Stage(ConvolutionWorkerPool& pool_, audiofft::ImplementationType fftType);
+
+		~Stage();
+
+		void init(const PreparedImpulse::Segments& newSegments);
+
+		void runJob() override;
+
+		/** Convolves the input block with the impulse response and writes the result to the output buffer. */
+		void processBlock(const Sample* blockInput);
+
+		void cleanPipeline();
+
+		ConvolutionWorkerPool& pool;
+		int jobIndex = -1;
+
+		/** True if the running job missed its deadline. Its result is thrown away when it's finished. */
+		bool late = false;
+
+		/** Set before the job is queued if it has to render the input that arrived while the job was late. */
+		bool renderSkippedInput = false;
+
+		audiofft::AudioFFT fft;
+
+		const PreparedImpulse::Segments* segments = nullptr;
+
+		size_t blockSize = 0;
+		size_t currentSegment = 0;
+		size_t inputFill = 0;
+
+		SampleBuffer inputReal, inputImag;
+		SampleBuffer convReal, convImag;
+		SampleBuffer fftBuffer;
+		SampleBuffer overlap;
+
+		SampleBuffer input;
+		SampleBuffer backgroundInput;
+		SampleBuffer skippedInput;
+		SampleBuffer backgroundSkippedInput;
+		SampleBuffer output;
+		SampleBuffer precalculated;
+
+		JUCE_DECLARE_NON_COPYABLE(Stage);
 	};
 
-	void startBackgroundProcessing() override
-	{
-		if (useBackgroundThread)
-		{
-			backgroundThread.setSomethingTodo(true);
-			backgroundThread.notify();
-		}
-		else
-		{
-			doBackgroundProcessing();
-		}
-	}
+	/** Collects the result of the stage when its input block is full and queues the next block. */
+	void finishStageBlock(Stage& s);
+
+	void startStage(Stage& s);
+
+	/** Waits for the job of the stage (see ConvolutionWorkerPool::waitForJob()) and returns false if the worker is late. */
+	bool waitForStage(Stage& s, int maxNumSpins=ConvolutionWorkerPool::MaxNumWaitSpins);
+
+	SharedResourcePointer<ConvolutionWorkerPool> pool;
+
+	audiofft::ImplementationType fftType;
+	fftconvolver::FFTConvolver head;
+	OwnedArray<Stage> stages;
+
+	PreparedImpulse::Ptr impulse;
+
+	double sampleRate = 44100.0;
+	bool useBackgroundThread = true;
+	bool nonRealtime = false;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultiStageConvolver);
+};
 
-	void waitForBackgroundProcessing() override
+class MultithreadedConvolver : public fftconvolver::TwoStageFFTConvolver
+{
+	struct TailJob : public ConvolutionWorkerPool::Job
 	{
-		if (useBackgroundThread)
-		{
-			while (backgroundThread.isBusy())
-				jassertfalse;
-		}
-	}
+		TailJob(MultithreadedConvolver& parent_) :
+			parent(parent_)
+		{};
+
+		void runJob() override { parent.doBackgroundProcessing(); }
+
+		MultithreadedConvolver& parent;
+	};
+
+public:
 
-	static bool prepareImpulseResponse(const AudioSampleBuffer& originalBuffer, AudioSampleBuffer& buffer, bool* abortFlag, Range<int> range, double resampleRatio);
+	MultithreadedConvolver(audiofft::ImplementationType fftType);
+
+	virtual ~MultithreadedConvolver();
+
+	bool init(size_t headBlockSize, size_t tailBlockSize, const fftconvolver::Sample* ir, size_t irLen) override;
+
+	void process(const fftconvolver::Sample* input, fftconvolver::Sample* output, size_t len) override;
+
+	void reset() override;
+
+	void cleanPipeline() override;
+
+	void startBackgroundProcessing() override;
+
+	bool waitForBackgroundProcessing() override;
+
+	size_t getIRMemoryUsage() const override;
+
+	/** Copies the range of the impulse response into the buffer and resamples it. The buffer will have numChannels channels (which wrap around the original channels). */
+	static bool prepareImpulseResponse(const AudioSampleBuffer& originalBuffer, AudioSampleBuffer& buffer, bool* abortFlag, Range<int> range, double resampleRatio, int numChannels=2);
 
 	static double getResampleFactor(double sampleRate, double impulseSampleRate);
 
+	/** Sets the sample rate that is used to calculate the deadline for the tail rendering. */
+	void setSampleRate(double newSampleRate)
+	{
+		sampleRate = newSampleRate;
+
+		if (multiStage != nullptr)
+			multiStage->setSampleRate(newSampleRate);
+	}
+
 	void setUseBackgroundThread(bool shouldBeUsingBackgroundThread)
 	{
-		if (useBackgroundThread != shouldBeUsingBackgroundThread)
-		{
-			useBackgroundThread = shouldBeUsingBackgroundThread;
-		
-			if (useBackgroundThread)
-				backgroundThread.startThread(9);
-			else
-			{
-				if(backgroundThread.isThreadRunning())
-					backgroundThread.stopThread(1000);
-			}
-				
-		}
+		useBackgroundThread = shouldBeUsingBackgroundThread && jobIndex != -1;
+
+		if (multiStage != nullptr)
+			multiStage->setUseBackgroundThread(shouldBeUsingBackgroundThread);
 	}
 
 	bool isUsingBackgroundThread() const
@@ -209,14 +341,142 @@ public:
 		return useBackgroundThread;
 	}
 
+	/** If enabled, the convolver waits until the worker has finished a late job instead of playing the block silent.
+
+		Use this if the convolver doesn't run in realtime (eg. when rendering offline or in a unit test), so that
+		a descheduled worker thread can't change the output.
+	*/
+	void setNonRealtime(bool isNonRealtime)
+	{
+		nonRealtime = isNonRealtime;
+
+		if (multiStage != nullptr)
+			multiStage->setNonRealtime(isNonRealtime);
+	}
+
+	/** Switches between the two stage convolution and the MultiStageConvolver. 
+	
+		This discards the impulse response, so you need to call init() again afterwards.
+	*/
+	void setUseMultiStage(bool shouldUseMultiStage);
+
+	bool isUsingMultiStage() const
+	{
+		return multiStage != nullptr;
+	}
+
+	/** Initialises the MultiStageConvolver with an impulse response that was created with MultiStageConvolver::prepare(). */
+	bool init(MultiStageConvolver::PreparedImpulse::Ptr preparedImpulse);
+
+	/** Initialises the two stage convolution with an impulse response that was created with TwoStageFFTConvolver::prepare(). */
+	bool init(fftconvolver::TwoStageFFTConvolver::PreparedIRPtr preparedIR) override;
+
 private:
 
-	BackgroundThread backgroundThread;
+	SharedResourcePointer<ConvolutionWorkerPool> pool;
+	TailJob tailJob;
+	int jobIndex = -1;
+
+	const audiofft::ImplementationType fftType;
+	ScopedPointer<MultiStageConvolver> multiStage;
 
+	double sampleRate = 44100.0;
 	bool useBackgroundThread = true;
+	bool nonRealtime = false;
 };
 
 
+/** A cache for impulse responses that are prepared for the convolution (resampled, filtered and transformed into the frequency domain).
+
+	It is shared between all ConvolutionEffect instances, so switching to an impulse response that was loaded before 
+	(or that is used by another instance) just swaps the reference to the prepared data instead of recalculating it.
+	The least recently used entries are removed when the cache exceeds its limits.
+*/
+class ConvolutionImpulseCache
+{
+public:
+
+	/** Everything that changes the prepared data of an impulse response. */
+	struct Key
+	{
+		bool operator==(const Key& other) const;
+
+		String reference;
+		double sampleRate = 0.0;
+		Range<int> range;
+		int numChannels = 2;
+		size_t headBlockSize = 0;
+		size_t tailBlockSize = 0;
+		bool multiStage = false;
+		audiofft::ImplementationType fftType = audiofft::ImplementationType::BestAvailable;
+		float damping = 1.0f;
+		double cutoffFrequency = 20000.0;
+	};
+
+	struct Entry : public ReferenceCountedObject
+	{
+		using Ptr = ReferenceCountedObjectPtr<Entry>;
+
+		size_t getMemoryUsage() const;
+
+		Key key;
+
+		/** The resampled and filtered impulse response. */
+		AudioSampleBuffer impulse;
+
+		/** The frequency domain data for every channel if the key uses the MultiStageConvolver. */
+		ReferenceCountedArray<MultiStageConvolver::PreparedImpulse> preparedChannels;
+
+		/** The frequency domain data for every channel if the key uses the two stage convolution. */
+		Array<fftconvolver::TwoStageFFTConvolver::PreparedIRPtr> preparedTwoStageChannels;
+
+		/** The frequency domain data of all paths if the impulse response is true stereo. */
+		MatrixConvolver::PreparedImpulse::Ptr preparedMatrix;
+	};
+
+	enum
+	{
+		MaxNumEntries = 64
+	};
+
+	ConvolutionImpulseCache() {};
+
+	/** Sets the amount of bytes that all cached impulse responses may use before the least recently used ones are removed.
+
+		The limit is shared between all caches and defaults to HISE_CONVOLUTION_CACHE_SIZE_MB. It will be applied
+		the next time an impulse response is added to the cache.
+	*/
+	static void setMaxMemoryUsage(size_t numBytes);
+
+	/** Returns the memory limit of the cache in bytes. */
+	static size_t getMaxMemoryUsage();
+
+	/** Returns the entry for the key or nullptr if it's not in the cache. */
+	Entry::Ptr getEntry(const Key& key);
+
+	/** Adds the entry to the cache. */
+	void addEntry(Entry::Ptr newEntry);
+
+	/** Removes all entries that were created from the given pool reference (eg. because the file was reloaded). */
+	void removeEntries(const String& reference);
+
+	/** Returns the amount of bytes used by all cached impulse responses. */
+	size_t getMemoryUsage() const;
+
+private:
+
+	void removeLeastRecentlyUsedEntries();
+
+	static std::atomic<size_t> maxMemoryUsage;
+
+	CriticalSection lock;
+
+	// sorted by the last usage (the most recent one is at the end)
+	ReferenceCountedArray<Entry> entries;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionImpulseCache);
+};
+
 /** @brief A convolution reverb using zero-latency convolution
 *	@ingroup effectTypes
 *
@@ -273,6 +533,9 @@ class ConvolutionEffect: public MasterEffectProcessor,
 
 		bool reloadInternal();
 
+		/** Resamples and filters the impulse response and transforms it into the frequency domain if required. Returns nullptr if the loading was aborted. */
+		ConvolutionImpulseCache::Entry::Ptr createCacheEntry(const AudioSampleBuffer& originalBuffer, const ConvolutionImpulseCache::Key& key, double resampleRatio);
+
 #if 0
 		void timerCallback() override
 		{
@@ -316,6 +579,7 @@ public:
 		HiCut, ///< applies a low pass filter to the impulse response
 		Damping, ///< applies a fade-out to the impulse response
 		FFTType, ///< the FFT implementation. It picks the best available but for some weird use cases you can force to use another one.
+		UseMultiStage, ///< if true, the impulse response is split into partitions with growing sizes which spreads the CPU load of long impulse responses more evenly.
 		numEffectParameters
 	};
 
@@ -327,6 +591,7 @@ public:
 	// ============================================================================================= Convolution methods
 
 	void newFileLoaded() override {	setImpulse(); }
+	void poolEntryReloaded(PoolReference referenceThatWasChanged) override;
 	void rangeUpdated() override { setImpulse(); }
 	void setImpulse();
 
@@ -343,13 +608,7 @@ public:
 	void applyEffect(AudioSampleBuffer &buffer, int startSample, int numSamples) override;;
 	bool hasTail() const override {return true; };
 
-	void voicesKilled() override
-	{
-		convolverL->cleanPipeline();
-		convolverR->cleanPipeline();
-		leftPredelay.clear();
-		rightPredelay.clear();
-	}
+	void voicesKilled() override;
 
 	int getNumChildProcessors() const override { return 0; };
 	Processor *getChildProcessor(int /*processorIndex*/) override { return nullptr; };
@@ -359,18 +618,19 @@ public:
 
 	const CriticalSection& getFileLock() const override { return unusedFileLock; }
 
-	void nonRealtimeModeChanged(bool isNonRealtime) override
-	{
-		nonRealtime = isNonRealtime;
+	void nonRealtimeModeChanged(bool isNonRealtime) override;
 
-		convolverL->setUseBackgroundThread(!nonRealtime && useBackgroundThread);
-		convolverR->setUseBackgroundThread(!nonRealtime && useBackgroundThread);
-	}
+	/** Returns true if a true stereo impulse response (4 channels: LL, LR, RL, RR) is loaded. */
+	bool isTrueStereo() const;
+
+	/** Returns the amount of bytes used by the frequency domain representation of the loaded impulse response. */
+	size_t getIRMemoryUsage() const;
 	
 
 private:
 
 	bool useBackgroundThread = false;
+	bool useMultiStage = false;
 	bool nonRealtime = false;
 
 	bool processingEnabled = true;
@@ -379,6 +639,12 @@ private:
 
 	void createEngine(audiofft::ImplementationType fftType);
 
+	void setUseBackgroundThreadForEngines(bool shouldBeUsingBackgroundThread);
+
+	void processConvolution(const float* inL, const float* inR, float* outL, float* outR, int numSamples);
+
+	void cleanConvolutionPipeline();
+
 	SpinLock swapLock;
 
 	LoadingThread loadingThread;
@@ -431,6 +697,11 @@ private:
 	ScopedPointer<MultithreadedConvolver> convolverL;
 	ScopedPointer<MultithreadedConvolver> convolverR;
 
+	/** Renders the 2 x 2 paths of a true stereo impulse response with a shared input FFT. */
+	ScopedPointer<MatrixConvolver> trueStereoConvolver;
+
+	SharedResourcePointer<ConvolutionImpulseCache> impulseCache;
+
 	double cutoffFrequency = 20000.0;
 
 	double lastSampleRate = 0.0;
@@ -464,6 +735,34 @@ struct convolution : public AudioFileNodeBase
 	SET_HISE_NODE_EXTRA_WIDTH(256);
 	SET_HISE_NODE_EXTRA_HEIGHT(100);
 
+	convolution() :
+		useMultiStage(PropertyIds::UseMultiStage, false)
+	{};
+
+	void initialise(NodeBase* n) override
+	{
+		AudioFileNodeBase::initialise(n);
+
+		useMultiStage.setAdditionalCallback(BIND_MEMBER_FUNCTION_2(convolution::updateMultiStage));
+		useMultiStage.init(n, this);
+	}
+
+	void updateMultiStage(Identifier, var newValue)
+	{
+		// not prepared yet, the flag will be applied to the new convolvers in prepare()
+		if (convolvers.isEmpty())
+			return;
+
+		{
+			SpinLock::ScopedLockType sl(impulseLock);
+
+			for (auto c : convolvers)
+				c->setUseMultiStage((bool)newValue);
+		}
+
+		rebuildImpulse();
+	}
+
 	void prepare(PrepareSpecs specs) override
 	{
 		lastSampleRate = specs.sampleRate;
@@ -474,6 +773,8 @@ struct convolution : public AudioFileNodeBase
 		for (int i = 0; i < specs.numChannels; i++)
 		{
 			newConvolvers.add(new MultithreadedConvolver(audiofft::ImplementationType::BestAvailable));
+			newConvolvers.getLast()->setSampleRate(specs.sampleRate);
+			newConvolvers.getLast()->setUseMultiStage(useMultiStage.getValue());
 		}
 
 		{
@@ -561,6 +862,8 @@ struct convolution : public AudioFileNodeBase
 	SpinLock impulseLock;
 
 	OwnedArray<hise::MultithreadedConvolver> convolvers;
+
+	NodePropertyT<bool> useMultiStage;
 	
 	int largestBlockSize = 0; 
 	double lastSampleRate = 44100.0;
@@ -0,0 +1,138 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef CONVOLUTIONWORKERPOOL_H_INCLUDED
+#define CONVOLUTIONWORKERPOOL_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** A pool of realtime worker threads that renders the tail convolution of all MultithreadedConvolver instances.
+
+	Instead of running one thread per convolver, every convolver registers a job in this pool (which is shared
+	between all instances using a SharedResourcePointer). When the audio thread queues a job, it passes the
+	time when it needs the result and the workers always pick the queued job with the earliest deadline.
+
+	If the audio thread needs the result of a job that no worker has picked up yet, it will render it directly
+	instead of waiting for the pool, so it only waits if the job is currently rendered by a worker. This wait
+	is limited to MaxNumWaitSpins calls to Thread::yield(), so the worst case cost of waitForJob() on the audio 
+	thread is either rendering one job or MaxNumWaitSpins yields. If the worker is still busy after that (eg.
+	because it was preempted), waitForJob() returns false and the convolver plays the block silent instead of 
+	stalling the audio thread. It then marks the job as late, throws away its result once it's finished and 
+	renders the skipped input block along with the next job, so the late result is never played one block too 
+	late and the input doesn't go missing in the history of the convolver.
+*/
+class ConvolutionWorkerPool
+{
+public:
+
+	struct Job
+	{
+		virtual ~Job() {};
+
+		/** Renders the job. This is called by one of the worker threads or by waitForJob(). */
+		virtual void runJob() = 0;
+	};
+
+	enum
+	{
+		MaxNumJobs = 256,
+		MaxNumThreads = 4,
+		MaxNumWaitSpins = 64
+	};
+
+	ConvolutionWorkerPool();
+	~ConvolutionWorkerPool();
+
+	/** Registers the job and returns the slot index that you need to pass into the other methods (or -1 if the pool is full). */
+	int registerJob(Job* job);
+
+	/** Removes the job from the pool. If it's currently rendered, it waits until the job is finished. */
+	void unregisterJob(int slotIndex);
+
+	/** Queues the job with a deadline in milliseconds from now. This is called from the audio thread. */
+	void addJob(int slotIndex, double deadlineMilliseconds);
+
+	/** Makes sure that the job has been rendered. This is called from the audio thread.
+
+		Returns false if a worker is still rendering the job after maxNumSpins yields. In this case you must not
+		touch the buffers of the job or queue it again before a later call to this method returned true. 
+		Pass -1 to wait until the job is finished (eg. when the pipeline is cleared).
+	*/
+	bool waitForJob(int slotIndex, int maxNumSpins=MaxNumWaitSpins);
+
+	int getNumWorkerThreads() const { return workers.size(); }
+
+private:
+
+	enum SlotState
+	{
+		Free = 0,
+		Registering,
+		Idle,
+		Queued,
+		Running
+	};
+
+	struct Slot
+	{
+		std::atomic<int> state;
+		std::atomic<Job*> job;
+		std::atomic<double> deadline;
+	};
+
+	struct WorkerThread : public Thread
+	{
+		WorkerThread(ConvolutionWorkerPool& parent_, int index);
+
+		void run() override;
+
+		ConvolutionWorkerPool& parent;
+	};
+
+	/** Picks the queued job with the earliest deadline and renders it. Returns false if there was nothing to do. */
+	bool runNextJob();
+
+	void runSlot(Slot& s);
+
+	Slot slots[MaxNumJobs];
+	std::atomic<int> numUsedSlots;
+
+	WaitableEvent jobAvailable;
+	OwnedArray<WorkerThread> workers;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionWorkerPool);
+};
+
+}
+
+#endif
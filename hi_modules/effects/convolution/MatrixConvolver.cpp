@@ -0,0 +1,566 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+namespace hise { using namespace juce;
+
+MatrixConvolver::MatrixConvolver(audiofft::ImplementationType fftType_) :
+	fftType(fftType_)
+{
+
+}
+
+MatrixConvolver::~MatrixConvolver()
+{
+	reset();
+}
+
+MatrixConvolver::PreparedImpulse::Ptr MatrixConvolver::prepare(audiofft::ImplementationType fftType, size_t headBlockSize, size_t tailBlockSize, int numInputs, int numOutputs, const Sample* const* irs, size_t irLen)
+{
+	if (headBlockSize == 0 || tailBlockSize == 0 || numInputs <= 0 || numOutputs <= 0)
+		return nullptr;
+
+	if (numInputs > (int)MaxNumChannels || numOutputs > (int)MaxNumChannels)
+	{
+		jassertfalse;
+		return nullptr;
+	}
+
+	PreparedImpulse::Ptr p = new PreparedImpulse();
+
+	p->numInputs = numInputs;
+	p->numOutputs = numOutputs;
+
+	const int numPaths = numInputs * numOutputs;
+
+	// Ignore zeros at the end of the impulse responses because they only waste computation time
+	while (irLen > 0)
+	{
+		bool silent = true;
+
+		for (int i = 0; i < numPaths; i++)
+			silent &= std::abs(irs[i][irLen - 1]) < 0.000001f;
+
+		if (!silent)
+			break;
+
+		--irLen;
+	}
+
+	if (irLen == 0)
+		return p;
+
+	headBlockSize = (size_t)nextPowerOfTwo((int)headBlockSize);
+	tailBlockSize = jmax(headBlockSize, (size_t)nextPowerOfTwo((int)tailBlockSize));
+
+	Array<size_t> blockSizes;
+
+	for (auto b = headBlockSize * StageFactor; b <= tailBlockSize && 2 * b < irLen; b *= StageFactor)
+		blockSizes.add(b);
+
+	auto headSegments = new PreparedImpulse::Segments();
+	headSegments->init(fftType, headBlockSize, numPaths, irs, 0, blockSizes.isEmpty() ? irLen : 2 * blockSizes.getFirst());
+	p->partitions.add(headSegments);
+
+	for (int i = 0; i < blockSizes.size(); i++)
+	{
+		const auto offset = 2 * blockSizes[i];
+		const auto end = i == blockSizes.size() - 1 ? irLen : 2 * blockSizes[i + 1];
+
+		auto s = new PreparedImpulse::Segments();
+		s->init(fftType, blockSizes[i], numPaths, irs, offset, end - offset);
+		p->partitions.add(s);
+	}
+
+	return p;
+}
+
+bool MatrixConvolver::init(size_t headBlockSize, size_t tailBlockSize, int numInputs_, int numOutputs_, const Sample* const* irs, size_t irLen)
+{
+	return init(prepare(fftType, headBlockSize, tailBlockSize, numInputs_, numOutputs_, irs, irLen));
+}
+
+bool MatrixConvolver::init(PreparedImpulse::Ptr preparedImpulse)
+{
+	reset();
+
+	if (preparedImpulse == nullptr)
+		return false;
+
+	impulse = preparedImpulse;
+	numInputs = impulse->numInputs;
+	numOutputs = impulse->numOutputs;
+
+	if (impulse->partitions.isEmpty())
+		return true;
+
+	head = new Head(fftType);
+	head->init(*impulse->partitions.getFirst(), numInputs, numOutputs);
+
+	for (int i = 1; i < impulse->partitions.size(); i++)
+	{
+		auto s = new Stage(*pool, fftType);
+		s->init(*impulse->partitions[i], numInputs, numOutputs);
+		stages.add(s);
+	}
+
+	return true;
+}
+
+void MatrixConvolver::process(const Sample* const* input, Sample* const* output, size_t len)
+{
+	if (head == nullptr)
+	{
+		for (int i = 0; i < numOutputs; i++)
+			FloatVectorOperations::clear(output[i], (int)len);
+
+		return;
+	}
+
+	if (stages.isEmpty())
+	{
+		head->process(input, output, len);
+		return;
+	}
+
+	const Sample* inputChunk[MaxNumChannels];
+	Sample* outputChunk[MaxNumChannels];
+
+	// The first stage has the smallest block size, so we split the buffer at its boundaries
+	auto& first = *stages.getFirst();
+
+	size_t processed = 0;
+
+	while (processed < len)
+	{
+		const auto numThisTime = jmin(len - processed, first.partition.blockSize - first.inputFill);
+
+		// Copy the input before the head writes into the output (they might share the same memory)
+		for (auto s : stages)
+		{
+			for (int i = 0; i < numInputs; i++)
+				memcpy(s->partition.getChannel(s->input, i) + s->inputFill, input[i] + processed, numThisTime * sizeof(Sample));
+		}
+
+		for (int i = 0; i < numInputs; i++)
+			inputChunk[i] = input[i] + processed;
+
+		for (int i = 0; i < numOutputs; i++)
+			outputChunk[i] = output[i] + processed;
+
+		head->process(inputChunk, outputChunk, numThisTime);
+
+		for (auto s : stages)
+		{
+			for (int i = 0; i < numOutputs; i++)
+				FloatVectorOperations::add(outputChunk[i], s->partition.getChannel(s->precalculated, i) + s->inputFill, (int)numThisTime);
+
+			s->inputFill += numThisTime;
+
+			if (s->inputFill == s->partition.blockSize)
+			{
+				finishStageBlock(*s);
+				s->inputFill = 0;
+			}
+		}
+
+		processed += numThisTime;
+	}
+}
+
+void MatrixConvolver::reset()
+{
+	// The destructor of each stage unregisters its job and waits until it's finished
+	stages.clear();
+	head = nullptr;
+	impulse = nullptr;
+
+	numInputs = 0;
+	numOutputs = 0;
+}
+
+void MatrixConvolver::cleanPipeline()
+{
+	for (auto s : stages)
+	{
+		waitForStage(*s, -1);
+		s->cleanPipeline();
+	}
+
+	if (head != nullptr)
+		head->cleanPipeline();
+}
+
+size_t MatrixConvolver::getIRMemoryUsage() const
+{
+	return impulse != nullptr ? impulse->getMemoryUsage() : 0;
+}
+
+size_t MatrixConvolver::PreparedImpulse::getMemoryUsage() const
+{
+	size_t numBytes = 0;
+
+	for (auto s : partitions)
+		numBytes += (s->real.size() + s->imag.size()) * sizeof(Sample);
+
+	return numBytes;
+}
+
+void MatrixConvolver::PreparedImpulse::Segments::init(audiofft::ImplementationType fftType, size_t newBlockSize, int numPaths, const Sample* const* irs, size_t irOffset, size_t irLength)
+{
+	blockSize = newBlockSize;
+
+	const auto segmentSize = 2 * blockSize;
+
+	complexSize = audiofft::AudioFFT::ComplexSize(segmentSize);
+
+	// keep every segment aligned for the SSE loads in ComplexMultiplyAccumulate()
+	segmentStride = (complexSize + 3) & ~(size_t)3;
+
+	numSegments = jmax<size_t>(1, (irLength + blockSize - 1) / blockSize);
+
+	audiofft::AudioFFT fft(fftType);
+	fft.init(segmentSize);
+
+	fftconvolver::SampleBuffer fftBuffer(segmentSize);
+
+	real.resize((size_t)numPaths * numSegments * segmentStride);
+	imag.resize((size_t)numPaths * numSegments * segmentStride);
+
+	for (int p = 0; p < numPaths; p++)
+	{
+		for (size_t s = 0; s < numSegments; s++)
+		{
+			const auto offset = s * blockSize;
+			const auto numToCopy = offset < irLength ? jmin(blockSize, irLength - offset) : 0;
+			const auto index = ((size_t)p * numSegments + s) * segmentStride;
+
+			fftconvolver::CopyAndPad(fftBuffer, irs[p] + irOffset + offset, numToCopy);
+			fft.fft(fftBuffer.data(), real.data() + index, imag.data() + index);
+		}
+	}
+}
+
+void MatrixConvolver::finishStageBlock(Stage& s)
+{
+	if (!waitForStage(s, nonRealtime ? -1 : ConvolutionWorkerPool::MaxNumWaitSpins))
+	{
+		// The worker is late, so this block of the stage is silent instead of stalling the audio thread. 
+		// The input is rendered with the next job so that it isn't missing in the history of the stage
+		// (if the worker is late for more than one block, only the last input block is kept).
+		s.late = true;
+		s.precalculated.setZero();
+		s.skippedInput.copyFrom(s.input);
+		return;
+	}
+
+	if (s.late)
+	{
+		// The late result belongs to a block that was already played silent, so it's thrown away
+		s.late = false;
+		s.precalculated.setZero();
+		s.backgroundSkippedInput.copyFrom(s.skippedInput);
+		s.renderSkippedInput = true;
+	}
+	else
+	{
+		fftconvolver::SampleBuffer::Swap(s.precalculated, s.output);
+		s.renderSkippedInput = false;
+	}
+
+	s.backgroundInput.copyFrom(s.input);
+	startStage(s);
+}
+
+void MatrixConvolver::startStage(Stage& s)
+{
+	if (useBackgroundThread && s.jobIndex != -1)
+	{
+		// The result is needed when the next block of this stage is filled
+		const auto deadline = 1000.0 * (double)s.partition.blockSize / sampleRate;
+		pool->addJob(s.jobIndex, deadline);
+	}
+	else
+	{
+		s.runJob();
+	}
+}
+
+bool MatrixConvolver::waitForStage(Stage& s, int maxNumSpins)
+{
+	// Always wait for the job, the flag might have been changed since the last call
+	if (s.jobIndex != -1)
+		return pool->waitForJob(s.jobIndex, maxNumSpins);
+
+	return true;
+}
+
+MatrixConvolver::Partition::Partition(audiofft::ImplementationType fftType) :
+	fft(fftType)
+{
+
+}
+
+void MatrixConvolver::Partition::init(const PreparedImpulse::Segments& newSegments, int numInputs_, int numOutputs_)
+{
+	segments = &newSegments;
+	numInputs = numInputs_;
+	numOutputs = numOutputs_;
+	blockSize = segments->blockSize;
+	complexSize = segments->complexSize;
+	segmentStride = segments->segmentStride;
+	numSegments = segments->numSegments;
+	currentSegment = 0;
+
+	fft.init(2 * blockSize);
+	fftBuffer.resize(2 * blockSize);
+
+	// The input spectra are calculated once and used for every output
+	inputReal.resize((size_t)numInputs * numSegments * segmentStride);
+	inputImag.resize((size_t)numInputs * numSegments * segmentStride);
+}
+
+void MatrixConvolver::Partition::cleanPipeline()
+{
+	inputReal.setZero();
+	inputImag.setZero();
+	currentSegment = 0;
+}
+
+void MatrixConvolver::Partition::transformInput(int inputIndex, const Sample* data)
+{
+	const auto index = ((size_t)inputIndex * numSegments + currentSegment) * segmentStride;
+
+	fftconvolver::CopyAndPad(fftBuffer, data, blockSize);
+	fft.fft(fftBuffer.data(), inputReal.data() + index, inputImag.data() + index);
+}
+
+void MatrixConvolver::Partition::accumulate(int outputIndex, size_t firstSegment, size_t lastSegment, Sample* re, Sample* im)
+{
+	for (int i = 0; i < numInputs; i++)
+	{
+		const auto pathIndex = (size_t)(i * numOutputs + outputIndex);
+
+		for (size_t s = firstSegment; s < lastSegment; s++)
+		{
+			const auto irIndex = (pathIndex * numSegments + s) * segmentStride;
+			const auto inputIndex = ((size_t)i * numSegments + (currentSegment + s) % numSegments) * segmentStride;
+
+			fftconvolver::ComplexMultiplyAccumulate(re, im,
+				segments->real.data() + irIndex, segments->imag.data() + irIndex,
+				inputReal.data() + inputIndex, inputImag.data() + inputIndex,
+				complexSize);
+		}
+	}
+}
+
+void MatrixConvolver::Partition::inverseTransform(const Sample* re, const Sample* im)
+{
+	fft.ifft(fftBuffer.data(), re, im);
+}
+
+void MatrixConvolver::Partition::advance()
+{
+	currentSegment = currentSegment > 0 ? currentSegment - 1 : numSegments - 1;
+}
+
+MatrixConvolver::Head::Head(audiofft::ImplementationType fftType) :
+	partition(fftType)
+{
+
+}
+
+void MatrixConvolver::Head::init(const PreparedImpulse::Segments& newSegments, int numInputs, int numOutputs)
+{
+	partition.init(newSegments, numInputs, numOutputs);
+
+	const auto newBlockSize = partition.blockSize;
+
+	input.resize((size_t)numInputs * newBlockSize);
+	overlap.resize((size_t)numOutputs * newBlockSize);
+	preMultipliedReal.resize((size_t)numOutputs * partition.segmentStride);
+	preMultipliedImag.resize((size_t)numOutputs * partition.segmentStride);
+	convReal.resize(partition.segmentStride);
+	convImag.resize(partition.segmentStride);
+	inputFill = 0;
+}
+
+void MatrixConvolver::Head::process(const Sample* const* in, Sample* const* out, size_t len)
+{
+	const auto blockSize = partition.blockSize;
+	const auto stride = partition.segmentStride;
+	const auto complexSize = partition.complexSize;
+
+	size_t processed = 0;
+
+	while (processed < len)
+	{
+		const bool inputWasEmpty = inputFill == 0;
+		const auto numThisTime = jmin(len - processed, blockSize - inputFill);
+
+		for (int i = 0; i < partition.numInputs; i++)
+		{
+			auto block = partition.getChannel(input, i);
+			memcpy(block + inputFill, in[i] + processed, numThisTime * sizeof(Sample));
+			partition.transformInput(i, block);
+		}
+
+		// The older segments don't change until the next block, so we only multiply them once per block
+		if (inputWasEmpty && partition.numSegments > 1)
+		{
+			preMultipliedReal.setZero();
+			preMultipliedImag.setZero();
+
+			for (int o = 0; o < partition.numOutputs; o++)
+				partition.accumulate(o, 1, partition.numSegments, preMultipliedReal.data() + o * stride, preMultipliedImag.data() + o * stride);
+		}
+
+		const bool blockFinished = inputFill + numThisTime == blockSize;
+
+		for (int o = 0; o < partition.numOutputs; o++)
+		{
+			memcpy(convReal.data(), preMultipliedReal.data() + o * stride, complexSize * sizeof(Sample));
+			memcpy(convImag.data(), preMultipliedImag.data() + o * stride, complexSize * sizeof(Sample));
+
+			partition.accumulate(o, 0, 1, convReal.data(), convImag.data());
+			partition.inverseTransform(convReal.data(), convImag.data());
+
+			auto channelOverlap = overlap.data() + o * blockSize;
+
+			fftconvolver::Sum(out[o] + processed, partition.fftBuffer.data() + inputFill, channelOverlap + inputFill, numThisTime);
+
+			if (blockFinished)
+				memcpy(channelOverlap, partition.fftBuffer.data() + blockSize, blockSize * sizeof(Sample));
+		}
+
+		inputFill += numThisTime;
+
+		if (blockFinished)
+		{
+			input.setZero();
+			inputFill = 0;
+			partition.advance();
+		}
+
+		processed += numThisTime;
+	}
+}
+
+void MatrixConvolver::Head::cleanPipeline()
+{
+	partition.cleanPipeline();
+	input.setZero();
+	overlap.setZero();
+	preMultipliedReal.setZero();
+	preMultipliedImag.setZero();
+	inputFill = 0;
+}
+
+MatrixConvolver::Stage::Stage(ConvolutionWorkerPool& pool_, audiofft::ImplementationType fftType) :
+	pool(pool_),
+	partition(fftType)
+{
+	jobIndex = pool.registerJob(this);
+}
+
+MatrixConvolver::Stage::~Stage()
+{
+	pool.unregisterJob(jobIndex);
+}
+
+void MatrixConvolver::Stage::init(const PreparedImpulse::Segments& newSegments, int numInputs, int numOutputs)
+{
+	partition.init(newSegments, numInputs, numOutputs);
+
+	const auto newBlockSize = partition.blockSize;
+
+	input.resize((size_t)numInputs * newBlockSize);
+	backgroundInput.resize((size_t)numInputs * newBlockSize);
+	skippedInput.resize((size_t)numInputs * newBlockSize);
+	backgroundSkippedInput.resize((size_t)numInputs * newBlockSize);
+	output.resize((size_t)numOutputs * newBlockSize);
+	precalculated.resize((size_t)numOutputs * newBlockSize);
+	overlap.resize((size_t)numOutputs * newBlockSize);
+	convReal.resize(partition.segmentStride);
+	convImag.resize(partition.segmentStride);
+	inputFill = 0;
+}
+
+void MatrixConvolver::Stage::runJob()
+{
+	// The output of the skipped block is too late to be played, it only updates the history of the stage
+	if (renderSkippedInput)
+		processBlock(backgroundSkippedInput);
+
+	processBlock(backgroundInput);
+}
+
+void MatrixConvolver::Stage::processBlock(SampleBuffer& blockInput)
+{
+	const auto blockSize = partition.blockSize;
+
+	for (int i = 0; i < partition.numInputs; i++)
+		partition.transformInput(i, partition.getChannel(blockInput, i));
+
+	for (int o = 0; o < partition.numOutputs; o++)
+	{
+		convReal.setZero();
+		convImag.setZero();
+
+		partition.accumulate(o, 0, partition.numSegments, convReal.data(), convImag.data());
+		partition.inverseTransform(convReal.data(), convImag.data());
+
+		auto channelOverlap = partition.getChannel(overlap, o);
+
+		fftconvolver::Sum(partition.getChannel(output, o), partition.fftBuffer.data(), channelOverlap, blockSize);
+		memcpy(channelOverlap, partition.fftBuffer.data() + blockSize, blockSize * sizeof(Sample));
+	}
+
+	partition.advance();
+}
+
+void MatrixConvolver::Stage::cleanPipeline()
+{
+	partition.cleanPipeline();
+	input.setZero();
+	backgroundInput.setZero();
+	skippedInput.setZero();
+	backgroundSkippedInput.setZero();
+	output.setZero();
+	precalculated.setZero();
+	overlap.setZero();
+	inputFill = 0;
+	late = false;
+	renderSkippedInput = false;
+}
+
+}
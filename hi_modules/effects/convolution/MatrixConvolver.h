@@ -0,0 +1,277 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#pragma once
+
+namespace hise { using namespace juce;
+
+/** A zero-latency convolver that renders a matrix of impulse responses (N inputs x M outputs).
+
+	This can be used for true stereo reverbs (2 x 2 impulse responses) or surround impulse responses. Instead of
+	running one convolver per path (which would transform the same input signal M times), the spectrum of every
+	input partition is calculated once and multiplied with the spectra of all impulse responses that start at this input.
+
+	The impulse response is partitioned like in the MultiStageConvolver: a head stage renders the first part without latency
+	on the audio thread and the remaining stages with growing block sizes are rendered in the ConvolutionWorkerPool.
+*/
+class MatrixConvolver
+{
+public:
+
+	using Sample = fftconvolver::Sample;
+
+	enum
+	{
+		StageFactor = 4,
+		MaxNumChannels = 16
+	};
+
+	MatrixConvolver(audiofft::ImplementationType fftType);
+
+	~MatrixConvolver();
+
+	/** The frequency domain representation of the impulse responses of all paths for a given partition scheme.
+
+		It contains only the impulse responses (and no rendering state), so it can be shared between multiple convolvers.
+	*/
+	struct PreparedImpulse : public ReferenceCountedObject
+	{
+		using Ptr = ReferenceCountedObjectPtr<PreparedImpulse>;
+
+		/** The spectra of all impulse response segments of all paths for one partition size. */
+		struct Segments
+		{
+			void init(audiofft::ImplementationType fftType, size_t newBlockSize, int numPaths, const Sample* const* irs, size_t irOffset, size_t irLength);
+
+			size_t blockSize = 0;
+			size_t complexSize = 0;
+			size_t segmentStride = 0;
+			size_t numSegments = 0;
+
+			fftconvolver::SampleBuffer real;
+			fftconvolver::SampleBuffer imag;
+		};
+
+		/** Returns the amount of bytes used by the impulse response data. */
+		size_t getMemoryUsage() const;
+
+		int numInputs = 0;
+		int numOutputs = 0;
+
+		/** The partition of the head followed by the partitions of every stage. */
+		OwnedArray<Segments> partitions;
+	};
+
+	/** Transforms the impulse responses into the frequency domain using the partition scheme of init().
+
+		This is the expensive part of the initialisation, so you can call this on a background thread and
+		share the result between multiple convolvers. It returns nullptr if the arguments are invalid.
+	*/
+	static PreparedImpulse::Ptr prepare(audiofft::ImplementationType fftType, size_t headBlockSize, size_t tailBlockSize, int numInputs, int numOutputs, const Sample* const* irs, size_t irLen);
+
+	/** Initialises the convolver with the impulse responses for every path.
+
+		The impulse response from input i to output o must be at irs[i * numOutputs + o] and all
+		impulse responses must have irLen samples.
+	*/
+	bool init(size_t headBlockSize, size_t tailBlockSize, int numInputs, int numOutputs, const Sample* const* irs, size_t irLen);
+
+	/** Initialises the convolver with impulse responses that were created with prepare().
+
+		The prepared impulse must have been created with the same FFT type.
+	*/
+	bool init(PreparedImpulse::Ptr preparedImpulse);
+
+	/** Convolves the input channels and writes the sum of all paths that end at an output channel into this channel. 
+	
+		The output channels are overwritten, but they may point to the same memory as the input channels.
+	*/
+	void process(const Sample* const* input, Sample* const* output, size_t len);
+
+	/** Resets the convolver and discards the impulse responses. */
+	void reset();
+
+	/** Clears the internal buffers without changing the impulse responses. */
+	void cleanPipeline();
+
+	/** Sets the sample rate that is used to calculate the deadline for the stage rendering. */
+	void setSampleRate(double newSampleRate) { sampleRate = newSampleRate; }
+
+	void setUseBackgroundThread(bool shouldBeUsingBackgroundThread) { useBackgroundThread = shouldBeUsingBackgroundThread; }
+
+	bool isUsingBackgroundThread() const { return useBackgroundThread; }
+
+	/** If enabled, the convolver waits until the worker has finished a late job instead of playing the block silent.
+
+		Use this if the convolver doesn't run in realtime (eg. when rendering offline or in a unit test), so that
+		a descheduled worker thread can't change the output.
+	*/
+	void setNonRealtime(bool isNonRealtime) { nonRealtime = isNonRealtime; }
+
+	int getNumInputs() const { return numInputs; }
+	int getNumOutputs() const { return numOutputs; }
+
+	/** Returns the amount of bytes that are used for the frequency domain representation of the impulse responses. */
+	size_t getIRMemoryUsage() const;
+
+private:
+
+	using SampleBuffer = fftconvolver::SampleBuffer;
+
+	/** The spectra of the last input blocks for one partition size. */
+	struct Partition
+	{
+		Partition(audiofft::ImplementationType fftType);
+
+		void init(const PreparedImpulse::Segments& newSegments, int numInputs, int numOutputs);
+
+		void cleanPipeline();
+
+		/** Transforms the input block of the given channel into the current segment. */
+		void transformInput(int inputIndex, const Sample* data);
+
+		/** Adds the products of the segments [firstSegment, lastSegment) of all paths that end at the output. */
+		void accumulate(int outputIndex, size_t firstSegment, size_t lastSegment, Sample* re, Sample* im);
+
+		/** Converts the spectrum into the time domain. The result will be in fftBuffer. */
+		void inverseTransform(const Sample* re, const Sample* im);
+
+		/** Moves the current segment index to the next block. */
+		void advance();
+
+		Sample* getChannel(SampleBuffer& b, int channelIndex) { return b.data() + (size_t)channelIndex * blockSize; }
+
+		audiofft::AudioFFT fft;
+
+		const PreparedImpulse::Segments* segments = nullptr;
+
+		int numInputs = 0;
+		int numOutputs = 0;
+
+		size_t blockSize = 0;
+		size_t complexSize = 0;
+		size_t segmentStride = 0;
+		size_t numSegments = 0;
+		size_t currentSegment = 0;
+
+		SampleBuffer inputReal, inputImag;
+		SampleBuffer fftBuffer;
+
+		JUCE_DECLARE_NON_COPYABLE(Partition);
+	};
+
+	/** Renders the beginning of the impulse responses without latency. */
+	struct Head
+	{
+		Head(audiofft::ImplementationType fftType);
+
+		void init(const PreparedImpulse::Segments& newSegments, int numInputs, int numOutputs);
+		void process(const Sample* const* input, Sample* const* output, size_t len);
+		void cleanPipeline();
+
+		Partition partition;
+		size_t inputFill = 0;
+
+		SampleBuffer input;
+		SampleBuffer overlap;
+		SampleBuffer preMultipliedReal, preMultipliedImag;
+		SampleBuffer convReal, convImag;
+	};
+
+	/** Renders a part of the impulse responses with one block of latency in the worker pool. */
+	struct Stage : public ConvolutionWorkerPool::Job
+	{
+		Stage(ConvolutionWorkerPool& pool_, audiofft::ImplementationType fftType);
+
+		~Stage();
+
+		void init(const PreparedImpulse::Segments& newSegments, int numInputs, int numOutputs);
+
+		void runJob() override;
+
+		/** Convolves one block of all input channels (stored next to each other). */
+		void processBlock(SampleBuffer& blockInput);
+
+		void cleanPipeline();
+
+		ConvolutionWorkerPool& pool;
+		int jobIndex = -1;
+
+		/** True if the running job missed its deadline. Its result is thrown away when it's finished. */
+		bool late = false;
+
+		/** Set before the job is queued if it has to render the input that arrived while the job was late. */
+		bool renderSkippedInput = false;
+
+		Partition partition;
+		size_t inputFill = 0;
+
+		SampleBuffer input;
+		SampleBuffer backgroundInput;
+		SampleBuffer skippedInput;
+		SampleBuffer backgroundSkippedInput;
+		SampleBuffer output;
+		SampleBuffer precalculated;
+		SampleBuffer overlap;
+		SampleBuffer convReal, convImag;
+
+		JUCE_DECLARE_NON_COPYABLE(Stage);
+	};
+
+	/** Collects the result of the stage when its input block is full and queues the next block. */
+	void finishStageBlock(Stage& s);
+
+	void startStage(Stage& s);
+
+	/** Waits for the job of the stage (see ConvolutionWorkerPool::waitForJob()) and returns false if the worker is late. */
+	bool waitForStage(Stage& s, int maxNumSpins=ConvolutionWorkerPool::MaxNumWaitSpins);
+
+	SharedResourcePointer<ConvolutionWorkerPool> pool;
+
+	audiofft::ImplementationType fftType;
+	ScopedPointer<Head> head;
+	OwnedArray<Stage> stages;
+
+	PreparedImpulse::Ptr impulse;
+
+	int numInputs = 0;
+	int numOutputs = 0;
+
+	double sampleRate = 44100.0;
+	bool useBackgroundThread = true;
+	bool nonRealtime = false;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MatrixConvolver);
+};
+
+}
@@ -0,0 +1,458 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+namespace hise {
+using namespace juce;
+
+#if JUCE_USE_SIMD
+struct BatchedPolyFilterKernels
+{
+	using Register = dsp::SIMDRegister<float>;
+
+	enum OutputType
+	{
+		LowPassOutput,
+		HighPassOutput,
+		BandPassOutput,
+		NotchOutput
+	};
+
+	/** The SVF from StateVariableFilterSubType with the states z1, v2, v0z and the coefficients g1, g2, g3, g4, k. */
+	template <int Output> static void processStateVariable(float* data, int numSamples, float* s, const float* c)
+	{
+		constexpr int L = BatchedPolyFilter::NumLanes;
+
+		auto z1 = Register::fromRawArray(s);
+		auto v2 = Register::fromRawArray(s + L);
+		auto v0z = Register::fromRawArray(s + 2 * L);
+
+		const auto g1 = Register::fromRawArray(c);
+		const auto g2 = Register::fromRawArray(c + L);
+		const auto g3 = Register::fromRawArray(c + 2 * L);
+		const auto g4 = Register::fromRawArray(c + 3 * L);
+		const auto k = Register::fromRawArray(c + 4 * L);
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			auto d = data + i * L;
+
+			const auto v0 = Register::fromRawArray(d);
+			const auto v1z = z1;
+			const auto v3 = v0 + v0z - v2 * 2.0f;
+
+			z1 += g1 * v3 - g2 * v1z;
+			v2 += g3 * v3 + g4 * v1z;
+			v0z = v0;
+
+			switch (Output)
+			{
+			case LowPassOutput:  v2.copyToRawArray(d); break;
+			case BandPassOutput: z1.copyToRawArray(d); break;
+			case HighPassOutput: (v0 - k * z1 - v2).copyToRawArray(d); break;
+			case NotchOutput:	 (v0 - k * z1).copyToRawArray(d); break;
+			}
+		}
+
+		z1.copyToRawArray(s);
+		v2.copyToRawArray(s + L);
+		v0z.copyToRawArray(s + 2 * L);
+	}
+
+	/** The transposed direct form II of the juce::IIRFilter with the states v1, v2. */
+	static void processBiquad(float* data, int numSamples, float* s, const float* c)
+	{
+		constexpr int L = BatchedPolyFilter::NumLanes;
+
+		auto v1 = Register::fromRawArray(s);
+		auto v2 = Register::fromRawArray(s + L);
+
+		const auto c0 = Register::fromRawArray(c);
+		const auto c1 = Register::fromRawArray(c + L);
+		const auto c2 = Register::fromRawArray(c + 2 * L);
+		const auto c3 = Register::fromRawArray(c + 3 * L);
+		const auto c4 = Register::fromRawArray(c + 4 * L);
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			auto d = data + i * L;
+
+			const auto in = Register::fromRawArray(d);
+			const auto out = c0 * in + v1;
+
+			v1 = c1 * in - c3 * out + v2;
+			v2 = c2 * in - c4 * out;
+
+			out.copyToRawArray(d);
+		}
+
+		v1.copyToRawArray(s);
+		v2.copyToRawArray(s + L);
+	}
+};
+#endif
+
+BatchedPolyFilter::BatchedPolyFilter(int numVoices_) :
+	numVoices(numVoices_)
+{
+	states.calloc(numVoices * MaxNumChannels * NumStates);
+	coefficients.calloc(numVoices * NumCoefficients);
+	lastParameters.calloc(numVoices * 3);
+	batchVoices.calloc(numVoices);
+	modulationValues.calloc(numVoices);
+
+	smoothers.insertMultiple(0, VoiceSmoothers(), numVoices);
+
+	scratchData.calloc((ChunkSize + NumStates + NumCoefficients) * NumLanes + Alignment / sizeof(float));
+
+	auto alignedStart = reinterpret_cast<float*>((reinterpret_cast<pointer_sized_int>(scratchData.get()) + Alignment - 1) & ~(pointer_sized_int)(Alignment - 1));
+
+	interleavedData = alignedStart;
+	laneStates = interleavedData + ChunkSize * NumLanes;
+	laneCoefficients = laneStates + NumStates * NumLanes;
+
+	reset();
+}
+
+bool BatchedPolyFilter::isSupported(FilterBank::FilterMode m)
+{
+#if JUCE_USE_SIMD
+	switch (m)
+	{
+	case FilterBank::LowPass:
+	case FilterBank::HighPass:
+	case FilterBank::LowShelf:
+	case FilterBank::HighShelf:
+	case FilterBank::Peak:
+	case FilterBank::ResoLow:
+	case FilterBank::StateVariableLP:
+	case FilterBank::StateVariableHP:
+	case FilterBank::StateVariableBandPass:
+	case FilterBank::StateVariableNotch:
+		return true;
+	default:
+		return false;
+	}
+#else
+	ignoreUnused(m);
+	return false;
+#endif
+}
+
+void BatchedPolyFilter::setMode(FilterBank::FilterMode newMode)
+{
+	if (mode != newMode)
+	{
+		SpinLock::ScopedLockType sl(lock);
+
+		mode = newMode;
+
+		isStateVariable = mode == FilterBank::StateVariableLP ||
+						  mode == FilterBank::StateVariableHP ||
+						  mode == FilterBank::StateVariableBandPass ||
+						  mode == FilterBank::StateVariableNotch;
+
+		reset();
+	}
+}
+
+void BatchedPolyFilter::setFrequency(double newFrequency)
+{
+	targetFreq = FilterLimits::limitFrequency(newFrequency);
+
+	for (auto& s : smoothers)
+		s.frequency.setValue(targetFreq);
+}
+
+void BatchedPolyFilter::setQ(double newQ)
+{
+	targetQ = FilterLimits::limitQ(newQ);
+
+	for (auto& s : smoothers)
+		s.q.setValue(targetQ);
+}
+
+void BatchedPolyFilter::setGain(double newGain)
+{
+	targetGain = FilterLimits::limitGain(newGain);
+
+	for (auto& s : smoothers)
+		s.gain.setValue(targetGain);
+}
+
+void BatchedPolyFilter::prepareToPlay(double newSampleRate, int /*maxBlockSize*/)
+{
+	SpinLock::ScopedLockType sl(lock);
+
+	sampleRate = newSampleRate;
+
+	for (auto& s : smoothers)
+	{
+		s.frequency.reset(sampleRate / 64.0, 0.03);
+		s.q.reset(sampleRate / 64.0, 0.03);
+		s.gain.reset(sampleRate / 64.0, 0.03);
+	}
+
+	prepared = true;
+
+	reset();
+}
+
+void BatchedPolyFilter::reset(int voiceIndex)
+{
+	if (isPositiveAndBelow(voiceIndex, numVoices))
+	{
+		FloatVectorOperations::clear(states + voiceIndex * MaxNumChannels * NumStates, MaxNumChannels * NumStates);
+
+		auto& s = smoothers.getReference(voiceIndex);
+		s.frequency.setValueWithoutSmoothing(targetFreq);
+		s.q.setValueWithoutSmoothing(targetQ);
+		s.gain.setValueWithoutSmoothing(targetGain);
+
+		// Invalidate the parameters so that the coefficients are calculated for the next chunk
+		for (int i = 0; i < 3; i++)
+			lastParameters[voiceIndex * 3 + i] = -1.0;
+	}
+}
+
+void BatchedPolyFilter::reset()
+{
+	for (int i = 0; i < numVoices; i++)
+		reset(i);
+}
+
+void BatchedPolyFilter::startBatch()
+{
+	numBatchVoices = 0;
+}
+
+BatchedPolyFilter::ModulationValues* BatchedPolyFilter::addVoice(int voiceIndex, AudioSampleBuffer& b, int startSample, int numSamples)
+{
+	const int numChannels = b.getNumChannels();
+
+	if (!isPositiveAndBelow(voiceIndex, numVoices) ||
+		numBatchVoices >= numVoices ||
+		numChannels > MaxNumChannels ||
+		!prepared)
+	{
+		return nullptr;
+	}
+
+	auto& v = batchVoices[numBatchVoices];
+
+	v.voiceIndex = voiceIndex;
+	v.numChannels = numChannels;
+	v.startSample = startSample;
+	v.numSamples = numSamples;
+
+	for (int i = 0; i < numChannels; i++)
+		v.channels[i] = b.getWritePointer(i, startSample);
+
+	v.modValues = modulationValues + numBatchVoices;
+	*v.modValues = {};
+
+	numBatchVoices++;
+
+	return v.modValues;
+}
+
+void BatchedPolyFilter::processBatch()
+{
+	SpinLock::ScopedLockType sl(lock);
+
+	if (numBatchVoices == 0)
+		return;
+
+	int index = 0;
+
+	while (index < numBatchVoices)
+	{
+		const auto& first = batchVoices[index];
+		int numInGroup = 1;
+
+		while (numInGroup < NumLanes && index + numInGroup < numBatchVoices)
+		{
+			const auto& next = batchVoices[index + numInGroup];
+
+			if (next.startSample != first.startSample ||
+				next.numSamples != first.numSamples ||
+				next.numChannels != first.numChannels)
+				break;
+
+			numInGroup++;
+		}
+
+		processGroup(batchVoices + index, numInGroup);
+		index += numInGroup;
+	}
+
+	numBatchVoices = 0;
+}
+
+void BatchedPolyFilter::processGroup(const VoiceData* groupVoices, int numVoicesInGroup)
+{
+	const int numSamples = groupVoices[0].numSamples;
+	const int numChannels = groupVoices[0].numChannels;
+
+	// unused lanes will have zero coefficients and process silence
+	FloatVectorOperations::clear(laneCoefficients, NumCoefficients * NumLanes);
+
+	for (int l = 0; l < numVoicesInGroup; l++)
+	{
+		const auto voiceIndex = groupVoices[l].voiceIndex;
+
+		updateCoefficients(voiceIndex, *groupVoices[l].modValues);
+
+		for (int c = 0; c < NumCoefficients; c++)
+			laneCoefficients[c * NumLanes + l] = coefficients[voiceIndex * NumCoefficients + c];
+	}
+
+	for (int offset = 0; offset < numSamples; offset += ChunkSize)
+	{
+		const int numThisTime = jmin<int>(ChunkSize, numSamples - offset);
+
+		for (int ch = 0; ch < numChannels; ch++)
+		{
+			if (numVoicesInGroup < NumLanes)
+			{
+				FloatVectorOperations::clear(interleavedData, ChunkSize * NumLanes);
+				FloatVectorOperations::clear(laneStates, NumStates * NumLanes);
+			}
+
+			for (int l = 0; l < numVoicesInGroup; l++)
+			{
+				const auto src = groupVoices[l].channels[ch] + offset;
+
+				for (int i = 0; i < numThisTime; i++)
+					interleavedData[i * NumLanes + l] = src[i];
+
+				auto s = states + (groupVoices[l].voiceIndex * MaxNumChannels + ch) * NumStates;
+
+				for (int k = 0; k < NumStates; k++)
+					laneStates[k * NumLanes + l] = s[k];
+			}
+
+			processInterleaved(interleavedData, numThisTime, laneStates, laneCoefficients);
+
+			for (int l = 0; l < numVoicesInGroup; l++)
+			{
+				auto dst = groupVoices[l].channels[ch] + offset;
+
+				for (int i = 0; i < numThisTime; i++)
+					dst[i] = interleavedData[i * NumLanes + l];
+
+				auto s = states + (groupVoices[l].voiceIndex * MaxNumChannels + ch) * NumStates;
+
+				for (int k = 0; k < NumStates; k++)
+				{
+					auto value = laneStates[k * NumLanes + l];
+					JUCE_SNAP_TO_ZERO(value);
+					s[k] = value;
+				}
+			}
+		}
+	}
+}
+
+void BatchedPolyFilter::updateCoefficients(int voiceIndex, const ModulationValues& mv)
+{
+	auto& s = smoothers.getReference(voiceIndex);
+
+	// Same calculation as MultiChannelFilter::update()
+	const auto thisFreq = FilterLimits::limitFrequency(s.frequency.getNextValue() * mv.freqModValue + mv.bipolarDelta * 20000.0);
+	const auto thisGain = mv.gainModValue * s.gain.getNextValue();
+	const auto thisQ = FilterLimits::limitQ(s.q.getNextValue() * mv.qModValue);
+
+	auto last = lastParameters + voiceIndex * 3;
+
+	if (last[0] == thisFreq && last[1] == thisQ && last[2] == thisGain)
+		return;
+
+	last[0] = thisFreq;
+	last[1] = thisQ;
+	last[2] = thisGain;
+
+	auto c = coefficients + voiceIndex * NumCoefficients;
+
+	if (isStateVariable)
+	{
+		// Same calculation as StateVariableFilterSubType::updateCoefficients()
+		const float scaledQ = jlimit<float>(0.0f, 9.999f, (float)thisQ * 0.1f);
+		const float g = (float)tan(double_Pi * thisFreq / sampleRate);
+		const float k = 1.0f - 0.99f * scaledQ;
+		const float ginv = g / (1.0f + g * (g + k));
+
+		c[0] = ginv;
+		c[1] = 2.0f * (g + k) * ginv;
+		c[2] = g * ginv;
+		c[3] = 2.0f * ginv;
+		c[4] = k;
+	}
+	else
+	{
+		IIRCoefficients ic;
+
+		switch (mode)
+		{
+		case FilterBank::LowPass:	ic = IIRCoefficients::makeLowPass(sampleRate, thisFreq); break;
+		case FilterBank::HighPass:	ic = IIRCoefficients::makeHighPass(sampleRate, thisFreq); break;
+		case FilterBank::LowShelf:	ic = IIRCoefficients::makeLowShelf(sampleRate, thisFreq, thisQ, (float)thisGain); break;
+		case FilterBank::HighShelf:	ic = IIRCoefficients::makeHighShelf(sampleRate, thisFreq, thisQ, (float)thisGain); break;
+		case FilterBank::Peak:		ic = IIRCoefficients::makePeakFilter(sampleRate, thisFreq, thisQ, (float)thisGain); break;
+		case FilterBank::ResoLow:	ic = FilterEffect::makeResoLowPass(sampleRate, thisFreq, thisQ); break;
+		default:					jassertfalse; break;
+		}
+
+		memcpy(c, ic.coefficients, sizeof(float) * NumCoefficients);
+	}
+}
+
+void BatchedPolyFilter::processInterleaved(float* data, int numSamples, float* stateData, const float* coefficientData) const
+{
+#if JUCE_USE_SIMD
+	using K = BatchedPolyFilterKernels;
+
+	switch (mode)
+	{
+	case FilterBank::StateVariableLP:		K::processStateVariable<K::LowPassOutput>(data, numSamples, stateData, coefficientData); break;
+	case FilterBank::StateVariableHP:		K::processStateVariable<K::HighPassOutput>(data, numSamples, stateData, coefficientData); break;
+	case FilterBank::StateVariableBandPass: K::processStateVariable<K::BandPassOutput>(data, numSamples, stateData, coefficientData); break;
+	case FilterBank::StateVariableNotch:	K::processStateVariable<K::NotchOutput>(data, numSamples, stateData, coefficientData); break;
+	default:								K::processBiquad(data, numSamples, stateData, coefficientData); break;
+	}
+#else
+	ignoreUnused(data, numSamples, stateData, coefficientData);
+	jassertfalse;
+#endif
+}
+
+}
@@ -0,0 +1,178 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef BATCHED_POLY_FILTER_H_INCLUDED
+#define BATCHED_POLY_FILTER_H_INCLUDED
+
+namespace hise {
+using namespace juce;
+
+/** A polyphonic filter that processes multiple voices at once using SIMD instructions.
+
+	Instead of rendering one MultiChannelFilter per voice, this class stores the filter states and coefficients
+	of all voices in flat arrays and processes voices with the same render range in parallel (one voice per SIMD lane).
+	Every lane has its own coefficients, so each voice can still have its own modulation.
+
+	The voices are collected with addVoice() during the voice rendering of the ModulatorSynth and processed
+	in processBatch(). It supports the state variable filters (except for the allpass and peak modes) and the static
+	biquad filters, so check isSupported() before using it.
+
+	Like the MultiChannelFilter of the per voice FilterBank, every voice samples its modulation and advances its
+	parameter smoothing once per render call, so the output matches FilterBank::renderPoly() with the same block.
+	If JUCE_USE_SIMD is disabled, no filter mode is supported and the voices are rendered one by one.
+*/
+class BatchedPolyFilter
+{
+public:
+
+	enum
+	{
+#if JUCE_USE_SIMD
+		NumLanes = (int)dsp::SIMDRegister<float>::SIMDNumElements,
+		Alignment = (int)dsp::SIMDRegister<float>::SIMDRegisterSize,
+#else
+		NumLanes = 1,
+		Alignment = 16,
+#endif
+		ChunkSize = 64,
+		MaxNumChannels = 2,
+		NumStates = 3,
+		NumCoefficients = 5
+	};
+
+	/** The modulation values of a voice for the current render call. */
+	struct ModulationValues
+	{
+		double freqModValue = 1.0;
+		double bipolarDelta = 0.0;
+		double gainModValue = 1.0;
+		double qModValue = 1.0;
+	};
+
+	BatchedPolyFilter(int numVoices);
+
+	/** Returns true if the given filter mode can be rendered as batch. */
+	static bool isSupported(FilterBank::FilterMode m);
+
+	void setMode(FilterBank::FilterMode newMode);
+	void setFrequency(double newFrequency);
+	void setQ(double newQ);
+	void setGain(double newGain);
+
+	/** Allocates the buffers. This must be called before any voice can be added. */
+	void prepareToPlay(double newSampleRate, int maxBlockSize);
+
+	/** Clears the state of the given voice. */
+	void reset(int voiceIndex);
+
+	/** Clears the state of all voices. */
+	void reset();
+
+	/** Clears the voice list. Call this before the voices are rendered. */
+	void startBatch();
+
+	/** Adds the voice to the current batch.
+
+		It returns the ModulationValues object of the voice that you need to fill before the next voice is added.
+		If the voice can't be processed as batch (eg. because it has too many channels or the buffers aren't
+		prepared), it returns nullptr and you need to render the voice directly.
+	*/
+	ModulationValues* addVoice(int voiceIndex, AudioSampleBuffer& b, int startSample, int numSamples);
+
+	/** Processes all voices that were added since the last call to startBatch(). */
+	void processBatch();
+
+private:
+
+	struct VoiceData
+	{
+		int voiceIndex = -1;
+		int numChannels = 0;
+		int startSample = 0;
+		int numSamples = 0;
+		float* channels[MaxNumChannels];
+		ModulationValues* modValues = nullptr;
+	};
+
+	/** The same parameter smoothing as in the MultiChannelFilter (one step per render call). */
+	struct VoiceSmoothers
+	{
+		LinearSmoothedValue<double> frequency = 1000.0;
+		LinearSmoothedValue<double> q = 1.0;
+		LinearSmoothedValue<double> gain = 1.0;
+	};
+
+	void processGroup(const VoiceData* groupVoices, int numVoicesInGroup);
+	void updateCoefficients(int voiceIndex, const ModulationValues& mv);
+	void processInterleaved(float* data, int numSamples, float* stateData, const float* coefficientData) const;
+
+	const int numVoices;
+
+	SpinLock lock;
+
+	FilterBank::FilterMode mode = FilterBank::StateVariableLP;
+	bool isStateVariable = true;
+
+	double sampleRate = 44100.0;
+	bool prepared = false;
+
+	double targetFreq = 1000.0;
+	double targetQ = 1.0;
+	double targetGain = 1.0;
+
+	Array<VoiceSmoothers> smoothers;
+
+	// NumStates values per channel and voice
+	HeapBlock<float> states;
+
+	// NumCoefficients values per voice and the parameters that were used to calculate them
+	HeapBlock<float> coefficients;
+	HeapBlock<double> lastParameters;
+
+	HeapBlock<VoiceData> batchVoices;
+	int numBatchVoices = 0;
+
+	HeapBlock<ModulationValues> modulationValues;
+
+	// aligned scratch memory for the interleaved samples, states and coefficients
+	HeapBlock<float> scratchData;
+	float* interleavedData = nullptr;
+	float* laneStates = nullptr;
+	float* laneCoefficients = nullptr;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchedPolyFilter);
+};
+
+}
+
+#endif
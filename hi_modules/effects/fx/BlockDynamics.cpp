@@ -0,0 +1,326 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+namespace hise { using namespace juce;
+
+BlockDynamics::BlockDynamics(Mode m) :
+	mode(m),
+	attackMs(m == Mode::Compressor ? 10.0 : 1.0),
+	releaseMs(m == Mode::Gate ? 100.0 : (m == Mode::Compressor ? 100.0 : 10.0))
+{
+	setSampleRate(sampleRate);
+	initRuntime();
+}
+
+void BlockDynamics::setSampleRate(double newSampleRate)
+{
+	jassert(newSampleRate > 0.0);
+
+	sampleRate = newSampleRate;
+
+	if (mode == Mode::Limiter)
+	{
+		auto requiredSize = nextPowerOfTwo(roundToInt(MaxLookaheadSeconds * sampleRate) + ChunkSize);
+
+		if (requiredSize != lookaheadBufferSize)
+		{
+			lookaheadBuffer.allocate(2 * requiredSize, true);
+			lookaheadBufferSize = requiredSize;
+			lookaheadWriteIndex = 0;
+		}
+	}
+
+	updateCoefficients();
+}
+
+void BlockDynamics::setThresh(double dB)
+{
+	thresholdDb = dB;
+	threshold = Decibels::decibelsToGain((float)dB, -1000.0f);
+}
+
+void BlockDynamics::setRatio(double newRatio)
+{
+	jassert(newRatio > 0.0);
+	ratio = newRatio;
+}
+
+void BlockDynamics::setAttack(double ms)
+{
+	attackMs = ms;
+	updateCoefficients();
+}
+
+void BlockDynamics::setRelease(double ms)
+{
+	releaseMs = ms;
+	updateCoefficients();
+}
+
+void BlockDynamics::setDetection(Detection newDetection)
+{
+	detection = newDetection;
+}
+
+void BlockDynamics::initRuntime()
+{
+	envelope = mode == Mode::Limiter ? threshold : DcOffset;
+	rmsState = DcOffset;
+	lastGain = 1.0f;
+	minGain = 1.0f;
+	maxGain = 1.0f;
+
+	peakTimer = 0;
+	maxPeak = threshold;
+
+	if (lookaheadBufferSize > 0)
+		FloatVectorOperations::clear(lookaheadBuffer, 2 * lookaheadBufferSize);
+
+	lookaheadWriteIndex = 0;
+}
+
+void BlockDynamics::processBlock(float** data, int numChannels, int numSamples)
+{
+	jassert(isPositiveAndBelow(numChannels - 1, 2));
+
+	float* chunk[2] = { data[0], numChannels > 1 ? data[1] : nullptr };
+
+	minGain = 1.0f;
+	maxGain = 0.0f;
+
+	while (numSamples > 0)
+	{
+		const int numThisTime = jmin(numSamples, ChunkSize);
+
+		processChunk(chunk, numChannels, numThisTime);
+
+		chunk[0] += numThisTime;
+
+		if (numChannels > 1)
+			chunk[1] += numThisTime;
+
+		numSamples -= numThisTime;
+	}
+}
+
+void BlockDynamics::process(double& left, double& right)
+{
+	float frame[2] = { (float)left, (float)right };
+	float* data[2] = { frame, frame + 1 };
+
+	minGain = 1.0f;
+	maxGain = 0.0f;
+	processChunk(data, 2, 1);
+
+	left = (double)frame[0];
+	right = (double)frame[1];
+}
+
+void BlockDynamics::processChunk(float** data, int numChannels, int numSamples)
+{
+	float key[ChunkSize];
+	float gain[ChunkSize];
+
+	calculateDetection(key, data, numChannels, numSamples);
+
+	switch (mode)
+	{
+	case Mode::Gate:		calculateGate(key, gain, numSamples); break;
+	case Mode::Compressor:	calculateCompressor(key, gain, numSamples); break;
+	case Mode::Limiter:		calculateLimiter(key, gain, numSamples);
+							applyLookahead(data, numChannels, numSamples);
+							break;
+	}
+
+	for (int c = 0; c < numChannels; c++)
+		FloatVectorOperations::multiply(data[c], gain, numSamples);
+
+	lastGain = gain[numSamples - 1];
+	const auto range = FloatVectorOperations::findMinAndMax(gain, numSamples);
+
+	minGain = jmin(minGain, range.getStart());
+	maxGain = jmax(maxGain, range.getEnd());
+}
+
+void BlockDynamics::calculateDetection(float* key, float** data, int numChannels, int numSamples)
+{
+	if (detection == Detection::Rms && mode != Mode::Limiter)
+	{
+		// Sum the power of both channels (a mono signal counts as both channels)
+		FloatVectorOperations::multiply(key, data[0], data[0], numSamples);
+
+		if (numChannels > 1)
+			FloatVectorOperations::addWithMultiply(key, data[1], data[1], numSamples);
+		else
+			FloatVectorOperations::multiply(key, 2.0f, numSamples);
+
+		auto state = rmsState;
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			const double in = (double)key[i] + DcOffset;
+			state = in + rmsCoefficient * (state - in);
+			key[i] = (float)state;
+		}
+
+		rmsState = state;
+
+		for (int i = 0; i < numSamples; i++)
+			key[i] = std::sqrt(key[i]);
+	}
+	else
+	{
+		FloatVectorOperations::abs(key, data[0], numSamples);
+
+		if (numChannels > 1)
+		{
+			float right[ChunkSize];
+			FloatVectorOperations::abs(right, data[1], numSamples);
+			FloatVectorOperations::max(key, key, right, numSamples);
+		}
+	}
+}
+
+void BlockDynamics::calculateGate(float* key, float* gain, int numSamples)
+{
+	auto env = envelope;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		const double over = (key[i] > threshold ? 1.0 : 0.0) + DcOffset;
+		env = over + (over > env ? attackCoefficient : releaseCoefficient) * (env - over);
+		gain[i] = (float)(env - DcOffset);
+	}
+
+	envelope = env;
+}
+
+void BlockDynamics::calculateCompressor(float* key, float* gain, int numSamples)
+{
+	static constexpr float DbPerOctave = 6.0205999f;
+
+	const float t = (float)thresholdDb;
+
+	for (int i = 0; i < numSamples; i++)
+		key[i] = DbPerOctave * fastLog2(key[i] + DcOffset) - t;
+
+	FloatVectorOperations::max(key, key, 0.0f, numSamples);
+
+	// Calculate the gain reduction as exponent of 2 so that the conversion is a single fastExp2() call
+	const double slope = (ratio - 1.0) / (double)DbPerOctave;
+	auto env = envelope;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		const double over = (double)key[i] + DcOffset;
+		env = over + (over > env ? attackCoefficient : releaseCoefficient) * (env - over);
+		gain[i] = (float)((env - DcOffset) * slope);
+	}
+
+	envelope = env;
+
+	for (int i = 0; i < numSamples; i++)
+		gain[i] = fastExp2(gain[i]);
+}
+
+void BlockDynamics::calculateLimiter(float* key, float* gain, int numSamples)
+{
+	// Feed at least the threshold into the sidechain
+	FloatVectorOperations::max(key, key, threshold, numSamples);
+
+	auto env = envelope;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		// Hold the maximum peak for the look-ahead time so that the envelope can reach it
+		// before the delayed sample arrives
+		if (++peakTimer >= lookaheadSamples || key[i] > maxPeak)
+		{
+			peakTimer = 0;
+			maxPeak = key[i];
+		}
+
+		env = (double)maxPeak + (maxPeak > env ? attackCoefficient : releaseCoefficient) * (env - (double)maxPeak);
+		gain[i] = threshold / (float)env;
+	}
+
+	envelope = env;
+}
+
+void BlockDynamics::applyLookahead(float** data, int numChannels, int numSamples)
+{
+	jassert(lookaheadBufferSize >= lookaheadSamples + numSamples);
+
+	const int mask = lookaheadBufferSize - 1;
+	const int readIndex = (lookaheadWriteIndex - lookaheadSamples) & mask;
+
+	const int numBeforeWrapWrite = jmin(numSamples, lookaheadBufferSize - lookaheadWriteIndex);
+	const int numBeforeWrapRead = jmin(numSamples, lookaheadBufferSize - readIndex);
+
+	for (int c = 0; c < numChannels; c++)
+	{
+		auto ring = lookaheadBuffer + c * lookaheadBufferSize;
+		auto d = data[c];
+
+		FloatVectorOperations::copy(ring + lookaheadWriteIndex, d, numBeforeWrapWrite);
+		FloatVectorOperations::copy(ring, d + numBeforeWrapWrite, numSamples - numBeforeWrapWrite);
+
+		FloatVectorOperations::copy(d, ring + readIndex, numBeforeWrapRead);
+		FloatVectorOperations::copy(d + numBeforeWrapRead, ring, numSamples - numBeforeWrapRead);
+	}
+
+	lookaheadWriteIndex = (lookaheadWriteIndex + numSamples) & mask;
+}
+
+void BlockDynamics::updateCoefficients()
+{
+	const bool isLimiter = mode == Mode::Limiter;
+
+	attackCoefficient = getCoefficient(jmax(isLimiter ? 0.02 : 0.01, attackMs), sampleRate, isLimiter);
+	releaseCoefficient = getCoefficient(jmax(0.01, releaseMs), sampleRate, isLimiter);
+	rmsCoefficient = getCoefficient(5.0, sampleRate, false);
+
+	if (isLimiter)
+		lookaheadSamples = jlimit(0, lookaheadBufferSize - ChunkSize, (int)(0.001 * jmax(0.02, attackMs) * sampleRate));
+}
+
+double BlockDynamics::getCoefficient(double ms, double sampleRate, bool useFastEnvelope)
+{
+	// The fast envelope of the limiter rises to 99% within the time constant
+	if (useFastEnvelope)
+		return std::pow(0.01, 1000.0 / (ms * sampleRate));
+
+	return std::exp(-1000.0 / (ms * sampleRate));
+}
+
+} // namespace hise
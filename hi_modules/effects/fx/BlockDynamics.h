@@ -0,0 +1,225 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef BLOCKDYNAMICS_H_INCLUDED
+#define BLOCKDYNAMICS_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** A block based dynamics processor that is used by the Dynamics effect and the scriptnode dynamics nodes.
+*
+*	It has the same parameters and envelope shapes as the chunkware classes, but renders the signal in chunks:
+*	the detection and the gain application use FloatVectorOperations, the dB conversion of the compressor uses
+*	fast log2 / exp2 approximations that the compiler can vectorise and only the envelope follower itself is a
+*	serial loop. The limiter delays the signal with a look-ahead buffer so that the gain reduction hits the peaks
+*	in time.
+*/
+class BlockDynamics
+{
+public:
+
+	enum class Mode
+	{
+		Gate,
+		Compressor,
+		Limiter
+	};
+
+	enum class Detection
+	{
+		Peak,
+		Rms
+	};
+
+	/** The size of the internal detection buffers. Longer blocks will be split up into chunks of this size. */
+	static constexpr int ChunkSize = 64;
+
+	/** The maximum attack time of the limiter (which is also its latency). */
+	static constexpr double MaxLookaheadSeconds = 0.1;
+
+	BlockDynamics(Mode m);
+
+	virtual ~BlockDynamics() {};
+
+	// ================================================================================================================
+
+	/** Sets the samplerate. This might resize the look-ahead buffer, so call it in prepareToPlay(). */
+	void setSampleRate(double newSampleRate);
+
+	void setThresh(double dB);
+
+	/** Sets the slope of the compressor (1 / ratio, just like the chunkware compressor). */
+	void setRatio(double newRatio);
+
+	void setAttack(double ms);
+	void setRelease(double ms);
+
+	/** Uses an RMS detector with a 5ms window instead of the (stereo linked) peak detection. */
+	void setDetection(Detection newDetection);
+
+	double getThresh() const noexcept { return thresholdDb; }
+	double getRatio() const noexcept { return ratio; }
+	double getAttack() const noexcept { return attackMs; }
+	double getRelease() const noexcept { return releaseMs; }
+	Detection getDetection() const noexcept { return detection; }
+
+	/** Returns the gain factor of the last processed sample. */
+	double getGainReduction() const noexcept { return (double)lastGain; }
+
+	/** Returns the lowest gain factor of the last processed block. */
+	float getMinimumGainOfLastBlock() const noexcept { return minGain; }
+
+	/** Returns the highest gain factor of the last processed block. */
+	float getMaximumGainOfLastBlock() const noexcept { return maxGain; }
+
+	/** Returns the look-ahead delay in samples (this is always zero for the gate and the compressor). */
+	int getLatency() const noexcept { return mode == Mode::Limiter ? lookaheadSamples : 0; }
+
+	/** Clears the envelope and the look-ahead buffer. */
+	void initRuntime();
+
+	// ================================================================================================================
+
+	/** Processes a block of mono or stereo data. Both channels are linked to one gain reduction. */
+	void processBlock(float** data, int numChannels, int numSamples);
+
+	/** Processes a single stereo frame. Use processBlock() wherever possible. */
+	void process(double& left, double& right);
+
+	// ================================================================================================================
+
+	/** A fast approximation of log2(x) for normalised x > 0 (the error is below 1e-6). */
+	static forcedinline float fastLog2(float x) noexcept
+	{
+		union { float f; uint32 i; } v = { x };
+
+		// Split into exponent and a mantissa within [sqrt(0.5), sqrt(2)) so that the series converges quickly
+		const int roundUp = (v.i & 0x007FFFFF) > 0x003504F3 ? 1 : 0;
+		const float e = (float)((int)((v.i >> 23) & 0xFF) - 127 + roundUp);
+
+		union { uint32 i; float f; } m = { (v.i & 0x007FFFFF) | (uint32)(0x3f800000 - (roundUp << 23)) };
+
+		const float t = (m.f - 1.0f) / (m.f + 1.0f);
+		const float t2 = t * t;
+
+		return e + t * (2.8853900818f + t2 * (0.9617966939f + t2 * (0.5770780164f + t2 * 0.4121985831f)));
+	}
+
+	/** A fast approximation of 2^x for x within [-126, 126] (the relative error is below 1e-6). */
+	static forcedinline float fastExp2(float x) noexcept
+	{
+		const float clipped = x < -126.0f ? -126.0f : (x > 126.0f ? 126.0f : x);
+		const int n = (int)(clipped + (clipped < 0.0f ? -0.5f : 0.5f));
+		const float y = (clipped - (float)n) * 0.6931471806f;
+
+		union { uint32 i; float f; } scale = { (uint32)(n + 127) << 23 };
+
+		const float p = 1.0f + y * (1.0f + y * (0.5f + y * (0.1666666667f + y * (0.0416666667f + y * (0.0083333333f + y * 0.0013888889f)))));
+
+		return p * scale.f;
+	}
+
+private:
+
+	static constexpr float DcOffset = 1.0e-25f;
+
+	void processChunk(float** data, int numChannels, int numSamples);
+
+	void calculateDetection(float* key, float** data, int numChannels, int numSamples);
+
+	void calculateGate(float* key, float* gain, int numSamples);
+	void calculateCompressor(float* key, float* gain, int numSamples);
+	void calculateLimiter(float* key, float* gain, int numSamples);
+
+	void applyLookahead(float** data, int numChannels, int numSamples);
+
+	void updateCoefficients();
+
+	static double getCoefficient(double ms, double sampleRate, bool useFastEnvelope);
+
+	const Mode mode;
+	Detection detection = Detection::Peak;
+
+	double sampleRate = 44100.0;
+
+	double thresholdDb = 0.0;
+	float threshold = 1.0f;
+	double ratio = 1.0;
+	double attackMs;
+	double releaseMs;
+
+	// The serial envelope loops run in double precision like the chunkware classes. The coefficients
+	// are close to 1.0 at high samplerates and would otherwise change the time constants.
+	double attackCoefficient = 0.0;
+	double releaseCoefficient = 0.0;
+	double rmsCoefficient = 0.0;
+
+	double envelope = 0.0;
+	double rmsState = DcOffset;
+	float lastGain = 1.0f;
+	float minGain = 1.0f;
+	float maxGain = 1.0f;
+
+	// The limiter holds the maximum peak for the look-ahead time
+	int lookaheadSamples = 0;
+	int peakTimer = 0;
+	float maxPeak = 1.0f;
+
+	HeapBlock<float> lookaheadBuffer;
+	int lookaheadBufferSize = 0;
+	int lookaheadWriteIndex = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(BlockDynamics);
+};
+
+/** The gate of the BlockDynamics engine. */
+struct BlockGate : public BlockDynamics
+{
+	BlockGate() : BlockDynamics(Mode::Gate) {};
+};
+
+/** The compressor of the BlockDynamics engine. */
+struct BlockCompressor : public BlockDynamics
+{
+	BlockCompressor() : BlockDynamics(Mode::Compressor) {};
+};
+
+/** The look-ahead limiter of the BlockDynamics engine. */
+struct BlockLimiter : public BlockDynamics
+{
+	BlockLimiter() : BlockDynamics(Mode::Limiter) {};
+};
+
+} // namespace hise
+
+#endif  // BLOCKDYNAMICS_H_INCLUDED
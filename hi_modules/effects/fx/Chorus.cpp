@@ -34,7 +34,7 @@ namespace hise { using namespace juce;
 
 ChorusEffect::ChorusEffect(MainController *mc, const String &id) :
 MasterEffectProcessor(mc, id),
-tempBuffer(2, 0)
+tempBuffer(3, 0)
 {
 	finaliseModChains();
 
@@ -43,20 +43,13 @@ tempBuffer(2, 0)
 	parameterNames.add("Feedback");	parameterDescriptions.add("The feedback amount of the chorus");
 	parameterNames.add("Delay");	parameterDescriptions.add("The delay amount of the chorus");
 
-	bufpos = 0;
-	buffer = new float[BUFMAX];
-	buffer2 = new float[BUFMAX];
-	phi = fb = fb1 = fb2 = deps = 0.0f;
+	phi = fb = fb1 = fb2 = 0.0f;
 
 	parameterRate = 0.30f; 
 	parameterDepth = 0.43f;
 	parameterMix = 0.47f;  
 	parameterFeedback = 0.30f;
 	parameterDelay = 1.00f;
-
-	if (buffer) memset(buffer, 0, BUFMAX * sizeof(float));
-	if (buffer2) memset(buffer2, 0, BUFMAX * sizeof(float));
-
 }
 
 float ChorusEffect::getAttribute(int parameterIndex) const
@@ -116,80 +109,91 @@ void ChorusEffect::prepareToPlay(double sampleRate, int samplesPerBlock)
 
 	ProcessorHelpers::increaseBufferIfNeeded(tempBuffer, samplesPerBlock);
 
+	leftDelay.setMaxDelaySamples(MaxDelaySamples, samplesPerBlock);
+	rightDelay.setMaxDelaySamples(MaxDelaySamples, samplesPerBlock);
+
 	calculateInternalValues();
 }
 
 void ChorusEffect::applyEffect(AudioSampleBuffer &b, int startSample, int numSamples)
 {
-	FloatVectorOperations::copy(tempBuffer.getWritePointer(0, 0), b.getReadPointer(0, startSample), numSamples);
-	FloatVectorOperations::copy(tempBuffer.getWritePointer(1, 0), b.getReadPointer(1, startSample), numSamples);
+	float* delayTimes = tempBuffer.getWritePointer(0, 0);
+
+	// Both channels use the same LFO, so the delay times are calculated once.
+	float ph = phi;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		ph += rat;
+		if (ph > 1.0f) ph -= 2.0f;
 
-	const float *inputL = tempBuffer.getReadPointer(0, 0);
-	const float *inputR = tempBuffer.getReadPointer(1, 0);
+		delayTimes[i] = dem + dep * (1.0f - ph * ph); //delay mod shape
+	}
 
-	const float *inputs[2] = { inputL, inputR };
-	
-	float *outputL = b.getWritePointer(0, startSample);
-	float *outputR = b.getWritePointer(1, startSample);
+	phi = ph;
 
-	float *outputs[2] = { outputL, outputR };
+	float* data[2] = { b.getWritePointer(0, startSample), b.getWritePointer(1, startSample) };
 
-	processReplacing(inputs, outputs, numSamples);
+	processStereo(data, delayTimes, numSamples);
 }
 
-//
-//								processReplacing
-//
-void ChorusEffect::processReplacing(const float** inputs, float** outputs, int sampleFrames)
+void ChorusEffect::processStereo(float** data, const float* delayTimes, int numSamples)
 {
-	const float *in1 = inputs[0];
-	const float *in2 = inputs[1];
-	float *out1 = outputs[0];
-	float *out2 = outputs[1];
-	float a, b, f = fb, f1 = fb1, f2 = fb2, ph = phi;
-	float ra = rat, de = dep, we = wet, dr = dry, ds = deps, dm = dem;
-	int  tmp, tmpi, bp = bufpos;
-	float tmpf, dpt;
-
-	--in1;
-	--in2;
-	--out1;
-	--out2;
-	while (--sampleFrames >= 0)
+	float* wetSignal[2] = { tempBuffer.getWritePointer(1, 0), tempBuffer.getWritePointer(2, 0) };
+	float feedbackSignal[2][ModulatedDelayLine::ChunkSize];
+
+	int pos = 0;
+
+	while (pos < numSamples)
 	{
-		a = *++in1;
-		b = *++in2;
+		float* wetThisTime[2] = { wetSignal[0] + pos, wetSignal[1] + pos };
 
-		ph += ra;
-		if (ph > 1.0f) ph -= 2.0f;
+		const int numInChunk = jmin(numSamples - pos, (int)ModulatedDelayLine::ChunkSize);
+		const float minDelay = FloatVectorOperations::findMinimum(delayTimes + pos, numInChunk);
+		const int numThisTime = jmin(numInChunk, leftDelay.getMaxFeedbackBlockSize(minDelay));
+
+		if (numThisTime == 0)
+		{
+			// The delay is shorter than the chunk, so this sample must be written before it can be read.
+			leftDelay.pushSample(data[0][pos] + fb * fb1);
+			rightDelay.pushSample(data[1][pos] + fb * fb2);
+
+			ModulatedDelayLine::readStereoBlock(leftDelay, rightDelay, wetThisTime, delayTimes + pos, 1, leftTap, rightTap);
+
+			fb1 = wetSignal[0][pos];
+			fb2 = wetSignal[1][pos];
+			pos++;
+			continue;
+		}
 
-		bp--; bp &= 0x7FF;
-		*(buffer + bp) = a + f * f1;
-		*(buffer2 + bp) = b + f * f2;
+		ModulatedDelayLine::readStereoBlock(leftDelay, rightDelay, wetThisTime, delayTimes + pos, numThisTime, leftTap, rightTap, ModulatedDelayLine::ReadPosition::BeforePush);
 
-		//ds = 0.995f * (ds - de) + de;          //smoothed depth change ...try inc not mult
-		dpt = tmpf = dm + de * (1.0f - ph * ph); //delay mod shape
-		tmp = int(tmpf);
-		tmpf -= tmp;
-		tmp = (tmp + bp) & 0x7FF;
-		tmpi = (tmp + 1) & 0x7FF;
+		// The feedback uses the wet signal of the previous sample
+		feedbackSignal[0][0] = data[0][pos] + fb * fb1;
+		feedbackSignal[1][0] = data[1][pos] + fb * fb2;
 
-		f1 = *(buffer + tmp);  //try adding a constant to reduce denormalling
-		f2 = *(buffer2 + tmp);
-		f1 = tmpf * (*(buffer + tmpi) - f1) + f1; //linear interpolation
-		f2 = tmpf * (*(buffer2 + tmpi) - f2) + f2;
+		for (int i = 1; i < numThisTime; i++)
+		{
+			feedbackSignal[0][i] = data[0][pos + i] + fb * wetThisTime[0][i - 1];
+			feedbackSignal[1][i] = data[1][pos + i] + fb * wetThisTime[1][i - 1];
+		}
 
-		a = a * dr - f1 * we;
-		b = b * dr - f2 * we;
+		leftDelay.pushBlock(feedbackSignal[0], numThisTime);
+		rightDelay.pushBlock(feedbackSignal[1], numThisTime);
 
-		*++out1 = a;
-		*++out2 = b;
+		fb1 = wetThisTime[0][numThisTime - 1];
+		fb2 = wetThisTime[1][numThisTime - 1];
+		pos += numThisTime;
+	}
+
+	if (std::abs(fb1) < 1.0e-10f)
+		fb1 = fb2 = 0.0f; //catch denormals
+
+	for (int c = 0; c < 2; c++)
+	{
+		FloatVectorOperations::multiply(data[c], dry, numSamples);
+		FloatVectorOperations::subtractWithMultiply(data[c], wetSignal[c], wet, numSamples);
 	}
-	if (fabs(f1) > 1.0e-10) { fb1 = f1; fb2 = f2; }
-	else fb1 = fb2 = 0.0f; //catch denormals
-	phi = ph;
-	deps = ds;
-	bufpos = bp;
 }
 
 
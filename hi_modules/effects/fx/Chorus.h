@@ -35,8 +35,6 @@
 
 namespace hise { using namespace juce;
 
-#define BUFMAX   2048
-
 /** A simple (and rather cheap sounding) chorus effect
 	@ingroup effectTypes
 */
@@ -73,19 +71,27 @@ public:
 	const Processor *getChildProcessor(int /*processorIndex*/) const override { return nullptr; };
 
 	ProcessorEditorBody *createEditor(ProcessorEditor *parentEditor)  override;
-	void processReplacing(const float** inputs, float** outputs, int sampleFrames);
 
 	void calculateInternalValues();
 
 private:
 
+	/** Runs the modulated feedback loop of both channels and mixes the wet signal into data. */
+	void processStereo(float** data, const float* delayTimes, int numSamples);
+
+	static constexpr int MaxDelaySamples = 2048;
+
 	AudioSampleBuffer tempBuffer;
 
 	///global internal variables
 	float rat, dep, wet, dry, fb, dem; //rate, depth, wet & dry mix, feedback, mindepth
-	float phi, fb1, fb2, deps;         //lfo & feedback buffers, depth change smoothing 
-	float *buffer, *buffer2;           //maybe use 2D buffer?
-	uint32 size, bufpos;
+	float phi, fb1, fb2;               //lfo & feedback buffers
+
+	ModulatedDelayLine leftDelay;
+	ModulatedDelayLine rightDelay;
+
+	ModulatedDelayLine::Tap leftTap;
+	ModulatedDelayLine::Tap rightTap;
 
 	float parameterRate;
 	float parameterDepth;
@@ -82,7 +82,10 @@ void CurveEq::setInternalAttribute(int index, float newValue)
 		case BandParameter::Gain:	filter->setGain(Decibels::decibelsToGain(newValue)); break;
 		case BandParameter::Freq:	filter->setFrequency(newValue); break;
 		case BandParameter::Q:		filter->setQ(newValue); break;
-		case BandParameter::Type:	filter->setType((int)newValue); break;
+		case BandParameter::Type:	if (filter->getType() != (int)newValue)
+										filter->resetFusedState();
+
+									filter->setType((int)newValue); break;
 		case BandParameter::Enabled:filter->setEnabled(newValue >= 0.5f); break;
 		case numBandParameters:
 		default:                    break;
@@ -94,6 +97,199 @@ void CurveEq::setInternalAttribute(int index, float newValue)
 	}
 }
 
+#if !HISE_USE_SVF_FOR_CURVE_EQ && JUCE_USE_SIMD
+struct CurveEqFusedKernel
+{
+	using Register = dsp::SIMDRegister<float>;
+
+	enum
+	{
+		NumLanes = (int)Register::SIMDNumElements,
+
+		// c0-c4, the per sample deltas of c0-c4, v1, v2
+		BandSize = 12 * NumLanes
+	};
+
+	template <bool Ramp> static void process(float* data, int numBands, float* l, float* r, int numSamples)
+	{
+		// the last slot after the bands is used to load the stereo frame
+		auto frame = data + numBands * BandSize;
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			frame[0] = l[i];
+
+			if (r != nullptr)
+				frame[1] = r[i];
+
+			auto x = Register::fromRawArray(frame);
+
+			for (int b = 0; b < numBands; b++)
+			{
+				auto d = data + b * BandSize;
+
+				auto c0 = Register::fromRawArray(d);
+				auto c1 = Register::fromRawArray(d + NumLanes);
+				auto c2 = Register::fromRawArray(d + 2 * NumLanes);
+				auto c3 = Register::fromRawArray(d + 3 * NumLanes);
+				auto c4 = Register::fromRawArray(d + 4 * NumLanes);
+
+				if (Ramp)
+				{
+					c0 += Register::fromRawArray(d + 5 * NumLanes);
+					c1 += Register::fromRawArray(d + 6 * NumLanes);
+					c2 += Register::fromRawArray(d + 7 * NumLanes);
+					c3 += Register::fromRawArray(d + 8 * NumLanes);
+					c4 += Register::fromRawArray(d + 9 * NumLanes);
+
+					c0.copyToRawArray(d);
+					c1.copyToRawArray(d + NumLanes);
+					c2.copyToRawArray(d + 2 * NumLanes);
+					c3.copyToRawArray(d + 3 * NumLanes);
+					c4.copyToRawArray(d + 4 * NumLanes);
+				}
+
+				auto v1 = Register::fromRawArray(d + 10 * NumLanes);
+				auto v2 = Register::fromRawArray(d + 11 * NumLanes);
+
+				const auto out = c0 * x + v1;
+
+				v1 = c1 * x - c3 * out + v2;
+				v2 = c2 * x - c4 * out;
+
+				v1.copyToRawArray(d + 10 * NumLanes);
+				v2.copyToRawArray(d + 11 * NumLanes);
+
+				x = out;
+			}
+
+			x.copyToRawArray(frame);
+
+			l[i] = frame[0];
+
+			if (r != nullptr)
+				r[i] = frame[1];
+		}
+	}
+};
+#endif
+
+bool CurveEq::renderFusedCascade(AudioSampleBuffer& b, int startSample, int numSamples)
+{
+#if !HISE_USE_SVF_FOR_CURVE_EQ && JUCE_USE_SIMD
+	using K = CurveEqFusedKernel;
+	constexpr int L = K::NumLanes;
+
+	const int numChannels = b.getNumChannels();
+
+	if (numChannels == 0 || numChannels > 2 || numSamples <= 0 || filterBands.size() > numFusedBands)
+		return false;
+
+	FilterHelpers::RenderData r(b, startSample, numSamples);
+
+	int numBands = 0;
+	bool ramp = false;
+
+	for (auto f : filterBands)
+	{
+		if (!f->isEnabled())
+			continue;
+
+		f->updateParameters(r);
+
+		const auto target = f->getCurrentCoefficients().coefficients;
+		auto d = fusedData + numBands * K::BandSize;
+
+		for (int c = 0; c < 5; c++)
+		{
+			const float start = f->fusedCoefficientsValid ? f->fusedCoefficients[c] : target[c];
+			const float delta = (target[c] - start) / (float)numSamples;
+
+			ramp |= delta != 0.0f;
+
+			// The ramp adds the delta before each sample so the last sample uses the target coefficients
+			for (int l = 0; l < L; l++)
+			{
+				d[c * L + l] = start;
+				d[(c + 5) * L + l] = delta;
+			}
+
+			f->fusedCoefficients[c] = target[c];
+		}
+
+		f->fusedCoefficientsValid = true;
+
+		FloatVectorOperations::clear(d + 10 * L, 2 * L);
+
+		for (int ch = 0; ch < numChannels; ch++)
+		{
+			d[10 * L + ch] = f->fusedState[ch][0];
+			d[11 * L + ch] = f->fusedState[ch][1];
+		}
+
+		numBands++;
+	}
+
+	if (numBands > 0)
+	{
+		FloatVectorOperations::clear(fusedData + numBands * K::BandSize, L);
+
+		auto left = b.getWritePointer(0, startSample);
+		auto right = numChannels > 1 ? b.getWritePointer(1, startSample) : nullptr;
+
+		if (ramp)
+			K::process<true>(fusedData, numBands, left, right, numSamples);
+		else
+			K::process<false>(fusedData, numBands, left, right, numSamples);
+
+		int bandIndex = 0;
+
+		for (auto f : filterBands)
+		{
+			if (!f->isEnabled())
+				continue;
+
+			auto d = fusedData + bandIndex++ * K::BandSize;
+
+			for (int ch = 0; ch < numChannels; ch++)
+			{
+				for (int s = 0; s < 2; s++)
+				{
+					auto v = d[(10 + s) * L + ch];
+					JUCE_SNAP_TO_ZERO(v);
+					f->fusedState[ch][s] = v;
+				}
+			}
+		}
+	}
+
+	return true;
+#else
+	ignoreUnused(b, startSample, numSamples);
+	return false;
+#endif
+}
+
+void CurveEq::allocateFusedData()
+{
+#if !HISE_USE_SVF_FOR_CURVE_EQ && JUCE_USE_SIMD
+	using K = CurveEqFusedKernel;
+
+	const int numBands = filterBands.size();
+
+	if (numBands <= numFusedBands)
+		return;
+
+	// the bands, the stereo frame and the alignment offset
+	HeapBlock<float> newScratch;
+	newScratch.calloc(numBands * K::BandSize + 2 * K::NumLanes);
+
+	fusedData = K::Register::getNextSIMDAlignedPtr(newScratch.get());
+	fusedScratch.swapWith(newScratch);
+	numFusedBands = numBands;
+#endif
+}
+
 ProcessorEditorBody *CurveEq::createEditor(ProcessorEditor *parentEditor)
 {
 #if USE_BACKEND
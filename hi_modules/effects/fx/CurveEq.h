@@ -107,6 +107,10 @@ public:
 
 		void setEnabled(bool shouldBeEnabled)
 		{
+			// the fused state is not updated while the band is disabled
+			if (shouldBeEnabled && !enabled)
+				resetFusedState();
+
 			enabled = shouldBeEnabled;
 		}
 
@@ -115,8 +119,22 @@ public:
 			return enabled;
 		}
 
+		/** Clears the filter state of the fused cascade. */
+		void resetFusedState()
+		{
+			zeromem(fusedState, sizeof(fusedState));
+			fusedCoefficientsValid = false;
+		}
+
 	private:
 
+		friend class CurveEq;
+
+		// the state and last coefficients when rendered with CurveEq::renderFusedCascade()
+		float fusedState[2][2] = { { 0.0f, 0.0f }, { 0.0f, 0.0f } };
+		float fusedCoefficients[5];
+		bool fusedCoefficientsValid = false;
+
 		bool enabled = true;
 	};
 
@@ -161,11 +179,14 @@ public:
 
 	void applyEffect(AudioSampleBuffer &buffer, int startSample, int numSamples) override
 	{
-		FilterHelpers::RenderData r(buffer, startSample, numSamples);
-
-		for (auto filter : filterBands)
+		if (!renderFusedCascade(buffer, startSample, numSamples))
 		{
-			filter->renderIfEnabled(r);
+			FilterHelpers::RenderData r(buffer, startSample, numSamples);
+
+			for (auto filter : filterBands)
+			{
+				filter->renderIfEnabled(r);
+			}
 		}
 
 		if (fftBuffer.isActive())
@@ -222,6 +243,7 @@ public:
 		f->setFrequency(freq);
 
 		filterBands.add(f);
+		allocateFusedData();
 
 		sendChangeMessage();
 	}
@@ -248,8 +270,11 @@ public:
 			for (int i = 0; i < filterBands.size(); i++)
 			{
 				filterBands[i]->setSampleRate(sampleRate);
+				filterBands[i]->resetFusedState();
 			}
 		}
+
+		allocateFusedData();
 	};
 
 	ValueTree exportAsValueTree() const override
@@ -283,6 +308,8 @@ public:
 			filterBands.add(new StereoFilter());
 		}
 
+		allocateFusedData();
+
 		for(int i = 0; i < numFilters * numBandParameters; i++)
 		{
             const float value = v.getProperty("Band" + String(i), 0.0f);
@@ -312,8 +339,23 @@ public:
 
 private:
 
+	/** Renders all enabled bands in a single pass over the buffer.
+
+		Each band is a biquad in transposed direct form II and the stereo pair is processed in one SIMD register.
+		The coefficients are interpolated linearly over the block if they change. Returns false if the bands
+		can't be fused (eg. if the SVF filters are used) so that they need to be rendered one by one.
+	*/
+	bool renderFusedCascade(AudioSampleBuffer& b, int startSample, int numSamples);
+
+	/** Makes sure that the fused cascade has enough memory for all filter bands. */
+	void allocateFusedData();
+
 	AnalyserRingBuffer fftBuffer;
 
+	HeapBlock<float> fusedScratch;
+	float* fusedData = nullptr;
+	int numFusedBands = 0;
+
 #if OLD_EQ_FFT
 	float fftData[FFT_SIZE_FOR_EQ];
 	double externalFftData[FFT_SIZE_FOR_EQ];
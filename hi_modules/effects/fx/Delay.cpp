@@ -58,6 +58,7 @@ DelayEffect::DelayEffect(MainController *mc, const String &id) :
 	parameterNames.add("HiPassFreq");
 	parameterNames.add("Mix");
 	parameterNames.add("TempoSync");
+	parameterNames.add("ExactFeedback");
 
 	mc->addTempoListener(this);
 
@@ -76,6 +77,7 @@ float DelayEffect::getAttribute(int parameterIndex) const
 	case HiPassFreq:		return hiPassFreq;
 	case Mix:				return mix;
 	case TempoSync:			return tempoSync ? 1.0f : 0.0f;
+	case ExactFeedback:		return exactFeedback ? 1.0f : 0.0f;
 	default:				jassertfalse; return 0.0f;
 	}
 }
@@ -108,6 +110,7 @@ void DelayEffect::setInternalAttribute(int parameterIndex, float newValue)
 	case Mix:				mix = newValue; break;
 	case TempoSync:			tempoSync = (newValue == 1.0f); 
 							calcDelayTimes(); break;
+	case ExactFeedback:		exactFeedback = newValue > 0.5f; break;
 	default:				jassertfalse;
 	}
 }
@@ -124,10 +127,65 @@ float DelayEffect::getDefaultValue(int parameterIndex) const
 	case HiPassFreq:		return hiPassFreq;
 	case Mix:				return 0.5f;
 	case TempoSync:			return true;
+	case ExactFeedback:		return false;
 	default:				jassertfalse; return 0.0f;
 	}
 }
 
+void DelayEffect::applyEffect(AudioSampleBuffer &buffer, int startSample, int numSamples)
+{
+	if (skipFirstBuffer)
+	{
+		skipFirstBuffer = false;
+		return;
+	}
+
+	float* wetL = leftDelayFrames.getWritePointer(0, startSample);
+	float* wetR = rightDelayFrames.getWritePointer(0, startSample);
+
+	processDelayLine(leftDelay, leftTap, buffer.getReadPointer(0, startSample), wetL, feedbackLeft, exactFeedback, numSamples);
+	processDelayLine(rightDelay, rightTap, buffer.getReadPointer(1, startSample), wetR, feedbackRight, exactFeedback, numSamples);
+
+	const float dryMix = (mix < 0.5f) ? 1.0f : (2.0f - 2.0f * mix);
+	const float wetMix = (mix > 0.5f) ? 1.0f : (2.0f * mix);
+
+	FloatVectorOperations::multiply(buffer.getWritePointer(0, startSample), dryMix, numSamples);
+	FloatVectorOperations::multiply(buffer.getWritePointer(1, startSample), dryMix, numSamples);
+
+	FloatVectorOperations::addWithMultiply(buffer.getWritePointer(0, startSample), wetL, wetMix, numSamples);
+	FloatVectorOperations::addWithMultiply(buffer.getWritePointer(1, startSample), wetR, wetMix, numSamples);
+}
+
+void DelayEffect::processDelayLine(ModulatedDelayLine& delayLine, ModulatedDelayLine::CrossfadeTap& tap, const float* input, float* wet, float feedback, bool exactFeedback, int numSamples)
+{
+	float feedbackSignal[ModulatedDelayLine::ChunkSize];
+
+	while (numSamples > 0)
+	{
+		// The chunk must not be longer than the delay time because it is read before it is written.
+		const int maxFeedbackSize = jmax(1, delayLine.getMaxFeedbackBlockSize(tap.getMinimumDelay()));
+		const int numThisTime = jmin(numSamples, maxFeedbackSize, (int)ModulatedDelayLine::ChunkSize);
+
+		// With the exact timing the feedback uses the delayed signal of this chunk, so every repeat is exactly 
+		// one delay time later. Otherwise it uses the delayed signal of the previous block at the same position,
+		// so it has to be calculated before the wet buffer is overwritten.
+		if (exactFeedback)
+			tap.read(delayLine, wet, numThisTime, ModulatedDelayLine::ReadPosition::BeforePush);
+
+		FloatVectorOperations::copy(feedbackSignal, input, numThisTime);
+		FloatVectorOperations::addWithMultiply(feedbackSignal, wet, feedback, numThisTime);
+
+		if (!exactFeedback)
+			tap.read(delayLine, wet, numThisTime, ModulatedDelayLine::ReadPosition::BeforePush);
+
+		delayLine.pushBlock(feedbackSignal, numThisTime);
+
+		input += numThisTime;
+		wet += numThisTime;
+		numSamples -= numThisTime;
+	}
+}
+
 ProcessorEditorBody *DelayEffect::createEditor(ProcessorEditor *parentEditor)
 {
 #if USE_BACKEND
@@ -56,6 +56,7 @@ public:
 		HiPassFreq, ///< the frequency for the high pass
 		Mix, ///< the wet amount
 		TempoSync, ///< if enabled, the delay time will sync to the host tempo
+		ExactFeedback, ///< if enabled, the repeats are exactly one delay time apart. It's disabled by default (and for older presets) which feeds back the delayed signal of the previous block, so the repeats are one buffer late.
 		numEffectParameters
 	};
 
@@ -96,6 +97,7 @@ public:
 		loadAttribute(LowPassFreq, "LowPassFreq");
 		loadAttribute(HiPassFreq, "HiPassFreq");
 		loadAttribute(Mix, "Mix");
+		loadAttribute(ExactFeedback, "ExactFeedback");
 		
 	};
 
@@ -111,6 +113,7 @@ public:
 		saveAttribute(HiPassFreq, "HiPassFreq");
 		saveAttribute(Mix, "Mix");
 		saveAttribute(TempoSync, "TempoSync");
+		saveAttribute(ExactFeedback, "ExactFeedback");
 
 		return v;
 
@@ -120,11 +123,19 @@ public:
 	{
 		MasterEffectProcessor::prepareToPlay(sampleRate, samplesPerBlock);
         
-        leftDelay.prepareToPlay(sampleRate);
-        rightDelay.prepareToPlay(sampleRate);
+		const int maxDelaySamples = (int)(MaxDelayTimeSeconds * sampleRate);
+
+		leftDelay.setMaxDelaySamples(maxDelaySamples, samplesPerBlock);
+		rightDelay.setMaxDelaySamples(maxDelaySamples, samplesPerBlock);
+
+		leftDelay.setInterpolation(ModulatedDelayLine::Interpolation::None);
+		rightDelay.setInterpolation(ModulatedDelayLine::Interpolation::None);
         
 		calcDelayTimes();
 
+		leftTap.reset();
+		rightTap.reset();
+
 		ProcessorHelpers::increaseBufferIfNeeded(leftDelayFrames, samplesPerBlock);
 		ProcessorHelpers::increaseBufferIfNeeded(rightDelayFrames, samplesPerBlock);
 	};
@@ -150,41 +161,14 @@ public:
 
 		
 
-        leftDelay.setDelayTimeSeconds(actualLeftTime * 0.001);
-        rightDelay.setDelayTimeSeconds(actualRightTime * 0.001);
-	}
-
-	void applyEffect(AudioSampleBuffer &buffer, int startSample, int numSamples) override
-	{
-		if(skipFirstBuffer)
-		{
-			skipFirstBuffer = false;
-			return;
-		}
-        
-		const int sampleIndex = startSample;
-		const int samplesToCopy = numSamples;
+		// The feedback loop reads a block before it writes it, so the delay needs at least one sample
+		const float samplesPerMs = (float)(getSampleRate() * 0.001);
 
-		float *inputL = buffer.getWritePointer(0, 0);
-		float *inputR = buffer.getWritePointer(1, 0);
-        
-        while(--numSamples >= 0)
-        {
-            leftDelayFrames.setSample(0, startSample, (float)leftDelay.getDelayedValue(inputL[startSample] + feedbackLeft * leftDelayFrames.getSample(0, startSample)));
-            rightDelayFrames.setSample(0, startSample, (float)rightDelay.getDelayedValue(inputR[startSample] + feedbackRight * rightDelayFrames.getSample(0, startSample)));
-            
-            ++startSample;
-        }
-
-        const float dryMix = (mix < 0.5f) ? 1.0f : (2.0f - 2.0f * mix);
-        const float wetMix = (mix > 0.5f) ? 1.0f : (2.0f * mix);
-        
-        FloatVectorOperations::multiply(buffer.getWritePointer(0, sampleIndex), dryMix, samplesToCopy);
-        FloatVectorOperations::multiply(buffer.getWritePointer(1, sampleIndex), dryMix, samplesToCopy);
+		leftTap.setDelayTimeSamples(jmax(1.0f, actualLeftTime * samplesPerMs));
+		rightTap.setDelayTimeSamples(jmax(1.0f, actualRightTime * samplesPerMs));
+	}
 
-		FloatVectorOperations::addWithMultiply(buffer.getWritePointer(0, sampleIndex), leftDelayFrames.getReadPointer(0, sampleIndex), wetMix, samplesToCopy);
-		FloatVectorOperations::addWithMultiply(buffer.getWritePointer(1, sampleIndex), rightDelayFrames.getReadPointer(0, sampleIndex), wetMix, samplesToCopy);
-	};
+	void applyEffect(AudioSampleBuffer &buffer, int startSample, int numSamples) override;
 
 	bool hasTail() const override {return true; };
 
@@ -192,6 +176,8 @@ public:
 	{
 		leftDelay.clear();
 		rightDelay.clear();
+		leftTap.reset();
+		rightTap.reset();
 		leftDelayFrames.clear();
 		rightDelayFrames.clear();
 	}
@@ -206,6 +192,15 @@ public:
 
 private:
 
+	/** Runs the feedback loop of one channel and writes the delayed signal into wet.
+	*
+	*	If exactFeedback is false, the wet buffer must still contain the delayed signal of the previous block, 
+	*	which is fed back into the delay line (this is the timing of the old DelayLine loop).
+	*/
+	static void processDelayLine(ModulatedDelayLine& delayLine, ModulatedDelayLine::CrossfadeTap& tap, const float* input, float* wet, float feedback, bool exactFeedback, int numSamples);
+
+	static constexpr float MaxDelayTimeSeconds = 4.0f;
+
 	// Unsynced
 	float delayTimeLeft;
 	float delayTimeRight;
@@ -222,12 +217,16 @@ private:
 	float hiPassFreq;
 	float mix;
 	bool tempoSync;
+	bool exactFeedback = false;
 
 	AudioSampleBuffer leftDelayFrames;
 	AudioSampleBuffer rightDelayFrames;
     
-    DelayLine<> leftDelay;
-    DelayLine<> rightDelay;
+	ModulatedDelayLine leftDelay;
+	ModulatedDelayLine rightDelay;
+
+	ModulatedDelayLine::CrossfadeTap leftTap;
+	ModulatedDelayLine::CrossfadeTap rightTap;
 
 	bool skipFirstBuffer;
 };
@@ -60,16 +60,16 @@ void DynamicsEffect::setInternalAttribute(int parameterIndex, float newValue)
 		limiterEnabled = isEnabled;
 		break;
 	}
-	case GateThreshold:			gate.setThresh((SimpleDataType)newValue); break;
-	case CompressorThreshold:	compressor.setThresh((SimpleDataType)newValue); updateMakeupValues(false); break;
-	case LimiterThreshold:		limiter.setThresh((SimpleDataType)newValue); updateMakeupValues(true); break;
-	case GateAttack:			gate.setAttack((SimpleDataType)newValue); break;
-	case CompressorAttack:		compressor.setAttack((SimpleDataType)newValue); break;
-	case LimiterAttack:			limiter.setAttack((SimpleDataType)newValue); break;
-	case GateRelease:			gate.setRelease((SimpleDataType)newValue); break;
-	case CompressorRelease:		compressor.setRelease((SimpleDataType)newValue); break;
-	case LimiterRelease:		limiter.setRelease((SimpleDataType)newValue); break;
-	case CompressorRatio:		compressor.setRatio((SimpleDataType)(1.0f / newValue)); updateMakeupValues(false); break;
+	case GateThreshold:			gate.setThresh((double)newValue); break;
+	case CompressorThreshold:	compressor.setThresh((double)newValue); updateMakeupValues(false); break;
+	case LimiterThreshold:		limiter.setThresh((double)newValue); updateMakeupValues(true); break;
+	case GateAttack:			gate.setAttack((double)newValue); break;
+	case CompressorAttack:		compressor.setAttack((double)newValue); break;
+	case LimiterAttack:			limiter.setAttack((double)newValue); break;
+	case GateRelease:			gate.setRelease((double)newValue); break;
+	case CompressorRelease:		compressor.setRelease((double)newValue); break;
+	case LimiterRelease:		limiter.setRelease((double)newValue); break;
+	case CompressorRatio:		compressor.setRatio((double)(1.0f / newValue)); updateMakeupValues(false); break;
 	case CompressorMakeup:		compressorMakeup = newValue > 0.5f; updateMakeupValues(false); break;
 	case LimiterMakeup:			limiterMakeup = newValue > 0.5f; updateMakeupValues(true); break;
 	case GateReduction:
@@ -211,50 +211,18 @@ void DynamicsEffect::applyEffect(AudioSampleBuffer &buffer, int startSample, int
 
 	if (gateEnabled)
 	{
-		float* l = buffer.getWritePointer(0, startSample);
-		float* r = buffer.getWritePointer(1, startSample);
+		float* data[2] = { buffer.getWritePointer(0, startSample), buffer.getWritePointer(1, startSample) };
 
-		for (int i = 0; i < numToProcess; i++)
-		{
-			SimpleDataType l_ = (SimpleDataType)*l;
-			SimpleDataType r_ = (SimpleDataType)*r;
-
-			gate.process(l_, r_);
-
-			const float gR = (float)gate.getGainReduction();
-
-			if (gR > gateReduction)
-				gateReduction = gR;
-			else
-				gateReduction = gateReduction * 0.9999f;
-
-			*l++ = (float)l_;
-			*r++ = (float)r_;
-		}
+		gate.processBlock(data, 2, numToProcess);
+		updateReductionMeter(gateReduction, gate.getMaximumGainOfLastBlock(), numToProcess);
 	}
 
 	if (compressorEnabled)
 	{
-		float* l = buffer.getWritePointer(0, startSample);
-		float* r = buffer.getWritePointer(1, startSample);
+		float* data[2] = { buffer.getWritePointer(0, startSample), buffer.getWritePointer(1, startSample) };
 
-		for (int i = 0; i < numToProcess; i++)
-		{
-			SimpleDataType l_ = (SimpleDataType)*l;
-			SimpleDataType r_ = (SimpleDataType)*r;
-
-			compressor.process(l_, r_);
-
-			const float gR = (float)compressor.getGainReduction();
-
-			if (gR > compressorReduction)
-				compressorReduction = gR;
-			else
-				compressorReduction = compressorReduction * 0.9999f;
-
-			*l++ = (float)l_;
-			*r++ = (float)r_;
-		}
+		compressor.processBlock(data, 2, numToProcess);
+		updateReductionMeter(compressorReduction, compressor.getMaximumGainOfLastBlock(), numToProcess);
 
 		if (compressorMakeup)
 		{
@@ -300,28 +268,10 @@ void DynamicsEffect::applyEffect(AudioSampleBuffer &buffer, int startSample, int
 
 void DynamicsEffect::applyLimiter(AudioSampleBuffer &buffer, int startSample, const int numToProcess)
 {
-	float* l = buffer.getWritePointer(0, startSample);
-	float* r = buffer.getWritePointer(1, startSample);
-
+	float* data[2] = { buffer.getWritePointer(0, startSample), buffer.getWritePointer(1, startSample) };
 
-
-	for (int i = 0; i < numToProcess; i++)
-	{
-		SimpleDataType l_ = (SimpleDataType)*l;
-		SimpleDataType r_ = (SimpleDataType)*r;
-
-		limiter.process(l_, r_);
-
-		const float gR = (float)limiter.getGainReduction();
-
-		if (gR > limiterReduction)
-			limiterReduction = gR;
-		else
-			limiterReduction = limiterReduction * 0.9999f;
-
-		*l++ = (float)l_;
-		*r++ = (float)r_;
-	}
+	limiter.processBlock(data, 2, numToProcess);
+	updateReductionMeter(limiterReduction, limiter.getMaximumGainOfLastBlock(), numToProcess);
 
 	if (limiterMakeup)
 	{
@@ -338,12 +288,19 @@ void DynamicsEffect::prepareToPlay(double sampleRate, int samplesPerBlock)
 	compressor.initRuntime();
 	limiter.initRuntime();
 
-	gate.setSampleRate(sampleRate);
-	compressor.setSampleRate(sampleRate);
-	limiter.setSampleRate(sampleRate);
+	gate.setSampleRate(getProcessingSampleRate());
+	compressor.setSampleRate(getProcessingSampleRate());
+	limiter.setSampleRate(getProcessingSampleRate());
 }
 
 
+void DynamicsEffect::updateReductionMeter(std::atomic<float>& reduction, float maxGainOfBlock, int numSamples)
+{
+	const float decayed = reduction * std::pow(0.9999f, (float)numSamples);
+
+	reduction = jmax(maxGainOfBlock, decayed);
+}
+
 void DynamicsEffect::updateMakeupValues(bool updateLimiter)
 {
 	if (updateLimiter)
@@ -35,14 +35,14 @@
 
 namespace hise { using namespace juce;
 
-/** A general purpose dynamics processor based on chunkware's SimpleCompressor.
+/** A general purpose dynamics processor (gate, compressor and look-ahead limiter) that uses the BlockDynamics engine.
 	@ingroup effectTypes
 */
 class DynamicsEffect : public MasterEffectProcessor
 {
 public:
 
-	SET_PROCESSOR_NAME("Dynamics", "Dynamics", "A general purpose dynamics processor based on chunkware's SimpleCompressor");
+	SET_PROCESSOR_NAME("Dynamics", "Dynamics", "A general purpose dynamics processor with a gate, a compressor and a look-ahead limiter");
 
 		enum Parameters
 	{
@@ -93,13 +93,21 @@ public:
 
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
 
+	bool supportsOversampling() const override { return true; }
+
 private:
 
 	void updateMakeupValues(bool updateLimiter);
 
-	chunkware_simple::SimpleGate gate;
-	chunkware_simple::SimpleComp compressor;
-	chunkware_simple::SimpleLimit limiter;
+	/** Updates the reduction meter with the highest gain value of the block and lets it decay over the block.
+	*
+	*	This is the block version of the old per-sample meter, which held the maximum gain and decayed otherwise.
+	*/
+	static void updateReductionMeter(std::atomic<float>& reduction, float maxGainOfBlock, int numSamples);
+
+	BlockGate gate;
+	BlockCompressor compressor;
+	BlockLimiter limiter;
 
 	std::atomic<bool> gateEnabled;
 	std::atomic<bool> compressorEnabled;
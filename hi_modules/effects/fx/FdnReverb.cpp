@@ -0,0 +1,528 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+namespace hise { using namespace juce;
+
+void FdnReverb::MultiTapBuffer::setMaxDelaySamples(int maxDelayInSamples)
+{
+	// The oldest sample of a chunk is read after the chunk has been written
+	const int newSize = nextPowerOfTwo(maxDelayInSamples + ChunkSize + 1);
+
+	if (newSize != size)
+	{
+		size = newSize;
+		mask = size - 1;
+		data.allocate(size * NumLines, true);
+		writeIndex = 0;
+	}
+}
+
+void FdnReverb::MultiTapBuffer::clear()
+{
+	if (data != nullptr)
+		FloatVectorOperations::clear(data, size * NumLines);
+
+	writeIndex = 0;
+}
+
+void FdnReverb::MultiTapBuffer::write(int channel, const float* source, int numSamples) noexcept
+{
+	auto c = getChannel(channel);
+	const int numBeforeWrap = jmin(numSamples, size - writeIndex);
+
+	FloatVectorOperations::copy(c + writeIndex, source, numBeforeWrap);
+
+	if (numSamples > numBeforeWrap)
+		FloatVectorOperations::copy(c, source + numBeforeWrap, numSamples - numBeforeWrap);
+}
+
+void FdnReverb::MultiTapBuffer::read(int channel, int delayInSamples, float gain, float* destination, int numSamples) const noexcept
+{
+	const float* c = data + channel * size;
+	const int readIndex = (writeIndex - delayInSamples) & mask;
+	const int numBeforeWrap = jmin(numSamples, size - readIndex);
+
+	FloatVectorOperations::copyWithMultiply(destination, c + readIndex, gain, numBeforeWrap);
+
+	if (numSamples > numBeforeWrap)
+		FloatVectorOperations::copyWithMultiply(destination + numBeforeWrap, c, gain, numSamples - numBeforeWrap);
+}
+
+FdnReverb::FdnReverb()
+{
+	FloatVectorOperations::clear(dampingStates, NumLines);
+	FloatVectorOperations::clear(lfoPhases, NumLines);
+	FloatVectorOperations::clear(lfoDeltas, NumLines);
+
+	// Random delay times within [stepLength * i / N, stepLength * (i+1) / N] for each diffusion step
+	// (the step length halves with every step). The seed is fixed so every instance sounds the same.
+	Random r(0x5eed);
+
+	const float maxStepMs = 20.0f;
+
+	for (int s = 0; s < NumDiffusionSteps; s++)
+	{
+		const float stepMs = maxStepMs / (float)(1 << s);
+
+		for (int i = 0; i < NumLines; i++)
+		{
+			const float lo = stepMs * (float)i / (float)NumLines;
+			const float hi = stepMs * (float)(i + 1) / (float)NumLines;
+
+			diffusionDelays[s][i] = jmax(0.5f, lo + r.nextFloat() * (hi - lo));
+			diffusionDelaySamples[s][i] = 1;
+
+			// The Hadamard matrix is not normalised, so the scaling is folded into the polarity flip
+			const float polarity = r.nextBool() ? 1.0f : -1.0f;
+			diffusionGains[s][i] = polarity / std::sqrt((float)NumLines);
+		}
+	}
+
+	updateCoefficients();
+}
+
+void FdnReverb::prepare(double newSampleRate)
+{
+	jassert(newSampleRate > 0.0);
+
+	sampleRate = newSampleRate;
+
+	const float msToSamples = (float)sampleRate * 0.001f;
+
+	for (int s = 0; s < NumDiffusionSteps; s++)
+	{
+		int maxDelay = 0;
+
+		for (int i = 0; i < NumLines; i++)
+		{
+			// The diffusion delays are constant, so they can be rounded and read without interpolation
+			diffusionDelaySamples[s][i] = jmax(1, roundToInt(diffusionDelays[s][i] * msToSamples));
+			maxDelay = jmax(maxDelay, diffusionDelaySamples[s][i]);
+		}
+
+		diffusionBuffers[s].setMaxDelaySamples(maxDelay);
+	}
+
+	// The longest line is twice the maximum room size, plus the modulation depth
+	maxFeedbackDelay = (int)(msToSamples * (2.0f * 100.0f + 2.0f)) + 4;
+
+	feedbackBuffer.setMaxDelaySamples(maxFeedbackDelay + 1);
+
+	// The feedback loop reads a whole chunk before it writes it, so the shortest line must be longer than a chunk
+	jassert(10.0f * msToSamples > (float)ChunkSize);
+
+	for (int i = 0; i < NumLines; i++)
+	{
+		// Spread the LFO rates between 0.1Hz and 0.9Hz and start at different phases
+		const float rate = 0.1f + 0.8f * (float)i / (float)(NumLines - 1);
+		lfoDeltas[i] = float_Pi * 2.0f * rate / (float)sampleRate;
+		lfoPhases[i] = float_Pi * 2.0f * (float)i / (float)NumLines;
+	}
+
+	// 100ms smoothing time for the room size (the coefficient is applied once per chunk)
+	sizeSmoothingCoefficient = 1.0f - std::exp(-(float)ChunkSize / (0.1f * (float)sampleRate));
+
+	updateCoefficients();
+	reset();
+}
+
+void FdnReverb::setParameters(const Parameters& newParameters)
+{
+	parameters = newParameters;
+	updateCoefficients();
+}
+
+void FdnReverb::updateCoefficients()
+{
+	if (sampleRate <= 0.0)
+		return;
+
+	const float sr = (float)sampleRate;
+	const float msToSamples = sr * 0.001f;
+
+	targetBaseDelay = (10.0f + 90.0f * jlimit(0.0f, 1.0f, parameters.roomSize)) * msToSamples;
+
+	// g = 10^(-3 * delay / (T60 * sampleRate)) = exp(delay * decayFactor)
+	decayFactor = -3.0f * std::log(10.0f) / (jmax(0.1f, parameters.decayTime) * sr);
+
+	const float damping = jlimit(0.0f, 1.0f, parameters.damping);
+	const float cutoff = 400.0f * std::pow(50.0f, 1.0f - damping);
+
+	// A damping of zero (or a cutoff close to Nyquist) bypasses the filter
+	dampingCoefficient = cutoff >= 0.45f * sr ? 1.0f : 1.0f - std::exp(-2.0f * float_Pi * cutoff / sr);
+
+	modulationDepth = jlimit(0.0f, 1.0f, parameters.modulation) * 2.0f * msToSamples;
+}
+
+void FdnReverb::reset()
+{
+	for (auto& b : diffusionBuffers)
+		b.clear();
+
+	feedbackBuffer.clear();
+
+	FloatVectorOperations::clear(dampingStates, NumLines);
+	currentBaseDelay = targetBaseDelay;
+}
+
+void FdnReverb::processStereo(float* left, float* right, int numSamples)
+{
+	jassert(sampleRate > 0.0);
+
+	while (numSamples > 0)
+	{
+		const int numThisTime = jmin(numSamples, (int)ChunkSize);
+
+		processChunk(left, right, left, right, numThisTime);
+
+		left += numThisTime;
+		right += numThisTime;
+		numSamples -= numThisTime;
+	}
+}
+
+void FdnReverb::processMono(float* data, int numSamples)
+{
+	jassert(sampleRate > 0.0);
+
+	float right[ChunkSize];
+
+	while (numSamples > 0)
+	{
+		const int numThisTime = jmin(numSamples, (int)ChunkSize);
+
+		processChunk(data, data, data, right, numThisTime);
+
+		FloatVectorOperations::add(data, right, numThisTime);
+		FloatVectorOperations::multiply(data, 0.5f, numThisTime);
+
+		data += numThisTime;
+		numSamples -= numThisTime;
+	}
+}
+
+/** The operations that are applied to all channels of a chunk. They process whole SIMD registers, so the
+	arrays must be aligned and the samples after the end of the chunk must be initialised.
+*/
+struct FdnReverbKernels
+{
+#if JUCE_USE_SIMD
+	using Vector = dsp::SIMDRegister<float>;
+
+	static forcedinline Vector expand(float value) noexcept { return Vector::expand(value); }
+	static forcedinline Vector load(const float* data) noexcept { return Vector::fromRawArray(data); }
+	static forcedinline void store(Vector v, float* data) noexcept { v.copyToRawArray(data); }
+#else
+	using Vector = float;
+
+	static forcedinline Vector expand(float value) noexcept { return value; }
+	static forcedinline Vector load(const float* data) noexcept { return *data; }
+	static forcedinline void store(Vector v, float* data) noexcept { *data = v; }
+#endif
+
+	using Chunk = float[FdnReverb::ChunkSize];
+
+	enum
+	{
+		NumLanes = (int)(sizeof(Vector) / sizeof(float)),
+		Alignment = (int)sizeof(Vector)
+	};
+
+	static_assert(FdnReverb::ChunkSize % NumLanes == 0, "the chunk must be a multiple of the register size");
+
+	static int getNumVectors(int numSamples) noexcept { return (numSamples + NumLanes - 1) / NumLanes; }
+
+	/** Clears the samples between the end of the chunk and the end of the last register. */
+	static void clearTail(float* data, int numSamples) noexcept
+	{
+		const int numToClear = getNumVectors(numSamples) * NumLanes - numSamples;
+
+		if (numToClear > 0)
+			FloatVectorOperations::clear(data + numSamples, numToClear);
+	}
+
+	/** Interpolates between the samples before (x0) and at (x1) a delay that ramps from delay + delayDelta
+		to delay + delayDelta * numSamples and does not cross the integer delay.
+	*/
+	static void interpolate(float* destination, const float* x0, const float* x1, float delay, float delayDelta, int integerDelay, int numSamples) noexcept
+	{
+		const int numToProcess = getNumVectors(numSamples) * NumLanes;
+
+		alignas(Alignment) float firstIndexes[NumLanes];
+
+		for (int i = 0; i < NumLanes; i++)
+			firstIndexes[i] = (float)(i + 1);
+
+		auto index = load(firstIndexes);
+
+		const auto start = expand(delay);
+		const auto delta = expand(delayDelta);
+		const auto offset = expand((float)integerDelay);
+		const auto one = expand(1.0f);
+		const auto step = expand((float)NumLanes);
+
+		for (int i = 0; i < numToProcess; i += NumLanes)
+		{
+			const auto alpha = one - ((start + delta * index) - offset);
+			const auto a = load(x0 + i);
+
+			store(a + alpha * (load(x1 + i) - a), destination + i);
+
+			index = index + step;
+		}
+	}
+
+	/** Applies an (unnormalised) Hadamard matrix. */
+	static void applyHadamard(Chunk* channels, int numSamples) noexcept
+	{
+		const int numToProcess = getNumVectors(numSamples) * NumLanes;
+
+		for (int stride = 1; stride < FdnReverb::NumLines; stride *= 2)
+		{
+			for (int start = 0; start < FdnReverb::NumLines; start += 2 * stride)
+			{
+				for (int k = start; k < start + stride; k++)
+				{
+					float* a = channels[k];
+					float* b = channels[k + stride];
+
+					for (int i = 0; i < numToProcess; i += NumLanes)
+					{
+						const auto x = load(a + i);
+						const auto y = load(b + i);
+						store(x + y, a + i);
+						store(x - y, b + i);
+					}
+				}
+			}
+		}
+	}
+
+	/** Calculates the output taps (alternating polarities for the left channel, pairs for the right channel)
+		and replaces the lines with the Householder feedback matrix (x - 2/N * sum(x)) plus the new input.
+	*/
+	static void applyFeedbackMatrix(Chunk* lines, const Chunk* input, float* left, float* right, float householderGain, int numSamples) noexcept
+	{
+		static_assert(FdnReverb::NumLines == 8, "the output taps are written for eight lines");
+
+		const int numToProcess = getNumVectors(numSamples) * NumLanes;
+
+		for (int i = 0; i < numToProcess; i += NumLanes)
+		{
+			Vector y[FdnReverb::NumLines];
+
+			for (int k = 0; k < FdnReverb::NumLines; k++)
+				y[k] = load(lines[k] + i);
+
+			store(y[0] - y[1] + y[2] - y[3] + y[4] - y[5] + y[6] - y[7], left + i);
+			store(y[0] + y[1] - y[2] - y[3] + y[4] + y[5] - y[6] - y[7], right + i);
+
+			auto sum = y[0];
+
+			for (int k = 1; k < FdnReverb::NumLines; k++)
+				sum = sum + y[k];
+
+			sum = sum * householderGain;
+
+			for (int k = 0; k < FdnReverb::NumLines; k++)
+				store(y[k] - sum + load(input[k] + i), lines[k] + i);
+		}
+	}
+};
+
+void FdnReverb::processChunk(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+{
+	// Ramp the room size and the LFOs over the chunk
+
+	static constexpr float lineRatios[NumLines] = { 1.0f, 1.1f, 1.23f, 1.34f, 1.49f, 1.62f, 1.79f, 1.97f };
+
+	const float lastBaseDelay = currentBaseDelay;
+	currentBaseDelay += (targetBaseDelay - currentBaseDelay) * sizeSmoothingCoefficient;
+
+	float delays[NumLines];
+	float delayDeltas[NumLines];
+	float lineGains[NumLines];
+
+	for (int k = 0; k < NumLines; k++)
+	{
+		const float start = lastBaseDelay * lineRatios[k];
+		const float end = currentBaseDelay * lineRatios[k];
+
+		lineGains[k] = std::exp(end * decayFactor);
+
+		float delayStart = start;
+		float delayEnd = end;
+
+		if (modulationDepth != 0.0f)
+		{
+			// The LFO adds up to 2ms and the line never gets shorter than the base delay
+			delayStart += modulationDepth * 0.5f * (1.0f + std::sin(lfoPhases[k]));
+			lfoPhases[k] += lfoDeltas[k] * (float)numSamples;
+
+			if (lfoPhases[k] > 2.0f * float_Pi)
+				lfoPhases[k] -= 2.0f * float_Pi;
+
+			delayEnd += modulationDepth * 0.5f * (1.0f + std::sin(lfoPhases[k]));
+		}
+
+		jassert(delayEnd < (float)maxFeedbackDelay);
+
+		delayDeltas[k] = (delayEnd - delayStart) / (float)numSamples;
+		delays[k] = delayStart;
+	}
+
+	const float c = dampingCoefficient;
+	const float householderGain = 2.0f / (float)NumLines;
+
+	const float width = jlimit(0.0f, 1.0f, parameters.width);
+	const float outputGain = 1.0f / std::sqrt((float)NumLines);
+	const float sameGain = outputGain * 0.5f * (1.0f + width);
+	const float otherGain = outputGain * 0.5f * (1.0f - width);
+
+	// Spread the stereo input over the channels
+
+	alignas(FdnReverbKernels::Alignment) float x[NumLines][ChunkSize];
+
+	for (int k = 0; k < NumLines; k++)
+		FloatVectorOperations::copy(x[k], (k % 2 == 0) ? inL : inR, numSamples);
+
+	for (int k = 0; k < NumLines; k++)
+		FdnReverbKernels::clearTail(x[k], numSamples);
+
+	// Diffusion: write the chunk and read every channel with its own tap
+
+	for (int s = 0; s < NumDiffusionSteps; s++)
+	{
+		auto& b = diffusionBuffers[s];
+
+		for (int k = 0; k < NumLines; k++)
+			b.write(k, x[k], numSamples);
+
+		for (int k = 0; k < NumLines; k++)
+			b.read(k, diffusionDelaySamples[s][k], diffusionGains[s][k], x[k], numSamples);
+
+		b.advance(numSamples);
+
+		FdnReverbKernels::applyHadamard(x, numSamples);
+	}
+
+	// Read the feedback lines with linear interpolation. The lines are longer than a chunk,
+	// so all samples of this chunk were written before and the lines can be read one after another.
+
+	alignas(FdnReverbKernels::Alignment) float lines[NumLines][ChunkSize];
+
+	for (int k = 0; k < NumLines; k++)
+	{
+		const int integerDelay = (int)(delays[k] + delayDeltas[k]);
+
+		jassert(integerDelay >= numSamples);
+
+		if ((int)(delays[k] + delayDeltas[k] * (float)numSamples) == integerDelay)
+		{
+			// The integer delay is the same for the whole chunk, so both taps can be read as blocks
+
+			alignas(FdnReverbKernels::Alignment) float x0[ChunkSize];
+			alignas(FdnReverbKernels::Alignment) float x1[ChunkSize];
+
+			feedbackBuffer.read(k, integerDelay + 1, 1.0f, x0, numSamples);
+			feedbackBuffer.read(k, integerDelay, 1.0f, x1, numSamples);
+
+			FdnReverbKernels::clearTail(x0, numSamples);
+			FdnReverbKernels::clearTail(x1, numSamples);
+
+			FdnReverbKernels::interpolate(lines[k], x0, x1, delays[k], delayDeltas[k], integerDelay, numSamples);
+		}
+		else
+		{
+			const float* line = feedbackBuffer.getChannel(k);
+			const int mask = feedbackBuffer.mask;
+			const int writeIndex = feedbackBuffer.writeIndex;
+
+			for (int i = 0; i < numSamples; i++)
+			{
+				const float delay = delays[k] + delayDeltas[k] * (float)(i + 1);
+				const int sampleDelay = (int)delay;
+				const float alpha = 1.0f - (delay - (float)sampleDelay);
+
+				const int readIndex = writeIndex + i - sampleDelay;
+				const float x0 = line[(readIndex - 1) & mask];
+				const float x1 = line[readIndex & mask];
+
+				lines[k][i] = x0 + alpha * (x1 - x0);
+			}
+		}
+	}
+
+	// Apply the damping and the decay
+
+	float states[NumLines];
+
+	for (int k = 0; k < NumLines; k++)
+		states[k] = dampingStates[k];
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		for (int k = 0; k < NumLines; k++)
+		{
+			states[k] += c * (lines[k][i] - states[k]);
+			lines[k][i] = states[k] * lineGains[k];
+		}
+	}
+
+	for (int k = 0; k < NumLines; k++)
+		FdnReverbKernels::clearTail(lines[k], numSamples);
+
+	// Output taps, feedback matrix and stereo width
+
+	alignas(FdnReverbKernels::Alignment) float left[ChunkSize];
+	alignas(FdnReverbKernels::Alignment) float right[ChunkSize];
+
+	FdnReverbKernels::applyFeedbackMatrix(lines, x, left, right, householderGain, numSamples);
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		outL[i] = left[i] * sameGain + right[i] * otherGain;
+		outR[i] = right[i] * sameGain + left[i] * otherGain;
+	}
+
+	for (int k = 0; k < NumLines; k++)
+		feedbackBuffer.write(k, lines[k], numSamples);
+
+	feedbackBuffer.advance(numSamples);
+
+	for (int k = 0; k < NumLines; k++)
+		dampingStates[k] = (std::abs(states[k]) < 1e-15f) ? 0.0f : states[k];
+}
+
+} // namespace hise
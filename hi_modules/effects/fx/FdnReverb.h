@@ -0,0 +1,153 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#ifndef FDNREVERB_H_INCLUDED
+#define FDNREVERB_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** A feedback delay network reverb that is used by the FDN Reverb effect and the scriptnode fdn_reverb node.
+*
+*	The input is spread over eight channels and runs through a few diffusion steps (a short delay for each
+*	channel, a polarity flip and a Hadamard matrix). The diffused signal is fed into eight modulated delay lines
+*	with a damping filter whose outputs are mixed back into the lines with a Householder matrix.
+*
+*	The signal is processed in chunks that are shorter than the shortest feedback delay, so every step runs
+*	over the whole chunk: each diffusion step and the feedback loop use a single buffer with all channels, and
+*	the delays, the Hadamard matrix and the Householder matrix are vectorised over the samples of the chunk.
+*/
+class FdnReverb
+{
+public:
+
+	/** The number of delay lines in the feedback loop (and the number of channels in the diffuser). */
+	static constexpr int NumLines = 8;
+
+	/** The number of diffusion steps before the feedback loop. */
+	static constexpr int NumDiffusionSteps = 3;
+
+	/** The parameter ramps and the LFOs are updated once per chunk of this size. */
+	static constexpr int ChunkSize = 64;
+
+	struct Parameters
+	{
+		float roomSize = 0.5f; ///< scales the delay times of the feedback loop (0...1)
+		float decayTime = 2.0f; ///< the time in seconds until the tail has decayed by 60dB
+		float damping = 0.5f; ///< the amount of high frequency damping in the feedback loop (0...1)
+		float modulation = 0.3f; ///< the depth of the delay time modulation (0...1)
+		float width = 1.0f; ///< the stereo width of the wet signal (0...1)
+	};
+
+	FdnReverb();
+
+	// ================================================================================================================
+
+	/** Allocates the delay buffers. Call this in prepareToPlay(). */
+	void prepare(double newSampleRate);
+
+	void setParameters(const Parameters& newParameters);
+
+	const Parameters& getParameters() const noexcept { return parameters; }
+
+	/** Clears the delay buffers and the filter states. */
+	void reset();
+
+	// ================================================================================================================
+
+	/** Replaces the stereo signal with the wet signal of the reverb. */
+	void processStereo(float* left, float* right, int numSamples);
+
+	/** Replaces the mono signal with the wet signal of the reverb. */
+	void processMono(float* data, int numSamples);
+
+private:
+
+	/** A delay buffer for all channels with a common write position. */
+	struct MultiTapBuffer
+	{
+		/** Allocates enough samples to read a chunk with the given delay after the chunk was written. */
+		void setMaxDelaySamples(int maxDelayInSamples);
+
+		void clear();
+
+		float* getChannel(int channel) noexcept { return data + channel * size; }
+
+		/** Writes the samples of a channel at the write position. */
+		void write(int channel, const float* source, int numSamples) noexcept;
+
+		/** Reads the samples of a channel that were written delayInSamples samples before the write position. */
+		void read(int channel, int delayInSamples, float gain, float* destination, int numSamples) const noexcept;
+
+		/** Moves the write position after all channels of a chunk have been written. */
+		void advance(int numSamples) noexcept { writeIndex = (writeIndex + numSamples) & mask; }
+
+		HeapBlock<float> data;
+		int mask = 0;
+		int size = 0;
+		int writeIndex = 0;
+	};
+
+	void processChunk(const float* inL, const float* inR, float* outL, float* outR, int numSamples);
+
+	void updateCoefficients();
+
+	Parameters parameters;
+
+	double sampleRate = 0.0;
+
+	MultiTapBuffer diffusionBuffers[NumDiffusionSteps];
+	MultiTapBuffer feedbackBuffer;
+
+	float diffusionDelays[NumDiffusionSteps][NumLines];
+	int diffusionDelaySamples[NumDiffusionSteps][NumLines];
+	float diffusionGains[NumDiffusionSteps][NumLines];
+
+	float lfoPhases[NumLines];
+	float lfoDeltas[NumLines];
+	float dampingStates[NumLines];
+
+	float currentBaseDelay = 0.0f;
+	float targetBaseDelay = 0.0f;
+	float sizeSmoothingCoefficient = 0.0f;
+	float decayFactor = 0.0f;
+	float dampingCoefficient = 1.0f;
+	float modulationDepth = 0.0f;
+	int maxFeedbackDelay = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(FdnReverb);
+};
+
+} // namespace hise
+
+#endif  // FDNREVERB_H_INCLUDED
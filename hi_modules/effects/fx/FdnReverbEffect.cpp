@@ -0,0 +1,163 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+namespace hise { using namespace juce;
+
+void FdnReverbEffect::applyEffect(AudioSampleBuffer &buffer, int startSample, int numSamples)
+{
+	float* l = buffer.getWritePointer(0, startSample);
+	float* r = buffer.getWritePointer(1, startSample);
+
+	float wetL[FdnReverb::ChunkSize];
+	float wetR[FdnReverb::ChunkSize];
+
+	const float wet = wetLevel;
+	const float dry = dryLevel;
+
+	while (numSamples > 0)
+	{
+		const int numThisTime = jmin(numSamples, (int)FdnReverb::ChunkSize);
+
+		FloatVectorOperations::copy(wetL, l, numThisTime);
+		FloatVectorOperations::copy(wetR, r, numThisTime);
+
+		reverb.processStereo(wetL, wetR, numThisTime);
+
+		FloatVectorOperations::multiply(l, dry, numThisTime);
+		FloatVectorOperations::addWithMultiply(l, wetL, wet, numThisTime);
+		FloatVectorOperations::multiply(r, dry, numThisTime);
+		FloatVectorOperations::addWithMultiply(r, wetR, wet, numThisTime);
+
+		l += numThisTime;
+		r += numThisTime;
+		numSamples -= numThisTime;
+	}
+}
+
+#if USE_BACKEND
+
+class FdnReverbEditorBody : public ProcessorEditorBody
+{
+public:
+
+	FdnReverbEditorBody(ProcessorEditor* parentEditor) :
+		ProcessorEditorBody(parentEditor),
+		sizeSlider("Room Size"),
+		decaySlider("Decay"),
+		dampingSlider("Damping"),
+		modulationSlider("Modulation"),
+		widthSlider("Width"),
+		wetSlider("Wet"),
+		drySlider("Dry")
+	{
+		sizeSlider.setup(getProcessor(), FdnReverbEffect::RoomSize, "Room Size");
+		sizeSlider.setMode(HiSlider::NormalizedPercentage);
+
+		decaySlider.setup(getProcessor(), FdnReverbEffect::DecayTime, "Decay");
+		decaySlider.setMode(HiSlider::Time, 100.0, 20000.0, 2000.0);
+
+		dampingSlider.setup(getProcessor(), FdnReverbEffect::Damping, "Damping");
+		dampingSlider.setMode(HiSlider::NormalizedPercentage);
+
+		modulationSlider.setup(getProcessor(), FdnReverbEffect::Modulation, "Modulation");
+		modulationSlider.setMode(HiSlider::NormalizedPercentage);
+
+		widthSlider.setup(getProcessor(), FdnReverbEffect::Width, "Width");
+		widthSlider.setMode(HiSlider::NormalizedPercentage);
+
+		wetSlider.setup(getProcessor(), FdnReverbEffect::WetLevel, "Wet");
+		wetSlider.setMode(HiSlider::NormalizedPercentage);
+
+		drySlider.setup(getProcessor(), FdnReverbEffect::DryLevel, "Dry");
+		drySlider.setMode(HiSlider::NormalizedPercentage);
+
+		for (auto s : getSliders())
+		{
+			s->setSliderStyle(Slider::RotaryHorizontalVerticalDrag);
+			s->setTextBoxStyle(Slider::TextBoxRight, false, 80, 20);
+			addAndMakeVisible(s);
+		}
+	}
+
+	void updateGui() override
+	{
+		for (auto s : getSliders())
+			s->updateValue();
+	}
+
+	int getBodyHeight() const override { return 64; };
+
+	void resized() override
+	{
+		auto b = getLocalBounds().reduced(10, 8);
+
+		for (auto s : getSliders())
+		{
+			s->setBounds(b.removeFromLeft(120));
+			b.removeFromLeft(10);
+		}
+	}
+
+private:
+
+	Array<HiSlider*> getSliders()
+	{
+		return { &sizeSlider, &decaySlider, &dampingSlider, &modulationSlider, &widthSlider, &wetSlider, &drySlider };
+	}
+
+	HiSlider sizeSlider;
+	HiSlider decaySlider;
+	HiSlider dampingSlider;
+	HiSlider modulationSlider;
+	HiSlider widthSlider;
+	HiSlider wetSlider;
+	HiSlider drySlider;
+};
+
+#endif
+
+ProcessorEditorBody *FdnReverbEffect::createEditor(ProcessorEditor *parentEditor)
+{
+#if USE_BACKEND
+
+	return new FdnReverbEditorBody(parentEditor);
+
+#else 
+
+	ignoreUnused(parentEditor);
+	jassertfalse;
+	return nullptr;
+
+#endif
+}
+
+} // namespace hise
@@ -0,0 +1,175 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+#ifndef FDNREVERBEFFECT_H_INCLUDED
+#define FDNREVERBEFFECT_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** An algorithmic reverb based on a feedback delay network.
+*	@ingroup effectTypes
+*
+*	The input is diffused and fed into eight modulated delay lines that are mixed with a Householder matrix
+*	(see FdnReverb). Unlike the SimpleReverb, the decay time is set directly in milliseconds and the wet and dry
+*	levels are independent.
+*/
+class FdnReverbEffect : public MasterEffectProcessor
+{
+public:
+
+	SET_PROCESSOR_NAME("FdnReverb", "FDN Reverb", "An algorithmic reverb based on a feedback delay network.");
+
+	/** The parameters */
+	enum Parameters
+	{
+		RoomSize = 0, ///< the room size (scales the delay times)
+		DecayTime, ///< the decay time (RT60) in milliseconds
+		Damping, ///< the high frequency damping
+		Modulation, ///< the depth of the delay time modulation
+		Width, ///< the stereo width
+		WetLevel, ///< the wet level
+		DryLevel, ///< the dry level
+		numEffectParameters
+	};
+
+	FdnReverbEffect(MainController *mc, const String &id):
+		MasterEffectProcessor(mc, id)
+	{
+		finaliseModChains();
+
+		parameterNames.add("RoomSize");
+		parameterNames.add("DecayTime");
+		parameterNames.add("Damping");
+		parameterNames.add("Modulation");
+		parameterNames.add("Width");
+		parameterNames.add("WetLevel");
+		parameterNames.add("DryLevel");
+
+		reverb.setParameters(parameters);
+	};
+
+	float getAttribute(int parameterIndex) const override
+	{
+		switch ( parameterIndex )
+		{
+		case RoomSize:		return parameters.roomSize;
+		case DecayTime:		return parameters.decayTime * 1000.0f;
+		case Damping:		return parameters.damping;
+		case Modulation:	return parameters.modulation;
+		case Width:			return parameters.width;
+		case WetLevel:		return wetLevel;
+		case DryLevel:		return dryLevel;
+		default:			jassertfalse; return 1.0f;
+		}
+	};
+
+	void setInternalAttribute(int parameterIndex, float newValue) override 
+	{
+		switch ( parameterIndex )
+		{
+		case RoomSize:		parameters.roomSize = newValue; break; 
+		case DecayTime:		parameters.decayTime = newValue * 0.001f; break;
+		case Damping:		parameters.damping = newValue; break;
+		case Modulation:	parameters.modulation = newValue; break;
+		case Width:			parameters.width = newValue; break;
+		case WetLevel:		wetLevel = newValue; return;
+		case DryLevel:		dryLevel = newValue; return;
+		default:			jassertfalse; 
+		}
+
+		reverb.setParameters(parameters);
+	};
+
+	void restoreFromValueTree(const ValueTree &v) override
+	{
+		MasterEffectProcessor::restoreFromValueTree(v);
+
+		loadAttribute(RoomSize, "RoomSize");
+		loadAttribute(DecayTime, "DecayTime");
+		loadAttribute(Damping, "Damping");
+		loadAttribute(Modulation, "Modulation");
+		loadAttribute(Width, "Width");
+		loadAttribute(WetLevel, "WetLevel");
+		loadAttribute(DryLevel, "DryLevel");
+	};
+
+	ValueTree exportAsValueTree() const override
+	{
+		ValueTree v = MasterEffectProcessor::exportAsValueTree();
+
+		saveAttribute(RoomSize, "RoomSize");
+		saveAttribute(DecayTime, "DecayTime");
+		saveAttribute(Damping, "Damping");
+		saveAttribute(Modulation, "Modulation");
+		saveAttribute(Width, "Width");
+		saveAttribute(WetLevel, "WetLevel");
+		saveAttribute(DryLevel, "DryLevel");
+
+		return v;
+	}
+
+	void prepareToPlay(double sampleRate, int samplesPerBlock) override
+	{
+		MasterEffectProcessor::prepareToPlay(sampleRate, samplesPerBlock);
+
+		reverb.prepare(sampleRate);
+	};
+
+	void voicesKilled() override
+	{
+		KILL_LOG("Kill Reverb");
+		reverb.reset();
+	}
+
+	void applyEffect(AudioSampleBuffer &buffer, int startSample, int numSamples) override;
+
+	bool hasTail() const override {return true; };
+
+	int getNumChildProcessors() const override { return 0; };
+
+	Processor *getChildProcessor(int /*processorIndex*/) override { return nullptr; };
+
+	const Processor *getChildProcessor(int /*processorIndex*/) const override { return nullptr; };
+
+	ProcessorEditorBody *createEditor(ProcessorEditor *parentEditor)  override;
+
+private:
+
+	FdnReverb reverb;
+	FdnReverb::Parameters parameters;
+
+	float wetLevel = 0.25f;
+	float dryLevel = 1.0f;
+};
+
+} // namespace hise
+
+#endif  // FDNREVERBEFFECT_H_INCLUDED
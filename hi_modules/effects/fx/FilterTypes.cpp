@@ -219,6 +219,12 @@ void MultiChannelFilter<FilterSubType>::render(FilterHelpers::RenderData& r)
 	FilterSubType::processSamples(r.b, r.startSample, r.numSamples);
 }
 
+template <class FilterSubType>
+void MultiChannelFilter<FilterSubType>::updateParameters(FilterHelpers::RenderData& r)
+{
+	update(r);
+}
+
 template <class FilterSubType>
 double MultiChannelFilter<FilterSubType>::limit(double value, double minValue, double maxValue)
 {
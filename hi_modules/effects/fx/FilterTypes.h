@@ -156,6 +156,9 @@ public:
 	StringArray getModes() const;
 	void render(FilterHelpers::RenderData& r);
 
+	/** Advances the parameter smoothing and updates the coefficients like render() without processing any samples. */
+	void updateParameters(FilterHelpers::RenderData& r);
+
 private:
 
 	double limit(double value, double minValue, double maxValue);
@@ -416,6 +419,9 @@ public:
 
 	Array<FilterHelpers::CoefficientType> getCoefficientTypeList() const;
 
+	/** Returns the coefficients that were calculated in the last update. */
+	const IIRCoefficients& getCurrentCoefficients() const { return currentCoefficients; }
+
 protected:
 
 	void setType(int newType);
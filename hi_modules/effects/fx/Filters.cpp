@@ -297,6 +297,7 @@ PolyFilterEffect::PolyFilterEffect(MainController *mc, const String &uid, int nu
 	VoiceEffectProcessor(mc, uid, numVoices),
 	voiceFilters(numVoices),
 	monoFilters(1),
+	batchFilter(numVoices),
 	frequency(getDefaultValue(PolyFilterEffect::Parameters::Frequency)),
 	q(getDefaultValue(PolyFilterEffect::Parameters::Q)),
 	gain(getDefaultValue(PolyFilterEffect::Parameters::Gain)),
@@ -359,6 +360,7 @@ PolyFilterEffect::PolyFilterEffect(MainController *mc, const String &uid, int nu
 
 	voiceFilters.setMode((FilterBank::FilterMode)(int)getDefaultValue(PolyFilterEffect::Mode));
 	monoFilters.setMode((FilterBank::FilterMode)(int)getDefaultValue(PolyFilterEffect::Mode));
+	batchFilter.setMode((FilterBank::FilterMode)(int)getDefaultValue(PolyFilterEffect::Mode));
 }
 
 PolyFilterEffect::~PolyFilterEffect()
@@ -413,13 +415,17 @@ void PolyFilterEffect::setInternalAttribute(int parameterIndex, float newValue)
 	switch (parameterIndex)
 	{
 	case PolyFilterEffect::Gain:		gain = newValue;
-										filterBankToUse.setGain(Decibels::decibelsToGain(newValue));			  break;
+										filterBankToUse.setGain(Decibels::decibelsToGain(newValue));
+										batchFilter.setGain(Decibels::decibelsToGain(newValue)); break;
 	case PolyFilterEffect::Frequency:	frequency = newValue;
-										filterBankToUse.setFrequency(newValue); break;
+										filterBankToUse.setFrequency(newValue);
+										batchFilter.setFrequency(newValue); break;
 	case PolyFilterEffect::Q:			q = newValue;
-										filterBankToUse.setQ(newValue); break;
+										filterBankToUse.setQ(newValue);
+										batchFilter.setQ(newValue); break;
 	case PolyFilterEffect::Mode:		mode = (FilterBank::FilterMode)(int)newValue;
-										filterBankToUse.setMode(mode); break;
+										filterBankToUse.setMode(mode);
+										batchFilter.setMode(mode); break;
     case PolyFilterEffect::Quality:		setRenderQuality((int)newValue); break;
 	case PolyFilterEffect::BipolarIntensity: bipolarParameterValue = jlimit<float>(-1.0f, 1.0f, newValue);
 										bipolarIntensity.setTargetValue(bipolarParameterValue); break;
@@ -486,7 +492,8 @@ void PolyFilterEffect::prepareToPlay(double sampleRate, int samplesPerBlock)
 	bipolarIntensity.reset(sampleRate / 64.0, 0.05);
 	voiceFilters.setSampleRate(sampleRate);
 	monoFilters.setSampleRate(sampleRate);
-	
+	batchFilter.prepareToPlay(sampleRate, samplesPerBlock);
+
 }
 
 void PolyFilterEffect::renderNextBlock(AudioSampleBuffer &b, int startSample, int numSamples)
@@ -591,21 +598,99 @@ void PolyFilterEffect::applyEffect(int voiceIndex, AudioSampleBuffer &b, int sta
 		return;
 	}
 
+	auto mv = calculateModulationValues(voiceIndex, startSample);
+
 	FilterHelpers::RenderData r(b, startSample, numSamples);
 	r.voiceIndex = voiceIndex;
+	r.freqModValue = mv.freqModValue;
+	r.bipolarDelta = mv.bipolarDelta;
+	r.gainModValue = mv.gainModValue;
+	r.qModValue = mv.qModValue;
 
-	r.freqModValue = modChains[FrequencyChain].getOneModulationValue(startSample);
+	voiceFilters.renderPoly(r);
+}
+
+BatchedPolyFilter::ModulationValues PolyFilterEffect::calculateModulationValues(int voiceIndex, int startSample)
+{
+	BatchedPolyFilter::ModulationValues mv;
+
+	mv.freqModValue = modChains[FrequencyChain].getOneModulationValue(startSample);
 
 	auto bipolarFMod = modChains[BipolarFrequencyChain].getOneModulationValue(startSample);
 
-	auto bp = bipolarIntensity.getNextValue();
+	auto bp = polyBipolarIntensity;
 
-	r.bipolarDelta = (double)(bp * bp * bp * bipolarFMod);
-	r.gainModValue = (double)modChains[GainChain].getOneModulationValue(startSample);
-	r.qModValue = (double)modChains[ResonanceChain].getOneModulationValue(startSample);
+	mv.bipolarDelta = (double)(bp * bp * bp * bipolarFMod);
+	mv.gainModValue = (double)modChains[GainChain].getOneModulationValue(startSample);
+	mv.qModValue = (double)modChains[ResonanceChain].getOneModulationValue(startSample);
 
-    voiceFilters.setDisplayModValues(voiceIndex, (float)r.freqModValue, (float)r.gainModValue);
-	voiceFilters.renderPoly(r);
+	voiceFilters.setDisplayModValues(voiceIndex, (float)mv.freqModValue, (float)mv.gainModValue);
+
+	return mv;
+}
+
+void PolyFilterEffect::renderVoice(int voiceIndex, AudioSampleBuffer &b, int startSample, int numSamples)
+{
+	if (batchActive)
+	{
+		if (auto voiceValues = batchFilter.addVoice(voiceIndex, b, startSample, numSamples))
+		{
+			preVoiceRendering(voiceIndex, startSample, numSamples);
+
+			// The modulation values are only valid until the next voice is calculated, so we store them now
+			*voiceValues = calculateModulationValues(voiceIndex, startSample);
+
+			return;
+		}
+	}
+	else if (lastBlockWasBatched)
+	{
+		// The voice filters haven't been used while the voices were batched, so we need to clear their states
+		for (int i = 0; i < getVoiceAmount(); i++)
+			voiceFilters.reset(i);
+
+		lastBlockWasBatched = false;
+	}
+
+	VoiceEffectProcessor::renderVoice(voiceIndex, b, startSample, numSamples);
+}
+
+void PolyFilterEffect::preRenderCallback(int startSample, int numSamples)
+{
+	VoiceEffectProcessor::preRenderCallback(startSample, numSamples);
+
+	if (!forceMono && hasPolyMods())
+	{
+		// The smoother is shared by all voices, so it must not be advanced per voice. 
+		// It was prepared with a step every 64 samples.
+		const int numSteps = jmax(1, numSamples / 64);
+
+		for (int i = 0; i < numSteps; i++)
+			polyBipolarIntensity = bipolarIntensity.getNextValue();
+	}
+}
+
+bool PolyFilterEffect::canRenderVoiceBatch() const
+{
+	return !forceMono && hasPolyMods() && BatchedPolyFilter::isSupported(mode);
+}
+
+void PolyFilterEffect::startVoiceBatch(int /*startSample*/, int /*numSamples*/)
+{
+	if (!lastBlockWasBatched)
+	{
+		batchFilter.reset();
+		lastBlockWasBatched = true;
+	}
+
+	batchFilter.startBatch();
+	batchActive = true;
+}
+
+void PolyFilterEffect::renderVoiceBatch()
+{
+	batchFilter.processBatch();
+	batchActive = false;
 }
 
 void PolyFilterEffect::startVoice(int voiceIndex, const HiseEvent& e)
@@ -613,6 +698,7 @@ void PolyFilterEffect::startVoice(int voiceIndex, const HiseEvent& e)
 	VoiceEffectProcessor::startVoice(voiceIndex, e);
 
 	voiceFilters.reset(voiceIndex);
+	batchFilter.reset(voiceIndex);
 
 	if (!polyMode && !blockIsActive)
 	{
@@ -196,6 +196,17 @@ public:
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;;
 	void renderNextBlock(AudioSampleBuffer &/*b*/, int /*startSample*/, int /*numSample*/);
 	void applyEffect(int voiceIndex, AudioSampleBuffer &b, int startSample, int numSamples) override;
+
+	/** Stores the voice in the batched filter if possible or renders it directly. */
+	void renderVoice(int voiceIndex, AudioSampleBuffer &b, int startSample, int numSamples) override;
+
+	/** Advances the bipolar intensity smoothing once per render call. */
+	void preRenderCallback(int startSample, int numSamples) override;
+
+	bool canRenderVoiceBatch() const override;
+	void startVoiceBatch(int startSample, int numSamples) override;
+	void renderVoiceBatch() override;
+
 	/** Resets the filter state if a new voice is started. */
 	void startVoice(int voiceIndex, const HiseEvent& e) override;
 	bool hasTail() const override { return false; };
@@ -208,7 +219,7 @@ public:
 
 private:
 
-	
+	BatchedPolyFilter::ModulationValues calculateModulationValues(int voiceIndex, int startSample);
 
 	bool blockIsActive = false;
 	int polyWatchdog = 0;
@@ -227,10 +238,15 @@ private:
 
 	float bipolarParameterValue = 0.0f;
 	LinearSmoothedValue<float> bipolarIntensity;
+	float polyBipolarIntensity = 0.0f;
 
 	FilterBank voiceFilters;
 	FilterBank monoFilters;
 
+	BatchedPolyFilter batchFilter;
+	bool batchActive = false;
+	bool lastBlockWasBatched = false;
+
 	mutable WeakReference<Processor> ownerSynthForCoefficients;
 
 	JUCE_DECLARE_WEAK_REFERENCEABLE(PolyFilterEffect)
@@ -172,13 +172,16 @@ void SaturatorEffect::applyEffect(AudioSampleBuffer &buffer, int startSample, in
     float *l = buffer.getWritePointer(0, startSample);
 	float *r = buffer.getWritePointer(1, startSample);
 
-	if (auto modValues = modChains[SaturationChain].getReadPointerForVoiceValues(startSample))
+	// The modulation values are rendered at the original samplerate
+	const int oversamplingFactor = getOversamplingFactor();
+
+	if (auto modValues = modChains[SaturationChain].getReadPointerForVoiceValues(startSample / oversamplingFactor))
 	{
 		for (int i = 0; i < numSamples; i++)
 		{
 			if (i & 7)
 			{
-				saturator.setSaturationAmount(modValues[i] * saturation);
+				saturator.setSaturationAmount(modValues[i / oversamplingFactor] * saturation);
 			}
 
 			l[i] = dry * l[i] + wet * (postGain * saturator.getSaturatedSample(preGain*l[i]));
@@ -79,6 +79,8 @@ public:
 
 	bool hasTail() const override { return false; };
 
+	bool supportsOversampling() const override { return true; }
+
 	Processor *getChildProcessor(int /*processorIndex*/) override { return saturationChain; };
 	const Processor *getChildProcessor(int /*processorIndex*/) const override { return saturationChain; };
 	int getNumInternalChains() const override { return numInternalChains; };
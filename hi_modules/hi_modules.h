@@ -77,6 +77,15 @@ If enabled, HISE will include the hardcoded nodes found at the specified locatio
 #define ENABLE_PEAK_METERS_FOR_GAIN_EFFECT 1
 #endif
 
+/**Config: HISE_CONVOLUTION_CACHE_SIZE_MB
+
+The default memory limit (in megabytes) for the prepared impulse responses that are shared between all convolution reverbs.
+You can change it at runtime with Engine.setImpulseResponseCacheSize().
+*/
+#ifndef HISE_CONVOLUTION_CACHE_SIZE_MB
+#define HISE_CONVOLUTION_CACHE_SIZE_MB 256
+#endif
+
 
 /** @defgroup modulatorTypes HISE Modulators
 *	@ingroup types
@@ -162,20 +171,26 @@ If enabled, HISE will include the hardcoded nodes found at the specified locatio
 #include "effects/fx/RouteFX.h"
 #include "effects/fx/FilterTypes.h"
 #include "effects/fx/FilterHelpers.h"
+#include "effects/fx/BatchedPolyFilter.h"
 #include "effects/fx/Filters.h"
 #include "effects/fx/HarmonicFilter.h"
 #include "effects/fx/CurveEq.h"
 #include "effects/fx/StereoFX.h"
 #include "effects/fx/SimpleReverb.h"
+#include "effects/fx/FdnReverb.h"
+#include "effects/fx/FdnReverbEffect.h"
 #include "effects/fx/Delay.h"
 #include "effects/fx/GainEffect.h"
 #include "effects/fx/Chorus.h"
 #include "effects/fx/Phaser.h"
 #include "effects/fx/GainCollector.h"
 #include "effects/convolution/AtkConvolution.h"
+#include "effects/convolution/ConvolutionWorkerPool.h"
+#include "effects/convolution/MatrixConvolver.h"
 #include "effects/convolution/Convolution.h"
 #include "effects/mda/mdaLimiter.h"
 #include "effects/mda/mdaDegrade.h"
+#include "effects/fx/BlockDynamics.h"
 #include "effects/fx/Dynamics.h"
 #include "effects/fx/Saturator.h"
 #include "effects/fx/AudioProcessorWrapper.h"
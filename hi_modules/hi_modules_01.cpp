@@ -96,10 +96,13 @@ namespace wdl
 #include "effects/fx/FilterTypes.cpp"
 #include "effects/fx/FilterHelpers.cpp"
 #include "effects/fx/Filters.cpp"
+#include "effects/fx/BatchedPolyFilter.cpp"
 #include "effects/fx/HarmonicFilter.cpp"
 #include "effects/fx/CurveEq.cpp"
 #include "effects/fx/StereoFX.cpp"
 #include "effects/fx/SimpleReverb.cpp"
+#include "effects/fx/FdnReverb.cpp"
+#include "effects/fx/FdnReverbEffect.cpp"
 #include "effects/fx/Delay.cpp"
 #include "effects/fx/GainEffect.cpp"
 #include "effects/fx/Chorus.cpp"
@@ -107,8 +110,10 @@ namespace wdl
 #include "effects/fx/GainCollector.cpp"
 #include "effects/convolution/AtkConvolution.cpp"
 #include "effects/convolution/Convolution.cpp"
+#include "effects/convolution/MatrixConvolver.cpp"
 #include "effects/mda/mdaLimiter.cpp"
 #include "effects/mda/mdaDegrade.cpp"
+#include "effects/fx/BlockDynamics.cpp"
 #include "effects/fx/Dynamics.cpp"
 #include "effects/fx/Saturator.cpp"
 #include "effects/fx/AudioProcessorWrapper.cpp"
@@ -61,13 +61,13 @@ GlobalModulatorEditor::GlobalModulatorEditor (ProcessorEditor *p)
 
 	getProcessor()->getMainController()->skin(*useTableButton);
 
-	tableUsed = getProcessor()->getAttribute(GlobalModulator::UseTable) == 1.0f;
+	tableUsed = getProcessor()->getAttribute(getParameterIndex(GlobalModulator::UseTable)) == 1.0f;
 
 	midiTable->connectToLookupTableProcessor(getProcessor());
 
-	useTableButton->setup(getProcessor(), GlobalModulator::UseTable, "Use Table");
+	useTableButton->setup(getProcessor(), getParameterIndex(GlobalModulator::UseTable), "Use Table");
 
-	invertButton->setup(getProcessor(), GlobalModulator::Inverted, "Inverted");
+	invertButton->setup(getProcessor(), getParameterIndex(GlobalModulator::Inverted), "Inverted");
 
 	getProcessor()->getMainController()->skin(*globalModSelector);
 
@@ -141,7 +141,7 @@ void GlobalModulatorEditor::buttonClicked (Button* buttonThatWasClicked)
     {
         //[UserButtonCode_useTableButton] -- add your button handler code here..
 		tableUsed = useTableButton->getToggleState();
-		getProcessor()->setAttribute(GlobalModulator::UseTable, tableUsed ? 1.0f : 0.0f, dontSendNotification);
+		getProcessor()->setAttribute(getParameterIndex(GlobalModulator::UseTable), tableUsed ? 1.0f : 0.0f, dontSendNotification);
 
 		refreshBodySize();
         //[/UserButtonCode_useTableButton]
@@ -48,7 +48,7 @@ public:
 
 	void updateGui() override
 	{
-		tableUsed = getProcessor()->getAttribute(GlobalModulator::UseTable) == 1.0f;
+		tableUsed = getProcessor()->getAttribute(getParameterIndex(GlobalModulator::UseTable)) == 1.0f;
 
 		useTableButton->updateValue();
 
@@ -65,6 +65,14 @@ public:
 
 	void setItemEntry();
 
+	int getParameterIndex(GlobalModulator::Parameters p) const
+	{
+		if (auto gm = dynamic_cast<const GlobalModulator*>(getProcessor()))
+			return gm->getParameterIndex(p);
+
+		return (int)p;
+	}
+
     //[/UserMethods]
 
     void paint (Graphics& g) override;
@@ -142,6 +142,13 @@ StringArray GlobalModulator::getListOfAllModulatorsWithType()
 			case VoiceStart: matches = dynamic_cast<VoiceStartModulator*>(chain->getHandler()->getProcessor(i)) != nullptr; break;
 			case TimeVariant: matches = dynamic_cast<TimeVariantModulator*>(chain->getHandler()->getProcessor(i)) != nullptr; break;
 			case StaticTimeVariant: matches = dynamic_cast<TimeVariantModulator*>(chain->getHandler()->getProcessor(i)) != nullptr; break;
+			case Envelope:
+			{
+				// Only polyphonic envelopes are rendered per voice in the container
+				auto env = dynamic_cast<EnvelopeModulator*>(chain->getHandler()->getProcessor(i));
+				matches = env != nullptr && !env->isInMonophonicMode();
+				break;
+			}
             case numTypes: jassertfalse; break;
 			}
 
@@ -281,9 +288,7 @@ float GlobalVoiceStartModulator::calculateVoiceStartValue(const HiseEvent &m)
 	{
 		jassert(m.isNoteOn());
 
-		const int noteNumber = m.getNoteNumber();
-
-		float globalValue = getConnectedContainer()->getConstantVoiceValue(getOriginalModulator(), noteNumber);
+		float globalValue = getConnectedContainer()->getVoiceStartValueForEvent(getOriginalModulator(), m);
 
 		if (useTable)
 		{
@@ -486,6 +491,20 @@ void GlobalTimeVariantModulator::calculateBlock(int startSample, int numSamples)
     setOutputValue(1.0f);
 }
 
+const float* GlobalTimeVariantModulator::getSharedModulationValues(int startSample, int /*numSamples*/)
+{
+	if (useTable || inverted || !isConnected())
+		return nullptr;
+
+	if (auto src = getConnectedContainer()->getSharedModulationValuesForModulator(getOriginalModulator(), startSample))
+	{
+		setOutputValue(src[0]);
+		return src;
+	}
+
+	return nullptr;
+}
+
 void GlobalTimeVariantModulator::invertBuffer(int startSample, int numSamples)
 {
 	if (inverted)
@@ -496,4 +515,198 @@ void GlobalTimeVariantModulator::invertBuffer(int startSample, int numSamples)
 	}
 }
 
+GlobalEnvelopeModulator::GlobalEnvelopeModulator(MainController *mc, const String &id, int numVoices, Modulation::Mode m) :
+	EnvelopeModulator(mc, id, numVoices, m),
+	Modulation(m),
+	GlobalModulator(mc)
+{
+	parameterNames.add("UseTable");
+	parameterNames.add("Inverted");
+
+	for (int i = 0; i < polyManager.getVoiceAmount(); i++) states.add(createSubclassedState(i));
+
+	monophonicState = createSubclassedState(-1);
+}
+
+void GlobalEnvelopeModulator::restoreFromValueTree(const ValueTree &v)
+{
+	EnvelopeModulator::restoreFromValueTree(v);
+	loadFromValueTree(v);
+}
+
+ValueTree GlobalEnvelopeModulator::exportAsValueTree() const
+{
+	ValueTree v = EnvelopeModulator::exportAsValueTree();
+
+	saveToValueTree(v);
+
+	return v;
+}
+
+ProcessorEditorBody * GlobalEnvelopeModulator::createEditor(ProcessorEditor *parentEditor)
+{
+#if USE_BACKEND
+	return new GlobalModulatorEditor(parentEditor);
+#else
+	ignoreUnused(parentEditor);
+	jassertfalse;
+	return nullptr;
+#endif
+}
+
+void GlobalEnvelopeModulator::setInternalAttribute(int parameterIndex, float newValue)
+{
+	if (parameterIndex < EnvelopeModulator::Parameters::numParameters)
+	{
+		EnvelopeModulator::setInternalAttribute(parameterIndex, newValue);
+		return;
+	}
+
+	switch (parameterIndex)
+	{
+	case UseTableParameter:	useTable = (newValue > 0.5f); break;
+	case InvertedParameter:	inverted = (newValue > 0.5f); break;
+	default:				jassertfalse; break;
+	}
+}
+
+float GlobalEnvelopeModulator::getAttribute(int parameterIndex) const
+{
+	if (parameterIndex < EnvelopeModulator::Parameters::numParameters)
+		return EnvelopeModulator::getAttribute(parameterIndex);
+
+	switch (parameterIndex)
+	{
+	case UseTableParameter:	return useTable ? 1.0f : 0.0f;
+	case InvertedParameter:	return inverted ? 1.0f : 0.0f;
+	default:				jassertfalse; return -1.0f;
+	}
+}
+
+float GlobalEnvelopeModulator::getDefaultValue(int parameterIndex) const
+{
+	if (parameterIndex < EnvelopeModulator::Parameters::numParameters)
+		return EnvelopeModulator::getDefaultValue(parameterIndex);
+
+	return 0.0f;
+}
+
+void GlobalEnvelopeModulator::handleHiseEvent(const HiseEvent &m)
+{
+	EnvelopeModulator::handleHiseEvent(m);
+
+	if (m.isNoteOn())
+		unsavedEventId = m.getEventId();
+}
+
+float GlobalEnvelopeModulator::startVoice(int voiceIndex)
+{
+	if (auto s = getState(voiceIndex))
+	{
+		s->eventId = unsavedEventId;
+		s->isHeld = true;
+
+		// The container is processed before this modulator, so the voice should already be there
+		s->containerVoiceIndex = isConnected() ? getConnectedContainer()->getVoiceIndexForEventId(s->eventId) : -1;
+	}
+
+	return EnvelopeModulator::startVoice(voiceIndex);
+}
+
+void GlobalEnvelopeModulator::stopVoice(int voiceIndex)
+{
+	// The release is handled by the envelope in the container...
+	if (auto s = getState(voiceIndex))
+		s->isHeld = false;
+}
+
+void GlobalEnvelopeModulator::reset(int voiceIndex)
+{
+	EnvelopeModulator::reset(voiceIndex);
+
+	if (auto s = getState(voiceIndex))
+	{
+		s->containerVoiceIndex = -1;
+		s->isHeld = false;
+	}
+}
+
+bool GlobalEnvelopeModulator::isPlaying(int voiceIndex) const
+{
+	if (auto s = getState(voiceIndex))
+	{
+		if (s->containerVoiceIndex != -1 && isConnected())
+			return getConnectedContainer()->isEnvelopeVoiceActive(s->containerVoiceIndex, s->eventId);
+
+		return s->isHeld;
+	}
+
+	return false;
+}
+
+void GlobalEnvelopeModulator::calculateBlock(int startSample, int numSamples)
+{
+	const int voiceIndex = isMonophonic ? polyManager.getLastStartedVoice() : polyManager.getCurrentVoice();
+
+	float* dest = internalBuffer.getWritePointer(0, startSample);
+
+	auto s = getState(voiceIndex);
+
+	if (s != nullptr && s->containerVoiceIndex != -1 && isConnected())
+	{
+		if (auto src = getConnectedContainer()->getEnvelopeValuesForVoice(getOriginalModulator(), s->containerVoiceIndex, s->eventId, startSample))
+		{
+			if (useTable)
+			{
+				for (int i = 0; i < numSamples; i++)
+					dest[i] = table->get((int)(src[i] * 127.0f));
+
+				if (shouldUpdatePlotter())
+					sendTableIndexChangeMessage(false, table, src[0]);
+			}
+			else
+			{
+				FloatVectorOperations::copy(dest, src, numSamples);
+			}
+
+			if (inverted)
+			{
+				FloatVectorOperations::multiply(dest, -1.0f, numSamples);
+				FloatVectorOperations::add(dest, 1.0f, numSamples);
+			}
+
+			return;
+		}
+
+		// The global envelope has finished...
+		FloatVectorOperations::clear(dest, numSamples);
+		return;
+	}
+
+	// Not connected to a global voice, so just act as a gate
+	FloatVectorOperations::fill(dest, (s != nullptr && s->isHeld) ? 1.0f : 0.0f, numSamples);
+}
+
+GlobalEnvelopeModulator::GlobalEnvelopeState* GlobalEnvelopeModulator::getState(int voiceIndex)
+{
+	if (isMonophonic)
+		return static_cast<GlobalEnvelopeState*>(monophonicState.get());
+
+	if (auto s = states[voiceIndex])
+		return static_cast<GlobalEnvelopeState*>(s);
+
+	return nullptr;
+}
+
+const GlobalEnvelopeModulator::GlobalEnvelopeState* GlobalEnvelopeModulator::getState(int voiceIndex) const
+{
+	if (isMonophonic)
+		return static_cast<const GlobalEnvelopeState*>(monophonicState.get());
+
+	if (auto s = states[voiceIndex])
+		return static_cast<const GlobalEnvelopeState*>(s);
+
+	return nullptr;
+}
+
 } // namespace hise
@@ -61,12 +61,21 @@ public:
 		VoiceStart,
 		TimeVariant,
 		StaticTimeVariant,
+		Envelope,
 		numTypes
 	};
 
 	virtual ModulatorType getModulatorType() const = 0;
 	virtual ~GlobalModulator();
 
+	/** Returns the attribute index for the given parameter. 
+	*
+	*	Overwrite getParameterOffset() if the modulator type already uses the first parameter indexes.
+	*/
+	int getParameterIndex(Parameters p) const { return getParameterOffset() + (int)p; }
+
+	virtual int getParameterOffset() const { return 0; }
+
 	Table *getTable(int /*tableIndex*/) const override { return table; }
 	Modulator *getOriginalModulator();
 	const Modulator *getOriginalModulator() const;
@@ -224,6 +233,9 @@ public:
 
 	void calculateBlock(int startSample, int numSamples) override;
 
+	/** Returns the values of the global modulator without copying if no table or inversion is used. */
+	const float* getSharedModulationValues(int startSample, int numSamples) override;
+
 	void invertBuffer(int startSample, int numSamples);
 
 	/** sets the new target value if the controller number matches. */
@@ -242,6 +254,85 @@ private:
 
 };
 
+/** A modulator that connects to a global envelope.
+@ingroup modulatorTypes
+
+The envelope is rendered polyphonically in the GlobalModulatorContainer and this modulator
+picks up the values of the container voice that was started with the same event id.
+*/
+class GlobalEnvelopeModulator : public EnvelopeModulator,
+								public GlobalModulator
+{
+public:
+
+	SET_PROCESSOR_NAME("GlobalEnvelopeModulator", "Global Envelope Modulator", "A modulator that connects to a global envelope.");
+
+	/** The table parameters are appended to the envelope parameters. */
+	enum SpecialParameters
+	{
+		UseTableParameter = EnvelopeModulator::Parameters::numParameters,
+		InvertedParameter,
+		numSpecialParameters
+	};
+
+	GlobalModulator::ModulatorType getModulatorType() const override { return GlobalModulator::Envelope; };
+
+	int getParameterOffset() const override { return UseTableParameter; }
+
+	GlobalEnvelopeModulator(MainController *mc, const String &id, int numVoices, Modulation::Mode m);
+
+	~GlobalEnvelopeModulator() {};
+
+	void restoreFromValueTree(const ValueTree &v) override;;
+
+	ValueTree exportAsValueTree() const override;;
+
+	ProcessorEditorBody *createEditor(ProcessorEditor *parentEditor)  override;
+
+	void setInternalAttribute(int parameterIndex, float newValue) override;;
+
+	float getAttribute(int parameterIndex) const override;;
+
+	float getDefaultValue(int parameterIndex) const override;
+
+	virtual Processor *getChildProcessor(int /*processorIndex*/) override final { return nullptr; };
+
+	virtual const Processor *getChildProcessor(int /*processorIndex*/) const override final { return nullptr; };
+
+	virtual int getNumChildProcessors() const override final { return 0; };
+
+	void handleHiseEvent(const HiseEvent &m) override;
+
+	float startVoice(int voiceIndex) override;
+	void stopVoice(int voiceIndex) override;
+	void reset(int voiceIndex) override;
+
+	/** Returns true as long as the voice of the global envelope is playing. */
+	bool isPlaying(int voiceIndex) const override;
+
+	void calculateBlock(int startSample, int numSamples) override;
+
+	ModulatorState *createSubclassedState(int voiceIndex) const override { return new GlobalEnvelopeState(voiceIndex); };
+
+private:
+
+	struct GlobalEnvelopeState : public EnvelopeModulator::ModulatorState
+	{
+		GlobalEnvelopeState(int voiceIndex) :
+			ModulatorState(voiceIndex)
+		{};
+
+		uint16 eventId = 0;
+		int containerVoiceIndex = -1;
+		bool isHeld = false;
+	};
+
+	GlobalEnvelopeState* getState(int voiceIndex);
+	const GlobalEnvelopeState* getState(int voiceIndex) const;
+
+	uint16 unsavedEventId = 0;
+};
+
 
 } // namespace hise
 
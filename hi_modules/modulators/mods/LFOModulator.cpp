@@ -459,6 +459,136 @@ float LfoModulator::calculateNewValue ()
 	return currentValue;
 }
 
+bool LfoModulator::VectorKernel::isSupported(Waveform w) noexcept
+{
+	return w == Sine || w == Triangle || w == Saw || w == Square;
+}
+
+void LfoModulator::VectorKernel::process(Waveform w, float* data, double& phase, double phaseDelta, int numValues) noexcept
+{
+	constexpr float tableSize = (float)SAMPLE_LOOKUP_TABLE_SIZE;
+	constexpr float halfTableSize = tableSize * 0.5f;
+	constexpr float invTableSize = 1.0f / tableSize;
+	constexpr float twoPi = 2.0f * float_Pi;
+
+	constexpr int mask = SAMPLE_LOOKUP_TABLE_SIZE - 1;
+	constexpr int halfIndex = SAMPLE_LOOKUP_TABLE_SIZE / 2;
+
+	float values[NumPerIteration];
+	float fractions[NumPerIteration];
+	int indexes[NumPerIteration];
+	float v1[NumPerIteration];
+	float v2[NumPerIteration];
+
+	while (numValues > 0)
+	{
+		const int numThisTime = jmin<int>(numValues, NumPerIteration);
+
+		// Wrap the phase with double precision once per iteration so that the float lanes stay accurate
+		const double wrappedPhase = phase - (double)SAMPLE_LOOKUP_TABLE_SIZE * std::floor(phase / (double)SAMPLE_LOOKUP_TABLE_SIZE);
+
+		// The table index and the interpolation factor are split before the conversion to float,
+		// otherwise the float phase would lose the precision that the steep edges need.
+		for (int i = 0; i < NumPerIteration; i++)
+		{
+			const double p = wrappedPhase + (double)i * phaseDelta;
+			const int index = (int)p;
+
+			indexes[i] = index;
+			fractions[i] = (float)(p - (double)index);
+			values[i] = (float)p - tableSize * std::floor((float)p * invTableSize);
+		}
+
+		switch (w)
+		{
+		case Sine:
+			
+			// 1 - (0.5 * cos(2pi * t) + 0.5) == 0.5 + 0.5 * cos(2pi * (t - 0.5))
+			for (int i = 0; i < NumPerIteration; i++)
+			{
+				float u = std::abs(values[i] * invTableSize - 0.5f);
+
+				const bool secondQuarter = u > 0.25f;
+				const float sign = secondQuarter ? -1.0f : 1.0f;
+				u = secondQuarter ? 0.5f - u : u;
+
+				const float z = twoPi * u;
+				const float z2 = z * z;
+
+				const float c = 1.0f + z2 * (-1.0f / 2.0f + z2 * (1.0f / 24.0f + z2 * (-1.0f / 720.0f + z2 * (1.0f / 40320.0f +
+								z2 * (-1.0f / 3628800.0f + z2 * (1.0f / 479001600.0f))))));
+
+				values[i] = 0.5f + 0.5f * sign * c;
+			}
+			break;
+		case Triangle:
+			for (int i = 0; i < NumPerIteration; i++)
+			{
+				v1[i] = std::abs(1.0f - (float)(indexes[i] & mask) / halfTableSize);
+				v2[i] = std::abs(1.0f - (float)((indexes[i] + 1) & mask) / halfTableSize);
+			}
+			break;
+		case Saw:
+			for (int i = 0; i < NumPerIteration; i++)
+			{
+				v1[i] = (float)(indexes[i] & mask) * invTableSize;
+				v2[i] = (float)((indexes[i] + 1) & mask) * invTableSize;
+			}
+			break;
+		case Square:
+			for (int i = 0; i < NumPerIteration; i++)
+			{
+				v1[i] = (indexes[i] & mask) >= halfIndex ? 0.0f : 1.0f;
+				v2[i] = ((indexes[i] + 1) & mask) >= halfIndex ? 0.0f : 1.0f;
+			}
+			break;
+		default:
+			jassertfalse;
+			break;
+		}
+
+		if (w != Sine)
+		{
+			// Interpolate the analytic table values like calculateNewValue() does
+			for (int i = 0; i < NumPerIteration; i++)
+				values[i] = 1.0f - ((1.0f - fractions[i]) * v1[i] + fractions[i] * v2[i]);
+		}
+
+		memcpy(data, values, sizeof(float) * numThisTime);
+
+		phase += phaseDelta * (double)numThisTime;
+		data += numThisTime;
+		numValues -= numThisTime;
+	}
+}
+
+void LfoModulator::calculateBlockVectorised(float* data, int numValues)
+{
+	VectorKernel::process(currentWaveform, data, uptime, angleDelta, numValues);
+
+	constexpr double ratio = 1.0 / (double)(SAMPLE_LOOKUP_TABLE_SIZE);
+	lastCycleIndex = (int)floor(uptime * ratio);
+
+	// The fade in and the smoothing are recursive, so they are applied in a second pass
+	const bool fadeIn = attack != 0.0f;
+	const bool smooth = smoother.getSmoothingTime() != 0.0f;
+	const float a0 = smoother.getA0();
+
+	if (!fadeIn)
+		attackValue = 1.0f;
+
+	for (int i = 0; i < numValues; i++)
+	{
+		if (fadeIn)
+			attackValue = CONSTRAIN_TO_0_1(attackBase + attackValue * attackCoef);
+
+		const float v = 1.0f - data[i] * attackValue;
+
+		currentValue = smooth ? smoother.smoothRaw(a0 * v) : v;
+		data[i] = currentValue;
+	}
+}
+
 void LfoModulator::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
 	Processor::prepareToPlay(sampleRate, samplesPerBlock);
@@ -498,9 +628,16 @@ void LfoModulator::calculateBlock(int startSample, int numSamples)
 
 	auto* modData = internalBuffer.getWritePointer(0, startSample);
 
-	while (--numSamples >= 0)
+	if (VectorKernel::isSupported(currentWaveform))
+	{
+		calculateBlockVectorised(modData, numSamples);
+	}
+	else
 	{
-		*modData++ = calculateNewValue();
+		while (--numSamples >= 0)
+		{
+			*modData++ = calculateNewValue();
+		}
 	}
 
 	const float newInputValue = ((int)(uptime) % SAMPLE_LOOKUP_TABLE_SIZE) / (float)SAMPLE_LOOKUP_TABLE_SIZE;
@@ -177,6 +177,24 @@ public:
 
 	void calculateBlock(int startSample, int numSamples) override;;
 
+	/** A lookup-free waveform generator for the built-in waveforms.
+	*
+	*	It calculates the phase of 8 values per iteration without branching and evaluates the waveform
+	*	analytically so that the loops can be vectorised. The triangle, saw and square waveforms match the 
+	*	interpolated lookup tables exactly, the sine uses a polynomial and is within 1e-5 of the table (this
+	*	is checked by the unit test in DspUnitTests.cpp).
+	*/
+	struct VectorKernel
+	{
+		static constexpr int NumPerIteration = 8;
+
+		/** Returns true if the waveform can be calculated without the lookup table. */
+		static bool isSupported(Waveform w) noexcept;
+
+		/** Writes the inverted waveform values into data and advances the phase. */
+		static void process(Waveform w, float* data, double& phase, double phaseDelta, int numValues) noexcept;
+	};
+
 	/** Returns the table that is used for the LFO waveform. */
 	Table *getTable(int=0) const override 
 	{
@@ -209,6 +227,9 @@ private:
 	*/
 	float calculateNewValue ();
 
+	/** Calculates a block of oscillator values using the VectorKernel. */
+	void calculateBlockVectorised(float* data, int numValues);
+
 	void setCurrentWaveform() 
 	{
 		switch(currentWaveform)
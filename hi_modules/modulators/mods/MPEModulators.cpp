@@ -42,7 +42,8 @@ MPEModulator::MPEModulator(MainController *mc, const String &id, int voiceAmount
 	table(new SampleLookupTable()),
 	monoState(-1),
 	g((Gesture)(int)getDefaultValue(GestureCC)),
-	smoothedIntensity(getIntensity())
+	smoothedIntensity(getIntensity()),
+	tableWatcher(*this)
 {
 	setAttribute(DefaultValue, getDefaultValue(DefaultValue), dontSendNotification);
 
@@ -60,10 +61,19 @@ MPEModulator::MPEModulator(MainController *mc, const String &id, int voiceAmount
 	for (int i = 0; i < polyManager.getVoiceAmount(); i++) states.add(createSubclassedState(i));
 
 	updateSmoothingTime(getDefaultValue(SpecialParameters::SmoothingTime));
+
+	table->addChangeListener(&tableWatcher);
 }
 
 MPEModulator::~MPEModulator()
 {
+	table->removeChangeListener(&tableWatcher);
+
+	{
+		ScopedLock sl(getMainController()->getLock());
+		getExpressionStore().releaseLane(expressionLane);
+	}
+
 	getMainController()->getMacroManager().getMidiControlAutomationHandler()->getMPEData().removeListener(this);
 	
 	getMainController()->getMacroManager().getMidiControlAutomationHandler()->getMPEData().removeConnection(this);
@@ -138,6 +148,8 @@ void MPEModulator::setInternalAttribute(int parameterIndex, float newValue)
 
 		mpeValues.reset();
 
+		updateExpressionLane();
+
 	}
 	else if (parameterIndex == SpecialParameters::SmoothingTime)
 	{
@@ -215,6 +227,7 @@ void MPEModulator::resetToDefault()
 	smoothedIntensity = getDefaultValue(SpecialParameters::SmoothedIntensity);
 	setIntensity(smoothedIntensity);
 	table->reset();
+	updateTableLinearity();
 	table->sendChangeMessage();
 	sendTableIndexChangeMessage(false, table, 0);
 	sendChangeMessage();
@@ -267,6 +280,7 @@ void MPEModulator::restoreFromValueTree(const ValueTree &v)
 	loadAttribute(DefaultValue, "DefaultValue");
 	loadAttribute(SmoothedIntensity, "SmoothedIntensity");
 	loadTable(table, "Table");
+	updateTableLinearity();
 }
 
 juce::ValueTree MPEModulator::exportAsValueTree() const
@@ -334,6 +348,16 @@ float MPEModulator::startVoice(int voiceIndex)
 
 			s->startVoice(startValue, g == Stroke ? unsavedStrokeValue : startValue);
 
+			if (usesExpressionStore())
+			{
+				// The store has reset the channel to the neutral value, so start with an offset that yields the start value
+				auto d = (ExpressionStore::Dimension)getExpressionDimension(g);
+
+				s->expressionOffset = startValue - getTableValue(ExpressionStore::getNeutralValue(d));
+				s->expressionReceived = false;
+				s->lastExpressionValue = startValue;
+			}
+
 #if 0
 			s->smoother.setDefaultValue(startValue);
 			s->smoother.resetToValue(startValue);
@@ -372,6 +396,14 @@ void MPEModulator::stopVoice(int voiceIndex)
 		if (auto s = getState(voiceIndex))
 		{
 			s->stopVoice();
+
+			if (usesExpressionStore() && s->midiChannel > 0)
+			{
+				auto d = (ExpressionStore::Dimension)getExpressionDimension(g);
+				auto target = getExpressionStore().getTargetValue(d, jlimit(0, 15, s->midiChannel - 1));
+
+				s->isRingingOff = getTableValue(target) == 0.0f;
+			}
 		}
 	}
 }
@@ -412,6 +444,9 @@ bool MPEModulator::isPlaying(int voiceIndex) const
 	}
 	else if(auto s = getState(voiceIndex))
 	{
+		if (usesExpressionStore())
+			return !(s->isRingingOff && s->lastExpressionValue == 0.0f);
+
 		return s->isPlaying();
 	}
 
@@ -423,6 +458,8 @@ void MPEModulator::prepareToPlay(double sampleRate, int samplesPerBlock)
 	EnvelopeModulator::prepareToPlay(sampleRate, samplesPerBlock);
 
 	monoState.prepareToPlay(getControlRate());
+
+	getExpressionStore().prepareToPlay(getControlRate(), samplesPerBlock / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR + 1);
 	
 	for (auto s_ : states)
 	{
@@ -453,7 +490,10 @@ void MPEModulator::calculateBlock(int startSample, int numSamples)
 	{
 		auto w = internalBuffer.getWritePointer(0, startSample);
 
-		s->process(w, numSamples);
+		if (usesExpressionStore() && s->midiChannel > 0)
+			processWithExpressionStore(*s, w, startSample, numSamples);
+		else
+			s->process(w, numSamples);
 
 		if (isMonophonic || polyManager.getLastStartedVoice() == voiceIndex)
 		{
@@ -466,6 +506,9 @@ void MPEModulator::handleHiseEvent(const HiseEvent& m)
 {
 	EnvelopeModulator::handleHiseEvent(m);
 
+	if (expressionLane != -1)
+		getExpressionStore().handleHiseEvent(m);
+
 	auto c = m.getChannel();
 
 	float midiValue;
@@ -531,6 +574,10 @@ void MPEModulator::handleHiseEvent(const HiseEvent& m)
 
 		if (s->isPressed && midiChannelMatches)
 		{
+			if (usesExpressionStore())
+				s->expressionReceived = true;
+
+			// Keep the smoother up to date so the voice can switch back to it if the table is changed
 			s->setTargetValue(targetValue);
 
 			
@@ -572,7 +619,75 @@ void MPEModulator::updateSmoothingTime(float newTime)
 
 		for (int i = 0; i < states.size(); i++)
 			getState(i)->setSmoothingTime(smoothingTime);
+
+		updateExpressionLane();
+	}
+}
+
+MPEModulator::ExpressionStore& MPEModulator::getExpressionStore()
+{
+	return getMainController()->getMacroManager().getMidiControlAutomationHandler()->getMPEData().getExpressionStore();
+}
+
+int MPEModulator::getExpressionDimension(Gesture g) noexcept
+{
+	switch (g)
+	{
+	case Press: return ExpressionStore::Press;
+	case Slide: return ExpressionStore::Slide;
+	case Glide: return ExpressionStore::Glide;
+	case Lift:	return ExpressionStore::Lift;
+	default:	return -1;
+	}
+}
+
+void MPEModulator::updateExpressionLane()
+{
+	auto& store = getExpressionStore();
+	auto d = getExpressionDimension(g);
+
+	ScopedLock sl(getMainController()->getLock());
+
+	store.releaseLane(expressionLane);
+	expressionLane = d != -1 ? store.acquireLane((ExpressionStore::Dimension)d, smoothingTime) : -1;
+}
+
+void MPEModulator::updateTableLinearity()
+{
+	auto data = table->getReadPointer();
+	const int lastIndex = SAMPLE_LOOKUP_TABLE_SIZE - 1;
+	const float delta = (data[lastIndex] - data[0]) / (float)lastIndex;
+
+	bool isLinear = true;
+
+	for (int i = 1; i < lastIndex; i++)
+	{
+		if (std::abs(data[i] - (data[0] + (float)i * delta)) > 1e-4f)
+		{
+			isLinear = false;
+			break;
+		}
 	}
+
+	tableIsLinear.store(isLinear);
+}
+
+void MPEModulator::processWithExpressionStore(MPEState& s, float* data, int startSample, int numSamples)
+{
+	auto& store = getExpressionStore();
+
+	auto values = store.getSmoothedValues(expressionLane, jlimit(0, 15, s.midiChannel - 1), startSample, numSamples);
+
+	// The offset follows the same curve as the smoothing so the transition from the start value stays continuous
+	const float decay = s.expressionReceived ? store.getDecayFactor(expressionLane) : 1.0f;
+
+	for (int i = 0; i < numSamples; i++)
+		data[i] = getTableValue(values[i]);
+
+	s.expressionOffset = ExpressionStore::applyStartOffset(data, numSamples, s.expressionOffset, decay);
+
+	if (numSamples > 0)
+		s.lastExpressionValue = data[numSamples - 1];
 }
 
 hise::MPEModulator::MPEState * MPEModulator::getState(int voiceIndex)
@@ -126,6 +126,11 @@ public:
 		bool isPressed = false;
 		bool isRingingOff = false;
 
+		/** The difference between the start value and the shared expression value. It decays once the channel receives its first message. */
+		float expressionOffset = 0.0f;
+		bool expressionReceived = false;
+		float lastExpressionValue = 0.0f;
+
 		void startVoice(float initialValue, float targetValue_)
 		{
 			const bool useSmoother = smoother.getSmoothingTime() > 0.0f;
@@ -192,6 +197,34 @@ public:
 
 private:
 
+	using ExpressionStore = MidiControllerAutomationHandler::MPEData::ExpressionStore;
+
+	ExpressionStore& getExpressionStore();
+
+	/** Returns the shared dimension for the gesture or -1 if the gesture can't be shared. */
+	static int getExpressionDimension(Gesture g) noexcept;
+
+	void updateExpressionLane();
+
+	/** The shared lanes smooth the raw MPE values and apply the table afterwards. This only yields 
+		the same result as smoothing the table output if the table is a straight line, so other tables 
+		use the per-voice smoothers. */
+	bool usesExpressionStore() const noexcept { return expressionLane != -1 && !isMonophonic && tableIsLinear.load(); }
+
+	void updateTableLinearity();
+
+	struct TableWatcher : public SafeChangeListener
+	{
+		TableWatcher(MPEModulator& parent_) : parent(parent_) {};
+
+		void changeListenerCallback(SafeChangeBroadcaster*) override { parent.updateTableLinearity(); }
+
+		MPEModulator& parent;
+	};
+
+	void processWithExpressionStore(MPEState& s, float* data, int startSample, int numSamples);
+	float getTableValue(float normalisedValue) const { return table->getInterpolatedValue(normalisedValue * (float)SAMPLE_LOOKUP_TABLE_SIZE); }
+
 	void updateSmoothingTime(float newTime);
 	MPEState * getState(int voiceIndex);
 	const MPEState * getState(int voiceIndex) const;
@@ -234,7 +267,11 @@ private:
 	Gesture g;
 	float smoothedIntensity;
 
+	int expressionLane = -1;
+	std::atomic<bool> tableIsLinear { true };
+
 	ScopedPointer<SampleLookupTable> table;
+	TableWatcher tableWatcher;
 
 	
 
@@ -42,17 +42,27 @@ void fix_delay::prepare(PrepareSpecs ps)
 	if (delayLines.size() != ps.numChannels)
 	{
 		delayLines.clear();
+		taps.clear();
 
 		for (int i = 0; i < ps.numChannels; i++)
-			delayLines.add(new DelayLine<>());
+		{
+			delayLines.add(new ModulatedDelayLine());
+			taps.add(ModulatedDelayLine::CrossfadeTap());
+		}
 	}
 
-	reset();
+	sampleRate = ps.sampleRate;
 
 	for (auto d : delayLines)
-		d->prepareToPlay(ps.sampleRate);
+	{
+		d->setMaxDelaySamples((int)(MaxDelayTimeSeconds * sampleRate), ps.blockSize);
+		d->setInterpolation(ModulatedDelayLine::Interpolation::None);
+	}
 
 	setDelayTimeMilliseconds(delayTimeSeconds * 1000.0);
+	setFadeTimeMilliseconds(fadeTimeSamples);
+
+	reset();
 }
 
 void fix_delay::createParameters(Array<ParameterData>& data)
@@ -78,6 +88,9 @@ void fix_delay::reset() noexcept
 {
 	for (auto d : delayLines)
 		d->clear();
+
+	for (auto& t : taps)
+		t.reset();
 }
 
 void fix_delay::process(ProcessData& d) noexcept
@@ -86,28 +99,34 @@ void fix_delay::process(ProcessData& d) noexcept
 
 	for (int i = 0; i < delayLines.size(); i++)
 	{
-		delayLines[i]->processBlock(d.data[i], d.size);
+		delayLines[i]->pushBlock(d.data[i], d.size);
+		taps.getReference(i).read(*delayLines[i], d.data[i], d.size, ModulatedDelayLine::ReadPosition::AfterPush);
 	}
 }
 
 void fix_delay::processSingle(float* numFrames, int numChannels) noexcept
 {
 	for (int i = 0; i < numChannels; i++)
-		numFrames[i] = delayLines[i]->getDelayedValue(numFrames[i]);
+	{
+		delayLines[i]->pushSample(numFrames[i]);
+		taps.getReference(i).read(*delayLines[i], numFrames + i, 1, ModulatedDelayLine::ReadPosition::AfterPush);
+	}
 }
 
 void fix_delay::setDelayTimeMilliseconds(double newValue)
 {
 	delayTimeSeconds = newValue * 0.001;
 
-	for (auto d : delayLines)
-		d->setDelayTimeSeconds(delayTimeSeconds);
+	for (auto& t : taps)
+		t.setDelayTimeSamples((float)(delayTimeSeconds * sampleRate));
 }
 
 void fix_delay::setFadeTimeMilliseconds(double newValue)
 {
-	for (auto d : delayLines)
-		d->setFadeTimeSamples((int)newValue);
+	fadeTimeSamples = newValue;
+
+	for (auto& t : taps)
+		t.setFadeTimeSamples((int)newValue);
 }
 
 }
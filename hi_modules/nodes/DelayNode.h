@@ -57,9 +57,14 @@ struct fix_delay : public HiseDspBase
 	void setFadeTimeMilliseconds(double newValue);
 	void createParameters(Array<ParameterData>& data) override;
 
-	OwnedArray<DelayLine<>> delayLines;
+	static constexpr double MaxDelayTimeSeconds = 1.0;
+
+	OwnedArray<ModulatedDelayLine> delayLines;
+	Array<ModulatedDelayLine::CrossfadeTap> taps;
 	
 	double delayTimeSeconds = 0.1;
+	double fadeTimeSamples = 512.0;
+	double sampleRate = 44100.0;
 };
 }
 
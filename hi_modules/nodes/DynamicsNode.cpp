@@ -39,22 +39,17 @@ namespace dynamics
 
 struct DynamicHelpers
 {
-	static Identifier getId(chunkware_simple::SimpleGate*)
+	static Identifier getId(BlockGate*)
 	{
 		RETURN_STATIC_IDENTIFIER("gate");
 	}
 
-	static Identifier getId(chunkware_simple::SimpleComp*)
+	static Identifier getId(BlockCompressor*)
 	{
 		RETURN_STATIC_IDENTIFIER("comp");
 	}
 
-	static Identifier getId(chunkware_simple::SimpleCompRms*)
-	{
-		RETURN_STATIC_IDENTIFIER("comp_rms");
-	}
-
-	static Identifier getId(chunkware_simple::SimpleLimit*)
+	static Identifier getId(BlockLimiter*)
 	{
 		RETURN_STATIC_IDENTIFIER("limiter");
 	}
@@ -118,6 +113,21 @@ void dynamics_wrapper<DynamicProcessorType>::createParameters(Array<ParameterDat
 
 		data.add(std::move(p));
 	}
+
+	// The limiter always uses the peak detection
+	if (!std::is_same<DynamicProcessorType, BlockLimiter>::value)
+	{
+		ParameterData p("RMS");
+		p.range = { 0.0, 1.0, 1.0 };
+		p.defaultValue = 0.0;
+
+		p.db = [this](double newValue)
+		{
+			obj.setDetection(newValue > 0.5 ? BlockDynamics::Detection::Rms : BlockDynamics::Detection::Peak);
+		};
+
+		data.add(std::move(p));
+	}
 }
 
 template <class DynamicProcessorType>
@@ -148,26 +158,8 @@ void dynamics_wrapper<DynamicProcessorType>::reset() noexcept
 template <class DynamicProcessorType>
 void dynamics_wrapper<DynamicProcessorType>::process(ProcessData& d)
 {
-	if (d.numChannels >= 2)
-	{
-		for (int i = 0; i < d.size; i++)
-		{
-			double v[2] = { d.data[0][i], d.data[1][i] };
-			obj.process(v[0], v[1]);
-			d.data[0][i] = (float)v[0];
-			d.data[1][i] = (float)v[1];
-		}
-	}
-	else if (d.numChannels == 1)
-	{
-		for (int i = 0; i < d.size; i++)
-		{
-			double v[2] = { d.data[0][i], d.data[0][i] };
-			obj.process(v[0], v[1]);
-			d.data[0][i] = (float)v[0];
-
-		}
-	}
+	if (d.numChannels > 0)
+		obj.processBlock(d.data, jmin(2, d.numChannels), d.size);
 }
 
 template <class DynamicProcessorType>
@@ -194,9 +186,9 @@ dynamics_wrapper<DynamicProcessorType>::dynamics_wrapper()
 
 }
 
-DEFINE_EXTERN_MONO_TEMPIMPL(dynamics_wrapper<chunkware_simple::SimpleGate>);
-DEFINE_EXTERN_MONO_TEMPIMPL(dynamics_wrapper<chunkware_simple::SimpleComp>);
-DEFINE_EXTERN_MONO_TEMPIMPL(dynamics_wrapper<chunkware_simple::SimpleLimit>);
+DEFINE_EXTERN_MONO_TEMPIMPL(dynamics_wrapper<BlockGate>);
+DEFINE_EXTERN_MONO_TEMPIMPL(dynamics_wrapper<BlockCompressor>);
+DEFINE_EXTERN_MONO_TEMPIMPL(dynamics_wrapper<BlockLimiter>);
 
 envelope_follower::envelope_follower() :
 	envelope(20.0, 50.0)
@@ -84,9 +84,9 @@ public:
 };
 
 
-DEFINE_EXTERN_MONO_TEMPLATE(gate, dynamics_wrapper<chunkware_simple::SimpleGate>);
-DEFINE_EXTERN_MONO_TEMPLATE(comp, dynamics_wrapper<chunkware_simple::SimpleComp>);
-DEFINE_EXTERN_MONO_TEMPLATE(limiter, dynamics_wrapper<chunkware_simple::SimpleLimit>);
+DEFINE_EXTERN_MONO_TEMPLATE(gate, dynamics_wrapper<BlockGate>);
+DEFINE_EXTERN_MONO_TEMPLATE(comp, dynamics_wrapper<BlockCompressor>);
+DEFINE_EXTERN_MONO_TEMPLATE(limiter, dynamics_wrapper<BlockLimiter>);
 ;
 }
 
@@ -564,5 +564,125 @@ void reverb::setSize(double size)
 	r.setParameters(p);
 }
 
+fdn_reverb::fdn_reverb()
+{
+
+}
+
+void fdn_reverb::initialise(NodeBase* )
+{
+
+}
+
+void fdn_reverb::prepare(PrepareSpecs ps)
+{
+	r.prepare(ps.sampleRate);
+}
+
+void fdn_reverb::process(ProcessData& d)
+{
+	if (d.numChannels == 2)
+		r.processStereo(d.data[0], d.data[1], d.size);
+	else if (d.numChannels == 1)
+		r.processMono(d.data[0], d.size);
+}
+
+void fdn_reverb::reset() noexcept
+{
+	r.reset();
+}
+
+void fdn_reverb::processSingle(float* numFrames, int numChannels)
+{
+	if (numChannels == 2)
+		r.processStereo(numFrames, numFrames + 1, 1);
+	else if (numChannels == 1)
+		r.processMono(numFrames, 1);
+}
+
+bool fdn_reverb::handleModulation(double&) noexcept
+{
+	return false;
+}
+
+void fdn_reverb::createParameters(Array<ParameterData>& data)
+{
+	{
+		ParameterData p("Size");
+		p.range = { 0.0, 1.0, 0.01 };
+		p.defaultValue = 0.5f;
+		p.db = BIND_MEMBER_FUNCTION_1(fdn_reverb::setSize);
+		data.add(std::move(p));
+	}
+
+	{
+		ParameterData p("Decay");
+		p.range = { 100.0, 20000.0, 1.0 };
+		p.range.setSkewForCentre(2000.0);
+		p.defaultValue = 2000.0f;
+		p.db = BIND_MEMBER_FUNCTION_1(fdn_reverb::setDecay);
+		data.add(std::move(p));
+	}
+
+	{
+		ParameterData p("Damping");
+		p.range = { 0.0, 1.0, 0.01 };
+		p.defaultValue = 0.5f;
+		p.db = BIND_MEMBER_FUNCTION_1(fdn_reverb::setDamping);
+		data.add(std::move(p));
+	}
+
+	{
+		ParameterData p("Modulation");
+		p.range = { 0.0, 1.0, 0.01 };
+		p.defaultValue = 0.3f;
+		p.db = BIND_MEMBER_FUNCTION_1(fdn_reverb::setModulation);
+		data.add(std::move(p));
+	}
+
+	{
+		ParameterData p("Width");
+		p.range = { 0.0, 1.0, 0.01 };
+		p.defaultValue = 1.0f;
+		p.db = BIND_MEMBER_FUNCTION_1(fdn_reverb::setWidth);
+		data.add(std::move(p));
+	}
+}
+
+void fdn_reverb::setSize(double size)
+{
+	auto p = r.getParameters();
+	p.roomSize = jlimit(0.0f, 1.0f, (float)size);
+	r.setParameters(p);
+}
+
+void fdn_reverb::setDecay(double decayMs)
+{
+	auto p = r.getParameters();
+	p.decayTime = jmax(0.1f, (float)decayMs * 0.001f);
+	r.setParameters(p);
+}
+
+void fdn_reverb::setDamping(double newDamping)
+{
+	auto p = r.getParameters();
+	p.damping = jlimit(0.0f, 1.0f, (float)newDamping);
+	r.setParameters(p);
+}
+
+void fdn_reverb::setModulation(double modulation)
+{
+	auto p = r.getParameters();
+	p.modulation = jlimit(0.0f, 1.0f, (float)modulation);
+	r.setParameters(p);
+}
+
+void fdn_reverb::setWidth(double width)
+{
+	auto p = r.getParameters();
+	p.width = jlimit(0.0f, 1.0f, (float)width);
+	r.setParameters(p);
+}
+
 }
 }
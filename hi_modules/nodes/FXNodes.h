@@ -177,6 +177,40 @@ private:
 
 };
 
+/** A reverb node that uses the feedback delay network of the FDN Reverb effect.
+*
+*	Like the reverb node, it renders only the wet signal.
+*/
+class fdn_reverb : public HiseDspBase
+{
+public:
+
+	SET_HISE_NODE_EXTRA_HEIGHT(0);
+	SET_HISE_NODE_ID("fdn_reverb");
+	GET_SELF_AS_OBJECT(fdn_reverb);
+	SET_HISE_NODE_IS_MODULATION_SOURCE(false);
+
+	fdn_reverb();
+
+	void initialise(NodeBase* n);
+	void prepare(PrepareSpecs ps);
+	void process(ProcessData& d);
+	void reset() noexcept;
+	void processSingle(float* numFrames, int numChannels);
+	bool handleModulation(double&) noexcept;
+	void createParameters(Array<ParameterData>& data) override;
+
+	void setSize(double size);
+	void setDecay(double decayMs);
+	void setDamping(double newDamping);
+	void setModulation(double modulation);
+	void setWidth(double width);
+
+private:
+
+	FdnReverb r;
+};
+
 
 template <int V> class haas_impl : public HiseDspBase
 {
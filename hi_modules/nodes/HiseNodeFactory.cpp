@@ -71,6 +71,7 @@ Factory::Factory(DspNetwork* network) :
 	registerPolyNode<haas, haas_poly>({});
 	registerPolyNode<phase_delay, phase_delay_poly>({});
 	registerNode<reverb>({});
+	registerNode<fdn_reverb>({});
 	
 }
 
@@ -42,7 +42,17 @@ ModulatorSynth(mc, id, numVoices)
 	// Do not expand the values, but leave them compressed for the receivers to expand them...
 	modChains[BasicChains::GainChain].setExpandToAudioRate(false);
 
-	
+	// The envelopes are rendered separately for each voice into the EnvelopeData slots...
+	modChains[BasicChains::GainChain].setRenderPolyphonicEnvelopes(false);
+	modChains[BasicChains::GainChain].setIncludeMonophonicValuesInVoiceRendering(false);
+
+	for (int i = 0; i < NUM_POLYPHONIC_VOICES; i++)
+		eventIdsForVoices[i] = -1;
+
+	slotsForEventIds.malloc(HISE_EVENT_ID_ARRAY_SIZE);
+
+	for (int i = 0; i < HISE_EVENT_ID_ARRAY_SIZE; i++)
+		slotsForEventIds[i] = -1;
 
 	for (int i = 0; i < numVoices; i++) addVoice(new GlobalModulatorContainerVoice(this));
 	addSound(new GlobalModulatorContainerSound());
@@ -95,6 +105,19 @@ const float * GlobalModulatorContainer::getModulationValuesForModulator(Processo
 	return nullptr;
 }
 
+const float* GlobalModulatorContainer::getSharedModulationValuesForModulator(const Processor* p, int startIndex) const
+{
+	const double blockTimestamp = getMainController()->getUptime();
+
+	for (const auto& tv : timeVariantData)
+	{
+		if (tv.getModulatorUnchecked() == p)
+			return tv.getPublishedReadPointer(startIndex, blockTimestamp);
+	}
+
+	return nullptr;
+}
+
 float GlobalModulatorContainer::getConstantVoiceValue(Processor *p, int noteNumber)
 {
 	for (auto& vd : voiceStartData)
@@ -108,6 +131,56 @@ float GlobalModulatorContainer::getConstantVoiceValue(Processor *p, int noteNumb
 	return 1.0f;
 }
 
+float GlobalModulatorContainer::getVoiceStartValueForEvent(Processor* p, const HiseEvent& e)
+{
+	const int voiceIndex = getVoiceIndexForEventId(e.getEventId());
+
+	for (auto& vd : voiceStartData)
+	{
+		if (vd.getModulator() == p)
+		{
+			if (voiceIndex != -1)
+				return vd.getValueForContainerVoice(voiceIndex);
+
+			return vd.getConstantVoiceValue(e.getNoteNumber());
+		}
+	}
+
+	jassertfalse;
+
+	return 1.0f;
+}
+
+int GlobalModulatorContainer::getVoiceIndexForEventId(uint16 eventId) const
+{
+	const int slot = slotsForEventIds[eventId % HISE_EVENT_ID_ARRAY_SIZE];
+
+	// The event ids wrap around, so check that the slot still belongs to this event
+	if (slot != -1 && eventIdsForVoices[slot] == (int)eventId)
+		return slot;
+
+	return -1;
+}
+
+const float* GlobalModulatorContainer::getEnvelopeValuesForVoice(const Processor* p, int voiceIndex, uint16 eventId, int startIndex) const
+{
+	if (!isEnvelopeVoiceActive(voiceIndex, eventId))
+		return nullptr;
+
+	for (auto ed : envelopeData)
+	{
+		if (ed->getModulatorUnchecked() == p)
+			return ed->getReadPointer(voiceIndex, startIndex);
+	}
+
+	return nullptr;
+}
+
+bool GlobalModulatorContainer::isEnvelopeVoiceActive(int voiceIndex, uint16 eventId) const
+{
+	return isPositiveAndBelow(voiceIndex, NUM_POLYPHONIC_VOICES) && eventIdsForVoices[voiceIndex] == (int)eventId;
+}
+
 ProcessorEditorBody* GlobalModulatorContainer::createEditor(ProcessorEditor *parentEditor)
 {
 
@@ -125,12 +198,40 @@ void GlobalModulatorContainer::preStartVoice(int voiceIndex, const HiseEvent& e)
 {
 	ModulatorSynth::preStartVoice(voiceIndex, e);
 
+	if (isPositiveAndBelow(voiceIndex, NUM_POLYPHONIC_VOICES))
+	{
+		eventIdsForVoices[voiceIndex] = (int)e.getEventId();
+		slotsForEventIds[e.getEventId() % HISE_EVENT_ID_ARRAY_SIZE] = (int16)voiceIndex;
+	}
+
 	for (auto& vd : voiceStartData)
 	{
 		vd.saveValue(e.getNoteNumber(), voiceIndex);
 	}
 }
 
+void GlobalModulatorContainer::preHiseEventCallback(const HiseEvent& e)
+{
+	ModulatorSynth::preHiseEventCallback(e);
+
+	if (e.isNoteOff())
+	{
+		const int slot = getVoiceIndexForEventId(e.getEventId());
+
+		// If the voice hasn't been rendered yet, it will be stopped by the note off
+		if (slot != -1 && static_cast<ModulatorSynthVoice*>(getVoice(slot))->isInactive())
+			modChains[GainChain].stopVoice(slot);
+	}
+	else if (e.isAllNotesOff())
+	{
+		for (int i = 0; i < jmin(getNumVoices(), NUM_POLYPHONIC_VOICES); i++)
+		{
+			if (isEnvelopeSlotBusy(i))
+				clearEnvelopeSlot(i);
+		}
+	}
+}
+
 void GlobalModulatorContainer::preVoiceRendering(int startSample, int numThisTime)
 {
 	int startSample_cr = startSample / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR;
@@ -138,6 +239,8 @@ void GlobalModulatorContainer::preVoiceRendering(int startSample, int numThisTim
 	
 	auto scratchBuffer = modChains[GainChain].getScratchBuffer();
 
+	const double blockTimestamp = getMainController()->getUptime();
+
 	for (auto& tv : timeVariantData)
 	{
 		if (auto mod = tv.getModulator())
@@ -153,8 +256,78 @@ void GlobalModulatorContainer::preVoiceRendering(int startSample, int numThisTim
 			{
 				tv.clear();
 			}
+
+			tv.publish(blockTimestamp);
+		}
+	}
+
+	renderEnvelopeSlots(startSample, numThisTime);
+}
+
+void GlobalModulatorContainer::renderEnvelopeSlots(int startSample, int numSamples)
+{
+	const int startSample_cr = startSample / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR;
+	const int numSamples_cr = numSamples / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR;
+
+	auto scratchBuffer = modChains[GainChain].getScratchBuffer();
+
+	const int numSlots = jmin(getNumVoices(), NUM_POLYPHONIC_VOICES);
+
+	for (int i = 0; i < numSlots; i++)
+	{
+		if (!isEnvelopeSlotBusy(i))
+			continue;
+
+		// Finished slots are cleared at the start of the next block so that the targets can read the last values
+		if (startSample == 0 && !isEnvelopeSlotPlaying(i))
+		{
+			clearEnvelopeSlot(i);
+			continue;
+		}
+
+		for (auto ed : envelopeData)
+		{
+			if (auto mod = ed->getModulator())
+			{
+				auto voiceBuffer = ed->initialiseBuffer(i, startSample_cr, numSamples_cr);
+
+				if (!mod->isBypassed())
+					mod->render(i, voiceBuffer, scratchBuffer, startSample_cr, numSamples_cr);
+			}
+		}
+	}
+}
+
+bool GlobalModulatorContainer::isEnvelopeSlotBusy(int voiceIndex) const
+{
+	return isPositiveAndBelow(voiceIndex, NUM_POLYPHONIC_VOICES) && eventIdsForVoices[voiceIndex] != -1;
+}
+
+bool GlobalModulatorContainer::isEnvelopeSlotPlaying(int voiceIndex) const
+{
+	for (auto ed : envelopeData)
+	{
+		if (auto mod = ed->getModulator())
+		{
+			if (!mod->isBypassed() && mod->isPlaying(voiceIndex))
+				return true;
 		}
 	}
+
+	return false;
+}
+
+void GlobalModulatorContainer::clearEnvelopeSlot(int voiceIndex)
+{
+	jassert(isEnvelopeSlotBusy(voiceIndex));
+
+	auto& slot = slotsForEventIds[eventIdsForVoices[voiceIndex] % HISE_EVENT_ID_ARRAY_SIZE];
+
+	if (slot == voiceIndex)
+		slot = -1;
+
+	eventIdsForVoices[voiceIndex] = -1;
+	modChains[GainChain].resetVoice(voiceIndex);
 }
 
 void GlobalModulatorContainer::prepareToPlay(double newSampleRate, int samplesPerBlock)
@@ -164,6 +337,9 @@ void GlobalModulatorContainer::prepareToPlay(double newSampleRate, int samplesPe
 	for (auto& d : timeVariantData)
 		d.prepareToPlay(samplesPerBlock);
 
+	for (auto ed : envelopeData)
+		ed->prepareToPlay(samplesPerBlock);
+
 	for (int i = 0; i < data.size(); i++)
 	{
 		data[i]->prepareToPlay(newSampleRate, samplesPerBlock);
@@ -267,6 +443,23 @@ void GlobalModulatorContainer::refreshList()
 		timeVariantData.add(TimeVariantData(mod, getLargestBlockSize()));
 		//mod->deactivateIntensitySmoothing();
 	}
+
+	OwnedArray<EnvelopeData> newEnvelopeData;
+
+	for (auto& mod : handler_->activeEnvelopesList)
+	{
+		newEnvelopeData.add(new EnvelopeData(mod, getNumVoices(), getLargestBlockSize()));
+	}
+
+	{
+		ScopedLock sl(getMainController()->getLock());
+		envelopeData.swapWith(newEnvelopeData);
+	}
+}
+
+bool GlobalModulatorContainerVoice::canPlaySound(SynthesiserSound *)
+{
+	return !static_cast<GlobalModulatorContainer*>(getOwnerSynth())->isEnvelopeSlotBusy(getVoiceIndex());
 }
 
 void GlobalModulatorContainerVoice::startNote(int midiNoteNumber, float /*velocity*/, SynthesiserSound*, int /*currentPitchWheelPosition*/)
@@ -280,11 +473,10 @@ void GlobalModulatorContainerVoice::startNote(int midiNoteNumber, float /*veloci
 
 void GlobalModulatorContainerVoice::calculateBlock(int startSample, int numSamples)
 {
-
-	
 	FloatVectorOperations::fill(voiceBuffer.getWritePointer(0, startSample), 0.0f, numSamples);
 	FloatVectorOperations::fill(voiceBuffer.getWritePointer(1, startSample), 0.0f, numSamples);
 
+	// The envelopes keep running in the container's envelope slot (see renderEnvelopeSlots())
 	resetVoice();
 }
 
@@ -52,11 +52,15 @@ public:
 		ModulatorSynthVoice(ownerSynth)
 	{};
 
-	bool canPlaySound(SynthesiserSound *) override { return true; };
+	/** Returns false while the envelope slot of this voice is still busy with a previous note. */
+	bool canPlaySound(SynthesiserSound *) override;
 
 	void startNote(int midiNoteNumber, float /*velocity*/, SynthesiserSound*, int /*currentPitchWheelPosition*/) override;
 	void calculateBlock(int startSample, int numSamples) override;;
 
+	/** The envelope state lives in the container's envelope slot, which is reset when the envelopes are finished. */
+	void resetEnvelopes() override {};
+
 };
 
 template <class ModulatorType> class GlobalModulatorDataBase
@@ -80,6 +84,12 @@ public:
 		return static_cast<ModulatorType*>(mod.get());
 	}
 
+	/** Returns the modulator without a cast. Use this only for comparing pointers. */
+	const Modulator* getModulatorUnchecked() const
+	{
+		return mod.get();
+	}
+
 private:
 
 	WeakReference<Modulator> mod;
@@ -94,19 +104,35 @@ public:
 		GlobalModulatorDataBase(mod)
 	{
 		FloatVectorOperations::clear(voiceValues, 128);
+		FloatVectorOperations::fill(valuesForContainerVoice, 1.0f, NUM_POLYPHONIC_VOICES);
 	}
 
 	void saveValue(int noteNumber, int voiceIndex)
 	{
 		if (auto m = getModulator())
 		{
+			const float v = m->getVoiceStartValue(voiceIndex);
+
 			if (isPositiveAndBelow(noteNumber, 128))
-			{
-				voiceValues[noteNumber] = m->getVoiceStartValue(voiceIndex);
-			}
+				voiceValues[noteNumber] = v;
+
+			if (isPositiveAndBelow(voiceIndex, NUM_POLYPHONIC_VOICES))
+				valuesForContainerVoice[voiceIndex] = v;
 		}
 	}
 
+	/** Returns the value that was calculated for the given container voice.
+	*
+	*	Unlike getConstantVoiceValue(), this doesn't get overwritten by another note with the same note number.
+	*/
+	float getValueForContainerVoice(int voiceIndex) const
+	{
+		if (isPositiveAndBelow(voiceIndex, NUM_POLYPHONIC_VOICES))
+			return valuesForContainerVoice[voiceIndex];
+
+		return 1.0f;
+	}
+
 	float getConstantVoiceValue(int noteNumber) const
 	{
 		if (isPositiveAndBelow(noteNumber, 128))
@@ -118,6 +144,7 @@ public:
 	}
 
 	float voiceValues[128];
+	float valuesForContainerVoice[NUM_POLYPHONIC_VOICES];
 };
 
 class TimeVariantData : public GlobalModulatorDataBase<TimeVariantModulator>
@@ -166,10 +193,86 @@ public:
 		}
 	}
 
+	/** Marks the values as valid for the block with the given timestamp.
+	*
+	*	Call this after the values have been written so that targets can read them directly
+	*	with getPublishedReadPointer() without copying them first. The release fence pairs with
+	*	the acquire fence in getPublishedReadPointer() so that a target never reads the values
+	*	before they are written, even if it is rendered on another thread.
+	*/
+	void publish(double blockTimestamp) noexcept
+	{
+		std::atomic_thread_fence(std::memory_order_release);
+		publishedTimestamp = blockTimestamp;
+	}
+
+	/** Returns the values if they were published for the given block or nullptr if they are outdated. */
+	const float* getPublishedReadPointer(int startSample, double blockTimestamp) const noexcept
+	{
+		if (publishedTimestamp != blockTimestamp)
+			return nullptr;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return savedValuesForBlock.getReadPointer(0, startSample);
+	}
+
 private:
 
 	AudioSampleBuffer savedValuesForBlock;
 	bool isClear = false;
+	double publishedTimestamp = -1.0;
+};
+
+/** Stores the values of a polyphonic envelope for each voice of the container.
+*
+*	The voices are tracked by event id, so a GlobalEnvelopeModulator can pick up the
+*	values of the container voice that was started by the same note on message.
+*/
+class EnvelopeData : public GlobalModulatorDataBase<EnvelopeModulator>
+{
+public:
+
+	EnvelopeData(Modulator* mod, int numVoices, int samplesPerBlock) :
+		GlobalModulatorDataBase(mod),
+		valuesForVoices(numVoices, 0)
+	{
+		prepareToPlay(samplesPerBlock);
+	}
+
+	void prepareToPlay(int samplesPerBlock)
+	{
+		// The envelope values are stored at control rate
+		const int numValues = samplesPerBlock / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR + 1;
+
+		if (numValues > valuesForVoices.getNumSamples())
+		{
+			valuesForVoices.setSize(valuesForVoices.getNumChannels(), numValues);
+			valuesForVoices.clear();
+		}
+	}
+
+	float* initialiseBuffer(int voiceIndex, int startSample_cr, int numSamples_cr)
+	{
+		jassert(isPositiveAndBelow(voiceIndex, valuesForVoices.getNumChannels()));
+
+		auto wp = valuesForVoices.getWritePointer(voiceIndex, 0);
+		FloatVectorOperations::fill(wp + startSample_cr, 1.0f, numSamples_cr);
+		return wp;
+	}
+
+	void clearVoice(int voiceIndex, int startSample_cr, int numSamples_cr)
+	{
+		FloatVectorOperations::clear(valuesForVoices.getWritePointer(voiceIndex, startSample_cr), numSamples_cr);
+	}
+
+	const float* getReadPointer(int voiceIndex, int startSample_cr) const
+	{
+		return valuesForVoices.getReadPointer(voiceIndex, startSample_cr);
+	}
+
+private:
+
+	AudioSampleBuffer valuesForVoices;
 };
 
 class GlobalModulatorData
@@ -340,14 +443,39 @@ public:
 	void restoreFromValueTree(const ValueTree &v) override;
 
 	const float *getModulationValuesForModulator(Processor *p, int startIndex);
+
+	/** Returns a read-only pointer to the values of the time variant modulator for the current block.
+	*
+	*	This returns nullptr if the modulator hasn't been rendered by this container in the current block 
+	*	(eg. because the container is processed after the target), so you need to fall back to getModulationValuesForModulator().
+	*/
+	const float* getSharedModulationValuesForModulator(const Processor* p, int startIndex) const;
+
 	float getConstantVoiceValue(Processor *p, int noteNumber);
 
+	/** Returns the voice start value that was calculated for the voice with the given event id. 
+	*
+	*	If there is no voice for the event, it returns the last value for the note number. 
+	*/
+	float getVoiceStartValueForEvent(Processor* p, const HiseEvent& e);
+
+	/** Returns the envelope slot that was started with the given event id or -1. */
+	int getVoiceIndexForEventId(uint16 eventId) const;
+
+	/** Returns the envelope values of the given container voice or nullptr if the voice is not active anymore. */
+	const float* getEnvelopeValuesForVoice(const Processor* p, int voiceIndex, uint16 eventId, int startIndex) const;
+
+	/** Checks if the voice that was started with the given event is still playing. */
+	bool isEnvelopeVoiceActive(int voiceIndex, uint16 eventId) const;
+
 	ProcessorEditorBody* createEditor(ProcessorEditor *parentEditor) override;
 
 	void changeListenerCallback(SafeChangeBroadcaster *) { refreshList(); }
 
 	void preStartVoice(int voiceIndex, const HiseEvent& e) final override;
 
+	void preHiseEventCallback(const HiseEvent& e) override;
+
 	void preVoiceRendering(int startSample, int numThisTime) override;
 
 	void addProcessorsWhenEmpty() override {};
@@ -367,8 +495,25 @@ public:
 
 private:
 
+	/** Renders the envelopes of every busy slot. 
+	*
+	*	The container voices are reset after their first block, so the envelopes are started, 
+	*	stopped and rendered with the voice index as slot index until they are finished. 
+	*/
+	void renderEnvelopeSlots(int startSample, int numSamples);
+
+	bool isEnvelopeSlotBusy(int voiceIndex) const;
+
+	bool isEnvelopeSlotPlaying(int voiceIndex) const;
+
+	void clearEnvelopeSlot(int voiceIndex);
+
 	Array<VoiceStartData> voiceStartData;
 	Array<TimeVariantData> timeVariantData;
+	OwnedArray<EnvelopeData> envelopeData;
+
+	int eventIdsForVoices[NUM_POLYPHONIC_VOICES];
+	HeapBlock<int16> slotsForEventIds;
 
 	Array<WeakReference<ModulatorListListener>> modListeners;
 
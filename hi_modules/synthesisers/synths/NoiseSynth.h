@@ -107,6 +107,9 @@ public:
 
 	NoiseSynth(MainController *mc, const String &id, int numVoices);
 
+	/** The voices apply the effect chain after the gain modulation. */
+	bool canBatchVoiceEffects() const override { return true; }
+
 	void setTestSignal(TestSignal newSignalType)
 	{
 #if !HI_RUN_UNIT_TESTS
@@ -158,6 +158,9 @@ public:
 
 	SineSynth(MainController *mc, const String &id, int numVoices);;
 
+	/** The voices apply the effect chain after the gain modulation. */
+	bool canBatchVoiceEffects() const override { return true; }
+
 	void restoreFromValueTree(const ValueTree &v) override
 	{
 		ModulatorSynth::restoreFromValueTree(v);
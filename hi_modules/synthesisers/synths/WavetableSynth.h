@@ -213,6 +213,9 @@ public:
 
 	SET_PROCESSOR_NAME("WavetableSynth", "Wavetable Synthesiser", "A two-dimensional wavetable synthesiser.");
 
+	/** The voices apply the effect chain after the gain modulation. */
+	bool canBatchVoiceEffects() const override { return true; }
+
 	enum EditorStates
 	{
 		TableIndexChainShow = ModulatorSynth::numEditorStates
@@ -752,6 +752,8 @@ void ModulatorSampler::setVoiceAmountInternal()
 	{
 		deleteAllVoices();
 
+		getVoiceStealer().setNumVoices(voiceAmount);
+
 		for (int i = 0; i < voiceAmount; i++)
 		{
 
@@ -972,19 +974,23 @@ void ModulatorSampler::handleRetriggeredNote(ModulatorSynthVoice *voice)
 	case RepeatMode::NoteOff:		voice->stopNote(1.0f, true); break;
 	case RepeatMode::KillSecondOldestNote:
 	{
-		int noteNumber = voice->getCurrentlyPlayingNote();
 		auto uptime = voice->getVoiceUptime();
 
-		for (auto v : activeVoices)
+		// Killing a voice changes the same note list, so collect the voices first
+		int voicesToKill[NUM_POLYPHONIC_VOICES];
+		int numVoicesToKill = 0;
+
+		getVoiceStealer().forEachVoiceWithSameNote(voice->getCurrentlyPlayingNote(), [&](int voiceIndex)
 		{
-			auto thisNumber = v->getCurrentlyPlayingNote();
-			auto thisUptime = v->getVoiceUptime();
+			auto v = static_cast<ModulatorSynthVoice*>(getVoice(voiceIndex));
+
+			if (v != nullptr && v->getVoiceUptime() < uptime && numVoicesToKill < NUM_POLYPHONIC_VOICES)
+				voicesToKill[numVoicesToKill++] = voiceIndex;
+		});
+
+		for (int i = 0; i < numVoicesToKill; i++)
+			static_cast<ModulatorSynthVoice*>(getVoice(voicesToKill[i]))->killVoice();
 
-			if (noteNumber == thisNumber && thisUptime < uptime)
-			{
-				v->killVoice();
-			}
-		}
 		break;
 	}
     default: jassertfalse; break;
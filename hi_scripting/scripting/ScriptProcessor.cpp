@@ -1207,9 +1207,14 @@ void JavascriptProcessor::registerCallbacks()
 
 	const double bufferTime = (double)p->getLargestBlockSize() / p->getSampleRate() * 1000.0;
 
+	auto& profiler = mainController->getPerformanceProfiler();
+
 	for (int i = 0; i < getNumSnippets(); i++)
 	{
-		scriptEngine->registerCallbackName(getSnippet(i)->getCallbackName(), getSnippet(i)->getNumArgs(), bufferTime);
+		auto callbackName = getSnippet(i)->getCallbackName();
+		auto profilerSource = profiler.registerSource(p->getId() + "." + callbackName.toString(), PerformanceProfiler::Category::ScriptCallback);
+
+		scriptEngine->registerCallbackName(callbackName, getSnippet(i)->getNumArgs(), bufferTime, profilerSource);
 	}
 }
 
@@ -894,6 +894,9 @@ public:
 		
 	~JavascriptSynthesiser();
 
+	/** The voices apply the effect chain after the gain modulation. */
+	bool canBatchVoiceEffects() const override { return true; }
+
 	Path getSpecialSymbol() const override;
 
 	ProcessorEditorBody *createEditor(ProcessorEditor *parentEditor)  override;
@@ -60,6 +60,737 @@ public:
 		testDspInstances();
 
 		testCircularBuffers();
+
+		testBatchedPolyFilter();
+
+		testCurveEqCascade();
+
+		testMatrixConvolver();
+
+		testMultiStageConvolver();
+
+		testBlockDynamics();
+
+		testModulatedDelayLine();
+
+		testFdnReverb();
+	}
+
+	void testBatchedPolyFilter()
+	{
+		beginTest("Testing the batched poly filter against the per voice filters");
+
+		const FilterBank::FilterMode modes[] = { FilterBank::StateVariableLP, FilterBank::StateVariableNotch,
+												 FilterBank::LowPass, FilterBank::HighShelf };
+
+		constexpr int numVoices = 6;
+		constexpr int blockSize = 200;
+		constexpr int numBlocks = 8;
+		constexpr double sampleRate = 44100.0;
+
+		Random r(42);
+
+		for (auto m : modes)
+		{
+			if (!BatchedPolyFilter::isSupported(m))
+				continue;
+
+			BatchedPolyFilter batch(numVoices);
+			FilterBank reference(numVoices);
+
+			reference.setMode(m);
+			reference.setSampleRate(sampleRate);
+			reference.setFrequency(1000.0);
+			reference.setQ(1.0);
+			reference.setGain(1.0f);
+
+			batch.setMode(m);
+			batch.prepareToPlay(sampleRate, blockSize);
+			batch.setFrequency(1000.0);
+			batch.setQ(1.0);
+			batch.setGain(1.0);
+
+			OwnedArray<AudioSampleBuffer> referenceBuffers, batchBuffers;
+
+			for (int v = 0; v < numVoices; v++)
+			{
+				reference.reset(v);
+				batch.reset(v);
+
+				referenceBuffers.add(new AudioSampleBuffer(2, blockSize));
+				batchBuffers.add(new AudioSampleBuffer(2, blockSize));
+			}
+
+			float maxError = 0.0f;
+
+			for (int block = 0; block < numBlocks; block++)
+			{
+				// Changes the base parameters so that the smoothing is compared too
+				if (block == 2)
+				{
+					reference.setFrequency(3000.0);
+					reference.setQ(4.0);
+					reference.setGain(2.0f);
+					batch.setFrequency(3000.0);
+					batch.setQ(4.0);
+					batch.setGain(2.0);
+				}
+
+				batch.startBatch();
+
+				for (int v = 0; v < numVoices; v++)
+				{
+					auto& rb = *referenceBuffers[v];
+					auto& bb = *batchBuffers[v];
+
+					for (int c = 0; c < 2; c++)
+					{
+						for (int i = 0; i < blockSize; i++)
+							rb.setSample(c, i, 2.0f * r.nextFloat() - 1.0f);
+					}
+
+					bb.makeCopyOf(rb);
+
+					BatchedPolyFilter::ModulationValues mv;
+					mv.freqModValue = 0.2 + 0.8 * r.nextDouble();
+					mv.bipolarDelta = 0.01 * (r.nextDouble() - 0.5);
+					mv.gainModValue = 0.5 + r.nextDouble();
+					mv.qModValue = 0.5 + r.nextDouble();
+
+					FilterHelpers::RenderData rd(rb, 0, blockSize);
+					rd.voiceIndex = v;
+					rd.freqModValue = mv.freqModValue;
+					rd.bipolarDelta = mv.bipolarDelta;
+					rd.gainModValue = mv.gainModValue;
+					rd.qModValue = mv.qModValue;
+
+					reference.renderPoly(rd);
+
+					auto voiceValues = batch.addVoice(v, bb, 0, blockSize);
+
+					expect(voiceValues != nullptr, "Voice can't be added to the batch");
+
+					if (voiceValues != nullptr)
+						*voiceValues = mv;
+				}
+
+				batch.processBatch();
+
+				for (int v = 0; v < numVoices; v++)
+				{
+					for (int c = 0; c < 2; c++)
+					{
+						for (int i = 0; i < blockSize; i++)
+							maxError = jmax(maxError, std::abs(referenceBuffers[v]->getSample(c, i) - batchBuffers[v]->getSample(c, i)));
+					}
+				}
+			}
+
+			expect(maxError < 1e-4f, "Batched output of mode " + String((int)m) + " deviates by " + String(maxError));
+		}
+	}
+
+	void testCurveEqCascade()
+	{
+#if !HISE_USE_SVF_FOR_CURVE_EQ && JUCE_USE_SIMD
+		beginTest("Testing the fused CurveEq cascade against the per band filters");
+
+		ScopedValueSetter<bool> s(MainController::unitTestMode, true);
+
+		constexpr int blockSize = 256;
+		constexpr int numBlocks = 12;
+		constexpr double sampleRate = 44100.0;
+
+		ScopedPointer<BackendProcessor> bp = new BackendProcessor(nullptr, nullptr);
+		ScopedPointer<CurveEq> eq = new CurveEq(bp, "TestEq");
+
+		eq->prepareToPlay(sampleRate, blockSize);
+
+		const double frequencies[] = { 120.0, 800.0, 3000.0, 9000.0 };
+		const double gains[] = { 2.0, 0.5, 1.5, 0.7 };
+		const int types[] = { CurveEq::LowShelf, CurveEq::Peak, CurveEq::Peak, CurveEq::HighShelf };
+
+		constexpr int numBands = 4;
+
+		for (int i = 0; i < numBands; i++)
+		{
+			eq->addFilterBand(frequencies[i], gains[i]);
+			eq->setAttribute(eq->getParameterIndex(i, CurveEq::Type), (float)types[i], dontSendNotification);
+		}
+
+		AudioSampleBuffer b(2, blockSize);
+
+		// Lets the parameter smoothing settle so that the coefficients stay constant
+		for (int i = 0; i < (int)sampleRate / blockSize; i++)
+		{
+			b.clear();
+			eq->applyEffect(b, 0, blockSize);
+		}
+
+		IIRFilter reference[numBands][2];
+
+		for (int i = 0; i < numBands; i++)
+		{
+			for (auto& f : reference[i])
+				f.setCoefficients(eq->getFilterBand(i)->getCurrentCoefficients());
+		}
+
+		AudioSampleBuffer referenceBuffer(2, blockSize);
+		Random r(7);
+		float maxError = 0.0f;
+
+		for (int block = 0; block < numBlocks; block++)
+		{
+			// Disables the second band for a few blocks so that it must start with a cleared state again
+			if (block == 4)
+				eq->setAttribute(eq->getParameterIndex(1, CurveEq::Enabled), 0.0f, dontSendNotification);
+
+			if (block == 8)
+			{
+				eq->setAttribute(eq->getParameterIndex(1, CurveEq::Enabled), 1.0f, dontSendNotification);
+
+				for (auto& f : reference[1])
+					f.reset();
+			}
+
+			for (int c = 0; c < 2; c++)
+			{
+				for (int i = 0; i < blockSize; i++)
+					b.setSample(c, i, 2.0f * r.nextFloat() - 1.0f);
+			}
+
+			referenceBuffer.makeCopyOf(b);
+
+			eq->applyEffect(b, 0, blockSize);
+
+			for (int i = 0; i < numBands; i++)
+			{
+				if (!eq->getFilterBand(i)->isEnabled())
+					continue;
+
+				for (int c = 0; c < 2; c++)
+					reference[i][c].processSamples(referenceBuffer.getWritePointer(c), blockSize);
+			}
+
+			for (int c = 0; c < 2; c++)
+			{
+				for (int i = 0; i < blockSize; i++)
+					maxError = jmax(maxError, std::abs(referenceBuffer.getSample(c, i) - b.getSample(c, i)));
+			}
+		}
+
+		expect(maxError < 1e-4f, "Fused cascade deviates by " + String(maxError));
+#endif
+	}
+
+	void testMatrixConvolver()
+	{
+		beginTest("Testing the true stereo matrix convolver against four mono convolutions");
+
+		constexpr int irLength = 30000;
+		constexpr int blockSize = 100;
+		constexpr int numSamples = irLength + 20 * blockSize;
+
+		Random r(12);
+
+		// LL, LR, RL, RR
+		AudioSampleBuffer irs(4, irLength);
+
+		for (int p = 0; p < 4; p++)
+		{
+			for (int i = 0; i < irLength; i++)
+				irs.setSample(p, i, (2.0f * r.nextFloat() - 1.0f) * std::exp(-4.0f * (float)i / (float)irLength));
+		}
+
+		AudioSampleBuffer input(2, numSamples);
+
+		for (int c = 0; c < 2; c++)
+		{
+			for (int i = 0; i < numSamples; i++)
+				input.setSample(c, i, r.nextFloat() - 0.5f);
+		}
+
+		// The reference renders every path with its own uniform convolver
+		AudioSampleBuffer expected(2, numSamples);
+		AudioSampleBuffer pathOutput(1, numSamples);
+
+		expected.clear();
+
+		for (int p = 0; p < 4; p++)
+		{
+			const int inputIndex = p / 2;
+			const int outputIndex = p % 2;
+
+			fftconvolver::FFTConvolver mono(audiofft::ImplementationType::BestAvailable);
+			mono.init(128, irs.getReadPointer(p), irLength);
+			mono.process(input.getReadPointer(inputIndex), pathOutput.getWritePointer(0), numSamples);
+
+			expected.addFrom(outputIndex, 0, pathOutput, 0, 0, numSamples);
+		}
+
+		for (auto useBackgroundThread : { false, true })
+		{
+			MatrixConvolver matrix(audiofft::ImplementationType::BestAvailable);
+			matrix.setUseBackgroundThread(useBackgroundThread);
+
+			// The test runs faster than realtime, so it must wait for the workers instead of dropping blocks
+			matrix.setNonRealtime(true);
+
+			expect(matrix.init(128, 4096, 2, 2, irs.getArrayOfReadPointers(), irLength), "Can't initialise the matrix convolver");
+			expect(matrix.getIRMemoryUsage() > 0, "No memory usage reported");
+
+			AudioSampleBuffer output(2, numSamples);
+
+			for (int i = 0; i < numSamples; i += blockSize)
+			{
+				const float* in[2] = { input.getReadPointer(0, i), input.getReadPointer(1, i) };
+				float* out[2] = { output.getWritePointer(0, i), output.getWritePointer(1, i) };
+
+				matrix.process(in, out, jmin(blockSize, numSamples - i));
+			}
+
+			float maxError = 0.0f;
+			float maxValue = 0.0f;
+
+			for (int c = 0; c < 2; c++)
+			{
+				for (int i = 0; i < numSamples; i++)
+				{
+					maxError = jmax(maxError, std::abs(expected.getSample(c, i) - output.getSample(c, i)));
+					maxValue = jmax(maxValue, std::abs(expected.getSample(c, i)));
+				}
+			}
+
+			expect(maxError < 1e-5f * maxValue, "Matrix output deviates by " + String(maxError) + " (peak: " + String(maxValue) + ")");
+		}
+	}
+
+	void testMultiStageConvolver()
+	{
+		beginTest("Testing the multi stage convolver against a uniform convolution");
+
+		// With a head block size of 64 this creates stages with 256, 1024 and 4096 samples
+		constexpr int irLength = 30000;
+		constexpr int numSamples = irLength + 10000;
+
+		Random r(31);
+
+		AudioSampleBuffer ir(1, irLength);
+
+		for (int i = 0; i < irLength; i++)
+			ir.setSample(0, i, (2.0f * r.nextFloat() - 1.0f) * std::exp(-3.0f * (float)i / (float)irLength));
+
+		AudioSampleBuffer input(1, numSamples);
+
+		for (int i = 0; i < numSamples; i++)
+			input.setSample(0, i, r.nextFloat() - 0.5f);
+
+		AudioSampleBuffer expected(1, numSamples);
+
+		fftconvolver::FFTConvolver reference(audiofft::ImplementationType::BestAvailable);
+		reference.init(128, ir.getReadPointer(0), irLength);
+		reference.process(input.getReadPointer(0), expected.getWritePointer(0), numSamples);
+
+		float maxValue = 0.0f;
+
+		for (int i = 0; i < numSamples; i++)
+			maxValue = jmax(maxValue, std::abs(expected.getSample(0, i)));
+
+		for (auto useBackgroundThread : { false, true })
+		{
+			// Odd block sizes so that the host blocks don't line up with any stage boundary
+			for (auto blockSize : { 37, 100, 441 })
+			{
+				MultiStageConvolver convolver(audiofft::ImplementationType::BestAvailable);
+				convolver.setUseBackgroundThread(useBackgroundThread);
+
+				// The test runs faster than realtime, so it must wait for the workers instead of dropping blocks
+				convolver.setNonRealtime(true);
+
+				expect(convolver.init(64, 4096, ir.getReadPointer(0), irLength), "Can't initialise the multi stage convolver");
+				expectGreaterOrEqual(convolver.getNumStages(), 3, "The impulse response doesn't span three stages");
+
+				AudioSampleBuffer output(1, numSamples);
+
+				for (int i = 0; i < numSamples; i += blockSize)
+					convolver.process(input.getReadPointer(0, i), output.getWritePointer(0, i), (size_t)jmin(blockSize, numSamples - i));
+
+				float maxError = 0.0f;
+
+				for (int i = 0; i < numSamples; i++)
+					maxError = jmax(maxError, std::abs(expected.getSample(0, i) - output.getSample(0, i)));
+
+				expect(maxError < 1e-5f * maxValue, "Multi stage output deviates by " + String(maxError) + " with block size " + String(blockSize) + " (peak: " + String(maxValue) + ")");
+			}
+		}
+	}
+
+	template <class ChunkwareType> static void setChunkwareParameters(ChunkwareType& reference, const BlockDynamics& block)
+	{
+		reference.setThresh(block.getThresh());
+		reference.setAttack(block.getAttack());
+		reference.setRelease(block.getRelease());
+	}
+
+	template <class ChunkwareType> void expectDynamicsMatch(ChunkwareType& reference, BlockDynamics& block, double sampleRate, const String& name)
+	{
+		constexpr int blockSize = 100;
+		const int numSamples = (int)sampleRate * 2;
+
+		reference.setSampleRate(sampleRate);
+		block.setSampleRate(sampleRate);
+		reference.initRuntime();
+		block.initRuntime();
+
+		// A sine that jumps between a quiet and a loud level every 250ms with some noise on top
+		AudioSampleBuffer expected(2, numSamples);
+		Random r(48);
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			const float level = (i / (int)(sampleRate * 0.25)) % 2 ? 0.9f : 0.05f;
+			const float v = level * std::sin((float)i * 0.05f) + 0.01f * (r.nextFloat() - 0.5f);
+
+			expected.setSample(0, i, v);
+			expected.setSample(1, i, 0.7f * v);
+		}
+
+		AudioSampleBuffer output;
+		output.makeCopyOf(expected);
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			double left = (double)expected.getSample(0, i);
+			double right = (double)expected.getSample(1, i);
+
+			reference.process(left, right);
+
+			expected.setSample(0, i, (float)left);
+			expected.setSample(1, i, (float)right);
+		}
+
+		for (int i = 0; i < numSamples; i += blockSize)
+		{
+			float* data[2] = { output.getWritePointer(0, i), output.getWritePointer(1, i) };
+			block.processBlock(data, 2, jmin(blockSize, numSamples - i));
+		}
+
+		float maxError = 0.0f;
+
+		for (int c = 0; c < 2; c++)
+		{
+			for (int i = 0; i < numSamples; i++)
+				maxError = jmax(maxError, std::abs(expected.getSample(c, i) - output.getSample(c, i)));
+		}
+
+		expect(maxError < 3e-5f, name + " deviates by " + String(maxError) + " at " + String(sampleRate) + "Hz");
+	}
+
+	void testBlockDynamics()
+	{
+		beginTest("Testing the block dynamics against the chunkware dynamics");
+
+		using Detection = BlockDynamics::Detection;
+
+		for (auto sampleRate : { 44100.0, 96000.0 })
+		{
+			for (auto useRms : { false, true })
+			{
+				const auto detection = useRms ? Detection::Rms : Detection::Peak;
+				const String suffix = useRms ? " (RMS)" : " (Peak)";
+
+				BlockGate gate;
+				gate.setDetection(detection);
+				gate.setThresh(-12.0);
+				gate.setAttack(5.0);
+				gate.setRelease(50.0);
+
+				BlockCompressor compressor;
+				compressor.setDetection(detection);
+				compressor.setThresh(-18.0);
+				compressor.setRatio(0.25);
+				compressor.setAttack(5.0);
+				compressor.setRelease(80.0);
+
+				if (useRms)
+				{
+					chunkware_simple::SimpleGateRms referenceGate;
+					chunkware_simple::SimpleCompRms referenceCompressor;
+
+					referenceGate.setWindow(5.0);
+					referenceCompressor.setWindow(5.0);
+
+					setChunkwareParameters(referenceGate, gate);
+					setChunkwareParameters(referenceCompressor, compressor);
+					referenceCompressor.setRatio(compressor.getRatio());
+
+					expectDynamicsMatch(referenceGate, gate, sampleRate, "Gate" + suffix);
+					expectDynamicsMatch(referenceCompressor, compressor, sampleRate, "Compressor" + suffix);
+				}
+				else
+				{
+					chunkware_simple::SimpleGate referenceGate;
+					chunkware_simple::SimpleComp referenceCompressor;
+
+					setChunkwareParameters(referenceGate, gate);
+					setChunkwareParameters(referenceCompressor, compressor);
+					referenceCompressor.setRatio(compressor.getRatio());
+
+					expectDynamicsMatch(referenceGate, gate, sampleRate, "Gate" + suffix);
+					expectDynamicsMatch(referenceCompressor, compressor, sampleRate, "Compressor" + suffix);
+				}
+
+				// The limiter always uses the peak detection, so the RMS setting must not change the output
+				BlockLimiter limiter;
+				limiter.setDetection(detection);
+				limiter.setThresh(-6.0);
+				limiter.setAttack(2.0);
+				limiter.setRelease(30.0);
+
+				chunkware_simple::SimpleLimit referenceLimiter;
+				referenceLimiter.setSampleRate(sampleRate);
+				setChunkwareParameters(referenceLimiter, limiter);
+
+				expectDynamicsMatch(referenceLimiter, limiter, sampleRate, "Limiter" + suffix);
+			}
+		}
+	}
+
+	void testModulatedDelayLine()
+	{
+		using Interpolation = ModulatedDelayLine::Interpolation;
+		using ReadPosition = ModulatedDelayLine::ReadPosition;
+
+		constexpr int blockSize = 32;
+		constexpr int numBlocks = 64;
+		constexpr int numSamples = blockSize * numBlocks;
+		constexpr int numInterpolationTypes = (int)Interpolation::numInterpolationTypes;
+
+		const StringArray interpolationNames = { "None", "Linear", "Lagrange", "Allpass" };
+
+		// Renders the input through a delay line and returns the output
+		auto render = [&](const float* input, float* output, Interpolation interpolation, ReadPosition position, const float* delayTimes, float constantDelay)
+		{
+			ModulatedDelayLine delayLine;
+			ModulatedDelayLine::Tap tap;
+
+			delayLine.setMaxDelaySamples(256, blockSize);
+			delayLine.setInterpolation(interpolation);
+
+			for (int i = 0; i < numSamples; i += blockSize)
+			{
+				if (position == ReadPosition::AfterPush)
+					delayLine.pushBlock(input + i, blockSize);
+
+				if (delayTimes != nullptr)
+					delayLine.readBlock(output + i, delayTimes + i, blockSize, tap, position);
+				else
+					delayLine.readBlock(output + i, constantDelay, blockSize, tap, position);
+
+				if (position == ReadPosition::BeforePush)
+					delayLine.pushBlock(input + i, blockSize);
+			}
+		};
+
+		HeapBlock<float> input(numSamples);
+		HeapBlock<float> output(numSamples);
+		HeapBlock<float> delayTimes(numSamples);
+
+		beginTest("Testing the read positions of the modulated delay line");
+
+		{
+			// A ramp shows exactly which sample was read. The delay is longer than the block so that
+			// the read before the push is valid and every interpolation must return the exact sample.
+			constexpr int delay = 40;
+
+			for (int i = 0; i < numSamples; i++)
+			{
+				input[i] = (float)(i + 1);
+				delayTimes[i] = (float)delay;
+			}
+
+			for (int m = 0; m < numInterpolationTypes; m++)
+			{
+				for (auto position : { ReadPosition::AfterPush, ReadPosition::BeforePush })
+				{
+					for (auto useModulation : { false, true })
+					{
+						render(input, output, (Interpolation)m, position, useModulation ? delayTimes.get() : nullptr, (float)delay);
+
+						float maxError = 0.0f;
+
+						for (int i = 0; i < numSamples; i++)
+						{
+							const float expected = i >= delay ? input[i - delay] : 0.0f;
+							maxError = jmax(maxError, std::abs(output[i] - expected));
+						}
+
+						String name;
+						name << interpolationNames[m] << (position == ReadPosition::AfterPush ? " after" : " before") << " the push";
+						name << (useModulation ? " (modulated)" : " (constant)");
+
+						expect(maxError < 1e-3f, name + " reads the wrong position. Error: " + String(maxError));
+					}
+				}
+			}
+		}
+
+		beginTest("Testing the fractional delay accuracy of the modulated delay line");
+
+		{
+			constexpr double omega = 0.05;
+
+			for (int i = 0; i < numSamples; i++)
+				input[i] = (float)std::sin(omega * (double)i);
+
+			// The largest deviation from the ideal fractional delay of a slow sine
+			const float tolerances[numInterpolationTypes] = { 1e-5f, 4e-4f, 1e-5f, 2e-5f };
+
+			for (int m = 0; m < numInterpolationTypes; m++)
+			{
+				for (auto delay : { 10.25f, 10.5f, 10.75f })
+				{
+					for (auto useModulation : { false, true })
+					{
+						for (int i = 0; i < numSamples; i++)
+							delayTimes[i] = delay;
+
+						render(input, output, (Interpolation)m, ReadPosition::AfterPush, useModulation ? delayTimes.get() : nullptr, delay);
+
+						// No interpolation truncates the delay time
+						const double expectedDelay = (Interpolation)m == Interpolation::None ? std::floor(delay) : (double)delay;
+
+						float maxError = 0.0f;
+
+						// Skip the first blocks so that the allpass has settled
+						for (int i = 4 * blockSize; i < numSamples; i++)
+						{
+							const float expected = (float)std::sin(omega * ((double)i - expectedDelay));
+							maxError = jmax(maxError, std::abs(output[i] - expected));
+						}
+
+						String name;
+						name << interpolationNames[m] << " with a delay of " << String(delay) << (useModulation ? " (modulated)" : " (constant)");
+
+						expect(maxError < tolerances[m], name + " deviates by " + String(maxError));
+					}
+				}
+			}
+
+			// A modulated delay time must follow the delay curve
+			for (auto interpolation : { Interpolation::Linear, Interpolation::Lagrange })
+			{
+				for (int i = 0; i < numSamples; i++)
+					delayTimes[i] = 20.0f + 8.0f * std::sin(2.0f * float_Pi * (float)i / 500.0f);
+
+				render(input, output, interpolation, ReadPosition::AfterPush, delayTimes, 0.0f);
+
+				float maxError = 0.0f;
+
+				for (int i = 4 * blockSize; i < numSamples; i++)
+				{
+					const float expected = (float)std::sin(omega * ((double)i - (double)delayTimes[i]));
+					maxError = jmax(maxError, std::abs(output[i] - expected));
+				}
+
+				const String name = interpolationNames[(int)interpolation] + " with a modulated delay";
+				expect(maxError < tolerances[(int)interpolation], name + " deviates by " + String(maxError));
+			}
+		}
+
+		beginTest("Testing the stereo read of the modulated delay line");
+
+		{
+			HeapBlock<float> rightInput(numSamples);
+			HeapBlock<float> expectedRight(numSamples);
+			HeapBlock<float> stereoLeft(numSamples);
+			HeapBlock<float> stereoRight(numSamples);
+
+			for (int i = 0; i < numSamples; i++)
+				rightInput[i] = 0.5f * input[i] + 0.1f;
+
+			for (int m = 0; m < numInterpolationTypes; m++)
+			{
+				const auto interpolation = (Interpolation)m;
+
+				render(input, output, interpolation, ReadPosition::AfterPush, delayTimes, 0.0f);
+				render(rightInput, expectedRight, interpolation, ReadPosition::AfterPush, delayTimes, 0.0f);
+
+				ModulatedDelayLine left, right;
+				ModulatedDelayLine::Tap leftTap, rightTap;
+
+				for (auto d : { &left, &right })
+				{
+					d->setMaxDelaySamples(256, blockSize);
+					d->setInterpolation(interpolation);
+				}
+
+				for (int i = 0; i < numSamples; i += blockSize)
+				{
+					float* stereoOutput[2] = { stereoLeft + i, stereoRight + i };
+
+					left.pushBlock(input + i, blockSize);
+					right.pushBlock(rightInput + i, blockSize);
+
+					ModulatedDelayLine::readStereoBlock(left, right, stereoOutput, delayTimes + i, blockSize, leftTap, rightTap);
+				}
+
+				float maxError = 0.0f;
+
+				for (int i = 0; i < numSamples; i++)
+				{
+					maxError = jmax(maxError, std::abs(stereoLeft[i] - output[i]));
+					maxError = jmax(maxError, std::abs(stereoRight[i] - expectedRight[i]));
+				}
+
+				expectEquals(maxError, 0.0f, interpolationNames[m] + " stereo read differs from the mono read");
+			}
+		}
+	}
+
+	void testFdnReverb()
+	{
+		constexpr double sampleRate = 44100.0;
+		constexpr int blockSize = 512;
+
+		beginTest("Testing the decay of the FDN reverb");
+
+		{
+			FdnReverb reverb;
+			reverb.prepare(sampleRate);
+
+			FdnReverb::Parameters p;
+			p.decayTime = 1.0f;
+			p.damping = 0.0f;
+			reverb.setParameters(p);
+
+			const int numSamples = 2 * (int)sampleRate;
+
+			AudioSampleBuffer impulse(2, numSamples);
+			impulse.clear();
+			impulse.setSample(0, 0, 1.0f);
+			impulse.setSample(1, 0, 1.0f);
+
+			for (int i = 0; i < numSamples; i += blockSize)
+				reverb.processStereo(impulse.getWritePointer(0, i), impulse.getWritePointer(1, i), jmin(blockSize, numSamples - i));
+
+			const int windowSize = (int)sampleRate / 10;
+
+			auto getRMSLevel = [&](int start)
+			{
+				return impulse.getRMSLevel(0, start, windowSize) + impulse.getRMSLevel(1, start, windowSize);
+			};
+
+			const auto early = getRMSLevel(windowSize);
+			const auto late = getRMSLevel(11 * windowSize);
+
+			expect(early > 0.0f, "The reverb doesn't produce a tail");
+
+			// The tail must decay by 60dB within the decay time (the lines lose a little more than that)
+			const auto decayDb = Decibels::gainToDecibels(late) - Decibels::gainToDecibels(early);
+
+			expect(decayDb < -55.0f && decayDb > -70.0f, "The tail decays by " + String(decayDb, 1) + "dB per second");
+		}
 	}
 
 	void testCircularBuffers()
@@ -376,6 +1107,215 @@ private:
 	
 		testScriptPitchFade(false);
 		testScriptPitchFade(true);
+
+		testLfoVectorKernel();
+
+		testMidiAutomationCoalescing();
+
+		testMpeExpressionLanes();
+		testMpeStartOffsetDecay();
+	}
+
+	void testMpeExpressionLanes()
+	{
+		beginTest("Testing the MPE expression lane sharing");
+
+		using Store = MidiControllerAutomationHandler::MPEData::ExpressionStore;
+
+		Store store;
+		store.prepareToPlay(1000.0, 64);
+
+		const int a = store.acquireLane(Store::Press, 50.0f);
+		const int b = store.acquireLane(Store::Press, 50.0f);
+		const int c = store.acquireLane(Store::Press, 20.0f);
+		const int d = store.acquireLane(Store::Slide, 50.0f);
+
+		expectEquals(a, b, "Same dimension and smoothing time share a lane");
+		expect(a != c, "Different smoothing time uses another lane");
+		expect(a != d && c != d, "Different dimension uses another lane");
+
+		store.releaseLane(a);
+		expectEquals(store.acquireLane(Store::Press, 50.0f), a, "Lane is kept while it has users");
+
+		store.releaseLane(a);
+		store.releaseLane(a);
+		expectEquals(store.acquireLane(Store::Glide, 10.0f), a, "Released lane is reused");
+
+		HiseEvent on(HiseEvent::Type::NoteOn, 64, 127, 3);
+		on.setEventId(1);
+
+		store.handleHiseEvent(on);
+		store.handleHiseEvent(HiseEvent(HiseEvent::Type::Controller, 74, 127, 3));
+
+		// The first reader renders the range, the second one must get the same values
+		Array<float> first;
+		first.addArray(store.getSmoothedValues(d, 2, 0, 32), 32);
+		first.addArray(store.getSmoothedValues(d, 2, 32, 32), 32);
+
+		auto second = store.getSmoothedValues(d, 2, 0, 64);
+
+		for (int i = 0; i < 64; i++)
+			expectEquals(second[i], first[i], "Shared lane value mismatch");
+
+		expect(first[63] > first[0] && first[0] > Store::getNeutralValue(Store::Slide), "Lane moves towards the target");
+
+		store.startNextBlock();
+
+		auto next = store.getSmoothedValues(d, 2, 0, 1);
+		expect(next[0] > first[63], "Lane continues after the next block starts");
+	}
+
+	void testMpeStartOffsetDecay()
+	{
+		beginTest("Testing the MPE start value offset decay");
+
+		using Store = MidiControllerAutomationHandler::MPEData::ExpressionStore;
+
+		Store store;
+		store.prepareToPlay(1000.0, 64);
+
+		const int lane = store.acquireLane(Store::Slide, 30.0f);
+		const float decay = store.getDecayFactor(lane);
+
+		HiseEvent on(HiseEvent::Type::NoteOn, 64, 127, 1);
+		on.setEventId(1);
+
+		store.handleHiseEvent(on);
+
+		// The voice starts at this value while the channel starts at the neutral value
+		const float startValue = 0.8f;
+		const float target = 1.0f;
+		float offset = startValue - Store::getNeutralValue(Store::Slide);
+
+		store.handleHiseEvent(HiseEvent(HiseEvent::Type::Controller, 74, 127, 1));
+
+		// This is what a per voice smoother would do when it starts at the start value
+		float expected = startValue;
+		float maxError = 0.0f;
+
+		for (int block = 0; block < 4; block++)
+		{
+			store.startNextBlock();
+
+			float data[64];
+			FloatVectorOperations::copy(data, store.getSmoothedValues(lane, 0, 0, 64), 64);
+
+			offset = Store::applyStartOffset(data, 64, offset, decay);
+
+			for (int i = 0; i < 64; i++)
+			{
+				expected = (1.0f - decay) * target + decay * expected;
+				maxError = jmax(maxError, std::abs(expected - data[i]));
+			}
+		}
+
+		expect(maxError < 1e-5f, "Offset doesn't follow the voice smoother: " + String(maxError));
+		expect(std::abs(offset) < 1e-3f, "Offset has decayed");
+	}
+
+	void testMidiAutomationCoalescing()
+	{
+		beginTest("Testing coalesced MIDI automation");
+
+		ScopedProcessor bp = Helpers::createWithOptionalGroup(NoiseSynth::DC, false);
+
+		auto synth = Helpers::getMainSynth(bp, false);
+		auto handler = bp->getMacroManager().getMidiControlAutomationHandler();
+
+		handler->addMidiControlledParameter(synth, ModulatorSynth::Gain, NormalisableRange<double>(0.0, 1.0), -1);
+		handler->setUnlearndedMidiControlNumber(1, dontSendNotification);
+
+		handler->setCoalescingBlockSize(30);
+		expectEquals(handler->getCoalescingBlockSize(), 32, "Block size is rounded up to the event raster");
+
+		MidiBuffer b;
+		b.addEvent(MidiMessage::controllerEvent(1, 1, 10), 3);
+		b.addEvent(MidiMessage::controllerEvent(1, 1, 20), 40);
+		b.addEvent(MidiMessage::controllerEvent(1, 2, 64), 50);
+		b.addEvent(MidiMessage::controllerEvent(1, 1, 127), 100);
+
+		int positions[16];
+		const int numPositions = handler->getSplitPositions(b, 256, positions, 16);
+
+		expectEquals(numPositions, 2, "Number of split positions");
+		expectEquals(positions[0], 32, "First split position");
+		expectEquals(positions[1], 96, "Second split position");
+
+		handler->handleParameterData(b);
+
+		expectEquals(synth->getAttribute(ModulatorSynth::Gain), 1.0f, "Last value is applied");
+		expectEquals(b.getNumEvents(), 1, "Unassigned CC is kept");
+
+		expectEquals(handler->flushDeferredNotifications(), 1, "Processor is notified once");
+		expectEquals(handler->flushDeferredNotifications(), 0, "Nothing to notify");
+
+		// Fill the notification queue without flushing it
+		for (int i = 0; i < 5000; i++)
+		{
+			MidiBuffer burst;
+			burst.addEvent(MidiMessage::controllerEvent(1, 1, (i % 2) * 127), 0);
+			handler->handleParameterData(burst);
+		}
+
+		expect(handler->hasDeferredNotificationOverflow(), "Overflow is reported");
+		expectEquals(handler->flushDeferredNotifications(), 1, "All connected processors are notified after an overflow");
+		expect(!handler->hasDeferredNotificationOverflow(), "Overflow is cleared by the flush");
+
+		handler->setCoalescingBlockSize(0);
+		expectEquals(handler->getSplitPositions(b, 256, positions, 16), 0, "No splitting when disabled");
+
+		bp = nullptr;
+	}
+
+	void testLfoVectorKernel()
+	{
+		beginTest("Testing LFO vector kernel against the lookup tables");
+
+		WaveformLookupTables::init();
+
+		const float* tables[] = { WaveformLookupTables::sineTable, WaveformLookupTables::triangleTable, 
+								  WaveformLookupTables::sawTable, WaveformLookupTables::squareTable };
+
+		const LfoModulator::Waveform waveforms[] = { LfoModulator::Sine, LfoModulator::Triangle, 
+													 LfoModulator::Saw, LfoModulator::Square };
+
+		// From very slow to the fastest LFO frequency at the control rate
+		const double phaseDeltas[] = { 0.01, 0.37, 1.49, 3.1, 14.9 };
+
+		constexpr int numValues = 8192;
+		constexpr int mask = SAMPLE_LOOKUP_TABLE_SIZE - 1;
+
+		HeapBlock<float> data(numValues);
+
+		for (int w = 0; w < 4; w++)
+		{
+			expect(LfoModulator::VectorKernel::isSupported(waveforms[w]), "Waveform not supported");
+
+			for (auto delta : phaseDeltas)
+			{
+				double phase = 0.0;
+				LfoModulator::VectorKernel::process(waveforms[w], data, phase, delta, numValues);
+
+				// This is the table interpolation of LfoModulator::calculateNewValue()
+				double uptime = 0.0;
+				float maxError = 0.0f;
+
+				for (int i = 0; i < numValues; i++)
+				{
+					const int index = (int)uptime;
+					const float alpha = (float)(uptime - (double)index);
+					const float v1 = tables[w][index & mask];
+					const float v2 = tables[w][(index + 1) & mask];
+					const float expected = 1.0f - ((1.0f - alpha) * v1 + alpha * v2);
+
+					maxError = jmax(maxError, std::abs(expected - data[i]));
+					uptime += delta;
+				}
+
+				expect(maxError < 1e-5f, "Waveform " + String(w + 1) + ", delta " + String(delta) + ": error " + String(maxError));
+				expectWithinAbsoluteError(phase, uptime, 1e-6);
+			}
+		}
 	}
 
 	void testPanModulation(bool useGroup)
@@ -1942,6 +2882,281 @@ private:
 
 static CustomContainerTest unorderedStackTest;
 
+class VoiceStealingTest : public UnitTest
+{
+public:
+
+	VoiceStealingTest() :
+		UnitTest("Testing voice stealing")
+	{}
+
+	void runTest() override
+	{
+		testHeapOrder();
+		testRandomOperations(VoiceStealer::Policy::Oldest);
+		testRandomOperations(VoiceStealer::Policy::Quietest);
+		testRandomOperations(VoiceStealer::Policy::LowestPriority);
+		testSameNote();
+		testKilledVoices();
+		testSiblings();
+		testEventPriorities();
+	}
+
+private:
+
+	void testHeapOrder()
+	{
+		beginTest("Testing the heap order");
+
+		VoiceStealer s;
+
+		for (int i = 0; i < 8; i++)
+			s.voiceStarted(i, (uint16)(i + 1), 60 + i, (double)i, 0);
+
+		expectEquals(s.getNumCandidates(), 8, "all voices are candidates");
+		expectEquals(s.getVoiceToSteal(-1), 0, "oldest voice");
+
+		s.voiceReleased(5);
+		expectEquals(s.getVoiceToSteal(-1), 5, "released voices are stolen first");
+
+		s.voiceRemoved(5);
+		s.voiceRemoved(0);
+		expectEquals(s.getVoiceToSteal(-1), 1, "next oldest voice after removal");
+
+		s.setPolicy(VoiceStealer::Policy::Quietest);
+
+		s.setVoiceLevel(6, 0.1f);
+		expectEquals(s.getVoiceToSteal(-1), 6, "quietest voice");
+
+		s.setVoiceLevel(6, 1.0f);
+		expectEquals(s.getVoiceToSteal(-1), 1, "level update resorts the heap");
+
+		s.clear();
+		expectEquals(s.getVoiceToSteal(-1), -1, "no voice after clear");
+	}
+
+	/** Applies random operations and compares the heap top against a linear search over the tracked voices. */
+	void testRandomOperations(VoiceStealer::Policy p)
+	{
+		beginTest("Testing random operations with policy " + VoiceStealer::getPolicyName(p));
+
+		VoiceStealer s;
+		s.setPolicy(p);
+
+		Random r(92);
+
+		struct Reference
+		{
+			bool active = false;
+			bool released = false;
+			bool killed = false;
+			float level = 1.0f;
+			int priority = 0;
+			double uptime = 0.0;
+		};
+
+		Reference ref[64];
+		double uptime = 0.0;
+
+		for (int i = 0; i < 5000; i++)
+		{
+			const int voiceIndex = r.nextInt(64);
+			auto& v = ref[voiceIndex];
+
+			switch (r.nextInt(5))
+			{
+			case 0:
+			case 1:
+			{
+				// multiple voices may share the start time
+				uptime += (double)r.nextInt(2);
+				v = Reference();
+				v.active = true;
+				v.priority = p == VoiceStealer::Policy::LowestPriority ? r.nextInt(4) : 0;
+				v.uptime = uptime;
+				s.voiceStarted(voiceIndex, (uint16)i, r.nextInt(128), uptime, v.priority);
+				break;
+			}
+			case 2:
+				s.voiceReleased(voiceIndex);
+				v.released = v.active;
+				break;
+			case 3:
+				s.voiceKilled(voiceIndex);
+				v.killed = v.active;
+				break;
+			case 4:
+				if (r.nextBool())
+				{
+					s.voiceRemoved(voiceIndex);
+					v = Reference();
+				}
+				else
+				{
+					v.level = r.nextFloat();
+					s.setVoiceLevel(voiceIndex, v.level);
+				}
+				break;
+			}
+
+			// Returns a negative value if a should be stolen before b (voices with the same start time are sorted by the start counter)
+			auto compare = [&ref, p](int a, int b)
+			{
+				const auto& va = ref[a];
+				const auto& vb = ref[b];
+
+				if (p == VoiceStealer::Policy::LowestPriority && va.priority != vb.priority)
+					return va.priority < vb.priority ? -1 : 1;
+
+				if (va.released != vb.released)
+					return va.released ? -1 : 1;
+
+				if (p == VoiceStealer::Policy::Quietest && va.level != vb.level)
+					return va.level < vb.level ? -1 : 1;
+
+				if (va.uptime != vb.uptime)
+					return va.uptime < vb.uptime ? -1 : 1;
+
+				return 0;
+			};
+
+			int expected = -1;
+			int numCandidates = 0;
+
+			for (int j = 0; j < 64; j++)
+			{
+				if (!ref[j].active || ref[j].killed)
+					continue;
+
+				numCandidates++;
+
+				if (expected == -1 || compare(j, expected) < 0)
+					expected = j;
+			}
+
+			const int actual = s.getVoiceToSteal(-1);
+
+			expectEquals(s.getNumCandidates(), numCandidates, "number of candidates");
+
+			if (expected == -1)
+			{
+				expectEquals(actual, -1, "no candidate");
+			}
+			else
+			{
+				expect(isPositiveAndBelow(actual, 64) && ref[actual].active && !ref[actual].killed, "stolen voice is a candidate");
+
+				if (isPositiveAndBelow(actual, 64))
+					expectEquals(compare(actual, expected), 0, "voice to steal");
+			}
+		}
+	}
+
+	void testSameNote()
+	{
+		beginTest("Testing the same note list");
+
+		VoiceStealer s;
+		s.setPolicy(VoiceStealer::Policy::SameNote);
+
+		s.voiceStarted(0, 1, 60, 0.0, 0);
+		s.voiceStarted(1, 2, 64, 1.0, 0);
+		s.voiceStarted(2, 3, 64, 2.0, 0);
+		s.voiceStarted(3, 4, 64, 3.0, 0);
+
+		expectEquals(s.getVoiceToSteal(64), 1, "oldest voice with the same note");
+		expectEquals(s.getVoiceToSteal(72), 0, "fallback to the oldest voice");
+
+		s.voiceRemoved(1);
+		expectEquals(s.getVoiceToSteal(64), 2, "next voice after removing the head");
+
+		s.voiceRemoved(3);
+		s.voiceStarted(4, 5, 64, 4.0, 0);
+		s.voiceRemoved(2);
+		expectEquals(s.getVoiceToSteal(64), 4, "tail is linked after removing the middle");
+
+		s.voiceKilled(4);
+		expectEquals(s.getVoiceToSteal(64), 0, "killed voices are not in the note list");
+	}
+
+	void testKilledVoices()
+	{
+		beginTest("Testing the killed voice list");
+
+		VoiceStealer s;
+
+		for (int i = 0; i < 4; i++)
+			s.voiceStarted(i, (uint16)(i + 1), 60, (double)i, 0);
+
+		expectEquals(s.getVoiceBeingKilled(), -1, "no voice is killed");
+
+		s.voiceKilled(1);
+		s.voiceKilled(2);
+
+		expectEquals(s.getNumCandidates(), 2, "killed voices are removed from the heap");
+		expectEquals(s.getVoiceBeingKilled(), 2, "last killed voice");
+
+		s.voiceKilled(2);
+		s.voiceRemoved(2);
+		expectEquals(s.getVoiceBeingKilled(), 1, "unlinked after removal");
+
+		s.voiceStarted(1, 10, 60, 5.0, 0);
+		expectEquals(s.getVoiceBeingKilled(), -1, "restarted voice is not killed anymore");
+		expectEquals(s.getNumCandidates(), 3, "restarted voice is a candidate");
+	}
+
+	void testSiblings()
+	{
+		beginTest("Testing the sibling list");
+
+		VoiceStealer s;
+
+		s.voiceStarted(3, 7, 60, 0.0, 0);
+		s.voiceStarted(5, 7, 60, 0.0, 0);
+		s.voiceStarted(9, 7, 60, 0.0, 0);
+		s.voiceStarted(1, 8, 60, 0.0, 0);
+
+		auto getSiblings = [&s](int voiceIndex)
+		{
+			Array<int> list;
+			s.forEachSibling(voiceIndex, [&list](int i) { list.addUsingDefaultSort(i); });
+			return list;
+		};
+
+		expect(getSiblings(5) == Array<int>({ 3, 9 }), "siblings of the same event");
+		expect(getSiblings(1).isEmpty(), "other event has no siblings");
+
+		s.voiceRemoved(5);
+		expect(getSiblings(3) == Array<int>({ 9 }), "sibling removed");
+		expect(getSiblings(5).isEmpty(), "removed voice is not tracked");
+	}
+
+	void testEventPriorities()
+	{
+		beginTest("Testing event priorities");
+
+		VoiceStealer s;
+
+		expect(!s.setPriorityForEvent(1, 5), "priority requires the LowestPriority policy");
+
+		s.setPolicy(VoiceStealer::Policy::LowestPriority);
+
+		expect(s.setPriorityForEvent(1, 5), "priority was set");
+		expectEquals(s.getPriorityForEvent(1), 5, "stored priority");
+		expectEquals(s.getPriorityForEvent(1 + HISE_EVENT_ID_ARRAY_SIZE), 0, "wrapped event id doesn't alias");
+
+		s.voiceStarted(0, 1, 60, 0.0, s.getPriorityForEvent(1));
+		s.voiceStarted(1, 2, 60, 1.0, s.getPriorityForEvent(2));
+		expectEquals(s.getVoiceToSteal(-1), 1, "voice with lower priority is stolen first");
+
+		s.clearPriorityForEvent(1);
+		expectEquals(s.getPriorityForEvent(1), 0, "priority was cleared");
+	}
+};
+
+static VoiceStealingTest voiceStealingTest;
+
+
 
 
 #endif
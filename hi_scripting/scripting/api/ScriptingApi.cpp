@@ -823,6 +823,7 @@ struct ScriptingApi::Engine::Wrapper
 	API_METHOD_WRAPPER_1(Engine, getSemitonesFromPitchRatio);
 	API_METHOD_WRAPPER_0(Engine, getSampleRate);
 	API_METHOD_WRAPPER_1(Engine, setMinimumSampleRate);
+	API_VOID_METHOD_WRAPPER_1(Engine, setImpulseResponseCacheSize);
 	API_METHOD_WRAPPER_1(Engine, getMidiNoteName);
 	API_METHOD_WRAPPER_1(Engine, getMidiNoteFromName);
 	API_METHOD_WRAPPER_1(Engine, getMacroName);
@@ -870,6 +871,7 @@ struct ScriptingApi::Engine::Wrapper
 	API_METHOD_WRAPPER_0(Engine, getFilterModeList);
 	API_METHOD_WRAPPER_2(Engine, sortWithFunction);
 	API_METHOD_WRAPPER_1(Engine, isControllerUsedByAutomation);
+	API_VOID_METHOD_WRAPPER_1(Engine, setMidiAutomationSubBlockSize);
 	API_METHOD_WRAPPER_0(Engine, getSettingsWindowObject);
 	API_METHOD_WRAPPER_1(Engine, getMasterPeakLevel);
 	API_METHOD_WRAPPER_0(Engine, getControlRateDownsamplingFactor);
@@ -932,6 +934,7 @@ parentMidiProcessor(dynamic_cast<ScriptBaseMidiProcessor*>(p))
 	ADD_API_METHOD_1(addModuleStateToUserPreset);
 	ADD_API_METHOD_0(getSampleRate);
 	ADD_API_METHOD_1(setMinimumSampleRate);
+	ADD_API_METHOD_1(setImpulseResponseCacheSize);
 	ADD_API_METHOD_1(getMidiNoteName);
 	ADD_API_METHOD_1(getMidiNoteFromName);
 	ADD_API_METHOD_1(getMacroName);
@@ -976,6 +979,7 @@ parentMidiProcessor(dynamic_cast<ScriptBaseMidiProcessor*>(p))
 	ADD_API_METHOD_0(createGlobalScriptLookAndFeel);
 	ADD_API_METHOD_1(setAllowDuplicateSamples);
 	ADD_API_METHOD_1(isControllerUsedByAutomation);
+	ADD_API_METHOD_1(setMidiAutomationSubBlockSize);
 	ADD_API_METHOD_0(getSettingsWindowObject);
 	ADD_API_METHOD_0(createTimerObject);
 	ADD_API_METHOD_0(createMessageHolder);
@@ -1102,6 +1106,17 @@ bool ScriptingApi::Engine::setMinimumSampleRate(double minimumSampleRate)
 	return getProcessor()->getMainController()->setMinimumSamplerate(minimumSampleRate);
 }
 
+void ScriptingApi::Engine::setImpulseResponseCacheSize(int megaBytes)
+{
+	if (megaBytes < 0)
+	{
+		reportScriptError("The cache size can't be negative");
+		return;
+	}
+
+	ConvolutionImpulseCache::setMaxMemoryUsage((size_t)megaBytes * 1024 * 1024);
+}
+
 double ScriptingApi::Engine::getSampleRate() const { return const_cast<MainController*>(getProcessor()->getMainController())->getMainSynthChain()->getSampleRate(); }
 double ScriptingApi::Engine::getSamplesForMilliSeconds(double milliSeconds) const { return (milliSeconds / 1000.0) * getSampleRate(); }
 
@@ -2187,6 +2202,17 @@ int ScriptingApi::Engine::isControllerUsedByAutomation(int controllerNumber)
 	return -1;
 }
 
+void ScriptingApi::Engine::setMidiAutomationSubBlockSize(int numSamples)
+{
+	if (numSamples < 0 || numSamples > HISE_MAX_PROCESSING_BLOCKSIZE)
+	{
+		reportScriptError("The sub block size must be between 0 and " + String(HISE_MAX_PROCESSING_BLOCKSIZE));
+		return;
+	}
+
+	getProcessor()->getMainController()->getMacroManager().getMidiControlAutomationHandler()->setCoalescingBlockSize(numSamples);
+}
+
 ScriptingObjects::MidiList *ScriptingApi::Engine::createMidiList() { return new ScriptingObjects::MidiList(getScriptProcessor()); };
 
 ScriptingObjects::ScriptSliderPackData* ScriptingApi::Engine::createSliderPackData() { return new ScriptingObjects::ScriptSliderPackData(getScriptProcessor()); }
@@ -3407,6 +3433,8 @@ struct ScriptingApi::Synth::Wrapper
 	API_METHOD_WRAPPER_1(Synth, isKeyDown);
 	API_VOID_METHOD_WRAPPER_1(Synth, setClockSpeed);
 	API_VOID_METHOD_WRAPPER_1(Synth, setShouldKillRetriggeredNote);
+	API_VOID_METHOD_WRAPPER_1(Synth, setVoiceStealingPolicy);
+	API_VOID_METHOD_WRAPPER_2(Synth, setVoiceStealingPriority);
 };
 
 
@@ -3476,6 +3504,8 @@ ScriptingApi::Synth::Synth(ProcessorWithScriptingContent *p, ModulatorSynth *own
 	ADD_API_METHOD_1(isKeyDown);
 	ADD_API_METHOD_1(setClockSpeed);
 	ADD_API_METHOD_1(setShouldKillRetriggeredNote);
+	ADD_API_METHOD_1(setVoiceStealingPolicy);
+	ADD_API_METHOD_2(setVoiceStealingPriority);
 
 };
 
@@ -4413,6 +4443,28 @@ void ScriptingApi::Synth::setShouldKillRetriggeredNote(bool killNote)
 	}
 }
 
+void ScriptingApi::Synth::setVoiceStealingPolicy(String policyName)
+{
+	if (owner != nullptr)
+	{
+		auto policy = VoiceStealer::getPolicyFromName(policyName);
+
+		if (VoiceStealer::getPolicyName(policy) != policyName)
+		{
+			reportScriptError("Unknown voice stealing policy: " + policyName);
+			return;
+		}
+
+		owner->setVoiceStealingPolicy(policy);
+	}
+}
+
+void ScriptingApi::Synth::setVoiceStealingPriority(int eventId, int priority)
+{
+	if (owner != nullptr && !owner->setVoiceStealingPriorityForEvent((uint16)eventId, priority))
+		reportScriptError("The voice stealing priority requires the LowestPriority policy");
+}
+
 var ScriptingApi::Synth::getAllModulators(String regex)
 {
 	Processor::Iterator<Modulator> iter(owner->getMainController()->getMainSynthChain());
@@ -210,6 +210,9 @@ public:
 		/** Sets the minimum sample rate for the global processing (and adds oversampling if the current samplerate is lower). */
 		bool setMinimumSampleRate(double minimumSampleRate);
 
+		/** Sets the memory limit in megabytes for the prepared impulse responses that are shared between all convolution reverbs. */
+		void setImpulseResponseCacheSize(int megaBytes);
+
 		/** Returns the current sample rate. */
 		double getSampleRate() const;
 
@@ -444,6 +447,9 @@ public:
 		/** Checks if the given CC number is used for parameter automation and returns the index of the control. */
 		int isControllerUsedByAutomation(int controllerNumber);
 
+		/** Enables the coalesced MIDI automation with the given sub block size in samples (0 disables it). */
+		void setMidiAutomationSubBlockSize(int numSamples);
+
 		/** Creates a MIDI List object. */
     ScriptingObjects::MidiList *createMidiList();
 
@@ -839,6 +845,12 @@ public:
 		/** If set to true, this will kill retriggered notes (default). */
 		void setShouldKillRetriggeredNote(bool killNote);
 
+		/** Sets the voice stealing policy ("Oldest", "Quietest", "LowestPriority" or "SameNote"). */
+		void setVoiceStealingPolicy(String policyName);
+
+		/** Sets the priority of the voices started by the given event for the "LowestPriority" voice stealing policy. Call this in the onNoteOn callback. */
+		void setVoiceStealingPriority(int eventId, int priority);
+
 		/** Returns an array of all modulators that match the given regex. */
 		var getAllModulators(String regex);
 
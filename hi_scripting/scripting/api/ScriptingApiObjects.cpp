@@ -1903,6 +1903,8 @@ struct ScriptingObjects::ScriptingEffect::Wrapper
 	API_METHOD_WRAPPER_1(ScriptingEffect, getModulatorChain);
 	API_METHOD_WRAPPER_3(ScriptingEffect, addStaticGlobalModulator);
 	API_METHOD_WRAPPER_0(ScriptingEffect, getId);
+	API_VOID_METHOD_WRAPPER_2(ScriptingEffect, setOversampling);
+	API_METHOD_WRAPPER_0(ScriptingEffect, getLatencySamples);
 };
 
 ScriptingObjects::ScriptingEffect::ScriptingEffect(ProcessorWithScriptingContent *p, EffectProcessor *fx) :
@@ -1943,6 +1945,8 @@ moduleHandler(fx, dynamic_cast<JavascriptProcessor*>(p))
 	ADD_API_METHOD_1(getModulatorChain);
 	ADD_API_METHOD_3(addGlobalModulator);
 	ADD_API_METHOD_3(addStaticGlobalModulator);
+	ADD_API_METHOD_2(setOversampling);
+	ADD_API_METHOD_0(getLatencySamples);
 };
 
 
@@ -2077,6 +2081,39 @@ float ScriptingObjects::ScriptingEffect::getCurrentLevel(bool leftChannel)
 	return 0.0f;
 }
 
+void ScriptingObjects::ScriptingEffect::setOversampling(int factor, int filterType)
+{
+	if (checkValidObject())
+	{
+		auto fx = dynamic_cast<MasterEffectProcessor*>(effect.get());
+
+		if (fx == nullptr || !fx->supportsOversampling())
+		{
+			reportScriptError(effect->getId() + " doesn't support oversampling");
+			return;
+		}
+
+		if (!isPositiveAndBelow(filterType, (int)EffectOversampler::numFilterTypes))
+		{
+			reportScriptError("Illegal filter type: " + String(filterType));
+			return;
+		}
+
+		fx->setOversampling(factor, (EffectOversampler::FilterType)filterType);
+	}
+}
+
+int ScriptingObjects::ScriptingEffect::getLatencySamples() const
+{
+	if (checkValidObject())
+	{
+		if (auto fx = dynamic_cast<const MasterEffectProcessor*>(effect.get()))
+			return fx->getLatencySamples();
+	}
+
+	return 0;
+}
+
 var ScriptingObjects::ScriptingEffect::addModulator(var chainIndex, var typeName, var modName)
 {
 	if (checkValidObject())
@@ -2926,6 +2963,7 @@ struct ScriptingObjects::ScriptingAudioSampleProcessor::Wrapper
 	API_METHOD_WRAPPER_0(ScriptingAudioSampleProcessor, getSampleLength);
 	API_VOID_METHOD_WRAPPER_2(ScriptingAudioSampleProcessor, setSampleRange);
 	API_VOID_METHOD_WRAPPER_1(ScriptingAudioSampleProcessor, setFile);
+	API_METHOD_WRAPPER_0(ScriptingAudioSampleProcessor, getIRMemoryUsage);
 };
 
 
@@ -2956,6 +2994,7 @@ audioSampleProcessor(dynamic_cast<Processor*>(sampleProcessor))
 	ADD_API_METHOD_0(getSampleLength);
 	ADD_API_METHOD_2(setSampleRange);
 	ADD_API_METHOD_1(setFile);
+	ADD_API_METHOD_0(getIRMemoryUsage);
 }
 
 
@@ -3053,6 +3092,19 @@ int ScriptingObjects::ScriptingAudioSampleProcessor::getSampleLength() const
 	else return 0;
 }
 
+int ScriptingObjects::ScriptingAudioSampleProcessor::getIRMemoryUsage() const
+{
+	if (checkValidObject())
+	{
+		if (auto c = dynamic_cast<const ConvolutionEffect*>(audioSampleProcessor.get()))
+			return (int)c->getIRMemoryUsage();
+
+		reportScriptError("This method is only available for the convolution reverb");
+	}
+
+	return 0;
+}
+
 // ScriptingTableProcessor ==============================================================================================================
 
 struct ScriptingObjects::ScriptingTableProcessor::Wrapper
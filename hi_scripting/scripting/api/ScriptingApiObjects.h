@@ -955,6 +955,12 @@ public:
 		/** Adds and connects a receiving static time variant modulator for the given global modulator. */
 		var addStaticGlobalModulator(var chainIndex, var timeVariantMod, String modName);
 
+		/** Renders the effect with the given oversampling factor (1-16) and filter type (0 = minimum phase IIR, 1 = linear phase FIR). */
+		void setOversampling(int factor, int filterType);
+
+		/** Returns the latency of the effect in samples. */
+		int getLatencySamples() const;
+
 		// ============================================================================================================
 
 		struct Wrapper;
@@ -1292,6 +1298,9 @@ public:
 		/** Sets the length of the current sample selection in samples. */
 		void setSampleRange(int startSample, int endSample);
 
+		/** Returns the amount of bytes used by the impulse response of a convolution reverb. */
+		int getIRMemoryUsage() const;
+
 		// ============================================================================================================
 
 		struct Wrapper; 
@@ -831,12 +831,15 @@ var HiseJavascriptEngine::callFunction(const Identifier& function, const var::Na
 
 
 
-int HiseJavascriptEngine::registerCallbackName(const Identifier &callbackName, int numArgs, double bufferTime)
+int HiseJavascriptEngine::registerCallbackName(const Identifier &callbackName, int numArgs, double bufferTime, const PerformanceProfiler::Source& profilerSource)
 {
 	// Can't register a callback twice...
 	jassert(root->hiseSpecialData.getCallback(callbackName) == nullptr);
 
-	root->hiseSpecialData.callbackNEW.add(new RootObject::Callback(callbackName, numArgs, bufferTime));
+	auto c = new RootObject::Callback(callbackName, numArgs, bufferTime);
+	c->profilerSource = profilerSource;
+
+	root->hiseSpecialData.callbackNEW.add(c);
 
 	return 1;
 }
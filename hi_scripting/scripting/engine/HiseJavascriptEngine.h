@@ -183,8 +183,10 @@ public:
 	*	- no scope (only global variables)
 	*	- no arguments
 	*	- no overhead if the callback is not found
+	*
+	*	The profiler source is used to profile the execution of the callback (see PerformanceProfiler).
 	*/
-	int registerCallbackName(const Identifier &callbackName, int numArgs, double bufferTime);
+	int registerCallbackName(const Identifier &callbackName, int numArgs, double bufferTime, const PerformanceProfiler::Source& profilerSource={});
 
 	var executeInlineFunction(var inlineFunction, var* arguments, Result* result, int numArgs=-1);
 
@@ -661,6 +663,8 @@ public:
 
 			NamedValueSet localProperties;
 
+			PerformanceProfiler::Source profilerSource;
+
 		private:
 
 			ScopedPointer<BlockStatement> statements;
@@ -898,6 +898,8 @@ var HiseJavascriptEngine::executeCallback(int callbackIndex, Result *result)
 
 	if (c != nullptr && c->isDefined())
 	{
+		PROFILE_SCOPE(c->profilerSource);
+
 		try
 		{
 			prepareTimeout();
@@ -54,16 +54,33 @@ struct PrepareSpecs
 	int blockSize = 0;
 	double sampleRate = -1.0;
 	int* voiceIndex = nullptr;
+
+	/** The amount of voices the polyphonic state must be able to hold. 
+	
+		This is the voice amount of the processor that owns the network (1 for monophonic networks), so 
+		PolyData objects only allocate as much per-voice state as the voice indexes can reach.
+	*/
+	int numVoices = NUM_POLYPHONIC_VOICES;
 };
 
+/** A container for per-voice state.
+
+	NumVoices only decides whether the data is polyphonic (NumVoices > 1), it doesn't limit the 
+	voice amount. The storage is one contiguous block that is resized in prepare() to the next power 
+	of two of PrepareSpecs::numVoices, so a network in a synth with 4 voices only allocates 4 elements
+	and a synth with more than NUM_POLYPHONIC_VOICES voices gets all of them. Until then (and for 
+	monophonic data) there is only a single element.
+*/
 template <typename T, int NumVoices> struct PolyData
 {
-	PolyData(T initValue)
+	PolyData(T initValue):
+		data(new T[1])
 	{
 		setAll(initValue);
 	}
 
-	PolyData()
+	PolyData():
+		data(new T[1])
 	{
 		
 	}
@@ -73,19 +90,39 @@ template <typename T, int NumVoices> struct PolyData
 		jassert(sp.voiceIndex != nullptr);
 		jassert(isPowerOfTwo(NumVoices));
 		voicePtr = sp.voiceIndex;
+
+		if (isPolyphonic())
+		{
+			auto newSize = nextPowerOfTwo(jmax(1, sp.numVoices));
+
+			if (newSize != numAllocated)
+			{
+				std::unique_ptr<T[]> newData(new T[newSize]);
+
+				// Carry over the existing state and initialise the new voices with the first voice
+				for (int i = 0; i < newSize; i++)
+					copyIfPossible(newData[i], data[i < numAllocated ? i : 0], std::is_copy_assignable<T>());
+
+				data.swap(newData);
+				numAllocated = newSize;
+			}
+		}
 	}
 
+	/** Returns the amount of elements that are currently allocated. */
+	int size() const noexcept { return numAllocated; }
+
 	static constexpr bool isPolyphonic() { return NumVoices > 1; }
 
 	void setAll(const T& value)
 	{
 		if (!isPolyphonic() || voicePtr == nullptr)
 		{
-			*data = value;
+			data[0] = value;
 		}
 		else
 		{
-			for (int i = 0; i < NumVoices; i++)
+			for (int i = 0; i < numAllocated; i++)
 				getWithIndex(i) = value;
 		}
 	}
@@ -93,19 +130,19 @@ template <typename T, int NumVoices> struct PolyData
 	T& getMonoValue()
 	{
 		jassert(!isPolyphonic());
-		return *data;
+		return data[0];
 	}
 
 	const T& getMonoValue() const
 	{
 		jassert(!isPolyphonic());
-		return *data;
+		return data[0];
 	}
 
 	T& get()
 	{
 		if (!isPolyphonic() || voicePtr == nullptr)
-			return *data;
+			return data[0];
 		else
 			return getWithIndex(getCurrentVoiceIndex());
 	}
@@ -113,7 +150,7 @@ template <typename T, int NumVoices> struct PolyData
 	const T& get() const
 	{
 		if (!isPolyphonic() || voicePtr == nullptr)
-			return *data;
+			return data[0];
 		else
 			return getWithIndex(getCurrentVoiceIndex());
 	}
@@ -121,10 +158,10 @@ template <typename T, int NumVoices> struct PolyData
 	void forEachVoice(const std::function<void(T& v)>& f)
 	{
 		if (!isPolyphonic() || voicePtr == nullptr)
-			f(*data);
+			f(data[0]);
 		else
 		{
-			for (int i = 0; i < NumVoices; i++)
+			for (int i = 0; i < numAllocated; i++)
 				f(getWithIndex(i));
 		}
 	}
@@ -162,12 +199,12 @@ template <typename T, int NumVoices> struct PolyData
 
 	const T& getFirst() const
 	{
-		return *data;
+		return data[0];
 	}
 
 	T& getFirst()
 	{
-		return *data;
+		return data[0];
 	}
 
 	String getVoiceIndexForDebugging() const
@@ -184,27 +221,33 @@ private:
 	{
 		jassert(isPolyphonic());
 		jassert(voicePtr != nullptr);
-		jassert(isPositiveAndBelow(*voicePtr, NumVoices));
+		jassert(isPositiveAndBelow(*voicePtr, numAllocated));
 		return *voicePtr;
 	}
 
 	int getVoiceIndex(int index) const
 	{
-		auto rv = index & (NumVoices - 1);
-		return rv;
+		// A voice index above the polyphony that was passed into prepare() would
+		// silently share the state of another voice, so catch it here...
+		jassert(isPositiveAndBelow(index, numAllocated));
+		return jlimit(0, numAllocated - 1, index);
 	}
 
 	T& getWithIndex(int index)
 	{
-		return *(data + getVoiceIndex(index));
+		return *(data.get() + getVoiceIndex(index));
 	}
 
 	const T& getWithIndex(int index) const
 	{
-		return *(data + getVoiceIndex(index));
+		return *(data.get() + getVoiceIndex(index));
 	}
 
-	T data[NumVoices];
+	static void copyIfPossible(T& dst, const T& src, std::true_type) { dst = src; }
+	static void copyIfPossible(T&, const T&, std::false_type) {}
+
+	std::unique_ptr<T[]> data;
+	int numAllocated = 1;
 	int* voicePtr = nullptr;
 	
 	
@@ -108,6 +108,7 @@ DspNetwork::DspNetwork(hise::ProcessorWithScriptingContent* p, ValueTree data_,
 			auto newId = v[PropertyIds::ID].toString();
 
 			changeNodeId(data, oldId, newId, getUndoManager());
+			n->updateProfilerSource();
 		}
 	});
     
@@ -294,6 +295,15 @@ void DspNetwork::prepareToPlay(double sampleRate, double blockSize)
 		ps.blockSize = (int)blockSize;
 		ps.numChannels = signalPath->getNumChannelsToProcess();
 		ps.voiceIndex = &voiceIndex;
+		ps.numVoices = 1;
+
+		if (isPolyphonic())
+		{
+			if (auto p = dynamic_cast<Processor*>(getScriptProcessor()))
+				ps.numVoices = jmax(1, p->getVoiceAmount());
+			else
+				ps.numVoices = NUM_POLYPHONIC_VOICES;
+		}
 
 		signalPath->prepare(ps);
 	}
@@ -84,6 +84,8 @@ NodeBase::NodeBase(DspNetwork* rootNetwork, ValueTree data_, int numConstants_)
 	{
 		addConstant(c[PropertyIds::ID].toString(), c[PropertyIds::ID]);
 	}
+
+	updateProfilerSource();
 }
 
 DspNetwork* NodeBase::getRootNetwork() const
@@ -91,6 +93,12 @@ DspNetwork* NodeBase::getRootNetwork() const
 	return static_cast<DspNetwork*>(parent.get());
 }
 
+void NodeBase::updateProfilerSource()
+{
+	auto& profiler = getScriptProcessor()->getMainController_()->getPerformanceProfiler();
+	profilerSource = profiler.registerSource(getRootNetwork()->getId() + "." + getId(), PerformanceProfiler::Category::Node);
+}
+
 
 void NodeBase::prepareParameters(PrepareSpecs specs)
 {
@@ -430,6 +430,12 @@ public:
 
 	String getCurrentId() const { return currentId; }
 
+	/** Returns the handle that is used by the containers to profile this node (see PerformanceProfiler). */
+	const PerformanceProfiler::Source& getProfilerSource() const noexcept { return profilerSource; }
+
+	/** Registers the current ID at the profiler. This is called when the node is created or renamed. */
+	void updateProfilerSource();
+
 	struct Wrapper;
 
 private:
@@ -448,6 +454,8 @@ private:
 
 	String currentId;
 
+	PerformanceProfiler::Source profilerSource;
+
 	HelpManager helpManager;
 
 	CachedValue<bool> bypassed;
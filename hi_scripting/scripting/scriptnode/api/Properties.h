@@ -107,6 +107,7 @@ DECLARE_ID(FillMode);
 DECLARE_ID(AddToSignal);
 DECLARE_ID(UseMidi);
 DECLARE_ID(UseFreqDomain);
+DECLARE_ID(UseMultiStage);
 DECLARE_ID(ResetValue);
 DECLARE_ID(UseResetValue);
 DECLARE_ID(RoutingMatrix);
@@ -142,10 +142,16 @@ void jit_impl<NV>::updateCode(Identifier id, var newValue)
 template <int NV>
 void jit_impl<NV>::prepare(PrepareSpecs specs)
 {
+	auto numBefore = cData.size();
+
 	cData.prepare(specs);
 
 	lastSpecs = specs;
 
+	// The voice state was reallocated, so the new voices need their own compiled objects
+	if (numBefore != cData.size() && lastCode.isNotEmpty())
+		triggerAsyncUpdate();
+
 	voiceIndexPtr = specs.voiceIndex;
 
 	if (auto l = SingleWriteLockfreeMutex::ScopedReadLock(lock))
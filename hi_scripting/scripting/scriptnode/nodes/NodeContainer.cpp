@@ -75,6 +75,7 @@ void NodeContainer::prepareContainer(PrepareSpecs& ps)
 	originalSampleRate = ps.sampleRate;
 	originalBlockSize = ps.blockSize;
 	lastVoiceIndex = ps.voiceIndex;
+	lastNumVoices = ps.numVoices;
 
 	ps.sampleRate = getSampleRateForChildNodes();
 	ps.blockSize = getBlockSizeForChildNodes();
@@ -179,6 +180,7 @@ void NodeContainer::updateChannels(ValueTree v, Identifier id)
 			ps.blockSize = originalBlockSize;
 			ps.sampleRate = originalSampleRate;
 			ps.voiceIndex = lastVoiceIndex;
+			ps.numVoices = lastNumVoices;
 
 			asNode()->prepare(ps);
 		}
@@ -199,6 +201,7 @@ void NodeContainer::updateChannels(ValueTree v, Identifier id)
 			ps.blockSize = originalBlockSize;
 			ps.sampleRate = originalSampleRate;
 			ps.voiceIndex = lastVoiceIndex;
+			ps.numVoices = lastNumVoices;
 
 			asNode()->prepare(ps);
 		}
@@ -983,7 +986,10 @@ void SerialNode::DynamicSerialProcessor::process(ProcessData& d)
 	jassert(parent != nullptr);
 
 	for (auto n : parent->getNodeList())
+	{
+		PROFILE_SCOPE(n->getProfilerSource());
 		n->process(d);
+	}
 }
 
 void SerialNode::DynamicSerialProcessor::processSingle(float* frameData, int numChannels)
@@ -192,6 +192,8 @@ private:
 	valuetree::RecursivePropertyListener channelListener;
 
 	int* lastVoiceIndex = nullptr;
+
+	int lastNumVoices = NUM_POLYPHONIC_VOICES;
 	bool channelRecursionProtection = false;
 };
 
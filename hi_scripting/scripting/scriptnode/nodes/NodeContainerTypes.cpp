@@ -133,6 +133,7 @@ void SplitNode::process(ProcessData& data)
 			if (n->isBypassed())
 				continue;
 
+			PROFILE_SCOPE(n->getProfilerSource());
 			n->process(data);
 		}
 		else
@@ -141,7 +142,12 @@ void SplitNode::process(ProcessData& data)
 				continue;
 
 			auto wd = original.copyTo(splitBuffer, 1);
-			n->process(wd);
+
+			{
+				PROFILE_SCOPE(n->getProfilerSource());
+				n->process(wd);
+			}
+
 			data += wd;
 		}
 	}
@@ -306,6 +312,7 @@ void OversampleNode<OversampleFactor>::updateBypassState(Identifier, var)
 	ps.sampleRate = originalSampleRate;
 	ps.numChannels = getNumChannelsToProcess();
 	ps.voiceIndex = lastVoiceIndex;
+	ps.numVoices = lastNumVoices;
 
 	prepare(ps);
 }
@@ -314,6 +321,7 @@ template <int OversampleFactor>
 void OversampleNode<OversampleFactor>::prepare(PrepareSpecs ps)
 {
 	lastVoiceIndex = ps.voiceIndex;
+	lastNumVoices = ps.numVoices;
 	prepareNodes(ps);
 
 	if (isBypassed())
@@ -390,6 +398,7 @@ void FixedBlockNode<B>::updateBypassState(Identifier, var)
 	ps.sampleRate = originalSampleRate;
 	ps.numChannels = getNumChannelsToProcess();
 	ps.voiceIndex = lastVoiceIndex;
+	ps.numVoices = lastNumVoices;
 
 	prepare(ps);
 }
@@ -411,6 +420,7 @@ template <int B>
 void FixedBlockNode<B>::prepare(PrepareSpecs ps)
 {
 	lastVoiceIndex = ps.voiceIndex;
+	lastNumVoices = ps.numVoices;
 	prepareNodes(ps);
 
 	if (isBypassed())
@@ -558,6 +568,7 @@ void MultiChannelNode::process(ProcessData& d)
 			thisData.numChannels = numChannelsThisTime;
 			thisData.size = d.size;
 
+			PROFILE_SCOPE(n->getProfilerSource());
 			n->process(thisData);
 		}
 
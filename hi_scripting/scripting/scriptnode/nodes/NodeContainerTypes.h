@@ -131,6 +131,7 @@ public:
 
 	valuetree::PropertyListener bypassListener;
 	int* lastVoiceIndex = nullptr;
+	int lastNumVoices = NUM_POLYPHONIC_VOICES;
 };
 
 template <int B> class FixedBlockNode : public SerialNode
@@ -159,6 +160,7 @@ public:
 
 	valuetree::PropertyListener bypassListener;
 	int* lastVoiceIndex = nullptr;
+	int lastNumVoices = NUM_POLYPHONIC_VOICES;
 };
 
 
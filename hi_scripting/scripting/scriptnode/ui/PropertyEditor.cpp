@@ -191,7 +191,7 @@ NodePropertyComponent::Comp::Comp(ValueTree d, NodeBase* n) :
 
 	Identifier propId = Identifier(d[PropertyIds::ID].toString().fromLastOccurrenceOf(".", false, false));
 
-	if (propId == PropertyIds::FillMode || propId == PropertyIds::UseMidi || propId == PropertyIds::UseResetValue || propId == PropertyIds::UseFreqDomain)
+	if (propId == PropertyIds::FillMode || propId == PropertyIds::UseMidi || propId == PropertyIds::UseResetValue || propId == PropertyIds::UseFreqDomain || propId == PropertyIds::UseMultiStage)
 	{
 		TextButton* t = new TextButton();
 		t->setButtonText("Enabled");
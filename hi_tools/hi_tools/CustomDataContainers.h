@@ -505,23 +505,28 @@ private:
 
 
 
-/** A simple container holding NUM_POLYPHONIC_VOICES elements of the given ObjectType
+/** A simple container holding a fixed amount of elements of the given ObjectType (one per voice).
 *	@ingroup data_containers
 *
+*	The elements are allocated as one contiguous block with the size passed into the constructor,
+*	so a processor with 8 voices only pays for 8 elements. NUM_POLYPHONIC_VOICES is not used as
+*	storage size anymore, so you can raise it for big instruments without bloating every other instance.
+*
 *	In order to make this work, the ObjectType must have a standard constructor.
 */
 template <class ObjectType> class FixedVoiceAmountArray
 {
 public:
 	explicit FixedVoiceAmountArray(int numInArray):
-		numUsed(jlimit<int>(0, NUM_POLYPHONIC_VOICES, numInArray))
+		numUsed((size_t)jmax<int>(0, numInArray)),
+		data(new ObjectType[jmax<size_t>(1, numUsed)])
 	{}
 
 	inline ObjectType& operator[](int index) const
 	{
 		if (isPositiveAndBelow(index, numUsed))
 		{
-			auto r = const_cast<ObjectType*>(data + index);
+			auto r = const_cast<ObjectType*>(data.get() + index);
 			return *r;
 		}
 		else
@@ -533,31 +538,34 @@ public:
 	}
 
 	FixedVoiceAmountArray(FixedVoiceAmountArray&& other) :
-		numUsed(other.numUsed)
+		numUsed(other.numUsed),
+		data(std::move(other.data))
 	{
-		
+		other.numUsed = 0;
 	}
 
 	int size() const noexcept { return (int)numUsed; };
 
 	inline ObjectType* begin() const noexcept
 	{
-		ObjectType* d = const_cast<ObjectType*>(data);
+		ObjectType* d = const_cast<ObjectType*>(data.get());
 		return d;
 	}
 
 	inline ObjectType* end() const noexcept
 	{
-		ObjectType* d = const_cast<ObjectType*>(data);
+		ObjectType* d = const_cast<ObjectType*>(data.get());
 		return d + numUsed;
 	}
 
 private:
 
-	const size_t numUsed;
+	size_t numUsed;
 
-	ObjectType data[NUM_POLYPHONIC_VOICES];
+	std::unique_ptr<ObjectType[]> data;
 	ObjectType fallback;
+
+	JUCE_DECLARE_NON_COPYABLE(FixedVoiceAmountArray);
 };
 
 namespace MultithreadedQueueHelpers
@@ -350,11 +350,53 @@ void HiseEventBuffer::clear()
 
 		numUsed = 0;
 	}
+
+	if (isSpilling())
+	{
+		// The fixed storage still contains the events from before the switch
+		memset(fixedStorage, 0, HISE_EVENT_BUFFER_SIZE * sizeof(HiseEvent));
+		buffer = fixedStorage;
+	}
+}
+
+void HiseEventBuffer::ensureSpillCapacity(int totalNumEvents)
+{
+	if (totalNumEvents <= jmax<int>(HISE_EVENT_BUFFER_SIZE, spillCapacity))
+		return;
+
+	HeapBlock<HiseEvent> newBlock;
+	newBlock.calloc(totalNumEvents);
+
+	if (isSpilling())
+	{
+		CopyHelpers::copyEvents(newBlock.get(), buffer, numUsed);
+		buffer = newBlock.get();
+	}
+
+	spillBlock.swapWith(newBlock);
+	spillCapacity = totalNumEvents;
+}
+
+bool HiseEventBuffer::ensureRoomFor(int numToAdd)
+{
+	const int numRequired = numUsed + numToAdd;
+
+	if (numRequired <= getActiveCapacity())
+		return true;
+
+	if (isSpilling() || numRequired > spillCapacity)
+		return false;
+
+	CopyHelpers::copyEvents(spillBlock.get(), fixedStorage, numUsed);
+	HiseEvent::clear(spillBlock.get() + numUsed, spillCapacity - numUsed);
+	buffer = spillBlock.get();
+
+	return true;
 }
 
 void HiseEventBuffer::addEvent(const HiseEvent& hiseEvent)
 {
-	if (numUsed >= HISE_EVENT_BUFFER_SIZE)
+	if (!ensureRoomFor(1))
 	{
 		// Buffer full..
 		jassertfalse;
@@ -367,34 +409,21 @@ void HiseEventBuffer::addEvent(const HiseEvent& hiseEvent)
 		return;
 	}
 
-	jassert(numUsed < HISE_EVENT_BUFFER_SIZE);
+	const int messageTimestamp = hiseEvent.getTimeStamp();
 
-    const int numToLookFor = jmin<int>(numUsed, HISE_EVENT_BUFFER_SIZE);
-    
-	for (int i = 0; i < numToLookFor; i++)
+	// Most events are appended, so check the last one before searching
+	if (buffer[numUsed - 1].getTimeStamp() <= messageTimestamp)
 	{
-		const int timestampInBuffer = buffer[i].getTimeStamp();
-		const int messageTimestamp = hiseEvent.getTimeStamp();
-
-		if (timestampInBuffer > messageTimestamp)
-		{
-			insertEventAtPosition(hiseEvent, i);
-
-#if JUCE_DEBUG
-			if (!timeStampsAreSorted())
-			{
-				for (int j = 0; j < numToLookFor; j++)
-					DBG(buffer[j].toDebugString());
-			}
-#endif
-
-			jassert(timeStampsAreSorted());
-
-			return;
-		}
+		insertEventAtPosition(hiseEvent, numUsed);
+		return;
 	}
 
-	insertEventAtPosition(hiseEvent, numUsed);
+	auto pos = std::upper_bound(begin(), end(), messageTimestamp, [](int t, const HiseEvent& e)
+	{
+		return t < (int)e.getTimeStamp();
+	});
+
+	insertEventAtPosition(hiseEvent, (int)(pos - begin()));
 
 	jassert(timeStampsAreSorted());
 }
@@ -421,25 +450,22 @@ void HiseEventBuffer::addEvents(const MidiBuffer& otherBuffer)
 
 	while (it.getNextEvent(m, samplePos))
 	{
-		jassert(index < HISE_EVENT_BUFFER_SIZE);
-
 		HiseEvent e(m);
 
 		if (e.isEmpty()) continue;
 
-		e.swapWith(buffer[index]);
-
-		buffer[index].setTimeStamp(samplePos);
-
-		numUsed++;
-
-		if (numUsed >= HISE_EVENT_BUFFER_SIZE)
+		if (!ensureRoomFor(1))
 		{
 			// Buffer full..
 			jassertfalse;
 			return;
 		}
 
+		e.swapWith(buffer[index]);
+
+		buffer[index].setTimeStamp(samplePos);
+
+		numUsed++;
 		index++;
 	}
 
@@ -449,13 +475,55 @@ void HiseEventBuffer::addEvents(const MidiBuffer& otherBuffer)
 
 void HiseEventBuffer::addEvents(const HiseEventBuffer &otherBuffer)
 {
-	Iterator iter(otherBuffer);
+	mergeSorted(otherBuffer);
+}
+
+void HiseEventBuffer::mergeSorted(const HiseEventBuffer& otherBuffer)
+{
+	jassert(&otherBuffer != this);
+
+	if (otherBuffer.numUsed == 0)
+		return;
 
-	while (HiseEvent* e = iter.getNextEventPointer(false, false))
+	if (!otherBuffer.timeStampsAreSorted())
 	{
-		addEvent(*e);
+		for (const auto& e : otherBuffer)
+			addEvent(e);
+
+		return;
 	}
 
+	int numToMerge = otherBuffer.numUsed;
+
+	if (!ensureRoomFor(numToMerge))
+	{
+		// Buffer full, the latest events will be dropped...
+		jassertfalse;
+		ensureRoomFor(jmax<int>(0, getCapacity() - numUsed));
+		numToMerge = getActiveCapacity() - numUsed;
+	}
+
+	if (numToMerge <= 0)
+		return;
+
+	// Merge from the back so that no event has to be moved twice. On equal timestamps
+	// the new event goes after the existing ones (just like addEvent() does).
+	int readIndex = numUsed - 1;
+	int otherIndex = numToMerge - 1;
+	int writeIndex = numUsed + numToMerge - 1;
+
+	const auto* otherEvents = otherBuffer.buffer;
+
+	while (otherIndex >= 0)
+	{
+		if (readIndex >= 0 && buffer[readIndex].getTimeStamp() > otherEvents[otherIndex].getTimeStamp())
+			buffer[writeIndex--] = buffer[readIndex--];
+		else
+			buffer[writeIndex--] = otherEvents[otherIndex--];
+	}
+
+	numUsed += numToMerge;
+
 	jassert(timeStampsAreSorted());
 }
 
@@ -522,7 +590,7 @@ int HiseEventBuffer::getMaxTimeStamp() const
 
 HiseEvent HiseEventBuffer::getEvent(int index) const
 {
-	if (index >= 0 && index < HISE_EVENT_BUFFER_SIZE)
+	if (index >= 0 && index < getActiveCapacity())
 	{
 		return buffer[index];
 	}
@@ -631,13 +699,20 @@ void HiseEventBuffer::moveEventsAbove(HiseEventBuffer& targetBuffer, int lowestT
 
 void HiseEventBuffer::copyFrom(const HiseEventBuffer& otherBuffer)
 {
-    const int eventsToCopy = jmin<int>(otherBuffer.numUsed, HISE_EVENT_BUFFER_SIZE);
+	clear();
+
+	int eventsToCopy = otherBuffer.numUsed;
+
+	if (!ensureRoomFor(eventsToCopy))
+	{
+		// Buffer full, call ensureSpillCapacity() on this buffer too...
+		jassertfalse;
+		eventsToCopy = jmin<int>(eventsToCopy, HISE_EVENT_BUFFER_SIZE);
+	}
     
 	memcpy(buffer, otherBuffer.buffer, sizeof(HiseEvent) * eventsToCopy);
 
-	jassert(otherBuffer.numUsed < HISE_EVENT_BUFFER_SIZE);
-
-	numUsed = otherBuffer.numUsed;
+	numUsed = eventsToCopy;
 }
 
 
@@ -655,7 +730,6 @@ bool HiseEventBuffer::Iterator::getNextEvent(HiseEvent& b, int &samplePosition,
 		  (skipIgnoredEvents && buffer->buffer[index].isIgnored())))
 	{
 		index++;
-		jassert(index < HISE_EVENT_BUFFER_SIZE);
 	}
 		
 	if (index < buffer->numUsed)
@@ -686,7 +760,6 @@ const HiseEvent* HiseEventBuffer::Iterator::getNextConstEventPointer(bool skipIg
 		  (skipIgnoredEvents && buffer->buffer[index].isIgnored())))
 	{
 		index++;
-		jassert(index < HISE_EVENT_BUFFER_SIZE);
 	}
 
 	if (index < buffer->numUsed)
@@ -710,16 +783,18 @@ void HiseEventBuffer::insertEventAtPosition(const HiseEvent& e, int positionInBu
 		return;
 	}
 
+	const int capacity = getActiveCapacity();
+
 	if (numUsed > positionInBuffer)
 	{
-		for (int i = jmin<int>(numUsed-1, HISE_EVENT_BUFFER_SIZE-2); i >= positionInBuffer; i--)
+		for (int i = jmin<int>(numUsed-1, capacity-2); i >= positionInBuffer; i--)
 		{
-			jassert(i + 1 < HISE_EVENT_BUFFER_SIZE);
+			jassert(i + 1 < capacity);
 			buffer[i + 1] = buffer[i];
 		}
 	}
 
-    if(positionInBuffer < HISE_EVENT_BUFFER_SIZE)
+    if(positionInBuffer < capacity)
     {
         buffer[positionInBuffer] = HiseEvent(e);
         numUsed++;
@@ -769,7 +844,7 @@ void EventIdHandler::handleEventIds()
 			if (realNoteOnEvents[channel][m->getNoteNumber()].isEmpty())
 				realNoteOnEvents[channel][m->getNoteNumber()] = HiseEvent(*m);
 			else
-				overlappingNoteOns.insertWithoutSearch(HiseEvent(*m));
+				overlappingNoteOns.push(channel, *m);
 		}
 		else if (m->isNoteOff())
 		{
@@ -786,25 +861,14 @@ void EventIdHandler::handleEventIds()
 			}
 			else
 			{
-				int s = overlappingNoteOns.size();
-				bool found = false;
+				HiseEvent on;
 
-				for (int i = 0; i < s; i++)
+				if (overlappingNoteOns.pop(channel, m->getNoteNumber(), on))
 				{
-					auto on = overlappingNoteOns[i];
-
-					if (on.getNoteNumber() == m->getNoteNumber() && on.getChannel() == m->getChannel())
-					{
-						auto id = on.getEventId();
-						m->setEventId(id);
-						m->setTransposeAmount(on.getTransposeAmount());
-						overlappingNoteOns.removeElement(i);
-						found = true;
-						break;
-					}
+					m->setEventId(on.getEventId());
+					m->setTransposeAmount(on.getTransposeAmount());
 				}
-
-				if (!found)
+				else
 				{
 					// There is something fishy here so deactivate this event
 					m->ignoreEvent(true);
@@ -832,11 +896,8 @@ uint16 EventIdHandler::getEventIdForNoteOff(const HiseEvent &noteOffEvent)
 		}
 		else
 		{
-			for (auto no : overlappingNoteOns)
-			{
-				if (noteOffEvent.getNoteNumber() == no.getNoteNumber() && noteOffEvent.getChannel() == no.getChannel())
-					return no.getEventId();
-			}
+			if (auto no = overlappingNoteOns.peek(channel, noteNumber))
+				return no->getEventId();
 
 			jassertfalse;
 			return 0;
@@ -875,5 +936,81 @@ HiseEvent EventIdHandler::popNoteOnFromEventId(uint16 eventId)
 	return e;
 }
 
+EventIdHandler::OverlappingNoteOns::OverlappingNoteOns()
+{
+	clear();
+}
+
+bool EventIdHandler::OverlappingNoteOns::push(int channelIndex, const HiseEvent& noteOn) noexcept
+{
+	if (firstFree == -1)
+	{
+		// Too many overlapping notes, the note off for this one will be ignored
+		jassertfalse;
+		return false;
+	}
+
+	const int noteNumber = noteOn.getNoteNumber();
+	const int16 index = firstFree;
+
+	firstFree = pool[index].next;
+
+	pool[index].e = noteOn;
+	pool[index].next = -1;
+
+	if (tails[channelIndex][noteNumber] == -1)
+		heads[channelIndex][noteNumber] = index;
+	else
+		pool[tails[channelIndex][noteNumber]].next = index;
+
+	tails[channelIndex][noteNumber] = index;
+	numUsed++;
+
+	return true;
+}
+
+bool EventIdHandler::OverlappingNoteOns::pop(int channelIndex, int noteNumber, HiseEvent& eventToFill) noexcept
+{
+	const int16 index = heads[channelIndex][noteNumber];
+
+	if (index == -1)
+		return false;
+
+	eventToFill = pool[index].e;
+
+	heads[channelIndex][noteNumber] = pool[index].next;
+
+	if (heads[channelIndex][noteNumber] == -1)
+		tails[channelIndex][noteNumber] = -1;
+
+	pool[index].e = HiseEvent();
+	pool[index].next = firstFree;
+	firstFree = index;
+	numUsed--;
+
+	return true;
+}
+
+const HiseEvent* EventIdHandler::OverlappingNoteOns::peek(int channelIndex, int noteNumber) const noexcept
+{
+	const int16 index = heads[channelIndex][noteNumber];
+	return index != -1 ? &pool[index].e : nullptr;
+}
+
+void EventIdHandler::OverlappingNoteOns::clear() noexcept
+{
+	memset(heads, 0xFF, sizeof(heads));
+	memset(tails, 0xFF, sizeof(tails));
+
+	for (int i = 0; i < PoolSize; i++)
+	{
+		pool[i].e = HiseEvent();
+		pool[i].next = (int16)(i + 1 < PoolSize ? i + 1 : -1);
+	}
+
+	firstFree = 0;
+	numUsed = 0;
+}
+
 
 } // namespace hise
@@ -489,6 +489,11 @@ private:
 
 #define HISE_EVENT_BUFFER_SIZE 256
 
+/** The default size of the secondary block that a HiseEventBuffer can spill into (see HiseEventBuffer::ensureSpillCapacity()). */
+#ifndef HISE_EVENT_BUFFER_SPILL_SIZE
+#define HISE_EVENT_BUFFER_SPILL_SIZE 2048
+#endif
+
 /** The buffer type for the HiseEvent.
 
 */
@@ -634,6 +639,24 @@ public:
 	/** Returns the number of events in this buffer. */
 	int getNumUsed() const { return numUsed; }
 
+	/** Returns the amount of events that fit into the buffer without dropping events. 
+	
+		This is HISE_EVENT_BUFFER_SIZE unless a spill block was preallocated with ensureSpillCapacity().
+	*/
+	int getCapacity() const noexcept { return jmax<int>(HISE_EVENT_BUFFER_SIZE, spillCapacity); }
+
+	/** Preallocates a secondary block that the buffer switches to when the fixed storage is full.
+	
+		Call this outside the audio thread (eg. in prepareToPlay()). Once it is allocated, dense 
+		event streams will be moved into the spill block instead of being dropped, so there is 
+		no allocation on the audio thread. The buffer switches back to its fixed storage when 
+		it is cleared.
+	*/
+	void ensureSpillCapacity(int totalNumEvents);
+
+	/** Returns true if the events are currently stored in the spill block. */
+	bool isSpilling() const noexcept { return buffer != fixedStorage; }
+
 	HiseEvent getEvent(int index) const;
 
 	HiseEvent popEvent(int index);
@@ -650,6 +673,14 @@ public:
 	void addEvents(const MidiBuffer& otherBuffer);
 
 	void addEvents(const HiseEventBuffer &otherBuffer);
+
+	/** Merges the (sorted) events of the other buffer into this buffer in O(n+m).
+	
+		Events with the same timestamp are inserted after the existing events, so the result
+		is the same as calling addEvent() for each event. If the other buffer is not sorted, 
+		it falls back to adding the events one by one.
+	*/
+	void mergeSorted(const HiseEventBuffer& otherBuffer);
 	
 	void sortTimestamps();
 	
@@ -729,9 +760,22 @@ private:
 
 	void insertEventAtPosition(const HiseEvent& e, int positionInBuffer);
 
-	event_alignment HiseEvent buffer[HISE_EVENT_BUFFER_SIZE];
+	/** Makes sure that numToAdd more events fit into the buffer (by switching to the spill block if required). */
+	bool ensureRoomFor(int numToAdd);
+
+	int getActiveCapacity() const noexcept { return isSpilling() ? spillCapacity : HISE_EVENT_BUFFER_SIZE; }
+
+	event_alignment HiseEvent fixedStorage[HISE_EVENT_BUFFER_SIZE];
+
+	HeapBlock<HiseEvent> spillBlock;
+	int spillCapacity = 0;
+
+	/** Points to either the fixed storage or the spill block. */
+	HiseEvent* buffer = fixedStorage;
 
 	int numUsed = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(HiseEventBuffer);
 };
 
 #undef event_alignment
@@ -772,13 +816,54 @@ public:
 
 private:
 
+	/** A fixed-size pool of note on events that share their channel and note number with a note that is still playing.
+
+		Every (channel, note) slot owns a singly linked list through the pool, so pushing a new overlapping note and
+		finding the oldest one for a note off are both O(1) no matter how many notes are overlapping.
+	*/
+	class OverlappingNoteOns
+	{
+	public:
+
+		OverlappingNoteOns();
+
+		/** Appends the note on to the list of its slot. Returns false if the pool is full. */
+		bool push(int channelIndex, const HiseEvent& noteOn) noexcept;
+
+		/** Removes the oldest note on of the given slot and returns false if there is none. */
+		bool pop(int channelIndex, int noteNumber, HiseEvent& eventToFill) noexcept;
+
+		/** Returns the oldest note on of the given slot without removing it or nullptr. */
+		const HiseEvent* peek(int channelIndex, int noteNumber) const noexcept;
+
+		void clear() noexcept;
+
+		int size() const noexcept { return numUsed; }
+
+	private:
+
+		static constexpr int PoolSize = 256;
+
+		struct Node
+		{
+			HiseEvent e;
+			int16 next;
+		};
+
+		Node pool[PoolSize];
+		int16 firstFree;
+		int16 heads[16][128];
+		int16 tails[16][128];
+		int numUsed = 0;
+	};
+
 	const HiseEventBuffer &masterBuffer;
 	HeapBlock<HiseEvent> artificialEvents;
 	uint16 lastArtificialEventIds[16][128];
 	HiseEvent realNoteOnEvents[16][128];
 	uint16 currentEventId;
 
-	UnorderedStack<HiseEvent, 256> overlappingNoteOns;
+	OverlappingNoteOns overlappingNoteOns;
 
 	// ===========================================================================================================
 
@@ -132,10 +132,151 @@ public:
         print("Add the -rlottie flag to include the .dlls for RLottie.");
         print("(You'll need to put them into the AdditionalSourceCode directory");
         print("Add the -a:x64 or -a:x86 flag to just create an installer for the specified platform");
+		print("");
+		print("render -p:PRESET -m:MIDI_FILE -o:OUTPUT_FILE [-sr:SAMPLERATE] [-bs:BLOCKSIZE] [-tail:SECONDS]");
+		print("Renders the MIDI file through the preset (.hip) faster than realtime and writes a WAV file.");
+		print("The sample streaming runs in non-realtime mode and the realtime factor is printed at the end.");
+		print("");
+		print("benchmark -o:OUTPUT_FILE [-s:SCENARIO] [-n:VOICES] [-sr:SAMPLERATE] [-bs:BLOCKSIZE] [-t:SECONDS] [-tag:TAG] [-strict] [-trace:DIRECTORY] [-fir]");
+		print("Runs the audio engine benchmark and writes the result as JSON file.");
+		print("-s:SCENARIO - one of sine, sampler, wavetable, scriptnode, convolution, script, oversampling1x, oversampling2x, oversampling4x, oversampling8x, oversampling16x, reverb, fdnreverb (default: all).");
+		print("-n:VOICES - the number of voices that are playing (default: 64).");
+		print("-t:SECONDS - the audio time that is measured for each scenario (default: 10).");
+		print("-tag:TAG - a string that is written to the report (eg. the commit hash).");
+		print("-strict - fails if the audio callback allocates or waits for a lock (needs HISE_ENABLE_AUDIO_THREAD_INSTRUMENTATION).");
+		print("-trace:DIRECTORY - profiles the measured blocks and writes a Chrome trace JSON file for each scenario.");
+		print("-fir - uses the linear phase FIR filters in the oversampling scenarios (default: minimum phase IIR).");
 
 		exit(0);
 	}
 
+	static void renderMidiFile(const String& commandLine)
+	{
+		auto args = getCommandLineArgs(commandLine);
+
+		auto getFile = [&args](const String& prefix)
+		{
+			auto s = getArgument(args, prefix);
+
+			if (s.isEmpty() || !File::isAbsolutePath(s))
+				throwErrorAndQuit("`" + s + "` is not a valid path for " + prefix);
+
+			return File(s);
+		};
+
+		OfflineMidiRenderer::Settings s;
+
+		s.presetFile = getFile("-p:");
+		s.midiFile = getFile("-m:");
+		s.outputFile = getFile("-o:");
+
+		auto sr = getArgument(args, "-sr:");
+		auto bs = getArgument(args, "-bs:");
+		auto tail = getArgument(args, "-tail:");
+
+		if (sr.isNotEmpty())
+			s.sampleRate = sr.getDoubleValue();
+
+		if (bs.isNotEmpty())
+			s.blockSize = bs.getIntValue();
+
+		if (tail.isNotEmpty())
+			s.tailSeconds = tail.getDoubleValue();
+
+		print("Rendering " + s.midiFile.getFileName() + " with " + s.presetFile.getFileName() + "...");
+
+		OfflineMidiRenderer renderer(s);
+
+		auto r = renderer.render();
+
+		if (r.failed())
+			throwErrorAndQuit(r.getErrorMessage());
+
+		print(renderer.getStatistics().toString());
+		print("Written to " + s.outputFile.getFullPathName());
+	}
+
+	static void runBenchmark(const String& commandLine)
+	{
+		auto args = getCommandLineArgs(commandLine);
+
+		auto output = getArgument(args, "-o:");
+
+		if (output.isEmpty() || !File::isAbsolutePath(output))
+			throwErrorAndQuit("`" + output + "` is not a valid path for -o:");
+
+		EngineBenchmark::Settings s;
+
+		auto sr = getArgument(args, "-sr:");
+		auto bs = getArgument(args, "-bs:");
+		auto numVoices = getArgument(args, "-n:");
+		auto seconds = getArgument(args, "-t:");
+		auto scenario = getArgument(args, "-s:");
+
+		if (sr.isNotEmpty())
+			s.sampleRate = sr.getDoubleValue();
+
+		if (bs.isNotEmpty())
+			s.blockSize = bs.getIntValue();
+
+		if (numVoices.isNotEmpty())
+			s.numVoices = numVoices.getIntValue();
+
+		if (seconds.isNotEmpty())
+			s.secondsToMeasure = seconds.getDoubleValue();
+
+		s.tag = getArgument(args, "-tag:");
+		s.failOnAudioThreadViolations = args.contains("-strict");
+
+		if (args.contains("-fir"))
+			s.oversamplingFilter = EffectOversampler::LinearPhaseFIR;
+
+		auto traceDirectory = getArgument(args, "-trace:");
+
+		if (traceDirectory.isNotEmpty())
+		{
+			if (!File::isAbsolutePath(traceDirectory))
+				throwErrorAndQuit("`" + traceDirectory + "` is not a valid path for -trace:");
+
+			s.traceDirectory = File(traceDirectory);
+			s.traceDirectory.createDirectory();
+		}
+
+		EngineBenchmark benchmark(s);
+
+		Result r = Result::ok();
+
+		if (scenario.isNotEmpty())
+		{
+			auto sc = EngineBenchmark::getScenarioFromName(scenario);
+
+			if (sc == EngineBenchmark::Scenario::numScenarios)
+				throwErrorAndQuit("Unknown scenario: " + scenario);
+
+			r = benchmark.run(sc);
+		}
+		else
+			r = benchmark.runAll();
+
+		if (r.failed())
+			throwErrorAndQuit(r.getErrorMessage());
+
+		for (const auto& m : benchmark.getMeasurements())
+		{
+			print(m.toString());
+
+			if (m.profilerSummary.isNotEmpty())
+				print(m.profilerSummary);
+		}
+
+		File outputFile(output);
+
+		if (!outputFile.replaceWithText(JSON::toString(benchmark.createReport())))
+			throwErrorAndQuit("Can't write to " + outputFile.getFullPathName());
+
+		print("Written to " + outputFile.getFullPathName());
+	}
+
 	static void createWindowsInstallerFile(const String& commandLine)
 	{
 		auto args = getCommandLineArgs(commandLine);
@@ -432,6 +573,18 @@ public:
 			quit();
 			return;
 		}
+		else if (commandLine.startsWith("render"))
+		{
+			CommandLineActions::renderMidiFile(commandLine);
+			quit();
+			return;
+		}
+		else if (commandLine.startsWith("benchmark"))
+		{
+			CommandLineActions::runBenchmark(commandLine);
+			quit();
+			return;
+		}
 		else if (commandLine.startsWith("set_hise_folder"))
 		{
 			CommandLineActions::setHiseFolder(commandLine);